@@ -0,0 +1,47 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Parse a comma-separated list of unsigned values ("1,2,4")
+ */
+inline std::vector<unsigned> ParseList(const std::string& list) {
+    std::vector<unsigned> values;
+    size_t start = 0;
+    while (start < list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        values.push_back(unsigned(std::stoul(list.substr(start, end - start))));
+        start = end + 1;
+    }
+    return values;
+}
+
+/**
+ * @brief Thread counts to run: the requested list, or powers of two up to the hardware
+ * @param requested Counts from --threads (may be empty)
+ * @param serialFirst Speedup is measured against a real serial run, so 1 thread always goes first
+ */
+inline std::vector<unsigned> ThreadCounts(std::vector<unsigned> requested, bool serialFirst) {
+    if (requested.empty()) {
+        const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned t = 1; t < hw; t *= 2) {
+            requested.push_back(t);
+        }
+        requested.push_back(hw);
+    }
+    if (serialFirst) {
+        requested.erase(std::remove(requested.begin(), requested.end(), 1u), requested.end());
+        requested.insert(requested.begin(), 1u);
+    }
+    return requested;
+}
+
+} // namespace NRE
@@ -0,0 +1,74 @@
+#include "BenchCommon.h"
+
+#include <core/JobSystem.h>
+#include <nature/Caustics.h>
+#include <nature/OceanFFT.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace NRE;
+
+/**
+ * @brief Caustics precomputation benchmark
+ *
+ * Refracts the ray grid through the finest cascade of a 3-cascade ocean
+ * and prints one CSV row per map resolution, rays per texel and thread
+ * count: milliseconds per map update (run once per ocean update), cost
+ * per ray, and parallel scaling. The ocean update itself is not timed;
+ * see bench_ocean for that.
+ *
+ * Usage: bench_caustics [--resolutions 128,256,512] [--rays 1,2]
+ *                       [--ocean N] [--frames N] [--threads 1,2,4]
+ */
+
+int main(int argc, char** argv) {
+    std::vector<unsigned> resolutions = {128, 256, 512};
+    std::vector<unsigned> raysPerTexel = {1, 2};
+    int oceanResolution = 256;
+    int frames = 10;
+    std::vector<unsigned> threadCounts;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--resolutions")) resolutions = ParseList(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--rays")) raysPerTexel = ParseList(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--ocean")) oceanResolution = std::atoi(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--frames")) frames = std::atoi(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--threads")) threadCounts = ParseList(argv[i + 1]);
+    }
+    threadCounts = ThreadCounts(threadCounts, true);
+
+    OceanFFT::Options oceanOptions;
+    oceanOptions.resolution = oceanResolution;
+    OceanFFT ocean(oceanOptions);
+    ocean.Update(1.0f);
+
+    std::cout << "map_resolution,rays_per_texel,rays,threads,ms_per_update,ns_per_ray,speedup" << std::endl;
+    for (unsigned resolution : resolutions) {
+        for (unsigned rays : raysPerTexel) {
+            Caustics::Options options;
+            options.resolution = int(resolution);
+            options.raysPerTexel = int(rays);
+            Caustics caustics(options);
+            const double rayCount = double(resolution * rays) * double(resolution * rays);
+            double singleThreadMs = 0.0;
+            for (unsigned threads : threadCounts) {
+                JobSystem jobs(threads);
+                caustics.Update(ocean, &jobs);  // Warm up band buffers
+                const auto start = std::chrono::steady_clock::now();
+                for (int f = 0; f < frames; ++f) {
+                    caustics.Update(ocean, &jobs);
+                }
+                const double ms =
+                    1000.0 * std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / frames;
+                if (threads == 1) {
+                    singleThreadMs = ms;
+                }
+                std::cout << resolution << "," << rays << "," << size_t(rayCount) << "," << threads << "," << ms
+                          << "," << 1e6 * ms / rayCount << "," << singleThreadMs / ms << std::endl;
+            }
+        }
+    }
+    return 0;
+}
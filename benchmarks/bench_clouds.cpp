@@ -0,0 +1,63 @@
+#include "BenchCommon.h"
+#include "MemoryStorage.h"
+
+#include <core/JobSystem.h>
+#include <core/StorageManager.h>
+#include <nature/CloudNoiseBaker.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace NRE;
+
+/**
+ * @brief Cloud noise bake benchmark
+ *
+ * Times CloudNoiseBaker at each shape volume size and thread count and
+ * prints one CSV row per run: generating from scratch, loading the same
+ * bake back from an in-memory StorageManager, and one weather coverage
+ * update, in milliseconds.
+ *
+ * Usage: bench_clouds [--sizes 64,128] [--weather N] [--threads 1,2,4]
+ */
+
+int main(int argc, char** argv) {
+    std::vector<unsigned> sizes = {64, 128};
+    int weatherSize = 512;
+    std::vector<unsigned> threadCounts;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--sizes")) sizes = ParseList(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--weather")) weatherSize = std::atoi(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--threads")) threadCounts = ParseList(argv[i + 1]);
+    }
+    threadCounts = ThreadCounts(threadCounts, false);
+
+    auto msSince = [](std::chrono::steady_clock::time_point start) {
+        return 1000.0 * std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+    std::cout << "shape_size,weather_size,threads,generate_ms,cache_load_ms,coverage_update_ms,stored_mb" << std::endl;
+    for (unsigned size : sizes) {
+        CloudNoiseBaker::Options options;
+        options.shapeSize = int(size);
+        options.weatherSize = weatherSize;
+        for (unsigned threads : threadCounts) {
+            JobSystem jobs(threads);
+            MemoryStorage storage;
+            CloudNoiseBaker generated(options), loaded(options);
+            auto start = std::chrono::steady_clock::now();
+            generated.Bake(&jobs, &storage);
+            const double generateMs = msSince(start);
+            start = std::chrono::steady_clock::now();
+            loaded.Bake(&jobs, &storage);
+            const double loadMs = msSince(start);
+            start = std::chrono::steady_clock::now();
+            loaded.UpdateCoverage(CloudNoiseBaker::CoverageFor(WeatherSystem::WeatherType::Rain), &jobs);
+            const double coverageMs = msSince(start);
+            std::cout << size << "," << weatherSize << "," << threads << "," << generateMs << "," << loadMs << ","
+                      << coverageMs << "," << double(generated.GetStoredBytes()) / (1024.0 * 1024.0) << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "BenchCommon.h"
+
+#include <nature/EcosystemStepper.h>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace NRE;
+
+/**
+ * @brief Headless ecosystem benchmark
+ *
+ * Runs seeded worlds at doubling populations up to Config::maxPlants and
+ * Config::maxAnimals, across thread counts, and prints one CSV row per run:
+ * ms per tick, memory per entity, and parallel scaling efficiency. A
+ * 1-thread run always comes first and is the baseline for speedup.
+ *
+ * Usage: bench_ecosystem [--ticks N] [--seed S] [--max-plants N]
+ *                        [--max-animals N] [--threads 1,2,4]
+ */
+
+struct BenchOptions {
+    int ticks = 60;
+    uint64_t seed = 1234;
+    std::vector<unsigned> threads;
+};
+
+template <typename Column>
+size_t ColumnBytes(const Column& column) {
+    return column.capacity() * sizeof(typename Column::value_type);
+}
+
+int main(int argc, char** argv) {
+    EcosystemSimulation::Config config;
+    BenchOptions bench;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--ticks")) bench.ticks = std::atoi(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--seed")) bench.seed = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--max-plants")) config.maxPlants = std::atoi(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--max-animals")) config.maxAnimals = std::atoi(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--threads")) bench.threads = ParseList(argv[i + 1]);
+    }
+    bench.threads = ThreadCounts(bench.threads, true);
+
+    SpeciesTraits grass;
+    SpeciesTraits oak;
+    oak.name = "oak";
+    oak.maxHeight = 25.0f;
+    oak.growthRate = 0.15f;
+    AnimalTraits deer;
+    AnimalTraits rabbit;
+    rabbit.name = "rabbit";
+    rabbit.speed = 2.0f;
+    rabbit.senseRadius = 15.0f;
+    AnimalTraits wolf;
+    wolf.name = "wolf";
+    wolf.speed = 5.0f;
+    wolf.isPredator = true;
+
+    const float tickSeconds = 1.0f / 60.0f;
+    std::cout << "plants,animals,threads,ms_per_tick,bytes_per_entity,speedup,efficiency,realtime_60hz" << std::endl;
+
+    for (int shift = 5; shift >= 0; --shift) {
+        const int plantCount = config.maxPlants >> shift;
+        const int animalCount = config.maxAnimals >> shift;
+        const float worldSize = std::sqrt(float(plantCount) * 25.0f);  // Constant density
+        double singleThreadMs = 0.0;
+
+        for (unsigned threads : bench.threads) {
+            PlantColumns plants;
+            AnimalColumns animals;
+            Random rng(bench.seed);
+            plants.Reserve(size_t(plantCount));
+            animals.Reserve(size_t(animalCount));
+            for (int i = 0; i < plantCount; i++) {
+                plants.Push(SpeciesId(i % 2), rng.Range(0.0f, worldSize), 0.0f, rng.Range(0.0f, worldSize));
+            }
+            for (int i = 0; i < animalCount; i++) {
+                const SpeciesId species = (i % 10 == 0) ? 2 : SpeciesId(i % 2);
+                animals.Push(species, rng.Range(0.0f, worldSize), 0.0f, rng.Range(0.0f, worldSize));
+            }
+
+            PopulationIndex::Config indexConfig;
+            indexConfig.regionSize = worldSize / float(indexConfig.regionsX);
+            PopulationIndex index(indexConfig);
+            for (size_t i = 0; i < animals.Size(); i++) {
+                index.OnSpawn(animals.species[i], animals.x[i], animals.z[i]);
+            }
+
+            EcosystemStepper::Options options;
+            options.worldMax[0] = worldSize;
+            options.worldMax[1] = worldSize;
+            JobSystem jobs(threads);
+            EcosystemStepper stepper(config, {grass, oak}, {deer, rabbit, wolf}, options, &jobs, &index);
+
+            for (int i = 0; i < 5; i++) {
+                stepper.Step(plants, animals, tickSeconds);  // Warm up caches and scratch buffers
+            }
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < bench.ticks; i++) {
+                stepper.Step(plants, animals, tickSeconds);
+            }
+            const auto end = std::chrono::steady_clock::now();
+            const double msPerTick =
+                std::chrono::duration<double, std::milli>(end - start).count() / bench.ticks;
+
+            size_t bytes = stepper.GetScratchBytes();
+            plants.ForEachColumn([&bytes](const auto& column) { bytes += ColumnBytes(column); });
+            animals.ForEachColumn([&bytes](const auto& column) { bytes += ColumnBytes(column); });
+            const double bytesPerEntity = double(bytes) / double(plantCount + animalCount);
+
+            if (threads == 1) {
+                singleThreadMs = msPerTick;
+            }
+            const double speedup = singleThreadMs / msPerTick;
+            const double efficiency = speedup / threads;
+
+            std::cout << plantCount << "," << animalCount << "," << threads << ","
+                      << msPerTick << "," << bytesPerEntity << "," << speedup << ","
+                      << efficiency << "," << (msPerTick <= 1000.0 * tickSeconds ? "yes" : "no")
+                      << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "BenchCommon.h"
+
+#include <core/JobSystem.h>
+#include <nature/OceanFFT.h>
+#include <nature/ShallowWaterSolver.h>
+#include <nature/WaterParticles.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace NRE;
+
+/**
+ * @brief FFT ocean benchmark
+ *
+ * Times OceanFFT::Update (spectrum evolution, four packed inverse 2D FFTs
+ * and map unpacking per cascade) at each resolution and thread count and
+ * prints one CSV row per run: milliseconds per frame for all cascades,
+ * per cascade, and parallel scaling. A second table times one
+ * ShallowWaterSolver step on a 512^2 lake with one disturbed spot and with
+ * every tile awake. A third table times WaterParticles: emitting a
+ * million rain droplets from every thread at once, and one Update() of
+ * the full pool.
+ *
+ * Usage: bench_ocean [--resolutions 256,512,1024] [--cascades N]
+ *                    [--frames N] [--threads 1,2,4]
+ */
+
+int main(int argc, char** argv) {
+    std::vector<unsigned> resolutions = {256, 512, 1024};
+    int cascades = 3;
+    int frames = 20;
+    std::vector<unsigned> threadCounts;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--resolutions")) resolutions = ParseList(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--cascades")) cascades = std::atoi(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--frames")) frames = std::atoi(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--threads")) threadCounts = ParseList(argv[i + 1]);
+    }
+    threadCounts = ThreadCounts(threadCounts, true);
+
+    const std::vector<float> allTiles = {500.0f, 85.0f, 15.0f, 4.0f};
+    std::cout << "resolution,cascades,threads,ms_per_frame,ms_per_cascade,speedup,efficiency" << std::endl;
+    for (unsigned resolution : resolutions) {
+        OceanFFT::Options options;
+        options.resolution = int(resolution);
+        options.tileSizes.assign(allTiles.begin(), allTiles.begin() + std::clamp(cascades, 1, int(allTiles.size())));
+        OceanFFT ocean(options);
+        double singleThreadMs = 0.0;
+        for (unsigned threads : threadCounts) {
+            JobSystem jobs(threads);
+            ocean.Update(0.0f, &jobs);  // Warm up scratch buffers
+            const auto start = std::chrono::steady_clock::now();
+            for (int f = 0; f < frames; ++f) {
+                ocean.Update(float(f) / 60.0f, &jobs);
+            }
+            const double ms =
+                1000.0 * std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / frames;
+            if (threads == 1) {
+                singleThreadMs = ms;
+            }
+            const double speedup = singleThreadMs / ms;
+            std::cout << resolution << "," << ocean.GetCascadeCount() << "," << threads << "," << ms << ","
+                      << ms / double(ocean.GetCascadeCount()) << "," << speedup << "," << speedup / threads
+                      << std::endl;
+        }
+    }
+
+    std::cout << "\ndomain,awake_tiles,simulated_tiles,threads,ms_per_step,pcg_iterations" << std::endl;
+    ShallowWaterSolver::Options waterOptions;
+    const std::vector<float> bed(size_t(waterOptions.width) * size_t(waterOptions.height), -3.0f);
+    for (int mode = 0; mode < 2; ++mode) {
+        for (unsigned threads : threadCounts) {
+            JobSystem jobs(threads);
+            ShallowWaterSolver water(waterOptions);
+            water.SetTerrain(bed.data());
+            water.Fill(0.0f);
+            if (mode == 0) {
+                water.AddDisturbance(100.0f, 100.0f, 8.0f, 0.5f);
+            } else {
+                for (float z = 8.0f; z < float(waterOptions.height); z += 32.0f) {
+                    for (float x = 8.0f; x < float(waterOptions.width); x += 32.0f) {
+                        water.AddDisturbance(x, z, 6.0f, 0.3f);  // Rain over the whole lake
+                    }
+                }
+            }
+            water.Step(1.0f / 60.0f, &jobs);
+            const auto start = std::chrono::steady_clock::now();
+            for (int f = 0; f < frames; ++f) {
+                water.Step(1.0f / 60.0f, &jobs);
+            }
+            const double ms =
+                1000.0 * std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / frames;
+            std::cout << waterOptions.width << "x" << waterOptions.height << "," << water.GetAwakeTileCount() << ","
+                      << water.GetSimulatedTileCount() << "," << threads << "," << ms << ","
+                      << water.GetLastIterations() << std::endl;
+        }
+    }
+
+    std::cout << "\nparticles,threads,ns_per_emit,ms_per_update" << std::endl;
+    const size_t particleCount = 1 << 20;
+    for (unsigned threads : threadCounts) {
+        JobSystem jobs(threads);
+        WaterParticles::Options particleOptions;
+        particleOptions.capacity = particleCount;
+        WaterParticles particles(particleOptions);
+        auto start = std::chrono::steady_clock::now();
+        jobs.ParallelFor(0, particleCount, 4096, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                WaterParticles::Droplet d;
+                d.x = float(i % 1024);
+                d.y = 1.0f;
+                d.z = float(i / 1024);
+                d.vy = 1.0f + float(i % 7);
+                particles.Emit(d);
+            }
+        });
+        const double emitNs =
+            1e9 * std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / particleCount;
+        start = std::chrono::steady_clock::now();
+        particles.Update(1.0f / 60.0f, nullptr, &jobs);
+        const double updateMs = 1000.0 * std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << particles.GetCount() << "," << threads << "," << emitNs << "," << updateMs << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include "BenchCommon.h"
+
+#include <nature/TreeMeshBuilder.h>
+#include <nature/TreeWindSway.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace NRE;
+
+/**
+ * @brief Forest generation benchmark
+ *
+ * Generates forests of unique seeds (L-system walk, skeleton, all mesh
+ * LODs) across thread counts and prints one CSV row per run: trees per
+ * second, triangles of the full-detail LOD, and parallel scaling. A second
+ * table times TreeWindSway for growing numbers of visible trees.
+ *
+ * Usage: bench_trees [--trees N] [--iterations N] [--species name]
+ *                    [--threads 1,2,4]
+ */
+
+int main(int argc, char** argv) {
+    int treeCount = 1000;
+    TreeRenderer::TreeConfig config;
+    std::vector<unsigned> threadCounts;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--trees")) treeCount = std::atoi(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--iterations")) config.iterations = std::atoi(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--species")) config.species = argv[i + 1];
+        else if (!std::strcmp(argv[i], "--threads")) threadCounts = ParseList(argv[i + 1]);
+    }
+    threadCounts = ThreadCounts(threadCounts, true);
+
+    std::vector<TreeRenderer::TreeConfig> forest(size_t(treeCount), config);
+    for (int i = 0; i < treeCount; ++i) {
+        forest[size_t(i)].seed = i;
+    }
+    TreeMeshBuilder builder(TreeMeshBuilder::Options{});
+
+    std::cout << "species,iterations,trees,threads,trees_per_second,lod0_triangles,speedup,efficiency" << std::endl;
+    double singleThreadSeconds = 0.0;
+    std::vector<TreeLODSet> out;
+    for (unsigned threads : threadCounts) {
+        JobSystem jobs(threads);
+        const auto start = std::chrono::steady_clock::now();
+        builder.GenerateForest(forest, out, &jobs);
+        const auto end = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(end - start).count();
+
+        size_t triangles = 0;
+        for (const auto& tree : out) {
+            triangles += size_t(tree.levels.front().triangleCount);
+        }
+        if (threads == 1) {
+            singleThreadSeconds = seconds;
+        }
+        const double speedup = singleThreadSeconds / seconds;
+        std::cout << config.species << "," << config.iterations << "," << treeCount << "," << threads << ","
+                  << double(treeCount) / seconds << "," << triangles / out.size() << "," << speedup << ","
+                  << speedup / threads << std::endl;
+    }
+
+    const int frames = 100;
+    const float wind[2] = {1.0f, 0.3f};
+    TreeWindSway sway(TreeWindSway::Options{});
+    sway.SetWind(wind, 8.0f);
+    // Second table: full rigs everywhere, then only the nearest quarter fully
+    // animated and the rest trunk-only
+    std::cout << "\nvisible_trees,bones,ms_per_frame_full,ms_per_frame_distance_lod" << std::endl;
+    for (int visible = 1000; visible <= 16000; visible *= 2) {
+        double ms[2] = {0.0, 0.0};
+        for (int mode = 0; mode < 2; ++mode) {
+            double seconds = 0.0;
+            for (int f = 0; f < frames; ++f) {
+                const auto start = std::chrono::steady_clock::now();
+                sway.BeginFrame();
+                for (int i = 0; i < visible; ++i) {
+                    const float position[3] = {float(i % 128) * 8.0f, 0.0f, float(i / 128) * 8.0f};
+                    const uint32_t levels = (mode == 1 && i >= visible / 4) ? 1u : 8u;
+                    sway.AddTree(out[size_t(i) % out.size()].rig, position, float(i) * 0.37f, 1.0f, levels);
+                }
+                sway.Evaluate(float(f) / 60.0f);
+                seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+            ms[mode] = 1000.0 * seconds / frames;
+        }
+        std::cout << visible << "," << sway.GetBoneCount() << "," << ms[0] << "," << ms[1] << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Fast LZ77 byte compression (LZ4-style block format, no dependencies)
+ *
+ * Each sequence is a token byte (literal length << 4 | match length - 4),
+ * optional length extension bytes, the literals, then a 16-bit match offset.
+ * The final sequence has literals only. Tuned for speed over ratio; it
+ * shines on delta-encoded or zero-heavy data.
+ */
+class Compression {
+public:
+    /**
+     * @brief Worst-case compressed size for an input size
+     */
+    static size_t CompressBound(size_t size) { return size + size / 255 + 16; }
+
+    /**
+     * @brief Largest output a compressed buffer of this size can decode to
+     *
+     * Every compressed byte expands to at most 255 output bytes (one
+     * extended length byte), so this rejects absurd sizes from corrupt headers.
+     */
+    static size_t DecompressBound(size_t size) { return size * 255 + 32; }
+
+    /**
+     * @brief Compress a buffer
+     * @param src Input bytes
+     * @param size Input size
+     * @param dst Output buffer of at least CompressBound(size) bytes
+     * @return Compressed size
+     */
+    static size_t Compress(const uint8_t* src, size_t size, uint8_t* dst) {
+        constexpr int kHashBits = 14;
+        uint32_t table[1u << kHashBits];
+        std::memset(table, 0, sizeof(table));
+
+        uint8_t* out = dst;
+        size_t anchor = 0;
+        size_t pos = 0;
+        const size_t matchLimit = size > kTail ? size - kTail : 0;
+
+        while (pos < matchLimit) {
+            const uint32_t seq = Read32(src + pos);
+            const uint32_t h = (seq * 2654435761u) >> (32 - kHashBits);
+            const size_t candidate = table[h];
+            table[h] = uint32_t(pos);
+
+            if (candidate >= pos || pos - candidate > 0xFFFF || Read32(src + candidate) != seq) {
+                ++pos;
+                continue;
+            }
+
+            size_t matchLen = 4;
+            while (pos + matchLen < matchLimit && src[candidate + matchLen] == src[pos + matchLen]) {
+                ++matchLen;
+            }
+
+            out = WriteSequence(out, src + anchor, pos - anchor, matchLen);
+            const uint16_t offset = uint16_t(pos - candidate);
+            *out++ = uint8_t(offset & 0xFF);
+            *out++ = uint8_t(offset >> 8);
+            out = WriteLength(out, matchLen - 4);
+
+            pos += matchLen;
+            anchor = pos;
+        }
+
+        out = WriteSequence(out, src + anchor, size - anchor, 0);
+        return size_t(out - dst);
+    }
+
+    /**
+     * @brief Decompress a buffer
+     * @param src Compressed bytes
+     * @param size Compressed size
+     * @param dst Output buffer
+     * @param capacity Output buffer size
+     * @return Decompressed size, or 0 if the input is malformed
+     */
+    static size_t Decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity) {
+        const uint8_t* in = src;
+        const uint8_t* end = src + size;
+        uint8_t* out = dst;
+        uint8_t* outEnd = dst + capacity;
+
+        while (in < end) {
+            const uint8_t token = *in++;
+            size_t literals = token >> 4;
+            if (literals == 15 && !ReadLength(in, end, literals)) {
+                return 0;
+            }
+            if (size_t(end - in) < literals || size_t(outEnd - out) < literals) {
+                return 0;
+            }
+            std::memcpy(out, in, literals);
+            in += literals;
+            out += literals;
+            if (in == end) {
+                break;  // Last sequence carries literals only
+            }
+
+            if (end - in < 2) {
+                return 0;
+            }
+            const size_t offset = size_t(in[0]) | (size_t(in[1]) << 8);
+            in += 2;
+            size_t matchLen = token & 0x0F;
+            if (matchLen == 15 && !ReadLength(in, end, matchLen)) {
+                return 0;
+            }
+            matchLen += 4;
+            if (offset == 0 || offset > size_t(out - dst) || size_t(outEnd - out) < matchLen) {
+                return 0;
+            }
+            const uint8_t* match = out - offset;
+            for (size_t i = 0; i < matchLen; ++i) {
+                out[i] = match[i];  // Byte copy: matches may overlap the output
+            }
+            out += matchLen;
+        }
+        return size_t(out - dst);
+    }
+
+    /**
+     * @brief Compress into a vector (resized to the compressed size)
+     */
+    static void Compress(const uint8_t* src, size_t size, std::vector<uint8_t>& out) {
+        out.resize(CompressBound(size));
+        out.resize(Compress(src, size, out.data()));
+    }
+
+private:
+    static constexpr size_t kTail = 12;  // Trailing bytes always emitted as literals
+
+    static uint32_t Read32(const uint8_t* p) {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static uint8_t* WriteLength(uint8_t* out, size_t length) {
+        if (length < 15) {
+            return out;
+        }
+        length -= 15;
+        while (length >= 255) {
+            *out++ = 255;
+            length -= 255;
+        }
+        *out++ = uint8_t(length);
+        return out;
+    }
+
+    static uint8_t* WriteSequence(uint8_t* out, const uint8_t* literals, size_t count, size_t matchLen) {
+        const size_t litNibble = count < 15 ? count : 15;
+        const size_t matchNibble = matchLen == 0 ? 0 : (matchLen - 4 < 15 ? matchLen - 4 : 15);
+        *out++ = uint8_t((litNibble << 4) | matchNibble);
+        out = WriteLength(out, count);
+        std::memcpy(out, literals, count);
+        return out + count;
+    }
+
+    static bool ReadLength(const uint8_t*& in, const uint8_t* end, size_t& length) {
+        uint8_t byte;
+        do {
+            if (in >= end) {
+                return false;
+            }
+            byte = *in++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+};
+
+} // namespace NRE
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <core/JobSystem.h>
+#include <core/Simd.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Power-of-two complex FFT, four transforms at a time
+ *
+ * Stockham autosort radix-4 passes (one radix-2 pass when log2(n) is odd),
+ * so no bit-reversal permutation is needed. Every Float4 lane carries an
+ * independent sequence: 2D transforms run four columns (or four rows,
+ * transposed in registers) per call, and the JobSystem splits the groups.
+ * Transforms are unnormalized; the inverse is the conjugate transform.
+ */
+class FFT {
+public:
+    /**
+     * @brief Prepare twiddles for size n (power of two, at least 4)
+     */
+    explicit FFT(size_t n) : n_(n), cos_(n), sin_(n) {
+        for (size_t k = 0; k < n; ++k) {
+            const double angle = -6.283185307179586 * double(k) / double(n);
+            cos_[k] = float(std::cos(angle));
+            sin_[k] = float(std::sin(angle));
+        }
+    }
+
+    size_t GetSize() const { return n_; }
+
+    /**
+     * @brief Transform four sequences in place
+     * @param re Real parts, n elements (lane = sequence)
+     * @param im Imaginary parts
+     * @param workRe Scratch, n elements
+     * @param workIm Scratch, n elements
+     * @param inverse Conjugate transform (exp(+i...))
+     */
+    void Transform4(Float4* re, Float4* im, Float4* workRe, Float4* workIm, bool inverse) const {
+        const float sign = inverse ? -1.0f : 1.0f;  // Applied to sines and to j
+        Float4 *xr = re, *xi = im, *yr = workRe, *yi = workIm;
+        size_t n = n_;
+        size_t s = 1;
+        while (n >= 4) {
+            const size_t m = n / 4;
+            for (size_t p = 0; p < m; ++p) {
+                const Float4 w1r(cos_[p * s]), w1i(sign * sin_[p * s]);
+                const Float4 w2r(cos_[2 * p * s]), w2i(sign * sin_[2 * p * s]);
+                const Float4 w3r(cos_[3 * p * s]), w3i(sign * sin_[3 * p * s]);
+                const Float4 js(sign);
+                for (size_t q = 0; q < s; ++q) {
+                    const size_t a = q + s * p;
+                    const size_t b = a + s * m;
+                    const size_t c = b + s * m;
+                    const size_t d = c + s * m;
+                    const Float4 apcR = xr[a] + xr[c], apcI = xi[a] + xi[c];
+                    const Float4 amcR = xr[a] - xr[c], amcI = xi[a] - xi[c];
+                    const Float4 bpdR = xr[b] + xr[d], bpdI = xi[b] + xi[d];
+                    // j * (b - d), with j conjugated for the inverse
+                    const Float4 jR = js * (xi[d] - xi[b]), jI = js * (xr[b] - xr[d]);
+                    const size_t o = q + s * 4 * p;
+                    yr[o] = apcR + bpdR;
+                    yi[o] = apcI + bpdI;
+                    Float4 tr = amcR - jR, ti = amcI - jI;
+                    yr[o + s] = w1r * tr - w1i * ti;
+                    yi[o + s] = w1r * ti + w1i * tr;
+                    tr = apcR - bpdR;
+                    ti = apcI - bpdI;
+                    yr[o + 2 * s] = w2r * tr - w2i * ti;
+                    yi[o + 2 * s] = w2r * ti + w2i * tr;
+                    tr = amcR + jR;
+                    ti = amcI + jI;
+                    yr[o + 3 * s] = w3r * tr - w3i * ti;
+                    yi[o + 3 * s] = w3r * ti + w3i * tr;
+                }
+            }
+            std::swap(xr, yr);
+            std::swap(xi, yi);
+            n = m;
+            s *= 4;
+        }
+        if (n == 2) {
+            for (size_t q = 0; q < s; ++q) {
+                const Float4 ar = xr[q], ai = xi[q];
+                const Float4 br = xr[q + s], bi = xi[q + s];
+                yr[q] = ar + br;
+                yi[q] = ai + bi;
+                yr[q + s] = ar - br;
+                yi[q + s] = ai - bi;
+            }
+            std::swap(xr, yr);
+            std::swap(xi, yi);
+        }
+        if (xr != re) {
+            std::copy(xr, xr + n_, re);
+            std::copy(xi, xi + n_, im);
+        }
+    }
+
+    /**
+     * @brief 2D transform of an n x n row-major grid in place
+     * @param re Real parts
+     * @param im Imaginary parts
+     * @param inverse Conjugate transform
+     * @param jobs Optional job system (columns and rows split in groups of four)
+     */
+    void Transform2D(float* re, float* im, bool inverse, JobSystem* jobs = nullptr) const {
+        const size_t n = n_;
+        auto columns = [&](size_t begin, size_t end) {
+            Float4* strip = Scratch();
+            for (size_t g = begin; g < end; ++g) {
+                const size_t c = g * 4;
+                for (size_t i = 0; i < n; ++i) {
+                    strip[i] = Float4::Load(re + i * n + c);
+                    strip[n + i] = Float4::Load(im + i * n + c);
+                }
+                Transform4(strip, strip + n, strip + 2 * n, strip + 3 * n, inverse);
+                for (size_t i = 0; i < n; ++i) {
+                    strip[i].Store(re + i * n + c);
+                    strip[n + i].Store(im + i * n + c);
+                }
+            }
+        };
+        auto rows = [&](size_t begin, size_t end) {
+            Float4* strip = Scratch();
+            for (size_t g = begin; g < end; ++g) {
+                for (int part = 0; part < 2; ++part) {
+                    float* base = (part == 0 ? re : im) + g * 4 * n;
+                    Float4* dst = strip + size_t(part) * n;
+                    for (size_t j = 0; j < n; j += 4) {
+                        Float4 r0 = Float4::Load(base + j), r1 = Float4::Load(base + n + j);
+                        Float4 r2 = Float4::Load(base + 2 * n + j), r3 = Float4::Load(base + 3 * n + j);
+                        Transpose(r0, r1, r2, r3);
+                        dst[j] = r0;
+                        dst[j + 1] = r1;
+                        dst[j + 2] = r2;
+                        dst[j + 3] = r3;
+                    }
+                }
+                Transform4(strip, strip + n, strip + 2 * n, strip + 3 * n, inverse);
+                for (int part = 0; part < 2; ++part) {
+                    float* base = (part == 0 ? re : im) + g * 4 * n;
+                    const Float4* src = strip + size_t(part) * n;
+                    for (size_t j = 0; j < n; j += 4) {
+                        Float4 r0 = src[j], r1 = src[j + 1], r2 = src[j + 2], r3 = src[j + 3];
+                        Transpose(r0, r1, r2, r3);
+                        r0.Store(base + j);
+                        r1.Store(base + n + j);
+                        r2.Store(base + 2 * n + j);
+                        r3.Store(base + 3 * n + j);
+                    }
+                }
+            }
+        };
+        const size_t groups = n / 4;
+        if (jobs) {
+            jobs->ParallelFor(0, groups, 4, columns);
+            jobs->ParallelFor(0, groups, 4, rows);
+        } else {
+            columns(0, groups);
+            rows(0, groups);
+        }
+    }
+
+private:
+    // Per-thread strip: data and Stockham work buffers, real and imaginary
+    Float4* Scratch() const {
+        thread_local std::vector<Float4> scratch;
+        if (scratch.size() < 4 * n_) {
+            scratch.resize(4 * n_);
+        }
+        return scratch.data();
+    }
+
+    size_t n_;
+    std::vector<float> cos_;
+    std::vector<float> sin_;
+};
+
+} // namespace NRE
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Minimal worker pool for data-parallel engine systems
+ *
+ * The calling thread always participates in ParallelFor, so a pool created
+ * with a thread count of 1 runs everything inline with no workers.
+ */
+class JobSystem {
+public:
+    /**
+     * @brief Create job system
+     * @param threadCount Total threads including the caller (0 = hardware concurrency)
+     */
+    explicit JobSystem(unsigned threadCount = 0) {
+        if (threadCount == 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threadCount_ = threadCount;
+        for (unsigned i = 1; i < threadCount; ++i) {
+            workers_.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    ~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * @brief Get number of threads that execute jobs (including the caller)
+     * @return Thread count
+     */
+    unsigned GetThreadCount() const { return threadCount_; }
+
+    /**
+     * @brief Queue a fire-and-forget job (runs inline when there are no workers)
+     * @param job Job to execute
+     */
+    void Submit(std::function<void()> job) {
+        if (workers_.empty()) {
+            job();
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(job));
+            ++pending_;
+        }
+        wake_.notify_one();
+    }
+
+    /**
+     * @brief Block until every submitted job has finished
+     */
+    void WaitIdle() {
+        while (RunOne()) {}
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return pending_ == 0; });
+    }
+
+    /**
+     * @brief Split [begin, end) into ranges and run them on all threads
+     * @param begin First index
+     * @param end One past the last index
+     * @param grain Minimum range size per job
+     * @param fn Callable invoked as fn(rangeBegin, rangeEnd)
+     */
+    template <typename Fn>
+    void ParallelFor(size_t begin, size_t end, size_t grain, Fn&& fn) {
+        if (end <= begin) {
+            return;
+        }
+        const size_t count = end - begin;
+        grain = std::max<size_t>(1, grain);
+        size_t jobs = std::min<size_t>((count + grain - 1) / grain, size_t(threadCount_) * 4);
+        if (jobs <= 1 || workers_.empty()) {
+            fn(begin, end);
+            return;
+        }
+
+        const size_t step = (count + jobs - 1) / jobs;
+        jobs = (count + step - 1) / step;
+        std::atomic<size_t> remaining{jobs - 1};
+        for (size_t j = 1; j < jobs; ++j) {
+            const size_t b = begin + j * step;
+            const size_t e = std::min(end, b + step);
+            Submit([&fn, &remaining, b, e] {
+                fn(b, e);
+                remaining.fetch_sub(1, std::memory_order_release);
+            });
+        }
+        fn(begin, std::min(end, begin + step));
+
+        // Help drain the queue instead of sleeping while our ranges run
+        while (remaining.load(std::memory_order_acquire) != 0) {
+            if (!RunOne()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    bool RunOne() {
+        std::function<void()> job;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queue_.empty()) {
+                return false;
+            }
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        job();
+        Finish();
+        return true;
+    }
+
+    void Finish() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0) {
+            idle_.notify_all();
+        }
+    }
+
+    void WorkerLoop() {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    return;
+                }
+                job = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            job();
+            Finish();
+        }
+    }
+
+    unsigned threadCount_ = 1;
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> queue_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    size_t pending_ = 0;
+    bool stopping_ = false;
+};
+
+} // namespace NRE
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace NRE {
+
+/**
+ * @brief Stateless integer hashing for reproducible procedural generation
+ */
+inline uint32_t Hash32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+/**
+ * @brief Combine a hash with another value (order dependent)
+ */
+inline uint32_t HashCombine(uint32_t seed, uint32_t value) {
+    return Hash32(seed ^ (value + 0x9e3779b9U + (seed << 6) + (seed >> 2)));
+}
+
+/**
+ * @brief Map a hash to a float in [0, 1)
+ */
+inline float HashToUnitFloat(uint32_t h) {
+    return float(h >> 8) * (1.0f / 16777216.0f);
+}
+
+/**
+ * @brief Small, fast, seedable PRNG (SplitMix64)
+ *
+ * Used where std::mt19937 would be too heavy to construct per job.
+ */
+class Random {
+public:
+    explicit Random(uint64_t seed = 0) : state_(seed) {}
+
+    uint64_t NextU64() {
+        uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    uint32_t NextU32() { return uint32_t(NextU64() >> 32); }
+
+    /**
+     * @brief Uniform float in [0, 1)
+     */
+    float NextFloat() { return float(NextU64() >> 40) * (1.0f / 16777216.0f); }
+
+    /**
+     * @brief Uniform float in [lo, hi)
+     */
+    float Range(float lo, float hi) { return lo + (hi - lo) * NextFloat(); }
+
+    /**
+     * @brief Uniform integer in [0, n)
+     */
+    uint32_t Below(uint32_t n) { return uint32_t((uint64_t(NextU32()) * n) >> 32); }
+
+    /**
+     * @brief Standard normal sample (Box-Muller)
+     */
+    float Gaussian() {
+        float u1 = NextFloat();
+        float u2 = NextFloat();
+        if (u1 < 1e-7f) {
+            u1 = 1e-7f;
+        }
+        return std::sqrt(-2.0f * std::log(u1)) * std::cos(6.28318530718f * u2);
+    }
+
+    /**
+     * @brief Poisson sample (normal approximation above lambda = 30)
+     */
+    uint32_t Poisson(float lambda) {
+        if (lambda <= 0.0f) {
+            return 0;
+        }
+        if (lambda > 30.0f) {
+            float v = lambda + std::sqrt(lambda) * Gaussian() + 0.5f;
+            return v > 0.0f ? uint32_t(v) : 0;
+        }
+        const float limit = std::exp(-lambda);
+        float p = NextFloat();
+        uint32_t k = 0;
+        while (p > limit) {
+            p *= NextFloat();
+            ++k;
+        }
+        return k;
+    }
+
+private:
+    uint64_t state_;
+};
+
+} // namespace NRE
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NRE_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define NRE_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace NRE {
+
+/**
+ * @brief Four-wide float vector (SSE2, NEON, or scalar fallback)
+ *
+ * Only the operations the engine's bulk kernels need. Comparisons return
+ * lane masks (all bits set or clear) usable with Select() and MoveMask().
+ */
+struct Float4 {
+#if defined(NRE_SIMD_SSE2)
+    __m128 v;
+    Float4() = default;
+    Float4(__m128 x) : v(x) {}
+    explicit Float4(float s) : v(_mm_set1_ps(s)) {}
+    Float4(float a, float b, float c, float d) : v(_mm_setr_ps(a, b, c, d)) {}
+    static Float4 Load(const float* p) { return _mm_loadu_ps(p); }
+    void Store(float* p) const { _mm_storeu_ps(p, v); }
+#elif defined(NRE_SIMD_NEON)
+    float32x4_t v;
+    Float4() = default;
+    Float4(float32x4_t x) : v(x) {}
+    explicit Float4(float s) : v(vdupq_n_f32(s)) {}
+    Float4(float a, float b, float c, float d) {
+        const float t[4] = {a, b, c, d};
+        v = vld1q_f32(t);
+    }
+    static Float4 Load(const float* p) { return vld1q_f32(p); }
+    void Store(float* p) const { vst1q_f32(p, v); }
+#else
+    float v[4];
+    Float4() = default;
+    explicit Float4(float s) : v{s, s, s, s} {}
+    Float4(float a, float b, float c, float d) : v{a, b, c, d} {}
+    static Float4 Load(const float* p) { return Float4(p[0], p[1], p[2], p[3]); }
+    void Store(float* p) const {
+        for (int i = 0; i < 4; ++i) p[i] = v[i];
+    }
+#endif
+};
+
+#if defined(NRE_SIMD_SSE2)
+
+inline Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a.v, b.v); }
+inline Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a.v, b.v); }
+inline Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a.v, b.v); }
+inline Float4 operator/(Float4 a, Float4 b) { return _mm_div_ps(a.v, b.v); }
+inline Float4 Min(Float4 a, Float4 b) { return _mm_min_ps(a.v, b.v); }
+inline Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a.v, b.v); }
+inline Float4 Sqrt(Float4 a) { return _mm_sqrt_ps(a.v); }
+inline Float4 operator<(Float4 a, Float4 b) { return _mm_cmplt_ps(a.v, b.v); }
+inline Float4 operator<=(Float4 a, Float4 b) { return _mm_cmple_ps(a.v, b.v); }
+inline Float4 operator>(Float4 a, Float4 b) { return _mm_cmpgt_ps(a.v, b.v); }
+inline Float4 operator>=(Float4 a, Float4 b) { return _mm_cmpge_ps(a.v, b.v); }
+inline Float4 operator&(Float4 a, Float4 b) { return _mm_and_ps(a.v, b.v); }
+inline Float4 operator|(Float4 a, Float4 b) { return _mm_or_ps(a.v, b.v); }
+inline Float4 Select(Float4 mask, Float4 a, Float4 b) {
+    return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+}
+inline int MoveMask(Float4 mask) { return _mm_movemask_ps(mask.v); }
+inline Float4 Floor(Float4 a) {
+    const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a.v), _mm_set1_ps(1.0f)));
+}
+/** @brief Truncate to int32 lanes and store */
+inline void StoreInt(Float4 a, int32_t* out) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_cvttps_epi32(a.v));
+}
+/** @brief Load four int32 values and convert to float */
+inline Float4 LoadInt(const int32_t* p) {
+    return _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+#elif defined(NRE_SIMD_NEON)
+
+inline Float4 operator+(Float4 a, Float4 b) { return vaddq_f32(a.v, b.v); }
+inline Float4 operator-(Float4 a, Float4 b) { return vsubq_f32(a.v, b.v); }
+inline Float4 operator*(Float4 a, Float4 b) { return vmulq_f32(a.v, b.v); }
+inline Float4 operator/(Float4 a, Float4 b) {
+    float x[4], y[4];
+    a.Store(x);
+    b.Store(y);
+    return Float4(x[0] / y[0], x[1] / y[1], x[2] / y[2], x[3] / y[3]);
+}
+inline Float4 Min(Float4 a, Float4 b) { return vminq_f32(a.v, b.v); }
+inline Float4 Max(Float4 a, Float4 b) { return vmaxq_f32(a.v, b.v); }
+inline Float4 Sqrt(Float4 a) {
+    float x[4];
+    a.Store(x);
+    return Float4(std::sqrt(x[0]), std::sqrt(x[1]), std::sqrt(x[2]), std::sqrt(x[3]));
+}
+inline Float4 operator<(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a.v, b.v)); }
+inline Float4 operator<=(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcleq_f32(a.v, b.v)); }
+inline Float4 operator>(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcgtq_f32(a.v, b.v)); }
+inline Float4 operator>=(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcgeq_f32(a.v, b.v)); }
+inline Float4 operator&(Float4 a, Float4 b) {
+    return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(b.v)));
+}
+inline Float4 operator|(Float4 a, Float4 b) {
+    return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(b.v)));
+}
+inline Float4 Select(Float4 mask, Float4 a, Float4 b) {
+    return vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v);
+}
+inline int MoveMask(Float4 mask) {
+    uint32_t m[4];
+    vst1q_u32(m, vreinterpretq_u32_f32(mask.v));
+    return int((m[0] >> 31) | ((m[1] >> 31) << 1) | ((m[2] >> 31) << 2) | ((m[3] >> 31) << 3));
+}
+inline Float4 Floor(Float4 a) {
+    const float32x4_t t = vcvtq_f32_s32(vcvtq_s32_f32(a.v));
+    const uint32x4_t gt = vcgtq_f32(t, a.v);
+    return vsubq_f32(t, vreinterpretq_f32_u32(vandq_u32(gt, vreinterpretq_u32_f32(vdupq_n_f32(1.0f)))));
+}
+inline void StoreInt(Float4 a, int32_t* out) { vst1q_s32(out, vcvtq_s32_f32(a.v)); }
+inline Float4 LoadInt(const int32_t* p) { return vcvtq_f32_s32(vld1q_s32(p)); }
+
+#else
+
+namespace SimdDetail {
+template <typename Fn>
+inline Float4 Map(Float4 a, Float4 b, Fn fn) {
+    return Float4(fn(a.v[0], b.v[0]), fn(a.v[1], b.v[1]), fn(a.v[2], b.v[2]), fn(a.v[3], b.v[3]));
+}
+inline float MaskOf(bool b) {
+    const uint32_t bits = b ? 0xFFFFFFFFu : 0u;
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+inline uint32_t Bits(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u;
+}
+inline float FromBits(uint32_t u) {
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+} // namespace SimdDetail
+
+inline Float4 operator+(Float4 a, Float4 b) { return SimdDetail::Map(a, b, [](float x, float y) { return x + y; }); }
+inline Float4 operator-(Float4 a, Float4 b) { return SimdDetail::Map(a, b, [](float x, float y) { return x - y; }); }
+inline Float4 operator*(Float4 a, Float4 b) { return SimdDetail::Map(a, b, [](float x, float y) { return x * y; }); }
+inline Float4 operator/(Float4 a, Float4 b) { return SimdDetail::Map(a, b, [](float x, float y) { return x / y; }); }
+inline Float4 Min(Float4 a, Float4 b) { return SimdDetail::Map(a, b, [](float x, float y) { return x < y ? x : y; }); }
+inline Float4 Max(Float4 a, Float4 b) { return SimdDetail::Map(a, b, [](float x, float y) { return x > y ? x : y; }); }
+inline Float4 Sqrt(Float4 a) { return SimdDetail::Map(a, a, [](float x, float) { return std::sqrt(x); }); }
+inline Float4 operator<(Float4 a, Float4 b) { return SimdDetail::Map(a, b, [](float x, float y) { return SimdDetail::MaskOf(x < y); }); }
+inline Float4 operator<=(Float4 a, Float4 b) { return SimdDetail::Map(a, b, [](float x, float y) { return SimdDetail::MaskOf(x <= y); }); }
+inline Float4 operator>(Float4 a, Float4 b) { return SimdDetail::Map(a, b, [](float x, float y) { return SimdDetail::MaskOf(x > y); }); }
+inline Float4 operator>=(Float4 a, Float4 b) { return SimdDetail::Map(a, b, [](float x, float y) { return SimdDetail::MaskOf(x >= y); }); }
+inline Float4 operator&(Float4 a, Float4 b) {
+    return SimdDetail::Map(a, b, [](float x, float y) { return SimdDetail::FromBits(SimdDetail::Bits(x) & SimdDetail::Bits(y)); });
+}
+inline Float4 operator|(Float4 a, Float4 b) {
+    return SimdDetail::Map(a, b, [](float x, float y) { return SimdDetail::FromBits(SimdDetail::Bits(x) | SimdDetail::Bits(y)); });
+}
+inline Float4 Select(Float4 mask, Float4 a, Float4 b) {
+    Float4 r;
+    for (int i = 0; i < 4; ++i) r.v[i] = SimdDetail::Bits(mask.v[i]) ? a.v[i] : b.v[i];
+    return r;
+}
+inline int MoveMask(Float4 mask) {
+    int m = 0;
+    for (int i = 0; i < 4; ++i) m |= int(SimdDetail::Bits(mask.v[i]) >> 31) << i;
+    return m;
+}
+inline Float4 Floor(Float4 a) { return SimdDetail::Map(a, a, [](float x, float) { return std::floor(x); }); }
+inline void StoreInt(Float4 a, int32_t* out) {
+    for (int i = 0; i < 4; ++i) out[i] = int32_t(a.v[i]);
+}
+inline Float4 LoadInt(const int32_t* p) { return Float4(float(p[0]), float(p[1]), float(p[2]), float(p[3])); }
+
+#endif
+
+/**
+ * @brief Fast sine for animation (any input range, absolute error < 2e-3)
+ */
+inline Float4 Sin(Float4 x) {
+    const Float4 twoPi(6.28318530718f);
+    x = x - twoPi * Floor(x * Float4(0.159154943f) + Float4(0.5f));  // [-pi, pi)
+    const Float4 ax = Max(x, Float4(0.0f) - x);
+    Float4 y = Float4(1.27323954f) * x - Float4(0.405284735f) * x * ax;
+    const Float4 ay = Max(y, Float4(0.0f) - y);
+    return y + Float4(0.225f) * (y * ay - y);
+}
+
+/**
+ * @brief Sine and cosine (any input range, absolute error < 1e-6)
+ */
+inline void SinCos(Float4 x, Float4& sinOut, Float4& cosOut) {
+    const Float4 pi(3.14159265359f);
+    const Float4 halfPi(1.57079632679f);
+    const Float4 zero(0.0f);
+    auto sinHalf = [](Float4 v) {  // Odd Taylor series to v^11 on [-pi/2, pi/2]
+        const Float4 v2 = v * v;
+        Float4 p = Float4(-2.50521084e-8f);
+        p = p * v2 + Float4(2.75573192e-6f);
+        p = p * v2 + Float4(-1.98412698e-4f);
+        p = p * v2 + Float4(8.33333333e-3f);
+        p = p * v2 + Float4(-1.66666667e-1f);
+        return v + v * v2 * p;
+    };
+    // Fold an angle in [-pi, pi) onto [-pi/2, pi/2] with the same sine
+    auto fold = [&](Float4 v) {
+        v = Select(v > halfPi, pi - v, v);
+        return Select(v < zero - halfPi, zero - pi - v, v);
+    };
+    const Float4 twoPi(6.28318530718f);
+    const Float4 inv(0.159154943f);
+    const Float4 s = x - twoPi * Floor(x * inv + Float4(0.5f));
+    Float4 c = s + halfPi;
+    c = Select(c >= pi, c - twoPi, c);
+    sinOut = sinHalf(fold(s));
+    cosOut = sinHalf(fold(c));
+}
+
+/**
+ * @brief Transpose four vectors as the rows of a 4x4 matrix
+ */
+inline void Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3) {
+#if defined(NRE_SIMD_SSE2)
+    _MM_TRANSPOSE4_PS(r0.v, r1.v, r2.v, r3.v);
+#else
+    float m[16];
+    r0.Store(m);
+    r1.Store(m + 4);
+    r2.Store(m + 8);
+    r3.Store(m + 12);
+    r0 = Float4(m[0], m[4], m[8], m[12]);
+    r1 = Float4(m[1], m[5], m[9], m[13]);
+    r2 = Float4(m[2], m[6], m[10], m[14]);
+    r3 = Float4(m[3], m[7], m[11], m[15]);
+#endif
+}
+
+} // namespace NRE
@@ -0,0 +1,606 @@
+#pragma once
+
+#include <core/JobSystem.h>
+#include <core/Random.h>
+#include <nature/WeatherSystem.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Coarse 3D atmosphere behind WeatherSystem
+ *
+ * A periodic grid of columns (kilometers wide) and layers holds
+ * temperature, water vapor and cloud water. Every simulation step
+ * advects the fields with the layer wind, relaxes them toward a forcing
+ * target, condenses vapor above saturation into cloud (releasing latent
+ * heat), evaporates cloud below it, and rains out cloud water above a
+ * threshold into a surface precipitation rate. SetWeather() only changes
+ * the forcing target; GetWeather() classifies the local column state, so
+ * fronts drift in with the wind instead of switching everywhere at once.
+ *
+ * A step is split into column chunks that read the last completed state
+ * and write the next one. Update() runs chunks on the job system until
+ * its microsecond budget would be exceeded and resumes next frame, so a
+ * step is spread over as many frames as the budget requires. At least one
+ * chunk runs per Update(), which bounds the overshoot to one chunk.
+ * A finished step is only published at the next step boundary, and
+ * readers blend the two published states by the time since that boundary,
+ * so what they see lags one step and does not depend on the budget or
+ * thread count as long as each step finishes within one step interval
+ * (otherwise readers hold the newest published state until it catches up).
+ */
+class AtmosphereGrid {
+public:
+    using WeatherType = WeatherSystem::WeatherType;
+
+    struct Options {
+        int width = 48;                 // Columns along X (at least 1)
+        int depth = 48;                 // Columns along Z (at least 1)
+        int layers = 10;                // At least 1
+        float cellSize = 2000.0f;       // Meters per column
+        float layerHeight = 1000.0f;    // Meters per layer
+        int chunkSize = 8;              // Columns per chunk side (at least 1)
+        float stepSeconds = 60.0f;      // Simulated seconds per step
+        float timeScale = 1.0f;         // Simulated seconds per real second
+        float budgetMicroseconds = 300.0f;  // Per Update()
+
+        // Initial forcing (until SetWeather)
+        float temperature = 20.0f;      // Celsius at the surface
+        float humidity = 0.5f;          // Relative, 0-1
+        float lapseRate = 6.5f;         // Kelvin per km
+        float pressure = 1013.25f;      // Millibars at the surface
+        float windSpeed = 5.0f;         // m/s at the surface
+        float windDirection[2] = {1.0f, 0.0f};
+        float windShear = 0.15f;        // Fractional wind increase per layer
+
+        // Physics
+        float forcingTime = 1800.0f;    // Seconds to relax toward the target
+        float condensationTime = 60.0f; // Seconds to reach saturation
+        float cloudThreshold = 0.5f;    // Cloud water (g/kg) above which it rains out
+        float precipitationTime = 300.0f;
+        bool precipitation = true;
+        float variability = 0.1f;       // Humidity target variation between regions
+        float patternSize = 8.0f;       // Columns per variation feature
+        uint32_t seed = 1;
+    };
+
+    /**
+     * @brief Atmosphere options from the weather config
+     */
+    static Options FromConfig(const WeatherSystem::Config& config) {
+        Options o;
+        o.temperature = config.temperature;
+        o.humidity = config.humidity;
+        o.pressure = config.pressure;
+        o.windSpeed = config.windSpeed;
+        o.windDirection[0] = config.windDirection[0];
+        o.windDirection[1] = config.windDirection[1];
+        o.precipitation = config.enablePrecipitation;
+        return o;
+    }
+
+    /**
+     * @brief Local state at a point
+     */
+    struct Conditions {
+        float temperature = 0.0f;       // Celsius
+        float relativeHumidity = 0.0f;  // Vapor over saturation
+        float cloudWater = 0.0f;        // g/kg
+        float precipitation = 0.0f;     // Surface rate below this point (mm/h)
+        float pressure = 0.0f;          // Millibars
+        float windX = 0.0f;             // m/s
+        float windZ = 0.0f;
+    };
+
+    explicit AtmosphereGrid(const Options& options) : options_(Normalized(options)) {
+        columns_ = size_t(options_.width) * size_t(options_.depth);
+        cells_ = columns_ * size_t(options_.layers);
+        chunksX_ = (options_.width + options_.chunkSize - 1) / options_.chunkSize;
+        chunksZ_ = (options_.depth + options_.chunkSize - 1) / options_.chunkSize;
+        from_ = to_ = Forcing{options_.temperature, options_.humidity, options_.lapseRate, 1.0f, 0.0f};
+        SetWind(options_.windSpeed, options_.windDirection);
+        for (State& state : states_) {
+            state.temperature.assign(cells_, 0.0f);
+            state.vapor.assign(cells_, 0.0f);
+            state.cloud.assign(cells_, 0.0f);
+            state.rain.assign(columns_, 0.0f);
+        }
+        // Start in balance with the initial forcing, without clouds
+        PrepareStep();
+        for (size_t i = 0; i < columns_; ++i) {
+            for (int k = 0; k < options_.layers; ++k) {
+                const size_t cell = size_t(k) * columns_ + i;
+                const float t = TargetTemperature(step_.forcing, k);
+                states_[0].temperature[cell] = t;
+                states_[0].vapor[cell] = std::min(1.0f, Humidity(step_.forcing, i, k)) * Saturation(t, LayerPressure(k));
+            }
+        }
+        states_[1] = states_[0];
+    }
+
+    /**
+     * @brief Change the forcing target (WeatherSystem::SetWeather)
+     * @param type Weather to steer toward
+     * @param transitionTime Simulated seconds to blend the target over
+     */
+    void SetWeather(WeatherType type, float transitionTime = 10.0f) {
+        from_ = CurrentForcing();
+        to_ = ForcingFor(type);
+        weather_ = type;
+        transition_ = std::max(0.0f, transitionTime);
+        transitionElapsed_ = 0.0f;
+    }
+
+    /**
+     * @brief Weather the atmosphere is being steered toward
+     */
+    WeatherType GetTarget() const { return weather_; }
+
+    /**
+     * @brief Set the surface wind (applies from the next step)
+     */
+    void SetWind(float speed, const float direction[2]) {
+        const float len = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1]);
+        windSpeed_ = speed;
+        windDirection_[0] = len > 0.0f ? direction[0] / len : 1.0f;
+        windDirection_[1] = len > 0.0f ? direction[1] / len : 0.0f;
+    }
+
+    /**
+     * @brief Advance time and run chunks within the budget
+     * @param deltaTime Real seconds since the last call
+     * @param jobs Optional job system
+     */
+    void Update(float deltaTime, JobSystem* jobs = nullptr) {
+        const auto start = std::chrono::steady_clock::now();
+        const float dt = deltaTime * options_.timeScale;
+        transitionElapsed_ += dt;
+        sinceStep_ += dt;
+        if (!stepping_ && sinceStep_ >= options_.stepSeconds) {
+            sinceStep_ -= options_.stepSeconds;
+            if (sinceStep_ >= options_.stepSeconds) {
+                // Fell behind: drop whole steps rather than spiral
+                droppedSteps_ += uint64_t(sinceStep_ / options_.stepSeconds);
+                sinceStep_ = std::fmod(sinceStep_, options_.stepSeconds);
+            }
+            Publish();
+            BeginStep();
+        }
+        const size_t chunkCount = GetChunkCount();
+        const size_t batch = jobs ? size_t(jobs->GetThreadCount()) : 1;
+        chunksLastUpdate_ = 0;
+        while (stepping_ && nextChunk_ < chunkCount) {
+            const double elapsed = MicrosecondsSince(start);
+            size_t n = std::min(batch, chunkCount - nextChunk_);
+            if (elapsed + batchMicroseconds_ > options_.budgetMicroseconds) {
+                if (chunksLastUpdate_ > 0) {
+                    break;
+                }
+                n = 1;
+            }
+            const auto batchStart = std::chrono::steady_clock::now();
+            const size_t first = nextChunk_;
+            if (jobs && n > 1) {
+                jobs->ParallelFor(first, first + n, 1, [this](size_t b, size_t e) {
+                    for (size_t c = b; c < e; ++c) {
+                        RunChunk(c);
+                    }
+                });
+            } else {
+                for (size_t c = first; c < first + n; ++c) {
+                    RunChunk(c);
+                }
+            }
+            nextChunk_ += n;
+            chunksLastUpdate_ += n;
+            const double cost = MicrosecondsSince(batchStart);
+            // Plan with a slowly decaying peak so ordinary jitter does not break the budget
+            batchMicroseconds_ = std::max(cost, 0.98 * batchMicroseconds_);
+            if (nextChunk_ == chunkCount) {
+                FinishStep();
+            }
+        }
+        lastMicroseconds_ = MicrosecondsSince(start);
+    }
+
+    /**
+     * @brief Local conditions at a world position (periodic horizontally)
+     * @param x World X (meters)
+     * @param altitude Meters above the surface
+     * @param z World Z (meters)
+     */
+    Conditions GetConditions(float x, float altitude, float z) const {
+        const float layer = std::clamp(altitude / options_.layerHeight - 0.5f, 0.0f, float(options_.layers - 1));
+        const int k0 = std::min(int(layer), options_.layers - 1);
+        const int k1 = std::min(k0 + 1, options_.layers - 1);
+        const float fk = layer - float(k0);
+        const Columns at = Locate(x, z);
+        auto field = [&](const std::vector<float> State::*member) {
+            const float a = Blend(member, at, size_t(k0) * columns_);
+            const float b = Blend(member, at, size_t(k1) * columns_);
+            return a + fk * (b - a);
+        };
+        Conditions out;
+        out.temperature = field(&State::temperature);
+        out.cloudWater = field(&State::cloud);
+        out.pressure = options_.pressure * std::exp(-altitude / kScaleHeight);
+        out.relativeHumidity = field(&State::vapor) / Saturation(out.temperature, out.pressure);
+        out.precipitation = Blend(&State::rain, at, 0);
+        const float speed = LayerWindSpeed(windSpeed_ * CurrentForcing().windScale, layer);
+        out.windX = speed * windDirection_[0];
+        out.windZ = speed * windDirection_[1];
+        return out;
+    }
+
+    /**
+     * @brief Weather an observer at a world position would report
+     *
+     * Precipitation comes from the column's surface rate (snow when the
+     * lowest layer is at or below 1 C, convective storms where the lower
+     * atmosphere cools faster than 8 K/km); otherwise sky cover counts the
+     * cloudy columns within two cells, and a cloud confined to the lowest
+     * layer is fog.
+     */
+    WeatherType GetWeather(float x, float z) const {
+        const Conditions surface = GetConditions(x, 0.0f, z);
+        const float rain = surface.precipitation;
+        const float wind = std::sqrt(surface.windX * surface.windX + surface.windZ * surface.windZ);
+        if (rain > 0.05f) {
+            if (surface.temperature <= 1.0f) {
+                return wind > 12.0f ? WeatherType::Blizzard : rain > 0.5f ? WeatherType::Snow : WeatherType::LightSnow;
+            }
+            const int upper = std::min(3, options_.layers - 1);
+            const float aloft = GetConditions(x, (float(upper) + 0.5f) * options_.layerHeight, z).temperature;
+            const float lapse = (surface.temperature - aloft) / (float(upper) * options_.layerHeight * 0.001f);
+            if (upper > 0 && lapse > 8.0f && rain > 2.5f) {
+                return surface.temperature < 12.0f ? WeatherType::Hail : WeatherType::Thunderstorm;
+            }
+            return rain > 7.6f ? WeatherType::HeavyRain : rain > 2.5f ? WeatherType::Rain : WeatherType::LightRain;
+        }
+        const Columns at = Locate(x, z);
+        int cloudy = 0, total = 0;
+        int lowOnly = 0;
+        for (int di = -2; di <= 2; ++di) {
+            for (int dj = -2; dj <= 2; ++dj) {
+                const size_t column = Wrap(at.i0 + di, options_.depth) * size_t(options_.width) +
+                                      Wrap(at.j0 + dj, options_.width);
+                int top = -1;
+                for (int k = 0; k < options_.layers; ++k) {
+                    if (Blend(&State::cloud, column, size_t(k) * columns_) > kCloudy) {
+                        top = k;
+                    }
+                }
+                cloudy += top >= 0;
+                lowOnly += top == 0;
+                ++total;
+            }
+        }
+        const float cover = float(cloudy) / float(total);
+        if (lowOnly * 2 > total) {
+            return WeatherType::Fog;
+        }
+        return cover < 0.1f ? WeatherType::Clear
+             : cover < 0.5f ? WeatherType::PartlyCloudy
+             : cover < 0.9f ? WeatherType::Cloudy
+                            : WeatherType::Overcast;
+    }
+
+    /**
+     * @brief Cloud water of one cell (g/kg, blended like GetConditions)
+     */
+    float GetCloudWater(int i, int j, int layer) const {
+        return Blend(&State::cloud, size_t(i) * size_t(options_.width) + size_t(j), size_t(layer) * columns_);
+    }
+
+    size_t GetChunkCount() const { return size_t(chunksX_) * size_t(chunksZ_); }
+
+    /**
+     * @brief Chunks run by the last Update()
+     */
+    size_t GetChunksLastUpdate() const { return chunksLastUpdate_; }
+
+    /**
+     * @brief Completed simulation steps
+     */
+    uint64_t GetStepCount() const { return stepCount_; }
+
+    /**
+     * @brief Steps skipped because updates could not keep up with timeScale
+     */
+    uint64_t GetDroppedSteps() const { return droppedSteps_; }
+
+    /**
+     * @brief Wall time of the last Update()
+     */
+    double GetLastUpdateMicroseconds() const { return lastMicroseconds_; }
+
+    const Options& GetOptions() const { return options_; }
+
+private:
+    static constexpr float kScaleHeight = 8400.0f;  // Meters
+    static constexpr float kLatentHeat = 2.49f;     // Kelvin per g/kg condensed (L / cp)
+    static constexpr float kCloudy = 0.02f;         // g/kg of cloud water that counts as cloud
+
+    static Options Normalized(Options options) {
+        // Columns wrap modulo the grid and chunks divide it, so none may be empty
+        options.width = std::max(1, options.width);
+        options.depth = std::max(1, options.depth);
+        options.layers = std::max(1, options.layers);
+        options.chunkSize = std::max(1, options.chunkSize);
+        return options;
+    }
+
+    struct State {
+        std::vector<float> temperature; // Celsius, [layer][z][x]
+        std::vector<float> vapor;       // g/kg
+        std::vector<float> cloud;       // g/kg
+        std::vector<float> rain;        // Surface precipitation (mm/h), [z][x]
+    };
+
+    struct Forcing {
+        float temperature;              // Surface target (Celsius)
+        float humidity;                 // Relative humidity target (> 1 forces cloud)
+        float lapseRate;                // Kelvin per km
+        float windScale;
+        float fog;                      // 1 keeps the humidity target in the lowest layer only
+    };
+
+    // Parameters frozen for one step so every chunk sees the same inputs
+    struct Step {
+        Forcing forcing;
+        std::vector<int> shiftX, shiftZ;        // Per layer departure cell
+        std::vector<float> fractionX, fractionZ;
+        float patternX = 0.0f, patternZ = 0.0f; // Drift of the humidity pattern (columns)
+    };
+
+    struct Columns {
+        int i0, j0;
+        float fi, fj;
+    };
+
+    Forcing ForcingFor(WeatherType type) const {
+        const float t = options_.temperature;
+        const float lapse = options_.lapseRate;
+        switch (type) {
+        case WeatherType::Clear:        return {t, 0.6f, lapse, 1.0f, 0.0f};
+        case WeatherType::PartlyCloudy: return {t, 1.0f, lapse, 1.0f, 0.0f};
+        case WeatherType::Cloudy:       return {t, 1.015f, lapse, 1.0f, 0.0f};
+        case WeatherType::Overcast:     return {t - 2.0f, 1.03f, lapse, 1.0f, 0.0f};
+        case WeatherType::LightRain:    return {t - 3.0f, 1.1f, lapse, 1.2f, 0.0f};
+        case WeatherType::Rain:         return {t - 4.0f, 1.3f, lapse, 1.5f, 0.0f};
+        case WeatherType::HeavyRain:    return {t - 5.0f, 1.7f, lapse, 2.0f, 0.0f};
+        case WeatherType::Thunderstorm: return {t + 5.0f, 1.6f, 9.0f, 2.5f, 0.0f};
+        case WeatherType::LightSnow:    return {-3.0f, 1.1f, lapse, 1.0f, 0.0f};
+        case WeatherType::Snow:         return {-5.0f, 1.3f, lapse, 1.5f, 0.0f};
+        case WeatherType::Blizzard:     return {-10.0f, 1.4f, lapse, 3.5f, 0.0f};
+        case WeatherType::Fog:          return {t - 5.0f, 1.03f, lapse, 0.3f, 1.0f};
+        case WeatherType::Hail:         return {8.0f, 1.6f, 9.0f, 2.5f, 0.0f};
+        }
+        return from_;
+    }
+
+    Forcing CurrentForcing() const {
+        const float s = transition_ > 0.0f ? std::min(1.0f, transitionElapsed_ / transition_) : 1.0f;
+        auto mix = [s](float a, float b) { return a + s * (b - a); };
+        return {mix(from_.temperature, to_.temperature), mix(from_.humidity, to_.humidity),
+                mix(from_.lapseRate, to_.lapseRate), mix(from_.windScale, to_.windScale), mix(from_.fog, to_.fog)};
+    }
+
+    float LayerPressure(int k) const {
+        return options_.pressure * std::exp(-(float(k) + 0.5f) * options_.layerHeight / kScaleHeight);
+    }
+
+    float LayerWindSpeed(float surface, float layer) const { return surface * (1.0f + options_.windShear * layer); }
+
+    float TargetTemperature(const Forcing& f, int k) const {
+        return f.temperature - f.lapseRate * (float(k) + 0.5f) * options_.layerHeight * 0.001f;
+    }
+
+    // Saturation mixing ratio (g/kg) over water (Bolton)
+    static float Saturation(float celsius, float millibars) {
+        const float es = 6.112f * std::exp(17.67f * celsius / (celsius + 243.5f));
+        return 622.0f * es / std::max(millibars - es, 1.0f);
+    }
+
+    // Relative humidity target of one column and layer, varied by drifting value noise
+    float Humidity(const Forcing& f, size_t column, int k) const {
+        const float lattice = std::max(1.0f, options_.patternSize);
+        const int cellsX = std::max(1, int(float(options_.width) / lattice));
+        const int cellsZ = std::max(1, int(float(options_.depth) / lattice));
+        const float u = (float(column % size_t(options_.width)) - step_.patternX) * float(cellsX) / float(options_.width);
+        const float v = (float(column / size_t(options_.width)) - step_.patternZ) * float(cellsZ) / float(options_.depth);
+        const float u0 = std::floor(u), v0 = std::floor(v);
+        const float fu = u - u0, fv = v - v0;
+        auto lattice01 = [&](float a, float b) {
+            const uint32_t ia = uint32_t(Wrap(int(a), cellsX)), ib = uint32_t(Wrap(int(b), cellsZ));
+            return HashToUnitFloat(HashCombine(HashCombine(options_.seed, ia), ib));
+        };
+        const float top = lattice01(u0, v0) + fu * (lattice01(u0 + 1.0f, v0) - lattice01(u0, v0));
+        const float bottom = lattice01(u0, v0 + 1.0f) + fu * (lattice01(u0 + 1.0f, v0 + 1.0f) - lattice01(u0, v0 + 1.0f));
+        const float rh = f.humidity + options_.variability * (2.0f * (top + fv * (bottom - top)) - 1.0f);
+        return k == 0 ? rh : rh + f.fog * (0.6f - rh);
+    }
+
+    void BeginStep() {
+        patternTime_ += options_.stepSeconds;
+        PrepareStep();
+        stepping_ = true;
+        nextChunk_ = 0;
+    }
+
+    void PrepareStep() {
+        step_.forcing = CurrentForcing();
+        const size_t layers = size_t(options_.layers);
+        step_.shiftX.resize(layers);
+        step_.shiftZ.resize(layers);
+        step_.fractionX.resize(layers);
+        step_.fractionZ.resize(layers);
+        const float surface = windSpeed_ * step_.forcing.windScale;
+        for (size_t k = 0; k < layers; ++k) {
+            const float speed = LayerWindSpeed(surface, float(k));
+            const float dx = -speed * windDirection_[0] * options_.stepSeconds / options_.cellSize;
+            const float dz = -speed * windDirection_[1] * options_.stepSeconds / options_.cellSize;
+            step_.shiftX[k] = int(std::floor(dx));
+            step_.shiftZ[k] = int(std::floor(dz));
+            step_.fractionX[k] = dx - std::floor(dx);
+            step_.fractionZ[k] = dz - std::floor(dz);
+        }
+        // The humidity pattern drifts with the surface wind
+        step_.patternX = std::fmod(surface * windDirection_[0] * patternTime_ / options_.cellSize, float(options_.width));
+        step_.patternZ = std::fmod(surface * windDirection_[1] * patternTime_ / options_.cellSize, float(options_.depth));
+    }
+
+    void FinishStep() {
+        stepping_ = false;
+        finished_ = true;
+        ++stepCount_;
+    }
+
+    // At a step boundary the finished state becomes current, current becomes the blend source
+    void Publish() {
+        if (finished_) {
+            previous_ = current_;
+            current_ = (current_ + 1) % 3;
+            finished_ = false;
+        }
+    }
+
+    void RunChunk(size_t chunk) {
+        const State& in = states_[size_t(current_)];
+        State& out = states_[size_t((current_ + 1) % 3)];
+        const int ci = int(chunk) / chunksX_, cj = int(chunk) % chunksX_;
+        const int i1 = std::min(options_.depth, (ci + 1) * options_.chunkSize);
+        const int j1 = std::min(options_.width, (cj + 1) * options_.chunkSize);
+        const Forcing& f = step_.forcing;
+        const float dt = options_.stepSeconds;
+        const float relax = std::min(1.0f, dt / options_.forcingTime);
+        const float condense = std::min(1.0f, dt / options_.condensationTime);
+        const float rainOut = options_.precipitation ? std::min(1.0f, dt / options_.precipitationTime) : 0.0f;
+        const size_t w = size_t(options_.width);
+        for (int i = ci * options_.chunkSize; i < i1; ++i) {
+            for (int j = cj * options_.chunkSize; j < j1; ++j) {
+                const size_t column = size_t(i) * w + size_t(j);
+                float fallen = 0.0f;    // kg/m^2 (mm) rained out of the column this step
+                for (int k = 0; k < options_.layers; ++k) {
+                    const size_t layer = size_t(k) * columns_;
+                    // Semi-Lagrangian advection by the uniform layer wind
+                    const size_t i0 = Wrap(i + step_.shiftZ[size_t(k)], options_.depth);
+                    const size_t iN = Wrap(i + step_.shiftZ[size_t(k)] + 1, options_.depth);
+                    const size_t j0 = Wrap(j + step_.shiftX[size_t(k)], options_.width);
+                    const size_t jN = Wrap(j + step_.shiftX[size_t(k)] + 1, options_.width);
+                    const float fx = step_.fractionX[size_t(k)], fz = step_.fractionZ[size_t(k)];
+                    auto advect = [&](const std::vector<float>& field) {
+                        const float* f0 = field.data() + layer + i0 * w;
+                        const float* f1 = field.data() + layer + iN * w;
+                        const float top = f0[j0] + fx * (f0[jN] - f0[j0]);
+                        const float bottom = f1[j0] + fx * (f1[jN] - f1[j0]);
+                        return top + fz * (bottom - top);
+                    };
+                    float t = advect(in.temperature);
+                    float q = advect(in.vapor);
+                    float c = advect(in.cloud);
+
+                    // Relax temperature and total water toward the forcing target
+                    const float p = LayerPressure(k);
+                    const float targetT = TargetTemperature(f, k);
+                    t += relax * (targetT - t);
+                    const float water = q + c;
+                    q = std::max(0.0f, q + relax * (Humidity(f, column, k) * Saturation(targetT, p) - water));
+
+                    // Condense above saturation, evaporate cloud below it
+                    const float saturation = Saturation(t, p);
+                    const float excess = q - saturation;
+                    if (excess > 0.0f) {
+                        // Latent heat raises saturation as vapor condenses; aim for the joint balance
+                        const float slope = saturation * 4302.6f / ((t + 243.5f) * (t + 243.5f));
+                        const float d = condense * excess / (1.0f + kLatentHeat * slope);
+                        q -= d;
+                        c += d;
+                        t += kLatentHeat * d;
+                    } else if (c > 0.0f) {
+                        const float e = std::min(c, -condense * excess);
+                        q += e;
+                        c -= e;
+                        t -= kLatentHeat * e;
+                    }
+
+                    // Cloud water above the threshold falls out; ice-phase clouds do so sooner
+                    const float threshold = options_.cloudThreshold * std::clamp(1.0f + t * 0.1f, 0.2f, 1.0f);
+                    if (c > threshold) {
+                        const float r = rainOut * (c - threshold);
+                        c -= r;
+                        const float density = 1.225f * std::exp(-(float(k) + 0.5f) * options_.layerHeight / kScaleHeight);
+                        fallen += r * 0.001f * density * options_.layerHeight;
+                    }
+                    const size_t cell = layer + column;
+                    out.temperature[cell] = t;
+                    out.vapor[cell] = q;
+                    out.cloud[cell] = c;
+                }
+                out.rain[column] = fallen * 3600.0f / dt;
+            }
+        }
+    }
+
+    Columns Locate(float x, float z) const {
+        const float u = x / options_.cellSize - 0.5f, v = z / options_.cellSize - 0.5f;
+        const float u0 = std::floor(u), v0 = std::floor(v);
+        return {int(v0), int(u0), v - v0, u - u0};
+    }
+
+    // Field value between the two published states, bilinear over columns
+    float Blend(const std::vector<float> State::*member, const Columns& at, size_t layer) const {
+        auto column = [&](int di, int dj) {
+            return Wrap(at.i0 + di, options_.depth) * size_t(options_.width) + Wrap(at.j0 + dj, options_.width);
+        };
+        const float a = Blend(member, column(0, 0), layer), b = Blend(member, column(0, 1), layer);
+        const float c = Blend(member, column(1, 0), layer), d = Blend(member, column(1, 1), layer);
+        const float top = a + at.fj * (b - a), bottom = c + at.fj * (d - c);
+        return top + at.fi * (bottom - top);
+    }
+
+    float Blend(const std::vector<float> State::*member, size_t column, size_t layer) const {
+        const float s = std::min(1.0f, sinceStep_ / options_.stepSeconds);
+        const float a = (states_[size_t(previous_)].*member)[layer + column];
+        const float b = (states_[size_t(current_)].*member)[layer + column];
+        return a + s * (b - a);
+    }
+
+    static size_t Wrap(int i, int n) { return size_t(((i % n) + n) % n); }
+
+    static double MicrosecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    Options options_;
+    size_t columns_ = 0, cells_ = 0;
+    int chunksX_ = 0, chunksZ_ = 0;
+    State states_[3];
+    int previous_ = 0, current_ = 1;    // The third state is written by the running step
+    Step step_;
+    bool stepping_ = false;
+    bool finished_ = false;             // The written state holds a step not yet published
+    size_t nextChunk_ = 0;
+    size_t chunksLastUpdate_ = 0;
+    double batchMicroseconds_ = 0.0;    // Recent peak cost of one batch
+    double lastMicroseconds_ = 0.0;
+    float sinceStep_ = 0.0f;            // Simulated seconds since the last step began
+    float patternTime_ = 0.0f;
+    uint64_t stepCount_ = 0;
+    uint64_t droppedSteps_ = 0;
+
+    Forcing from_{}, to_{};
+    WeatherType weather_ = WeatherType::Clear;
+    float transition_ = 0.0f, transitionElapsed_ = 0.0f;
+    float windSpeed_ = 0.0f;
+    float windDirection_[2] = {1.0f, 0.0f};
+};
+
+} // namespace NRE
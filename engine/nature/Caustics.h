@@ -0,0 +1,265 @@
+#pragma once
+
+#include <core/JobSystem.h>
+#include <core/Simd.h>
+#include <nature/OceanFFT.h>
+#include <nature/WaterRenderer.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Caustic light map on the sea floor, precomputed per ocean update
+ *
+ * Update() shoots a regular grid of parallel sun rays at one FFT cascade,
+ * refracts each through the displaced surface (Snell's law, four rays per
+ * SIMD group), follows it to a flat floor below sea level and splats its
+ * energy bilinearly into a map. The map covers exactly one cascade period
+ * and wraps, so a single map tiles the whole ocean in step with the waves.
+ * Flat water yields a uniform map equal to the transmitted light; focusing
+ * crests raise it above that and defocusing troughs lower it.
+ *
+ * Rays are split into a fixed number of row bands, each splatting into its
+ * own map, and the bands are summed in order, so results do not depend on
+ * thread count.
+ */
+class Caustics {
+public:
+    struct Options {
+        int resolution = 256;           // Map texels per side (rounded up to a power of two >= 4, 0 = off)
+        int raysPerTexel = 2;           // Rays per texel side (at least 1)
+        float floorDepth = 8.0f;        // Floor plane below sea level (m)
+        float ior = 1.333f;             // Water index of refraction
+        float lightDirection[3] = {0.2f, -1.0f, 0.1f};  // Direction light travels (downward; else straight down)
+        float extinction = 0.05f;       // Underwater attenuation (1/m)
+        int cascade = -1;               // Ocean cascade to refract through (-1 = the finest)
+    };
+
+    /**
+     * @brief Caustics options from the water renderer config
+     */
+    static Options FromConfig(const WaterRenderer::Config& config) {
+        Options o;
+        if (!config.enableCaustics) {
+            o.resolution = 0;
+        }
+        o.ior = config.ior;
+        o.extinction = 0.02f + 0.5f * (1.0f - config.clarity);
+        return o;
+    }
+
+    explicit Caustics(const Options& options) : options_(options) {
+        // Wrapping uses '& (res - 1)' and rays are traced four per row group
+        if (options_.resolution > 0) {
+            options_.resolution = int(std::bit_ceil(unsigned(std::max(4, options_.resolution))));
+        }
+        options_.raysPerTexel = std::max(1, options_.raysPerTexel);
+        const float* d = options_.lightDirection;
+        const float len = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        // Light must reach the floor; zero, grazing or upward directions fall back to straight down
+        if (len > 1e-6f && d[1] < -1e-3f * len) {
+            for (int i = 0; i < 3; ++i) {
+                light_[i] = d[i] / len;
+            }
+        }
+        const size_t res = size_t(std::max(0, options_.resolution));
+        map_.assign(res * res, 0.0f);
+    }
+
+    /**
+     * @brief Recompute the map from the ocean's latest maps (once per OceanFFT::Update)
+     * @param ocean Ocean to refract through
+     * @param jobs Optional job system
+     */
+    void Update(const OceanFFT& ocean, JobSystem* jobs = nullptr) {
+        const int res = options_.resolution;
+        if (res <= 0 || ocean.GetCascadeCount() == 0) {
+            return;
+        }
+        const size_t index = options_.cascade < 0 ? ocean.GetCascadeCount() - 1 : size_t(options_.cascade);
+        const OceanFFT::Cascade& cascade = ocean.GetCascade(std::min(index, ocean.GetCascadeCount() - 1));
+        tileSize_ = cascade.tileSize;
+
+        const size_t rays = size_t(res) * size_t(options_.raysPerTexel);
+        const size_t mapSize = size_t(res) * size_t(res);
+        const size_t bandCount = std::min<size_t>(kBands, rays);
+        bands_.resize(bandCount);
+        auto trace = [&](size_t begin, size_t end) {
+            for (size_t b = begin; b < end; ++b) {
+                std::vector<float>& band = bands_[b];
+                band.assign(mapSize, 0.0f);
+                TraceRows(ocean.GetResolution(), cascade, rays, rays * b / bandCount, rays * (b + 1) / bandCount,
+                          band.data());
+            }
+        };
+        auto reduce = [&](size_t begin, size_t end) {
+            for (size_t i = begin * 4; i < end * 4; i += 4) {
+                Float4 sum = Float4::Load(bands_[0].data() + i);
+                for (size_t b = 1; b < bandCount; ++b) {
+                    sum = sum + Float4::Load(bands_[b].data() + i);
+                }
+                sum.Store(map_.data() + i);
+            }
+        };
+        const size_t groups = (mapSize + 3) / 4;
+        if (jobs) {
+            jobs->ParallelFor(0, bandCount, 1, trace);
+            jobs->ParallelFor(0, groups, 1024, reduce);
+        } else {
+            trace(0, bandCount);
+            reduce(0, groups);
+        }
+        ++version_;
+    }
+
+    /**
+     * @brief Caustic intensity at a world floor position (bilinear, periodic)
+     */
+    float Sample(float x, float z) const {
+        const int res = options_.resolution;
+        if (res <= 0 || tileSize_ <= 0.0f) {
+            return 0.0f;
+        }
+        const float u = x / tileSize_ * float(res) - 0.5f;
+        const float v = z / tileSize_ * float(res) - 0.5f;
+        const float u0 = std::floor(u), v0 = std::floor(v);
+        const float fu = u - u0, fv = v - v0;
+        const int mask = res - 1;
+        auto at = [&](int i, int j) { return map_[size_t(i & mask) * size_t(res) + size_t(j & mask)]; };
+        const int i = int(v0), j = int(u0);
+        const float top = at(i, j) + fu * (at(i, j + 1) - at(i, j));
+        const float bottom = at(i + 1, j) + fu * (at(i + 1, j + 1) - at(i + 1, j));
+        return top + fv * (bottom - top);
+    }
+
+    /**
+     * @brief Intensity map (resolution^2, row = z), one cascade period per side
+     */
+    const std::vector<float>& GetMap() const { return map_; }
+    int GetResolution() const { return options_.resolution; }
+
+    /**
+     * @brief Meters covered by one map period (0 before the first Update)
+     */
+    float GetTileSize() const { return tileSize_; }
+
+    /**
+     * @brief Number of updates so far
+     */
+    uint64_t GetVersion() const { return version_; }
+
+private:
+    static constexpr size_t kBands = 16;
+
+    // Refract ray rows [row0, row1) of a rays^2 grid and splat them into out
+    void TraceRows(int n, const OceanFFT::Cascade& cascade, size_t rays, size_t row0, size_t row1,
+                   float* out) const {
+        const int res = options_.resolution;
+        const float raySpacing = cascade.tileSize / float(rays);
+        const float toSample = float(n) / cascade.tileSize;
+        const float toTexel = float(res) / cascade.tileSize;
+        const float perTexel = float(rays) / float(res);
+        const float eta = 1.0f / options_.ior;
+        const Float4 lx(light_[0]), ly(light_[1]), lz(light_[2]);
+        const Float4 one(1.0f), zero(0.0f), etaV(eta), depth(options_.floorDepth);
+        const Float4 flatCos(-light_[1]), energy(1.0f / (perTexel * perTexel));
+        const Float4 extinction(-options_.extinction), lane(0.5f, 1.5f, 2.5f, 3.5f);
+        const int mask = res - 1;
+        for (size_t r = row0; r < row1; ++r) {
+            const float z = (float(r) + 0.5f) * raySpacing;
+            for (size_t c = 0; c < rays; c += 4) {
+                const Float4 x = (Float4(float(c)) + lane) * Float4(raySpacing);
+                Float4 height, dx, dz, nx, ny, nz;
+                SampleSurface(n, cascade, x * Float4(toSample), Float4(z * toSample), height, dx, dz, nx, ny, nz);
+                // Bilinear blending shortens normals slightly
+                const Float4 invLen = one / Sqrt(nx * nx + ny * ny + nz * nz);
+                nx = nx * invLen;
+                ny = ny * invLen;
+                nz = nz * invLen;
+                // Snell: t = eta l + (eta cos_i - sqrt(1 - eta^2 (1 - cos_i^2))) n
+                const Float4 cosI = zero - (nx * lx + ny * ly + nz * lz);
+                const Float4 k = one - etaV * etaV * (one - cosI * cosI);
+                const Float4 scale = etaV * cosI - Sqrt(Max(zero, k));
+                const Float4 tx = etaV * lx + scale * nx;
+                const Float4 ty = etaV * ly + scale * ny;
+                const Float4 tz = etaV * lz + scale * nz;
+                // Travel from the displaced surface point down to the floor plane
+                const Float4 travel = (height + depth) / Max(Float4(1e-4f), zero - ty);
+                const Float4 fx = (x + dx + tx * travel) * Float4(toTexel) - Float4(0.5f);
+                const Float4 fz = (Float4(z) + dz + tz * travel) * Float4(toTexel) - Float4(0.5f);
+                // Flux through the tilted surface, attenuated along the underwater path
+                float attenuation[4];
+                (extinction * travel).Store(attenuation);
+                float weight[4];
+                (energy * Max(zero, cosI) / flatCos).Store(weight);
+                const Float4 fx0 = Floor(fx), fz0 = Floor(fz);
+                float wu[4], wv[4];
+                (fx - fx0).Store(wu);
+                (fz - fz0).Store(wv);
+                int32_t iu[4], iv[4];
+                StoreInt(fx0, iu);
+                StoreInt(fz0, iv);
+                for (int l = 0; l < 4; ++l) {
+                    const float w = weight[l] * std::exp(attenuation[l]);
+                    const size_t r0 = size_t(iv[l] & mask) * size_t(res), r1 = size_t((iv[l] + 1) & mask) * size_t(res);
+                    const size_t c0 = size_t(iu[l] & mask), c1 = size_t((iu[l] + 1) & mask);
+                    out[r0 + c0] += w * (1.0f - wu[l]) * (1.0f - wv[l]);
+                    out[r0 + c1] += w * wu[l] * (1.0f - wv[l]);
+                    out[r1 + c0] += w * (1.0f - wu[l]) * wv[l];
+                    out[r1 + c1] += w * wu[l] * wv[l];
+                }
+            }
+        }
+    }
+
+    // Bilinear surface maps at four sample-space positions (periodic)
+    static void SampleSurface(int n, const OceanFFT::Cascade& cascade, Float4 u, Float4 v, Float4& height,
+                              Float4& dx, Float4& dz, Float4& nx, Float4& ny, Float4& nz) {
+        const Float4 u0 = Floor(u), v0 = Floor(v);
+        const Float4 fu = u - u0, fv = v - v0;
+        int32_t iu[4], iv[4];
+        StoreInt(u0, iu);
+        StoreInt(v0, iv);
+        const int mask = n - 1;
+        size_t corner[4][4];  // [corner][lane]
+        for (int l = 0; l < 4; ++l) {
+            const size_t r0 = size_t(iv[l] & mask) * size_t(n), r1 = size_t((iv[l] + 1) & mask) * size_t(n);
+            const size_t c0 = size_t(iu[l] & mask), c1 = size_t((iu[l] + 1) & mask);
+            corner[0][l] = r0 + c0;
+            corner[1][l] = r0 + c1;
+            corner[2][l] = r1 + c0;
+            corner[3][l] = r1 + c1;
+        }
+        const Float4 one(1.0f);
+        const Float4 weight[4] = {(one - fu) * (one - fv), fu * (one - fv), (one - fu) * fv, fu * fv};
+        auto blend = [&](const std::vector<float>& map) {
+            Float4 sum(0.0f);
+            for (int k = 0; k < 4; ++k) {
+                const size_t* at = corner[k];
+                sum = sum + weight[k] * Float4(map[at[0]], map[at[1]], map[at[2]], map[at[3]]);
+            }
+            return sum;
+        };
+        height = blend(cascade.height);
+        dx = blend(cascade.displaceX);
+        dz = blend(cascade.displaceZ);
+        nx = blend(cascade.normalX);
+        ny = blend(cascade.normalY);
+        nz = blend(cascade.normalZ);
+    }
+
+    Options options_;
+    float light_[3] = {0.0f, -1.0f, 0.0f};
+    float tileSize_ = 0.0f;
+    std::vector<float> map_;
+    std::vector<std::vector<float>> bands_;  // Per-band splat targets, summed into map_
+    uint64_t version_ = 0;
+};
+
+} // namespace NRE
@@ -0,0 +1,646 @@
+#pragma once
+
+#include <core/Compression.h>
+#include <core/JobSystem.h>
+#include <core/Random.h>
+#include <core/Simd.h>
+#include <core/StorageManager.h>
+#include <nature/AtmosphereGrid.h>
+#include <nature/WeatherSystem.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Tileable noise volumes and weather map for volumetric clouds
+ *
+ * Bake() produces the usual cloud inputs, all wrapping seamlessly:
+ * - shape volume (RGBA8): Perlin-Worley, then Worley fBm at 1x, 2x and 4x
+ *   the base frequency
+ * - detail volume (RGBA8): Worley fBm at 1x, 2x and 4x, with the combined
+ *   fBm in alpha
+ * - weather map (RGBA8): coverage, precipitation and cloud type
+ *
+ * Noise lattices are tabulated once per frequency. Volumes are generated
+ * in parallel z slices, with four voxels per SIMD group. Given a
+ * StorageManager, the baked bytes are stored compressed with
+ * Priority::Low under a key hashing every setting, and later startups
+ * load them instead of generating them. UpdateCoverage() only remaps the
+ * cached base noise of the weather map, so a weather change costs one
+ * pass over its pixels.
+ */
+class CloudNoiseBaker {
+public:
+    struct Options {
+        int shapeSize = 128;            // Shape volume texels per side (rounded up to a multiple of four)
+        int detailSize = 32;            // Detail volume texels per side (rounded up to a multiple of four)
+        int weatherSize = 512;          // Weather map texels per side (rounded up to a multiple of four)
+        int shapeFrequency = 4;         // Base noise cells per tile side (at least 1)
+        int detailFrequency = 4;
+        int weatherFrequency = 4;
+        int perlinOctaves = 4;          // At least 1
+        uint32_t seed = 1;
+        std::string keyPrefix = "clouds";
+    };
+
+    /**
+     * @brief Baker options from the weather config
+     */
+    static Options FromConfig(const WeatherSystem::Config& config) {
+        Options o;
+        o.weatherSize = config.cloudResolution;
+        if (!config.enableVolumetricClouds) {
+            o.shapeSize = 0;
+            o.detailSize = 0;
+        }
+        return o;
+    }
+
+    /**
+     * @brief Weather map targets for a region
+     */
+    struct Coverage {
+        float coverage = 0.5f;          // Fraction of sky covered (0-1)
+        float precipitation = 0.0f;     // Cloud darkness / rain density (0-1)
+        float type = 0.5f;              // 0 = stratus, 1 = cumulonimbus
+    };
+
+    /**
+     * @brief Coverage a weather type steers toward
+     */
+    static Coverage CoverageFor(WeatherSystem::WeatherType type) {
+        using W = WeatherSystem::WeatherType;
+        switch (type) {
+        case W::Clear:        return {0.05f, 0.0f, 0.5f};
+        case W::PartlyCloudy: return {0.35f, 0.0f, 0.6f};
+        case W::Cloudy:       return {0.65f, 0.1f, 0.5f};
+        case W::Overcast:     return {0.95f, 0.2f, 0.1f};
+        case W::LightRain:    return {0.85f, 0.4f, 0.3f};
+        case W::Rain:         return {0.95f, 0.6f, 0.4f};
+        case W::HeavyRain:    return {1.0f, 0.8f, 0.5f};
+        case W::Thunderstorm: return {0.8f, 1.0f, 1.0f};
+        case W::LightSnow:    return {0.85f, 0.3f, 0.2f};
+        case W::Snow:         return {0.95f, 0.5f, 0.2f};
+        case W::Blizzard:     return {1.0f, 0.7f, 0.3f};
+        case W::Fog:          return {0.3f, 0.0f, 0.0f};
+        case W::Hail:         return {0.8f, 1.0f, 1.0f};
+        }
+        return {};
+    }
+
+    /**
+     * @brief Cubic RGBA8 volume, x fastest, then y, then z
+     */
+    struct Volume {
+        int size = 0;
+        std::vector<uint8_t> texels;
+    };
+
+    explicit CloudNoiseBaker(const Options& options) : options_(Normalized(options)) {}
+
+    /**
+     * @brief FNV-1a hash of the settings that determine the baked bytes
+     */
+    static uint64_t HashOptions(const Options& options) {
+        uint64_t h = 14695981039346656037ull;
+        auto mix = [&h](const void* data, size_t size) {
+            const uint8_t* p = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                h = (h ^ p[i]) * 1099511628211ull;
+            }
+        };
+        const int32_t values[] = {options.shapeSize,     options.detailSize,       options.weatherSize,
+                                  options.shapeFrequency, options.detailFrequency, options.weatherFrequency,
+                                  options.perlinOctaves,  int32_t(options.seed),   int32_t(kVersion)};
+        mix(values, sizeof(values));
+        return h;
+    }
+
+    /**
+     * @brief Storage key of the baked data
+     */
+    std::string GetKey() const {
+        char hash[17];
+        std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(HashOptions(options_)));
+        return options_.keyPrefix + "." + hash;
+    }
+
+    /**
+     * @brief Generate the volumes and weather noise, or load them from the cache
+     * @param jobs Optional job system
+     * @param cache Optional storage; a hit skips generation, a miss stores the result
+     * @return true if loaded from the cache
+     */
+    bool Bake(JobSystem* jobs = nullptr, StorageManager* cache = nullptr) {
+        loaded_ = cache && Load(*cache);
+        if (!loaded_) {
+            Generate(jobs);
+            if (cache) {
+                Store(*cache);
+            }
+        }
+        weatherMap_.assign(size_t(options_.weatherSize) * size_t(options_.weatherSize) * 4, 0);
+        UpdateCoverage(Coverage{}, jobs);
+        return loaded_;
+    }
+
+    /**
+     * @brief Remap the weather map to uniform targets (cheap; no noise evaluation)
+     */
+    void UpdateCoverage(const Coverage& target, JobSystem* jobs = nullptr) {
+        RemapWeather(jobs, [&](size_t, size_t, Float4& coverage, Float4& precipitation, Float4& type) {
+            coverage = Float4(target.coverage);
+            precipitation = Float4(target.precipitation);
+            type = Float4(target.type);
+        });
+    }
+
+    /**
+     * @brief Remap the weather map to the clouds of an atmosphere grid
+     *
+     * The map spans the whole (periodic) grid. Coverage follows the
+     * column's densest cloud layer, precipitation its surface rate, and
+     * cloud type how high the cloud reaches.
+     */
+    void UpdateCoverage(const AtmosphereGrid& grid, JobSystem* jobs = nullptr) {
+        const auto& o = grid.GetOptions();
+        const size_t columns = size_t(o.width) * size_t(o.depth);
+        columnTargets_.resize(columns * 3);
+        for (int i = 0; i < o.depth; ++i) {
+            for (int j = 0; j < o.width; ++j) {
+                float densest = 0.0f;
+                int top = -1;
+                for (int k = 0; k < o.layers; ++k) {
+                    const float cloud = grid.GetCloudWater(i, j, k);
+                    densest = std::max(densest, cloud);
+                    top = cloud > 0.02f ? k : top;
+                }
+                const float x = (float(j) + 0.5f) * o.cellSize, z = (float(i) + 0.5f) * o.cellSize;
+                const float rain = grid.GetConditions(x, 0.0f, z).precipitation;
+                float* t = columnTargets_.data() + (size_t(i) * size_t(o.width) + size_t(j)) * 3;
+                t[0] = std::min(1.0f, densest / 0.2f);
+                t[1] = std::min(1.0f, rain / 10.0f);
+                t[2] = top < 0 ? 0.5f : float(top + 1) / float(o.layers);
+            }
+        }
+        const float n = float(options_.weatherSize);
+        const float scaleX = float(o.width) / n, scaleZ = float(o.depth) / n;
+        RemapWeather(jobs, [&](size_t i, size_t j, Float4& coverage, Float4& precipitation, Float4& type) {
+            float c[4], p[4], t[4];
+            for (int l = 0; l < 4; ++l) {
+                // Bilinear between column centers, wrapping like the grid
+                const float u = (float(j + size_t(l)) + 0.5f) * scaleX - 0.5f;
+                const float v = (float(i) + 0.5f) * scaleZ - 0.5f;
+                const float u0 = std::floor(u), v0 = std::floor(v);
+                const float fu = u - u0, fv = v - v0;
+                const int j0 = Wrap(int(u0), o.width), j1 = Wrap(int(u0) + 1, o.width);
+                const int i0 = Wrap(int(v0), o.depth), i1 = Wrap(int(v0) + 1, o.depth);
+                auto at = [&](int a, int b, int ch) {
+                    return columnTargets_[(size_t(a) * size_t(o.width) + size_t(b)) * 3 + size_t(ch)];
+                };
+                float* out[3] = {c, p, t};
+                for (int ch = 0; ch < 3; ++ch) {
+                    const float top = at(i0, j0, ch) + fu * (at(i0, j1, ch) - at(i0, j0, ch));
+                    const float bottom = at(i1, j0, ch) + fu * (at(i1, j1, ch) - at(i1, j0, ch));
+                    out[ch][l] = top + fv * (bottom - top);
+                }
+            }
+            coverage = Float4::Load(c);
+            precipitation = Float4::Load(p);
+            type = Float4::Load(t);
+        });
+    }
+
+    const Volume& GetShape() const { return shape_; }
+    const Volume& GetDetail() const { return detail_; }
+
+    /**
+     * @brief Weather map (weatherSize^2 RGBA8: coverage, precipitation, type, 255)
+     */
+    const std::vector<uint8_t>& GetWeatherMap() const { return weatherMap_; }
+    int GetWeatherSize() const { return options_.weatherSize; }
+
+    /**
+     * @brief Whether the last Bake() was served from the cache
+     */
+    bool WasLoaded() const { return loaded_; }
+
+    /**
+     * @brief Bytes written to the cache by the last Bake() (0 on a hit)
+     */
+    size_t GetStoredBytes() const { return storedBytes_; }
+
+    const Options& GetOptions() const { return options_; }
+
+private:
+    static constexpr uint32_t kMagic = 0x444C434Eu;  // "NCLD"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint32_t kFlagCompressed = 1;
+
+    // Rows are written four texels per SIMD group, and lattices wrap modulo their period
+    static Options Normalized(Options options) {
+        for (int* size : {&options.shapeSize, &options.detailSize, &options.weatherSize}) {
+            *size = (std::max(0, *size) + 3) & ~3;
+        }
+        for (int* count : {&options.shapeFrequency, &options.detailFrequency, &options.weatherFrequency,
+                           &options.perlinOctaves}) {
+            *count = std::max(1, *count);
+        }
+        return options;
+    }
+
+    struct Header {
+        uint32_t magic = kMagic;
+        uint32_t version = kVersion;
+        uint32_t flags = 0;
+        uint32_t rawSize = 0;
+    };
+
+    // Gradient directions per lattice point of one tileable Perlin frequency
+    struct PerlinLattice {
+        int period = 0;
+        std::vector<uint8_t> gradient;
+    };
+
+    // One jittered feature point per cell of one tileable Worley frequency
+    struct WorleyLattice {
+        int period = 0;
+        std::vector<float> x, y, z;     // Offsets within the cell, [0, 1)
+    };
+
+    static int Wrap(int i, int n) { return ((i % n) + n) % n; }
+
+    static PerlinLattice MakePerlin(int period, uint32_t seed) {
+        PerlinLattice lattice;
+        lattice.period = period;
+        lattice.gradient.resize(size_t(period) * size_t(period) * size_t(period));
+        for (size_t i = 0; i < lattice.gradient.size(); ++i) {
+            lattice.gradient[i] = uint8_t(HashCombine(seed, uint32_t(i)) % 12u);
+        }
+        return lattice;
+    }
+
+    static WorleyLattice MakeWorley(int period, uint32_t seed) {
+        WorleyLattice lattice;
+        lattice.period = period;
+        const size_t cells = size_t(period) * size_t(period) * size_t(period);
+        lattice.x.resize(cells);
+        lattice.y.resize(cells);
+        lattice.z.resize(cells);
+        for (size_t i = 0; i < cells; ++i) {
+            const uint32_t h = HashCombine(seed, uint32_t(i));
+            lattice.x[i] = HashToUnitFloat(h);
+            lattice.y[i] = HashToUnitFloat(Hash32(h ^ 0x68E31DA4u));
+            lattice.z[i] = HashToUnitFloat(Hash32(h ^ 0xB5297A4Du));
+        }
+        return lattice;
+    }
+
+    // Tileable gradient noise at four x positions of one row (lattice units), about [-1, 1]
+    static Float4 Perlin(const PerlinLattice& lattice, Float4 x, float y, float z) {
+        static const float kGradients[12][3] = {{1, 1, 0}, {-1, 1, 0}, {1, -1, 0}, {-1, -1, 0},
+                                                 {1, 0, 1}, {-1, 0, 1}, {1, 0, -1}, {-1, 0, -1},
+                                                 {0, 1, 1}, {0, -1, 1}, {0, 1, -1}, {0, -1, -1}};
+        const int p = lattice.period;
+        const Float4 x0 = Floor(x), fx = x - x0;
+        const float y0 = std::floor(y), z0 = std::floor(z);
+        const float fy = y - y0, fz = z - z0;
+        int32_t ix[4];
+        StoreInt(x0, ix);
+        const Float4 six(6.0f), fifteen(15.0f), ten(10.0f);
+        const Float4 u = fx * fx * fx * (fx * (fx * six - fifteen) + ten);
+        const float v = fy * fy * fy * (fy * (fy * 6.0f - 15.0f) + 10.0f);
+        const float w = fz * fz * fz * (fz * (fz * 6.0f - 15.0f) + 10.0f);
+        Float4 corner[8];
+        for (int c = 0; c < 8; ++c) {
+            const int dx = c & 1, dy = (c >> 1) & 1, dz = c >> 2;
+            const size_t row = (size_t(Wrap(int(z0) + dz, p)) * size_t(p) + size_t(Wrap(int(y0) + dy, p))) * size_t(p);
+            float gx[4], gy[4], gz[4];
+            for (int l = 0; l < 4; ++l) {
+                const float* g = kGradients[lattice.gradient[row + size_t(Wrap(ix[l] + dx, p))]];
+                gx[l] = g[0];
+                gy[l] = g[1];
+                gz[l] = g[2];
+            }
+            corner[c] = Float4::Load(gx) * (fx - Float4(float(dx))) + Float4::Load(gy) * Float4(fy - float(dy)) +
+                        Float4::Load(gz) * Float4(fz - float(dz));
+        }
+        auto lerp = [](Float4 a, Float4 b, Float4 t) { return a + t * (b - a); };
+        const Float4 vy(v), wz(w);
+        const Float4 y00 = lerp(corner[0], corner[1], u), y10 = lerp(corner[2], corner[3], u);
+        const Float4 y01 = lerp(corner[4], corner[5], u), y11 = lerp(corner[6], corner[7], u);
+        return lerp(lerp(y00, y10, vy), lerp(y01, y11, vy), wz);
+    }
+
+    // Inverted tileable cellular noise (1 at feature points) at four x positions of one row
+    static Float4 Worley(const WorleyLattice& lattice, Float4 x, float y, float z) {
+        const int p = lattice.period;
+        const Float4 x0 = Floor(x), fx = x - x0;
+        const float y0 = std::floor(y), z0 = std::floor(z);
+        const Float4 fy(y - y0), fz(z - z0);
+        int32_t ix[4];
+        StoreInt(x0, ix);
+        Float4 best(1.0f);
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                const size_t row =
+                    (size_t(Wrap(int(z0) + dz, p)) * size_t(p) + size_t(Wrap(int(y0) + dy, p))) * size_t(p);
+                for (int dx = -1; dx <= 1; ++dx) {
+                    float px[4], py[4], pz[4];
+                    for (int l = 0; l < 4; ++l) {
+                        const size_t cell = row + size_t(Wrap(ix[l] + dx, p));
+                        px[l] = float(dx) + lattice.x[cell];
+                        py[l] = float(dy) + lattice.y[cell];
+                        pz[l] = float(dz) + lattice.z[cell];
+                    }
+                    const Float4 ddx = Float4::Load(px) - fx, ddy = Float4::Load(py) - fy;
+                    const Float4 ddz = Float4::Load(pz) - fz;
+                    best = Min(best, ddx * ddx + ddy * ddy + ddz * ddz);
+                }
+            }
+        }
+        return Float4(1.0f) - Sqrt(best);
+    }
+
+    // Worley fBm over three octaves starting at lattice index first
+    static Float4 WorleyFbm(const Float4* octave, int first) {
+        return Float4(0.625f) * octave[first] + Float4(0.25f) * octave[first + 1] +
+               Float4(0.125f) * octave[first + 2];
+    }
+
+    static void StoreBytes(Float4 value, uint8_t* out, size_t stride) {
+        int32_t bytes[4];
+        StoreInt(Min(Float4(255.0f), Max(Float4(0.0f), value * Float4(255.0f) + Float4(0.5f))), bytes);
+        for (int l = 0; l < 4; ++l) {
+            out[size_t(l) * stride] = uint8_t(bytes[l]);
+        }
+    }
+
+    void Generate(JobSystem* jobs) {
+        // Worley frequencies f, 2f, ... 16f for the shape and f ... 8f for detail
+        std::vector<WorleyLattice> shapeWorley, detailWorley;
+        for (int o = 0; o < 5; ++o) {
+            shapeWorley.push_back(MakeWorley(options_.shapeFrequency << o, HashCombine(options_.seed, 100u + uint32_t(o))));
+        }
+        for (int o = 0; o < 4; ++o) {
+            detailWorley.push_back(MakeWorley(options_.detailFrequency << o, HashCombine(options_.seed, 200u + uint32_t(o))));
+        }
+        std::vector<PerlinLattice> shapePerlin, weatherPerlin;
+        for (int o = 0; o < options_.perlinOctaves; ++o) {
+            shapePerlin.push_back(MakePerlin(options_.shapeFrequency << o, HashCombine(options_.seed, 300u + uint32_t(o))));
+            weatherPerlin.push_back(MakePerlin(options_.weatherFrequency << o, HashCombine(options_.seed, 400u + uint32_t(o))));
+        }
+
+        shape_.size = options_.shapeSize;
+        detail_.size = options_.detailSize;
+        shape_.texels.resize(VolumeBytes(shape_.size));
+        detail_.texels.resize(VolumeBytes(detail_.size));
+        const size_t weatherPixels = size_t(options_.weatherSize) * size_t(options_.weatherSize);
+        weatherBase_.resize(weatherPixels * 2);
+
+        const size_t shapeSlices = size_t(shape_.size), detailSlices = size_t(detail_.size);
+        const size_t weatherRows = size_t(options_.weatherSize);
+        auto work = [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; ++s) {
+                if (s < shapeSlices) {
+                    ShapeSlice(shapePerlin, shapeWorley, int(s));
+                } else if (s < shapeSlices + detailSlices) {
+                    DetailSlice(detailWorley, int(s - shapeSlices));
+                } else {
+                    WeatherRow(weatherPerlin, int(s - shapeSlices - detailSlices));
+                }
+            }
+        };
+        const size_t total = shapeSlices + detailSlices + weatherRows;
+        if (jobs) {
+            jobs->ParallelFor(0, total, 1, work);
+        } else {
+            work(0, total);
+        }
+    }
+
+    void ShapeSlice(const std::vector<PerlinLattice>& perlin, const std::vector<WorleyLattice>& worley, int z) {
+        const int n = shape_.size;
+        const Float4 lane(0.5f, 1.5f, 2.5f, 3.5f);
+        const float inv = 1.0f / float(n);
+        for (int y = 0; y < n; ++y) {
+            uint8_t* row = shape_.texels.data() + (size_t(z) * size_t(n) + size_t(y)) * size_t(n) * 4;
+            for (int x = 0; x < n; x += 4) {
+                const Float4 t = (Float4(float(x)) + lane) * Float4(inv);
+                const float ty = (float(y) + 0.5f) * inv, tz = (float(z) + 0.5f) * inv;
+                Float4 octave[5];
+                for (size_t o = 0; o < worley.size(); ++o) {
+                    const float f = float(worley[o].period);
+                    octave[o] = Worley(worley[o], t * Float4(f), ty * f, tz * f);
+                }
+                Float4 fbm(0.0f), amplitude(1.0f), total(0.0f);
+                for (const PerlinLattice& lattice : perlin) {
+                    const float f = float(lattice.period);
+                    fbm = fbm + amplitude * Perlin(lattice, t * Float4(f), ty * f, tz * f);
+                    total = total + amplitude;
+                    amplitude = amplitude * Float4(0.5f);
+                }
+                const Float4 one(1.0f), zero(0.0f);
+                const Float4 p = Float4(0.5f) + Float4(0.5f) * fbm / total;
+                const Float4 g = WorleyFbm(octave, 0);
+                // Perlin-Worley: remap Perlin from [worley - 1, 1] to [0, 1]
+                const Float4 r = Min(one, Max(zero, (p - g + one) / (Float4(2.0f) - g)));
+                StoreBytes(r, row + size_t(x) * 4, 4);
+                StoreBytes(g, row + size_t(x) * 4 + 1, 4);
+                StoreBytes(WorleyFbm(octave, 1), row + size_t(x) * 4 + 2, 4);
+                StoreBytes(WorleyFbm(octave, 2), row + size_t(x) * 4 + 3, 4);
+            }
+        }
+    }
+
+    void DetailSlice(const std::vector<WorleyLattice>& worley, int z) {
+        const int n = detail_.size;
+        const Float4 lane(0.5f, 1.5f, 2.5f, 3.5f);
+        const float inv = 1.0f / float(n);
+        for (int y = 0; y < n; ++y) {
+            uint8_t* row = detail_.texels.data() + (size_t(z) * size_t(n) + size_t(y)) * size_t(n) * 4;
+            for (int x = 0; x < n; x += 4) {
+                const Float4 t = (Float4(float(x)) + lane) * Float4(inv);
+                const float ty = (float(y) + 0.5f) * inv, tz = (float(z) + 0.5f) * inv;
+                Float4 octave[4];
+                for (size_t o = 0; o < worley.size(); ++o) {
+                    const float f = float(worley[o].period);
+                    octave[o] = Worley(worley[o], t * Float4(f), ty * f, tz * f);
+                }
+                const Float4 r = WorleyFbm(octave, 0), g = WorleyFbm(octave, 1);
+                const Float4 b = Float4(0.75f) * octave[2] + Float4(0.25f) * octave[3];
+                StoreBytes(r, row + size_t(x) * 4, 4);
+                StoreBytes(g, row + size_t(x) * 4 + 1, 4);
+                StoreBytes(b, row + size_t(x) * 4 + 2, 4);
+                StoreBytes(Float4(0.625f) * r + Float4(0.25f) * g + Float4(0.125f) * b, row + size_t(x) * 4 + 3, 4);
+            }
+        }
+    }
+
+    // Two base noise planes: coverage (Perlin fBm) and type variation (one octave, other seed slice)
+    void WeatherRow(const std::vector<PerlinLattice>& perlin, int y) {
+        const int n = options_.weatherSize;
+        const size_t pixels = size_t(n) * size_t(n);
+        const Float4 lane(0.5f, 1.5f, 2.5f, 3.5f);
+        const float inv = 1.0f / float(n);
+        uint8_t* coverage = weatherBase_.data() + size_t(y) * size_t(n);
+        uint8_t* variation = coverage + pixels;
+        for (int x = 0; x < n; x += 4) {
+            const Float4 t = (Float4(float(x)) + lane) * Float4(inv);
+            const float ty = (float(y) + 0.5f) * inv;
+            Float4 fbm(0.0f), amplitude(1.0f), total(0.0f);
+            for (const PerlinLattice& lattice : perlin) {
+                const float f = float(lattice.period);
+                fbm = fbm + amplitude * Perlin(lattice, t * Float4(f), ty * f, 0.0f);
+                total = total + amplitude;
+                amplitude = amplitude * Float4(0.5f);
+            }
+            // Gradient noise is exactly 0 on lattice planes, so sample the type between them
+            const float f = float(perlin[0].period);
+            const Float4 type = Perlin(perlin[0], t * Float4(f), ty * f, 0.5f);
+            StoreBytes(Float4(0.5f) + Float4(0.9f) * fbm / total, coverage + x, 1);
+            StoreBytes(Float4(0.5f) + Float4(0.9f) * type, variation + x, 1);
+        }
+    }
+
+    // Rebuild the weather map from the base noise and per-pixel targets
+    template <typename Targets>
+    void RemapWeather(JobSystem* jobs, Targets&& targets) {
+        const size_t n = size_t(options_.weatherSize);
+        const size_t pixels = n * n;
+        if (weatherBase_.size() < pixels * 2) {
+            return;
+        }
+        auto rows = [&](size_t begin, size_t end) {
+            const Float4 inv255(1.0f / 255.0f), one(1.0f), zero(0.0f), half(0.5f);
+            for (size_t i = begin; i < end; ++i) {
+                const uint8_t* base = weatherBase_.data() + i * n;
+                const uint8_t* variation = base + pixels;
+                uint8_t* out = weatherMap_.data() + i * n * 4;
+                for (size_t j = 0; j < n; j += 4) {
+                    Float4 coverage, precipitation, type;
+                    targets(i, j, coverage, precipitation, type);
+                    const Float4 noise = Float4(float(base[j]), float(base[j + 1]), float(base[j + 2]),
+                                                float(base[j + 3])) * inv255;
+                    const Float4 vary = Float4(float(variation[j]), float(variation[j + 1]),
+                                               float(variation[j + 2]), float(variation[j + 3])) * inv255;
+                    // Coverage c keeps noise above 1 - 2c, so 0 is empty sky and 1 is solid overcast
+                    const Float4 cover = Min(one, Max(zero, Float4(2.0f) * (noise + coverage + coverage - one)));
+                    StoreBytes(cover, out + j * 4, 4);
+                    StoreBytes(precipitation * cover, out + j * 4 + 1, 4);
+                    StoreBytes(Min(one, Max(zero, type + Float4(0.4f) * (vary - half))), out + j * 4 + 2, 4);
+                    for (int l = 0; l < 4; ++l) {
+                        out[(j + size_t(l)) * 4 + 3] = 255;
+                    }
+                }
+            }
+        };
+        if (jobs && n >= 64) {
+            jobs->ParallelFor(0, n, 16, rows);
+        } else {
+            rows(0, n);
+        }
+    }
+
+    static size_t VolumeBytes(int size) { return size_t(size) * size_t(size) * size_t(size) * 4; }
+
+    size_t RawSize() const {
+        return VolumeBytes(options_.shapeSize) + VolumeBytes(options_.detailSize) +
+               size_t(options_.weatherSize) * size_t(options_.weatherSize) * 2;
+    }
+
+    // Channels are split into planes before compressing; neighbors in one channel correlate
+    void Store(StorageManager& storage) {
+        std::vector<uint8_t> planar(RawSize());
+        uint8_t* out = planar.data();
+        for (const Volume* volume : {&shape_, &detail_}) {
+            const size_t texels = volume->texels.size() / 4;
+            for (size_t c = 0; c < 4; ++c) {
+                for (size_t i = 0; i < texels; ++i) {
+                    *out++ = volume->texels[i * 4 + c];
+                }
+            }
+        }
+        std::memcpy(out, weatherBase_.data(), weatherBase_.size());
+
+        Header header;
+        header.rawSize = uint32_t(planar.size());
+        std::vector<uint8_t> blob(sizeof(header) + Compression::CompressBound(planar.size()));
+        const size_t compressed = Compression::Compress(planar.data(), planar.size(), blob.data() + sizeof(header));
+        if (compressed < planar.size()) {
+            header.flags = kFlagCompressed;
+            blob.resize(sizeof(header) + compressed);
+        } else {
+            std::memcpy(blob.data() + sizeof(header), planar.data(), planar.size());
+            blob.resize(sizeof(header) + planar.size());
+        }
+        std::memcpy(blob.data(), &header, sizeof(header));
+        storage.Write(GetKey(), blob.data(), blob.size(), StorageManager::Priority::Low);
+        storedBytes_ = blob.size();
+    }
+
+    bool Load(StorageManager& storage) {
+        storedBytes_ = 0;
+        const std::string key = GetKey();
+        const size_t size = storage.GetSize(key);
+        if (size < sizeof(Header)) {
+            return false;
+        }
+        std::vector<uint8_t> blob(size);
+        if (storage.Read(key, blob.data(), size) != size) {
+            return false;
+        }
+        Header header;
+        std::memcpy(&header, blob.data(), sizeof(header));
+        const size_t raw = RawSize();
+        if (header.magic != kMagic || header.version != kVersion || header.rawSize != raw) {
+            return false;
+        }
+        std::vector<uint8_t> planar(raw);
+        const uint8_t* payload = blob.data() + sizeof(header);
+        const size_t payloadSize = size - sizeof(header);
+        if (header.flags & kFlagCompressed) {
+            if (Compression::Decompress(payload, payloadSize, planar.data(), raw) != raw) {
+                return false;
+            }
+        } else if (payloadSize == raw) {
+            std::memcpy(planar.data(), payload, raw);
+        } else {
+            return false;
+        }
+
+        const uint8_t* in = planar.data();
+        shape_.size = options_.shapeSize;
+        detail_.size = options_.detailSize;
+        for (Volume* volume : {&shape_, &detail_}) {
+            volume->texels.resize(VolumeBytes(volume->size));
+            const size_t texels = volume->texels.size() / 4;
+            for (size_t c = 0; c < 4; ++c) {
+                for (size_t i = 0; i < texels; ++i) {
+                    volume->texels[i * 4 + c] = *in++;
+                }
+            }
+        }
+        weatherBase_.assign(in, static_cast<const uint8_t*>(planar.data() + raw));
+        return true;
+    }
+
+    Options options_;
+    Volume shape_;
+    Volume detail_;
+    std::vector<uint8_t> weatherBase_;  // Coverage noise plane, then type variation plane
+    std::vector<uint8_t> weatherMap_;
+    std::vector<float> columnTargets_;  // Per atmosphere column: coverage, precipitation, type
+    bool loaded_ = false;
+    size_t storedBytes_ = 0;
+};
+
+} // namespace NRE
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <core/JobSystem.h>
+#include <core/Random.h>
+#include <nature/EcosystemSimulation.h>
+#include <nature/EcosystemState.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Time-lapse plant simulation for pre-aging worlds at generation time
+ *
+ * Advances PlantColumns by years at a time: growth uses the closed-form
+ * solution of logistic height growth, reproduction and seed dispersal are
+ * batched per species, and crowding comes from a coarse occupancy grid.
+ * There are no rendering, audio, or per-entity object hooks.
+ */
+class EcosystemFastForward {
+public:
+    struct Options {
+        float minStepYears = 1.0f / 12.0f;
+        float maxStepYears = 5.0f;
+        float maxPopulationChange = 0.1f;   // Max births per step as fraction of population
+        float lifeCycleFraction = 0.25f;    // Max step as fraction of shortest maturity/lifespan
+        float cellSize = 10.0f;             // Crowding grid resolution (meters)
+        float backgroundMortality = 0.01f;  // Fraction dying per year regardless of age
+        float worldMin[2] = {0.0f, 0.0f};   // X/Z bounds for dispersal
+        float worldMax[2] = {1000.0f, 1000.0f};
+        uint64_t seed = 1;
+        std::function<float(float x, float z)> groundHeight;  // Optional; parent Y otherwise
+    };
+
+    struct Stats {
+        int steps = 0;
+        int births = 0;
+        int deaths = 0;
+        float simulatedYears = 0.0f;
+    };
+
+    /**
+     * @brief Create fast-forward simulator
+     * @param config Ecosystem configuration (environment and population cap)
+     * @param species Species table indexed by SpeciesId
+     * @param jobs Optional job system for parallel growth passes
+     */
+    EcosystemFastForward(const EcosystemSimulation::Config& config,
+                         std::vector<SpeciesTraits> species,
+                         JobSystem* jobs = nullptr)
+        : config_(config), species_(std::move(species)), jobs_(jobs),
+          environment_(EnvironmentFactor(config)) {}
+
+    /**
+     * @brief Simulate plants forward with adaptive steps
+     * @param plants Plant columns (modified in place)
+     * @param years In-game years to simulate
+     * @param options Step and world options
+     * @return Simulation statistics
+     */
+    Stats Run(PlantColumns& plants, float years, const Options& options) {
+        Stats stats;
+        Random rng(options.seed);
+        lastTurnover_ = -1.0;
+        plants.Reserve(size_t(std::max(0, config_.maxPlants)));
+        while (stats.simulatedYears < years) {
+            float dt = ChooseStep(plants, options);
+            dt = std::min(dt, years - stats.simulatedYears);
+            const int turnover = stats.births + stats.deaths;
+            Step(plants, dt, options, rng, stats);
+            lastTurnover_ = double(stats.births + stats.deaths - turnover) / dt;
+            stats.simulatedYears += dt;
+            ++stats.steps;
+        }
+        return stats;
+    }
+
+    /**
+     * @brief Environmental suitability derived from the config (0-1)
+     */
+    float GetEnvironmentFactor() const { return environment_; }
+
+    /**
+     * @brief Growth suitability of temperature, rainfall and sunlight (0-1)
+     */
+    static float EnvironmentFactor(const EcosystemSimulation::Config& config) {
+        const float temp = (config.baseTemperature - 20.0f) / 15.0f;
+        const float warmth = std::exp(-temp * temp);
+        const float water = std::min(1.0f, config.rainfall / 800.0f);
+        const float light = std::min(1.0f, config.sunlightHours / 10.0f);
+        return warmth * water * light;
+    }
+
+    /**
+     * @brief Closed-form logistic height after dt years
+     */
+    static float LogisticHeight(float h, float maxHeight, float rate, float dt) {
+        h = std::max(h, 1e-4f);
+        return maxHeight / (1.0f + (maxHeight / h - 1.0f) * std::exp(-rate * dt));
+    }
+
+private:
+    float ChooseStep(const PlantColumns& plants, const Options& options) const {
+        double fecundity = 0.0;
+        float lifeCycle = options.maxStepYears / options.lifeCycleFraction;
+        const size_t n = plants.Size();
+        for (size_t i = 0; i < n; ++i) {
+            const SpeciesTraits& s = species_[plants.species[i]];
+            lifeCycle = std::min(lifeCycle, std::min(s.maturityAge, s.lifespan));
+            if (plants.age[i] >= s.maturityAge) {
+                fecundity += s.seedsPerYear * plants.health[i];
+            }
+        }
+        // Once established, seedling survival is limited by crowding, so the
+        // realized turnover of the previous step is a better rate estimate
+        const double rate = lastTurnover_ >= 0.0 ? std::min(fecundity, lastTurnover_) : fecundity;
+        float dt = std::min(options.maxStepYears, lifeCycle * options.lifeCycleFraction);
+        if (rate > 0.0) {
+            const double budget = options.maxPopulationChange * std::max<double>(double(n), 100.0);
+            dt = std::min(dt, float(budget / rate));
+        }
+        return std::max(dt, options.minStepYears);
+    }
+
+    void BuildGrid(const PlantColumns& plants, const Options& options) {
+        gridW_ = std::max(1, int(std::ceil((options.worldMax[0] - options.worldMin[0]) / options.cellSize)));
+        gridH_ = std::max(1, int(std::ceil((options.worldMax[1] - options.worldMin[1]) / options.cellSize)));
+        occupancy_.assign(size_t(gridW_) * gridH_, 0.0f);
+        const float invCellArea = 1.0f / (options.cellSize * options.cellSize);
+        const size_t n = plants.Size();
+        for (size_t i = 0; i < n; ++i) {
+            const SpeciesTraits& s = species_[plants.species[i]];
+            const float r = s.canopyRadius * plants.height[i] / s.maxHeight;
+            occupancy_[CellIndex(plants.x[i], plants.z[i], options)] += 3.14159265f * r * r * invCellArea;
+        }
+    }
+
+    size_t CellIndex(float x, float z, const Options& options) const {
+        int cx = int((x - options.worldMin[0]) / options.cellSize);
+        int cz = int((z - options.worldMin[1]) / options.cellSize);
+        cx = std::clamp(cx, 0, gridW_ - 1);
+        cz = std::clamp(cz, 0, gridH_ - 1);
+        return size_t(cz) * gridW_ + cx;
+    }
+
+    void Step(PlantColumns& plants, float dt, const Options& options, Random& rng, Stats& stats) {
+        BuildGrid(plants, options);
+        const size_t n = plants.Size();
+        alive_.assign(n, 1);
+        const uint32_t stepSeed = HashCombine(uint32_t(options.seed), uint32_t(stats.steps));
+
+        auto grow = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const SpeciesTraits& s = species_[plants.species[i]];
+                const float crowding = occupancy_[CellIndex(plants.x[i], plants.z[i], options)];
+                const float shade = crowding > 1.0f ? 1.0f / crowding : 1.0f;
+                const float health = environment_ * shade;
+                plants.health[i] = health;
+                plants.height[i] = LogisticHeight(plants.height[i], s.maxHeight, s.growthRate * health, dt);
+                plants.age[i] += dt;
+
+                // Self-thinning favours the tallest plants in crowded cells
+                float deathRate = options.backgroundMortality;
+                if (crowding > 1.0f) {
+                    deathRate += (1.0f - shade) * (1.0f - plants.height[i] / s.maxHeight);
+                }
+                const float pDeath = 1.0f - std::exp(-deathRate * dt);
+                const float roll = HashToUnitFloat(HashCombine(stepSeed, uint32_t(i)));
+                if (plants.age[i] > s.lifespan || roll < pDeath) {
+                    alive_[i] = 0;
+                }
+            }
+        };
+        if (jobs_) {
+            jobs_->ParallelFor(0, n, 4096, grow);
+        } else {
+            grow(0, n);
+        }
+
+        Reproduce(plants, dt, options, rng, stats);
+        Compact(plants, stats);
+    }
+
+    void Reproduce(PlantColumns& plants, float dt, const Options& options, Random& rng, Stats& stats) {
+        parents_.resize(species_.size());
+        for (auto& list : parents_) {
+            list.clear();
+        }
+        const size_t n = plants.Size();
+        for (size_t i = 0; i < n; ++i) {
+            if (alive_[i] && plants.age[i] >= species_[plants.species[i]].maturityAge) {
+                parents_[plants.species[i]].push_back(uint32_t(i));
+            }
+        }
+
+        const size_t cap = size_t(std::max(0, config_.maxPlants));
+        for (size_t sid = 0; sid < species_.size(); ++sid) {
+            const auto& list = parents_[sid];
+            if (list.empty()) {
+                continue;
+            }
+            const SpeciesTraits& s = species_[sid];
+            const float expected = float(list.size()) * s.seedsPerYear * environment_ * dt;
+            const uint32_t seeds = rng.Poisson(expected);
+            for (uint32_t k = 0; k < seeds && plants.Size() < cap; ++k) {
+                const uint32_t parent = list[rng.Below(uint32_t(list.size()))];
+                const float px = plants.x[parent] + rng.Gaussian() * s.dispersalRadius;
+                const float pz = plants.z[parent] + rng.Gaussian() * s.dispersalRadius;
+                if (px < options.worldMin[0] || px >= options.worldMax[0] ||
+                    pz < options.worldMin[1] || pz >= options.worldMax[1]) {
+                    continue;
+                }
+                float& cell = occupancy_[CellIndex(px, pz, options)];
+                if (rng.NextFloat() < cell) {
+                    continue;  // Failed to establish under the canopy
+                }
+                const float age = rng.NextFloat() * dt;
+                const float h = LogisticHeight(0.01f * s.maxHeight, s.maxHeight, s.growthRate * environment_, age);
+                const float py = options.groundHeight ? options.groundHeight(px, pz) : plants.y[parent];
+                plants.Push(SpeciesId(sid), px, py, pz, h, age);
+                plants.health.back() = environment_;
+                alive_.push_back(1);
+                const float r = s.canopyRadius * h / s.maxHeight;
+                cell += 3.14159265f * r * r / (options.cellSize * options.cellSize);
+                ++stats.births;
+            }
+        }
+    }
+
+    void Compact(PlantColumns& plants, Stats& stats) {
+        const size_t n = plants.Size();
+        size_t out = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (!alive_[i]) {
+                continue;
+            }
+            if (out != i) {
+                plants.x[out] = plants.x[i];
+                plants.y[out] = plants.y[i];
+                plants.z[out] = plants.z[i];
+                plants.height[out] = plants.height[i];
+                plants.age[out] = plants.age[i];
+                plants.health[out] = plants.health[i];
+                plants.species[out] = plants.species[i];
+            }
+            ++out;
+        }
+        stats.deaths += int(n - out);
+        plants.x.resize(out);
+        plants.y.resize(out);
+        plants.z.resize(out);
+        plants.height.resize(out);
+        plants.age.resize(out);
+        plants.health.resize(out);
+        plants.species.resize(out);
+    }
+
+    EcosystemSimulation::Config config_;
+    std::vector<SpeciesTraits> species_;
+    JobSystem* jobs_ = nullptr;
+    float environment_ = 1.0f;
+    double lastTurnover_ = -1.0;
+
+    int gridW_ = 1;
+    int gridH_ = 1;
+    std::vector<float> occupancy_;
+    std::vector<uint8_t> alive_;
+    std::vector<std::vector<uint32_t>> parents_;
+};
+
+} // namespace NRE
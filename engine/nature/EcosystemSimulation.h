@@ -1,12 +1,43 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <vector>
-<string>
+#include <string>
 #include <functional>
 
+#include <nature/EntityPool.h>
+#include <nature/PopulationIndex.h>
+
 namespace NRE {
 
+class EcosystemSnapshotWriter;
+class EcosystemSnapshotReader;
+
+/**
+ * @brief Ecosystem configuration (EcosystemSimulation::Config)
+ *
+ * Create() defaults to Config{}, and a nested struct with default member
+ * initializers cannot be used that way before its enclosing class is
+ * complete, so the struct lives at namespace scope behind an alias.
+ */
+struct EcosystemConfig {
+    // Simulation parameters
+    float timeScale = 1.0f;         // Speed multiplier
+    bool enablePlantGrowth = true;
+    bool enableAnimalBehavior = true;
+    bool enablePredatorPreyDynamics = true;
+    
+    // Population limits
+    int maxPlants = 100000;
+    int maxAnimals = 10000;
+    
+    // Environmental factors
+    float baseTemperature = 20.0f;  // Celsius
+    float rainfall = 1000.0f;       // mm per year
+    float sunlightHours = 12.0f;    // Average hours per day
+};
+
 /**
  * @brief Ecosystem simulation with living flora and fauna
  * 
@@ -131,22 +162,13 @@ public:
         virtual void GetPosition(float& x, float& y, float& z) const = 0;
     };
 
-    struct Config {
-        // Simulation parameters
-        float timeScale = 1.0f;         // Speed multiplier
-        bool enablePlantGrowth = true;
-        bool enableAnimalBehavior = true;
-        bool enablePredatorPreyDynamics = true;
-        
-        // Population limits
-        int maxPlants = 100000;
-        int maxAnimals = 10000;
-        
-        // Environmental factors
-        float baseTemperature = 20.0f;  // Celsius
-        float rainfall = 1000.0f;       // mm per year
-        float sunlightHours = 12.0f;    // Average hours per day
-    };
+    using Config = EcosystemConfig;
+
+    /**
+     * @brief Generational handles to pooled entities (see EntityPool)
+     */
+    using PlantHandle = Handle<Plant>;
+    using AnimalHandle = Handle<Animal>;
 
     virtual ~EcosystemSimulation() = default;
 
@@ -169,6 +191,32 @@ public:
      */
     virtual void Update(float deltaTime) = 0;
 
+    /**
+     * @brief Fast-forward plant life cycles without rendering or audio
+     *
+     * Uses adaptive multi-month steps (see EcosystemFastForward) to pre-age
+     * worlds at generation time instead of calling Update millions of times.
+     * @param years In-game years to simulate
+     */
+    virtual void FastForward(float years) = 0;
+
+    /**
+     * @brief Stage current state for background saving
+     *
+     * Only copies the SoA columns on the calling thread; encoding and
+     * storage writes happen on the writer's worker thread.
+     * @param writer Snapshot writer
+     * @return Snapshot sequence number
+     */
+    virtual uint64_t CaptureSnapshot(EcosystemSnapshotWriter& writer) const = 0;
+
+    /**
+     * @brief Restore state from the last snapshot decoded by reader
+     * @param reader Snapshot reader
+     * @return true if successful
+     */
+    virtual bool RestoreSnapshot(const EcosystemSnapshotReader& reader) = 0;
+
     /**
      * @brief Add plant to ecosystem
      * @param species Species name (e.g., "oak", "grass", "rose")
@@ -189,6 +237,54 @@ public:
      */
     virtual Animal* AddAnimal(const std::string& species, float x, float y, float z) = 0;
 
+    /**
+     * @brief Spawn plant from the species pool
+     * @param species Species name
+     * @param x X position
+     * @param y Y position
+     * @param z Z position
+     * @return Handle to the plant (invalid if the pool is full)
+     */
+    virtual PlantHandle SpawnPlant(const std::string& species, float x, float y, float z) = 0;
+
+    /**
+     * @brief Spawn animal from the species pool
+     * @param species Species name
+     * @param x X position
+     * @param y Y position
+     * @param z Z position
+     * @return Handle to the animal (invalid if the pool is full)
+     */
+    virtual AnimalHandle SpawnAnimal(const std::string& species, float x, float y, float z) = 0;
+
+    /**
+     * @brief Resolve plant handle
+     * @param handle Plant handle
+     * @return Plant pointer, or nullptr if the plant has died
+     */
+    virtual Plant* GetPlant(PlantHandle handle) = 0;
+
+    /**
+     * @brief Resolve animal handle
+     * @param handle Animal handle
+     * @return Animal pointer, or nullptr if the animal has died
+     */
+    virtual Animal* GetAnimal(AnimalHandle handle) = 0;
+
+    /**
+     * @brief Return plant to its species pool (e.g. after Plant::Die)
+     * @param handle Plant handle
+     * @return false if the handle was already stale
+     */
+    virtual bool Despawn(PlantHandle handle) = 0;
+
+    /**
+     * @brief Return animal to its species pool
+     * @param handle Animal handle
+     * @return false if the handle was already stale
+     */
+    virtual bool Despawn(AnimalHandle handle) = 0;
+
     /**
      * @brief Get all animals in ecosystem
      * @return Vector of animal pointers
@@ -201,12 +297,41 @@ public:
      */
     virtual std::vector<Plant*> GetPlants() = 0;
 
+    /**
+     * @brief Register species and intern its name
+     * @param species Species name
+     * @return Compact species id (existing id if already registered)
+     */
+    virtual SpeciesId RegisterSpecies(const std::string& species) = 0;
+
     /**
      * @brief Get population count by species
+     *
+     * Resolves the name through the species registry; per-frame callers
+     * should use the SpeciesId overload.
      * @param species Species name
      * @return Population count
      */
     virtual int GetPopulation(const std::string& species) const = 0;
+
+    /**
+     * @brief Get population count by species id (O(1) counter lookup)
+     * @param species Species id from RegisterSpecies
+     * @return Population count
+     */
+    virtual int GetPopulation(SpeciesId species) const = 0;
+
+    /**
+     * @brief Get incrementally maintained per-species and per-region counters
+     * @return Population index
+     */
+    virtual const PopulationIndex& GetPopulationIndex() const = 0;
+
+    /**
+     * @brief Get population time series for UI graphs
+     * @return Population history ring buffer
+     */
+    virtual const PopulationHistory& GetPopulationHistory() const = 0;
 };
 
 } // namespace NRE
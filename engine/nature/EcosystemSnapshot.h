@@ -0,0 +1,460 @@
+#pragma once
+
+#include <core/Compression.h>
+#include <core/StorageManager.h>
+#include <nature/EcosystemState.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief 64-byte aligned byte buffer that only reallocates when growing
+ */
+class SnapshotBuffer {
+public:
+    static constexpr size_t kAlignment = 64;
+
+    uint8_t* Data() { return data_.get(); }
+    const uint8_t* Data() const { return data_.get(); }
+    size_t Size() const { return size_; }
+
+    void Resize(size_t size) {
+        if (size > capacity_) {
+            const size_t capacity = std::max(size, capacity_ + capacity_ / 2);
+            data_.reset(static_cast<uint8_t*>(::operator new(capacity, std::align_val_t(kAlignment))));
+            capacity_ = capacity;
+        }
+        size_ = size;
+    }
+
+private:
+    struct Deleter {
+        void operator()(uint8_t* p) const { ::operator delete(p, std::align_val_t(kAlignment)); }
+    };
+
+    std::unique_ptr<uint8_t, Deleter> data_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+
+/**
+ * @brief Binary snapshot format for EcosystemSimulation state
+ *
+ * Blob layout: Snapshot::Header, then the LZ-compressed payload. The payload is
+ * a column directory followed by each SoA column as a raw 64-byte aligned
+ * block. Delta snapshots keep the directory as is and XOR each column with
+ * the column of the same id in the previous snapshot, so unchanged columns
+ * compress to almost nothing even when other columns grow or shrink.
+ */
+namespace Snapshot {
+
+constexpr uint32_t kVersion = 2;      // 2: deltas are encoded per column
+constexpr uint32_t kFlagDelta = 1u << 0;
+
+// Column ids: plants occupy 0-15, animals 16-31, in ForEachColumn order
+constexpr uint32_t kPlantColumnBase = 0;
+constexpr uint32_t kAnimalColumnBase = 16;
+
+struct Header {
+    char magic[4] = {'N', 'R', 'E', 'S'};
+    uint32_t version = kVersion;
+    uint32_t flags = 0;
+    uint32_t columnCount = 0;
+    uint64_t sequence = 0;
+    uint64_t baseSequence = 0;      // Snapshot a delta was encoded against
+    uint64_t payloadSize = 0;       // Uncompressed payload bytes
+    uint64_t compressedSize = 0;
+};
+
+struct ColumnEntry {
+    uint32_t id = 0;
+    uint32_t elementSize = 0;
+    uint64_t offset = 0;            // From start of payload, 64-byte aligned
+    uint64_t count = 0;
+};
+
+inline size_t AlignUp(size_t value) {
+    return (value + SnapshotBuffer::kAlignment - 1) & ~(SnapshotBuffer::kAlignment - 1);
+}
+
+/**
+ * @brief Lay out all columns into a payload buffer (plain memcpy per column)
+ * @return Number of columns written
+ */
+inline uint32_t BuildPayload(const PlantColumns& plants, const AnimalColumns& animals, SnapshotBuffer& out) {
+    constexpr uint32_t kColumns = 7 + 10;
+    size_t offset = AlignUp(sizeof(ColumnEntry) * kColumns);
+    ColumnEntry entries[kColumns];
+    uint32_t n = 0;
+
+    auto plan = [&](uint32_t id) {
+        return [&, id](const auto& column) mutable {
+            using T = typename std::decay_t<decltype(column)>::value_type;
+            entries[n] = {id++, uint32_t(sizeof(T)), offset, column.size()};
+            offset = AlignUp(offset + sizeof(T) * column.size());
+            ++n;
+        };
+    };
+    plants.ForEachColumn(plan(kPlantColumnBase));
+    animals.ForEachColumn(plan(kAnimalColumnBase));
+
+    out.Resize(offset);
+    std::memset(out.Data(), 0, AlignUp(sizeof(ColumnEntry) * kColumns));
+    std::memcpy(out.Data(), entries, sizeof(ColumnEntry) * n);
+    uint32_t i = 0;
+    auto copy = [&](const auto& column) {
+        const ColumnEntry& e = entries[i++];
+        const size_t bytes = e.elementSize * e.count;
+        std::memcpy(out.Data() + e.offset, column.data(), bytes);
+        // Zero the alignment padding so deltas and compression stay deterministic
+        const size_t end = (i < n) ? entries[i].offset : out.Size();
+        std::memset(out.Data() + e.offset + bytes, 0, end - e.offset - bytes);
+    };
+    plants.ForEachColumn(copy);
+    animals.ForEachColumn(copy);
+    return n;
+}
+
+/**
+ * @brief Check that a payload's column directory and columns lie inside it
+ * @return false if the directory or any column extends past the payload
+ */
+inline bool ValidateDirectory(const uint8_t* payload, size_t payloadSize, uint32_t columnCount) {
+    if (columnCount > payloadSize / sizeof(ColumnEntry)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < columnCount; ++i) {
+        ColumnEntry e;
+        std::memcpy(&e, payload + i * sizeof(e), sizeof(e));
+        if (e.elementSize == 0 || e.offset % SnapshotBuffer::kAlignment != 0 || e.offset > payloadSize ||
+            e.count > (payloadSize - e.offset) / e.elementSize) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief XOR each column of target with the matching column of base
+ *
+ * Columns are matched by id and element size; only the bytes both columns
+ * have are XORed, the rest of a grown column is left raw. Applying it
+ * twice with the same base is the identity, so it both encodes and decodes
+ * deltas. Both directories must already be validated.
+ */
+inline void XorColumns(uint8_t* target, uint32_t targetColumns, const uint8_t* base, uint32_t baseColumns) {
+    for (uint32_t i = 0; i < targetColumns; ++i) {
+        ColumnEntry t;
+        std::memcpy(&t, target + i * sizeof(t), sizeof(t));
+        for (uint32_t j = 0; j < baseColumns; ++j) {
+            ColumnEntry b;
+            std::memcpy(&b, base + j * sizeof(b), sizeof(b));
+            if (b.id != t.id || b.elementSize != t.elementSize) {
+                continue;
+            }
+            const size_t bytes = size_t(std::min(t.count, b.count)) * t.elementSize;
+            uint8_t* d = target + t.offset;
+            const uint8_t* p = base + b.offset;
+            for (size_t k = 0; k < bytes; ++k) {
+                d[k] ^= p[k];
+            }
+            break;
+        }
+    }
+}
+
+} // namespace Snapshot
+
+/**
+ * @brief Background snapshot writer
+ *
+ * Capture() copies the columns into a staging buffer on the calling thread
+ * (a few memcpys, no encoding). A worker thread then delta-encodes against
+ * the last written snapshot, compresses, and hands the blob to the sink, so
+ * Update never waits on encoding or I/O. If a capture arrives while the
+ * previous one is still queued, the newer state replaces it.
+ */
+class EcosystemSnapshotWriter {
+public:
+    using Sink = std::function<void(const uint8_t* data, size_t size, uint64_t sequence)>;
+
+    /**
+     * @brief Create writer
+     * @param sink Receives each encoded blob (called on the worker thread)
+     * @param keyframeInterval Write a full snapshot every N captures
+     */
+    explicit EcosystemSnapshotWriter(Sink sink, int keyframeInterval = 30)
+        : sink_(std::move(sink)), keyframeInterval_(std::max(1, keyframeInterval)) {
+        worker_ = std::thread([this] { WorkerLoop(); });
+    }
+
+    ~EcosystemSnapshotWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        worker_.join();
+    }
+
+    EcosystemSnapshotWriter(const EcosystemSnapshotWriter&) = delete;
+    EcosystemSnapshotWriter& operator=(const EcosystemSnapshotWriter&) = delete;
+
+    /**
+     * @brief Stage current state for writing (main thread cost: column copies)
+     * @return Sequence number assigned to this snapshot
+     */
+    uint64_t Capture(const PlantColumns& plants, const AnimalColumns& animals) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pendingColumns_ = Snapshot::BuildPayload(plants, animals, pending_);
+        pendingSequence_ = ++sequence_;
+        hasPending_ = true;
+        wake_.notify_one();
+        return pendingSequence_;
+    }
+
+    /**
+     * @brief Block until every captured snapshot has been written
+     */
+    void Flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return !hasPending_ && !busy_; });
+    }
+
+    /**
+     * @brief Sink that stores blobs through StorageManager as "<prefix>.<sequence>"
+     *
+     * Only the chain needed to restore the latest state is kept: once a
+     * keyframe is written successfully, the previous keyframe and its deltas
+     * are deleted, so storage holds at most keyframeInterval blobs.
+     */
+    static Sink ToStorage(StorageManager& storage, const std::string& keyPrefix) {
+        auto chain = std::make_shared<std::vector<std::string>>();
+        return [&storage, keyPrefix, chain](const uint8_t* data, size_t size, uint64_t sequence) {
+            Snapshot::Header header;
+            std::memcpy(&header, data, std::min(size, sizeof(header)));
+            const std::string key = keyPrefix + "." + std::to_string(sequence);
+            if (!storage.Write(key, data, size, StorageManager::Priority::Critical)) {
+                return;
+            }
+            if ((header.flags & Snapshot::kFlagDelta) == 0) {
+                for (const std::string& superseded : *chain) {
+                    storage.Delete(superseded);
+                }
+                chain->clear();
+            }
+            chain->push_back(key);
+        };
+    }
+
+private:
+    void WorkerLoop() {
+        for (;;) {
+            uint64_t sequence;
+            uint32_t columns;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this] { return stopping_ || hasPending_; });
+                if (!hasPending_) {
+                    return;
+                }
+                std::swap(pending_, working_);
+                sequence = pendingSequence_;
+                columns = pendingColumns_;
+                hasPending_ = false;
+                busy_ = true;
+            }
+
+            Encode(sequence, columns);
+            sink_(blob_.data(), blob_.size(), sequence);
+            std::swap(previous_, working_);
+            previousSequence_ = sequence;
+            previousColumns_ = columns;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                busy_ = false;
+            }
+            idle_.notify_all();
+        }
+    }
+
+    void Encode(uint64_t sequence, uint32_t columns) {
+        Snapshot::Header header;
+        header.columnCount = columns;
+        header.sequence = sequence;
+        header.payloadSize = working_.Size();
+
+        const uint8_t* payload = working_.Data();
+        const bool keyframe = previousSequence_ == 0 || ++sinceKeyframe_ >= keyframeInterval_;
+        if (!keyframe) {
+            header.flags |= Snapshot::kFlagDelta;
+            header.baseSequence = previousSequence_;
+            delta_.Resize(working_.Size());
+            std::memcpy(delta_.Data(), working_.Data(), working_.Size());
+            Snapshot::XorColumns(delta_.Data(), columns, previous_.Data(), previousColumns_);
+            payload = delta_.Data();
+        } else {
+            sinceKeyframe_ = 0;
+        }
+
+        blob_.resize(sizeof(header) + Compression::CompressBound(working_.Size()));
+        header.compressedSize = Compression::Compress(payload, working_.Size(), blob_.data() + sizeof(header));
+        std::memcpy(blob_.data(), &header, sizeof(header));
+        blob_.resize(sizeof(header) + header.compressedSize);
+    }
+
+    Sink sink_;
+    int keyframeInterval_;
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    bool stopping_ = false;
+    bool hasPending_ = false;
+    bool busy_ = false;
+
+    SnapshotBuffer pending_;
+    uint32_t pendingColumns_ = 0;
+    uint64_t pendingSequence_ = 0;
+    uint64_t sequence_ = 0;
+
+    // Worker-owned
+    SnapshotBuffer working_;
+    SnapshotBuffer previous_;
+    SnapshotBuffer delta_;
+    std::vector<uint8_t> blob_;
+    uint64_t previousSequence_ = 0;
+    uint32_t previousColumns_ = 0;
+    int sinceKeyframe_ = 0;
+};
+
+/**
+ * @brief Decodes snapshot blobs and exposes columns in place
+ *
+ * Decode a keyframe, then each following delta in order. Column() returns
+ * pointers directly into the decoded, aligned payload (no per-entity work).
+ */
+class EcosystemSnapshotReader {
+public:
+    /**
+     * @brief Decode a blob produced by EcosystemSnapshotWriter
+     * @return false if malformed (including a payload size the blob cannot
+     *         hold and directory entries that point past the payload) or a
+     *         delta whose base was not the last decode
+     */
+    bool Decode(const uint8_t* blob, size_t size) {
+        Snapshot::Header header;
+        if (size < sizeof(header)) {
+            return false;
+        }
+        std::memcpy(&header, blob, sizeof(header));
+        if (std::memcmp(header.magic, "NRES", 4) != 0 || header.version != Snapshot::kVersion ||
+            header.compressedSize != size - sizeof(header) ||
+            header.payloadSize > Compression::DecompressBound(header.compressedSize)) {
+            return false;
+        }
+        const bool delta = (header.flags & Snapshot::kFlagDelta) != 0;
+        if (delta && (sequence_ == 0 || header.baseSequence != sequence_)) {
+            return false;
+        }
+
+        decoded_.Resize(header.payloadSize);
+        const size_t n = Compression::Decompress(blob + sizeof(header), header.compressedSize,
+                                                 decoded_.Data(), decoded_.Size());
+        if (n != header.payloadSize) {
+            return false;
+        }
+        if (!Snapshot::ValidateDirectory(decoded_.Data(), decoded_.Size(), header.columnCount)) {
+            return false;
+        }
+        if (delta) {
+            Snapshot::XorColumns(decoded_.Data(), header.columnCount, payload_.Data(), columnCount_);
+        }
+        std::swap(decoded_, payload_);
+        sequence_ = header.sequence;
+        columnCount_ = header.columnCount;
+        return true;
+    }
+
+    uint64_t GetSequence() const { return sequence_; }
+
+    /**
+     * @brief Get pointer to a column inside the decoded payload
+     * @param id Column id (Snapshot::kPlantColumnBase/kAnimalColumnBase + index)
+     * @param count Output element count
+     * @return Column data, or nullptr if missing or of a different element size
+     */
+    template <typename T>
+    const T* Column(uint32_t id, size_t& count) const {
+        for (uint32_t i = 0; i < columnCount_; ++i) {
+            Snapshot::ColumnEntry e;
+            std::memcpy(&e, payload_.Data() + i * sizeof(e), sizeof(e));
+            if (e.id == id && e.elementSize == sizeof(T)) {
+                count = size_t(e.count);
+                return reinterpret_cast<const T*>(payload_.Data() + e.offset);
+            }
+        }
+        count = 0;
+        return nullptr;
+    }
+
+    /**
+     * @brief Copy decoded columns back into simulation storage
+     * @return false (storage untouched) if any column is missing or mismatched,
+     *         or if the columns of one population disagree on its size
+     */
+    bool Restore(PlantColumns& plants, AnimalColumns& animals) const {
+        bool ok = true;
+        auto check = [&](uint32_t id) {
+            return [&, id, first = id, expected = size_t(0)](const auto& column) mutable {
+                using T = typename std::decay_t<decltype(column)>::value_type;
+                size_t count = 0;
+                ok = ok && Column<T>(id, count) != nullptr;
+                expected = id == first ? count : expected;
+                ok = ok && count == expected;
+                ++id;
+            };
+        };
+        plants.ForEachColumn(check(Snapshot::kPlantColumnBase));
+        animals.ForEachColumn(check(Snapshot::kAnimalColumnBase));
+        if (!ok) {
+            return false;
+        }
+
+        auto restore = [&](uint32_t id) {
+            return [&, id](auto& column) mutable {
+                using T = typename std::decay_t<decltype(column)>::value_type;
+                size_t count = 0;
+                const T* data = Column<T>(id++, count);
+                column.assign(data, data + count);
+            };
+        };
+        plants.ForEachColumn(restore(Snapshot::kPlantColumnBase));
+        animals.ForEachColumn(restore(Snapshot::kAnimalColumnBase));
+        ++animals.structureVersion;
+        return true;
+    }
+
+private:
+    SnapshotBuffer payload_;
+    SnapshotBuffer decoded_;
+    uint64_t sequence_ = 0;
+    uint32_t columnCount_ = 0;
+};
+
+} // namespace NRE
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Compact species identifier (index into the species table)
+ */
+using SpeciesId = uint16_t;
+
+constexpr SpeciesId kInvalidSpecies = 0xFFFF;
+
+/**
+ * @brief Per-species life-history parameters used by bulk plant simulation
+ */
+struct SpeciesTraits {
+    std::string name = "grass";
+    float maxHeight = 0.5f;         // Asymptotic height (meters)
+    float growthRate = 1.0f;        // Logistic growth rate (per year)
+    float maturityAge = 1.0f;       // Years before producing seeds
+    float lifespan = 5.0f;          // Maximum age (years)
+    float seedsPerYear = 2.0f;      // Established seedlings per mature plant per year
+    float dispersalRadius = 2.0f;   // Std. deviation of seed travel (meters)
+    float canopyRadius = 0.2f;      // Crown radius at max height (meters)
+};
+
+/**
+ * @brief Per-species behaviour parameters used by bulk animal simulation
+ */
+struct AnimalTraits {
+    std::string name = "deer";
+    float speed = 3.0f;             // Wander speed (m/s)
+    float fleeSpeed = 10.0f;        // Speed when afraid (m/s)
+    float hungerRate = 0.05f;       // Hunger gained per second
+    float thirstRate = 0.08f;       // Thirst gained per second
+    float senseRadius = 30.0f;      // Predator detection radius (meters)
+    bool isPredator = false;
+};
+
+/**
+ * @brief Structure-of-arrays storage for plants
+ *
+ * Hot per-plant data is kept in parallel columns so bulk passes touch only
+ * the fields they need. Ages are in years (Plant::State::age is in days).
+ */
+struct PlantColumns {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> height;
+    std::vector<float> age;
+    std::vector<float> health;
+    std::vector<SpeciesId> species;
+
+    size_t Size() const { return x.size(); }
+
+    template <typename Fn>
+    void ForEachColumn(Fn&& fn) {
+        fn(x);
+        fn(y);
+        fn(z);
+        fn(height);
+        fn(age);
+        fn(health);
+        fn(species);
+    }
+
+    template <typename Fn>
+    void ForEachColumn(Fn&& fn) const {
+        fn(x);
+        fn(y);
+        fn(z);
+        fn(height);
+        fn(age);
+        fn(health);
+        fn(species);
+    }
+
+    void Reserve(size_t count) {
+        x.reserve(count);
+        y.reserve(count);
+        z.reserve(count);
+        height.reserve(count);
+        age.reserve(count);
+        health.reserve(count);
+        species.reserve(count);
+    }
+
+    void Clear() {
+        x.clear();
+        y.clear();
+        z.clear();
+        height.clear();
+        age.clear();
+        health.clear();
+        species.clear();
+    }
+
+    void Push(SpeciesId id, float px, float py, float pz, float h = 0.05f, float a = 0.0f) {
+        x.push_back(px);
+        y.push_back(py);
+        z.push_back(pz);
+        height.push_back(h);
+        age.push_back(a);
+        health.push_back(1.0f);
+        species.push_back(id);
+    }
+
+    /**
+     * @brief Remove plant by moving the last plant into its slot
+     */
+    void SwapRemove(size_t i) {
+        const size_t last = Size() - 1;
+        x[i] = x[last];
+        y[i] = y[last];
+        z[i] = z[last];
+        height[i] = height[last];
+        age[i] = age[last];
+        health[i] = health[last];
+        species[i] = species[last];
+        x.pop_back();
+        y.pop_back();
+        z.pop_back();
+        height.pop_back();
+        age.pop_back();
+        health.pop_back();
+        species.pop_back();
+    }
+};
+
+/**
+ * @brief Structure-of-arrays storage for animals
+ *
+ * Mirrors EcosystemSimulation::Animal::Needs so bulk passes (needs decay,
+ * movement, snapshots) can run over contiguous columns.
+ */
+struct AnimalColumns {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> velocityX;
+    std::vector<float> velocityZ;
+    std::vector<float> hunger;
+    std::vector<float> thirst;
+    std::vector<float> energy;
+    std::vector<float> fear;
+    std::vector<SpeciesId> species;
+
+    // Bumped whenever animals are added, removed or reordered, so caches keyed
+    // by slot (e.g. EcosystemStepper's region table) know to rebuild
+    uint64_t structureVersion = 0;
+
+    size_t Size() const { return x.size(); }
+
+    template <typename Fn>
+    void ForEachColumn(Fn&& fn) {
+        fn(x);
+        fn(y);
+        fn(z);
+        fn(velocityX);
+        fn(velocityZ);
+        fn(hunger);
+        fn(thirst);
+        fn(energy);
+        fn(fear);
+        fn(species);
+    }
+
+    template <typename Fn>
+    void ForEachColumn(Fn&& fn) const {
+        fn(x);
+        fn(y);
+        fn(z);
+        fn(velocityX);
+        fn(velocityZ);
+        fn(hunger);
+        fn(thirst);
+        fn(energy);
+        fn(fear);
+        fn(species);
+    }
+
+    void Reserve(size_t count) {
+        ForEachColumn([count](auto& column) { column.reserve(count); });
+    }
+
+    void Clear() {
+        ForEachColumn([](auto& column) { column.clear(); });
+        ++structureVersion;
+    }
+
+    void Push(SpeciesId id, float px, float py, float pz) {
+        ++structureVersion;
+        x.push_back(px);
+        y.push_back(py);
+        z.push_back(pz);
+        velocityX.push_back(0.0f);
+        velocityZ.push_back(0.0f);
+        hunger.push_back(0.0f);
+        thirst.push_back(0.0f);
+        energy.push_back(100.0f);
+        fear.push_back(0.0f);
+        species.push_back(id);
+    }
+
+    /**
+     * @brief Remove animal by moving the last animal into its slot
+     */
+    void SwapRemove(size_t i) {
+        ForEachColumn([i](auto& column) {
+            column[i] = column.back();
+            column.pop_back();
+        });
+        ++structureVersion;
+    }
+};
+
+} // namespace NRE
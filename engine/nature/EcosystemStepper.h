@@ -0,0 +1,244 @@
+#pragma once
+
+#include <core/JobSystem.h>
+#include <core/Random.h>
+#include <nature/EcosystemFastForward.h>
+#include <nature/EcosystemSimulation.h>
+#include <nature/EcosystemState.h>
+#include <nature/PopulationIndex.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Headless real-time ecosystem tick over SoA columns
+ *
+ * One Step() advances plant growth, animal needs, predator avoidance
+ * (through a uniform grid of predators), and movement, in parallel over
+ * the JobSystem. Region counters in the PopulationIndex are kept in sync.
+ */
+class EcosystemStepper {
+public:
+    struct Options {
+        float worldMin[2] = {0.0f, 0.0f};
+        float worldMax[2] = {1000.0f, 1000.0f};
+    };
+
+    /**
+     * @brief Create stepper
+     * @param config Ecosystem configuration (timeScale and environment)
+     * @param plantSpecies Plant species table indexed by SpeciesId
+     * @param animalSpecies Animal species table indexed by SpeciesId
+     * @param options World bounds
+     * @param jobs Optional job system for parallel passes
+     * @param index Optional population index to keep region counts current
+     */
+    EcosystemStepper(const EcosystemSimulation::Config& config,
+                     std::vector<SpeciesTraits> plantSpecies,
+                     std::vector<AnimalTraits> animalSpecies,
+                     const Options& options,
+                     JobSystem* jobs = nullptr,
+                     PopulationIndex* index = nullptr)
+        : config_(config),
+          plantSpecies_(std::move(plantSpecies)),
+          animalSpecies_(std::move(animalSpecies)),
+          options_(options),
+          jobs_(jobs),
+          index_(index) {
+        cellSize_ = 1.0f;
+        for (const auto& s : animalSpecies_) {
+            cellSize_ = std::max(cellSize_, s.senseRadius);
+        }
+        gridW_ = std::max(1, int(std::ceil((options_.worldMax[0] - options_.worldMin[0]) / cellSize_)));
+        gridH_ = std::max(1, int(std::ceil((options_.worldMax[1] - options_.worldMin[1]) / cellSize_)));
+        environment_ = EcosystemFastForward::EnvironmentFactor(config_);
+    }
+
+    /**
+     * @brief Advance simulation by one frame
+     * @param plants Plant columns
+     * @param animals Animal columns
+     * @param deltaTime Time since last update (seconds, scaled by Config::timeScale)
+     */
+    void Step(PlantColumns& plants, AnimalColumns& animals, float deltaTime) {
+        const float dt = deltaTime * config_.timeScale;
+        ++frame_;
+        if (config_.enablePlantGrowth) {
+            StepPlants(plants, dt);
+        }
+        if (config_.enableAnimalBehavior) {
+            StepAnimals(animals, dt);
+        }
+    }
+
+    /**
+     * @brief Scratch memory owned by the stepper (bytes)
+     */
+    size_t GetScratchBytes() const {
+        return cellStart_.capacity() * sizeof(uint32_t) + cellItems_.capacity() * sizeof(PredatorEntry) +
+               regions_.capacity() * sizeof(int) + newRegions_.capacity() * sizeof(int);
+    }
+
+private:
+    struct PredatorEntry {
+        float x;
+        float z;
+    };
+
+    void StepPlants(PlantColumns& plants, float dt) {
+        const float years = dt / (365.0f * 86400.0f);
+        Run(plants.Size(), 8192, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const SpeciesTraits& s = plantSpecies_[plants.species[i]];
+                const float rate = s.growthRate * environment_ * plants.health[i];
+                plants.height[i] = EcosystemFastForward::LogisticHeight(plants.height[i], s.maxHeight, rate, years);
+                plants.age[i] += years;
+            }
+        });
+    }
+
+    // Predator positions are copied so prey never read positions being written this step
+    void BuildPredatorGrid(const AnimalColumns& animals) {
+        const size_t cells = size_t(gridW_) * gridH_;
+        cellStart_.assign(cells + 1, 0);
+        const size_t n = animals.Size();
+        for (size_t i = 0; i < n; ++i) {
+            if (animalSpecies_[animals.species[i]].isPredator) {
+                ++cellStart_[Cell(animals.x[i], animals.z[i]) + 1];
+            }
+        }
+        for (size_t c = 0; c < cells; ++c) {
+            cellStart_[c + 1] += cellStart_[c];
+        }
+        cellItems_.resize(cellStart_[cells]);
+        cursor_.assign(cellStart_.begin(), cellStart_.end() - 1);
+        for (size_t i = 0; i < n; ++i) {
+            if (animalSpecies_[animals.species[i]].isPredator) {
+                cellItems_[cursor_[Cell(animals.x[i], animals.z[i])]++] = {animals.x[i], animals.z[i]};
+            }
+        }
+    }
+
+    void StepAnimals(AnimalColumns& animals, float dt) {
+        const size_t n = animals.Size();
+        BuildPredatorGrid(animals);
+        if (index_ && (regionsVersion_ != animals.structureVersion || regions_.size() != n)) {
+            regions_.resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                regions_[i] = index_->RegionOf(animals.x[i], animals.z[i]);
+            }
+            regionsVersion_ = animals.structureVersion;
+        }
+        newRegions_.resize(index_ ? n : 0);
+
+        Run(n, 1024, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                UpdateAnimal(animals, i, dt);
+            }
+        });
+
+        if (index_) {
+            for (size_t i = 0; i < n; ++i) {
+                index_->OnRegionChange(animals.species[i], regions_[i], newRegions_[i]);
+            }
+            std::swap(regions_, newRegions_);
+        }
+    }
+
+    void UpdateAnimal(AnimalColumns& a, size_t i, float dt) {
+        const AnimalTraits& s = animalSpecies_[a.species[i]];
+        a.hunger[i] = std::min(100.0f, a.hunger[i] + s.hungerRate * dt);
+        a.thirst[i] = std::min(100.0f, a.thirst[i] + s.thirstRate * dt);
+
+        float fleeX = 0.0f;
+        float fleeZ = 0.0f;
+        float nearest = s.senseRadius * s.senseRadius;
+        if (!s.isPredator && config_.enablePredatorPreyDynamics) {
+            const int cx = CellX(a.x[i]);
+            const int cz = CellZ(a.z[i]);
+            for (int z = std::max(0, cz - 1); z <= std::min(gridH_ - 1, cz + 1); ++z) {
+                for (int x = std::max(0, cx - 1); x <= std::min(gridW_ - 1, cx + 1); ++x) {
+                    const size_t c = size_t(z) * gridW_ + x;
+                    for (uint32_t k = cellStart_[c]; k < cellStart_[c + 1]; ++k) {
+                        const float dx = a.x[i] - cellItems_[k].x;
+                        const float dz = a.z[i] - cellItems_[k].z;
+                        const float d2 = dx * dx + dz * dz;
+                        if (d2 < nearest) {
+                            nearest = d2;
+                            fleeX = dx;
+                            fleeZ = dz;
+                        }
+                    }
+                }
+            }
+        }
+
+        float vx;
+        float vz;
+        if (fleeX != 0.0f || fleeZ != 0.0f) {
+            const float d = std::sqrt(nearest);
+            a.fear[i] = 100.0f * (1.0f - d / s.senseRadius);
+            a.energy[i] = std::max(0.0f, a.energy[i] - 2.0f * dt);
+            vx = fleeX / d * s.fleeSpeed;
+            vz = fleeZ / d * s.fleeSpeed;
+        } else {
+            a.fear[i] = std::max(0.0f, a.fear[i] - 20.0f * dt);
+            a.energy[i] = std::min(100.0f, a.energy[i] + 0.5f * dt);
+            // Wander: change heading a few times a minute, per-animal and thread independent
+            const uint32_t h = HashCombine(uint32_t(i), uint32_t(frame_ / 120));
+            const float heading = HashToUnitFloat(h) * 6.28318530718f;
+            vx = std::cos(heading) * s.speed;
+            vz = std::sin(heading) * s.speed;
+        }
+        a.velocityX[i] = vx;
+        a.velocityZ[i] = vz;
+        a.x[i] = std::clamp(a.x[i] + vx * dt, options_.worldMin[0], options_.worldMax[0]);
+        a.z[i] = std::clamp(a.z[i] + vz * dt, options_.worldMin[1], options_.worldMax[1]);
+        if (index_) {
+            newRegions_[i] = index_->RegionOf(a.x[i], a.z[i]);
+        }
+    }
+
+    template <typename Fn>
+    void Run(size_t count, size_t grain, Fn&& fn) {
+        if (jobs_) {
+            jobs_->ParallelFor(0, count, grain, fn);
+        } else {
+            fn(size_t(0), count);
+        }
+    }
+
+    int CellX(float x) const {
+        return std::clamp(int((x - options_.worldMin[0]) / cellSize_), 0, gridW_ - 1);
+    }
+    int CellZ(float z) const {
+        return std::clamp(int((z - options_.worldMin[1]) / cellSize_), 0, gridH_ - 1);
+    }
+    size_t Cell(float x, float z) const { return size_t(CellZ(z)) * gridW_ + CellX(x); }
+
+    EcosystemSimulation::Config config_;
+    std::vector<SpeciesTraits> plantSpecies_;
+    std::vector<AnimalTraits> animalSpecies_;
+    Options options_;
+    JobSystem* jobs_ = nullptr;
+    PopulationIndex* index_ = nullptr;
+    float environment_ = 1.0f;
+    uint64_t frame_ = 0;
+
+    float cellSize_ = 1.0f;
+    int gridW_ = 1;
+    int gridH_ = 1;
+    std::vector<uint32_t> cellStart_;
+    std::vector<PredatorEntry> cellItems_;
+    std::vector<uint32_t> cursor_;
+    std::vector<int> regions_;        // Region of each animal slot as of regionsVersion_
+    std::vector<int> newRegions_;
+    uint64_t regionsVersion_ = ~uint64_t(0);
+};
+
+} // namespace NRE
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <nature/EcosystemState.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Generational handle to a pooled entity
+ *
+ * A handle stays valid until its entity is despawned; after that, lookups
+ * return nullptr even if the slot has been reused by a later spawn.
+ */
+template <typename Tag>
+struct Handle {
+    uint32_t index = 0xFFFFFFFFu;
+    uint16_t generation = 0;
+    SpeciesId species = kInvalidSpecies;
+
+    bool IsValid() const { return index != 0xFFFFFFFFu; }
+
+    bool operator==(const Handle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const Handle& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Fixed-capacity entity storage with per-species free lists
+ *
+ * All slots are allocated once at construction, so Spawn/Despawn never touch
+ * the global allocator. Despawned slots go to a free list for their species,
+ * which keeps same-species entities close together. A slot is reused by
+ * another species only when the pool is otherwise full.
+ *
+ * @tparam T Concrete entity type stored in the pool
+ * @tparam Base Type the handles refer to (e.g. EcosystemSimulation::Plant)
+ */
+template <typename T, typename Base = T>
+class EntityPool {
+public:
+    using HandleType = Handle<Base>;
+
+    /**
+     * @brief Create pool
+     * @param capacity Maximum number of live entities
+     * @param speciesCount Number of species free lists to preallocate
+     */
+    explicit EntityPool(size_t capacity, size_t speciesCount = 16)
+        : capacity_(capacity),
+          slots_(new Slot[capacity]),
+          generation_(capacity, 0),
+          species_(capacity, kInvalidSpecies),
+          next_(capacity, kNone),
+          freeHead_(speciesCount, kNone) {}
+
+    ~EntityPool() { Clear(); }
+
+    EntityPool(const EntityPool&) = delete;
+    EntityPool& operator=(const EntityPool&) = delete;
+
+    /**
+     * @brief Construct an entity in a pooled slot
+     * @param species Species the entity belongs to
+     * @param args Constructor arguments for T
+     * @return Handle to the entity, or an invalid handle if the pool is full or
+     *         species is kInvalidSpecies (which marks free slots)
+     */
+    template <typename... Args>
+    HandleType Spawn(SpeciesId species, Args&&... args) {
+        if (species == kInvalidSpecies) {
+            return HandleType{};
+        }
+        const uint32_t index = AcquireSlot(species);
+        if (index == kNone) {
+            return HandleType{};
+        }
+        new (slots_[index].storage) T(std::forward<Args>(args)...);
+        species_[index] = species;
+        ++size_;
+        return HandleType{index, generation_[index], species};
+    }
+
+    /**
+     * @brief Destroy entity and return its slot to the species free list
+     * @param handle Entity handle
+     * @return false if the handle was already stale
+     */
+    bool Despawn(HandleType handle) {
+        if (!IsAlive(handle)) {
+            return false;
+        }
+        const uint32_t index = handle.index;
+        Ptr(index)->~T();
+#ifndef NDEBUG
+        std::memset(slots_[index].storage, 0xDD, sizeof(T));
+#endif
+        const SpeciesId species = species_[index];
+        species_[index] = kInvalidSpecies;
+        ++generation_[index];
+        EnsureSpecies(species);
+        next_[index] = freeHead_[species];
+        freeHead_[species] = index;
+        --size_;
+        return true;
+    }
+
+    /**
+     * @brief Resolve handle
+     * @return Entity pointer, or nullptr if the handle is stale
+     */
+    T* Get(HandleType handle) { return IsAlive(handle) ? Ptr(handle.index) : nullptr; }
+    const T* Get(HandleType handle) const { return IsAlive(handle) ? Ptr(handle.index) : nullptr; }
+
+    /**
+     * @brief Check whether handle still refers to a live entity
+     */
+    bool IsAlive(HandleType handle) const {
+        return handle.index < highWater_ &&
+               species_[handle.index] != kInvalidSpecies &&
+               generation_[handle.index] == handle.generation;
+    }
+
+    /**
+     * @brief Check whether a raw pointer refers to a live entity in this pool
+     *
+     * Detects dangling pointers to despawned entities until the slot is
+     * reused; hold handles rather than pointers across frames.
+     */
+    bool IsAlive(const Base* ptr) const {
+        const uint32_t index = IndexOf(ptr);
+        return index != kNone && species_[index] != kInvalidSpecies;
+    }
+
+    /**
+     * @brief Get handle for a live entity pointer
+     * @return Handle, or an invalid handle if ptr is not a live entity
+     */
+    HandleType HandleOf(const Base* ptr) const {
+        const uint32_t index = IndexOf(ptr);
+        if (index == kNone || species_[index] == kInvalidSpecies) {
+            return HandleType{};
+        }
+        return HandleType{index, generation_[index], species_[index]};
+    }
+
+    /**
+     * @brief Call fn(T&) for every live entity
+     */
+    template <typename Fn>
+    void ForEach(Fn&& fn) {
+        for (uint32_t i = 0; i < highWater_; ++i) {
+            if (species_[i] != kInvalidSpecies) {
+                fn(*Ptr(i));
+            }
+        }
+    }
+
+    /**
+     * @brief Destroy all entities (invalidates every outstanding handle)
+     */
+    void Clear() {
+        for (uint32_t i = 0; i < highWater_; ++i) {
+            if (species_[i] != kInvalidSpecies) {
+                Ptr(i)->~T();
+                species_[i] = kInvalidSpecies;
+            }
+            ++generation_[i];
+            next_[i] = kNone;
+        }
+        std::fill(freeHead_.begin(), freeHead_.end(), kNone);
+        highWater_ = 0;
+        size_ = 0;
+    }
+
+    size_t Size() const { return size_; }
+    size_t Capacity() const { return capacity_; }
+
+private:
+    static constexpr uint32_t kNone = 0xFFFFFFFFu;
+
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    T* Ptr(uint32_t index) { return std::launder(reinterpret_cast<T*>(slots_[index].storage)); }
+    const T* Ptr(uint32_t index) const {
+        return std::launder(reinterpret_cast<const T*>(slots_[index].storage));
+    }
+
+    uint32_t IndexOf(const Base* ptr) const {
+        if (!ptr) {
+            return kNone;
+        }
+        // Entities are only ever stored as T, so this cast recovers the slot address
+        const auto* object = reinterpret_cast<const unsigned char*>(static_cast<const T*>(ptr));
+        const auto* first = reinterpret_cast<const unsigned char*>(slots_.get());
+        if (object < first || object >= first + sizeof(Slot) * highWater_) {
+            return kNone;
+        }
+        const size_t offset = size_t(object - first);
+        return offset % sizeof(Slot) == 0 ? uint32_t(offset / sizeof(Slot)) : kNone;
+    }
+
+    void EnsureSpecies(SpeciesId species) {
+        if (species >= freeHead_.size()) {
+            freeHead_.resize(size_t(species) + 1, kNone);  // Once per new species
+        }
+    }
+
+    uint32_t AcquireSlot(SpeciesId species) {
+        EnsureSpecies(species);
+        uint32_t index = freeHead_[species];
+        if (index != kNone) {
+            freeHead_[species] = next_[index];
+            return index;
+        }
+        if (highWater_ < capacity_) {
+            return highWater_++;
+        }
+        for (auto& head : freeHead_) {
+            if (head != kNone) {
+                index = head;
+                head = next_[index];
+                return index;
+            }
+        }
+        return kNone;
+    }
+
+    size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    std::vector<uint16_t> generation_;
+    std::vector<SpeciesId> species_;
+    std::vector<uint32_t> next_;
+    std::vector<uint32_t> freeHead_;
+    uint32_t highWater_ = 0;
+    size_t size_ = 0;
+};
+
+} // namespace NRE
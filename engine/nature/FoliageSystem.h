@@ -0,0 +1,502 @@
+#pragma once
+
+#include <core/JobSystem.h>
+#include <core/Random.h>
+#include <nature/TreeRenderer.h>
+#include <nature/TreeWindSway.h>
+#include <nature/TurtleInterpreter.h>
+#include <renderer/Mesh.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Procedural leaf atlas shared by all foliage
+ *
+ * A square RGBA8 texture split into tilesPerSide x tilesPerSide tiles. The
+ * first half of the tiles hold single leaves (shape variants), the second
+ * half hold clusters of overlapping leaves used by cluster cards and canopy
+ * shells. RGB is an untinted luminance (veins, edge darkening) that the
+ * shader multiplies by the instance's seasonal color; A is coverage.
+ */
+class LeafAtlas {
+public:
+    struct Options {
+        int resolution = 512;
+        int tilesPerSide = 4;          // At least 2, so both halves get a tile
+        int leavesPerCluster = 28;
+        uint32_t seed = 1;
+    };
+
+    /**
+     * @brief Bake the atlas
+     * @param options Atlas options
+     * @param jobs Optional job system (tiles are baked in parallel)
+     */
+    explicit LeafAtlas(const Options& options, JobSystem* jobs = nullptr) : options_(options) {
+        options_.tilesPerSide = std::max(2, options.tilesPerSide);
+        options_.resolution = std::max(options_.tilesPerSide, options.resolution);
+        const size_t res = size_t(options_.resolution);
+        pixels_.assign(res * res * 4, 0);
+        const size_t tiles = size_t(GetTileCount());
+        auto bake = [this](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t) {
+                BakeTile(int(t));
+            }
+        };
+        if (jobs) {
+            jobs->ParallelFor(0, tiles, 1, bake);
+        } else {
+            bake(0, tiles);
+        }
+    }
+
+    int GetTileCount() const { return options_.tilesPerSide * options_.tilesPerSide; }
+    int GetSingleLeafTiles() const { return GetTileCount() / 2; }
+    int GetResolution() const { return options_.resolution; }
+
+    /**
+     * @brief Atlas tile of a single-leaf or cluster variant
+     */
+    int SingleLeafTile(uint32_t variant) const { return int(variant % uint32_t(GetSingleLeafTiles())); }
+    int ClusterTile(uint32_t variant) const {
+        return GetSingleLeafTiles() + int(variant % uint32_t(GetTileCount() - GetSingleLeafTiles()));
+    }
+
+    /**
+     * @brief UV rectangle of a tile
+     * @param tile Tile index
+     * @param uv Output (u0, v0, u1, v1)
+     */
+    void GetTileUV(int tile, float uv[4]) const {
+        const float size = 1.0f / float(options_.tilesPerSide);
+        uv[0] = float(tile % options_.tilesPerSide) * size;
+        uv[1] = float(tile / options_.tilesPerSide) * size;
+        uv[2] = uv[0] + size;
+        uv[3] = uv[1] + size;
+    }
+
+    /**
+     * @brief RGBA8 pixels, row-major
+     */
+    const uint8_t* GetData() const { return pixels_.data(); }
+
+    /**
+     * @brief Fraction of a tile's pixels with nonzero coverage
+     */
+    float GetTileCoverage(int tile) const {
+        const int tileSize = options_.resolution / options_.tilesPerSide;
+        const int x0 = (tile % options_.tilesPerSide) * tileSize;
+        const int y0 = (tile / options_.tilesPerSide) * tileSize;
+        size_t covered = 0;
+        for (int y = y0; y < y0 + tileSize; ++y) {
+            for (int x = x0; x < x0 + tileSize; ++x) {
+                covered += pixels_[(size_t(y) * size_t(options_.resolution) + size_t(x)) * 4 + 3] > 0;
+            }
+        }
+        return float(covered) / float(tileSize * tileSize);
+    }
+
+private:
+    // Signed leaf shape at local (u along the leaf 0..1, v across -1..1): > 0 inside
+    static float LeafShape(float u, float v, float width, float tip) {
+        if (u <= 0.0f || u >= 1.0f) {
+            return -1.0f;
+        }
+        const float halfWidth = width * std::pow(std::sin(3.14159265f * u), tip) * (1.0f - 0.3f * u);
+        return halfWidth - std::fabs(v);
+    }
+
+    // Splat one leaf into a tile (pixel coordinates relative to the tile)
+    void SplatLeaf(int x0, int y0, int tileSize, float cx, float cy, float length, float angle, float width,
+                   float tip, float shade) {
+        const float c = std::cos(angle);
+        const float s = std::sin(angle);
+        const int r = int(std::ceil(length));
+        for (int py = std::max(0, int(cy) - r); py < std::min(tileSize, int(cy) + r + 1); ++py) {
+            for (int px = std::max(0, int(cx) - r); px < std::min(tileSize, int(cx) + r + 1); ++px) {
+                const float dx = float(px) + 0.5f - cx;
+                const float dy = float(py) + 0.5f - cy;
+                const float u = (dx * c + dy * s) / length + 0.5f;
+                const float v = (-dx * s + dy * c) / (0.5f * length);
+                const float inside = LeafShape(u, v, width, tip);
+                if (inside <= 0.0f) {
+                    continue;
+                }
+                // Midrib and side veins darken; the edge darkens slightly
+                const bool midrib = std::fabs(v) < 0.04f;
+                const bool sideVein = std::fabs(std::sin(u * 40.0f + std::fabs(v) * 18.0f)) < 0.12f;
+                const float vein = midrib ? 0.75f : (sideVein ? 0.88f : 1.0f);
+                const float edge = std::min(1.0f, inside * 8.0f);
+                const float lum = shade * vein * (0.8f + 0.2f * edge);
+                uint8_t* p = &pixels_[(size_t(y0 + py) * size_t(options_.resolution) + size_t(x0 + px)) * 4];
+                const uint8_t value = uint8_t(std::clamp(lum, 0.0f, 1.0f) * 255.0f);
+                p[0] = p[1] = p[2] = value;
+                p[3] = 255;
+            }
+        }
+    }
+
+    void BakeTile(int tile) {
+        const int tileSize = options_.resolution / options_.tilesPerSide;
+        const int x0 = (tile % options_.tilesPerSide) * tileSize;
+        const int y0 = (tile / options_.tilesPerSide) * tileSize;
+        Random rng(HashCombine(options_.seed, uint32_t(tile)));
+        const float size = float(tileSize);
+        if (tile < GetSingleLeafTiles()) {
+            // One upright leaf filling the tile
+            const float width = rng.Range(0.25f, 0.5f);
+            const float tip = rng.Range(0.6f, 1.2f);
+            SplatLeaf(x0, y0, tileSize, 0.5f * size, 0.5f * size, 0.9f * size, 1.5707963f, width, tip,
+                      rng.Range(0.85f, 1.0f));
+        } else {
+            const float width = rng.Range(0.3f, 0.45f);
+            for (int i = 0; i < options_.leavesPerCluster; ++i) {
+                const float angle = rng.Range(0.0f, 6.2831853f);
+                const float radius = rng.Range(0.0f, 0.28f) * size;
+                const float cx = 0.5f * size + std::cos(angle) * radius;
+                const float cy = 0.5f * size + std::sin(angle) * radius;
+                SplatLeaf(x0, y0, tileSize, cx, cy, rng.Range(0.3f, 0.45f) * size, angle, width,
+                          rng.Range(0.6f, 1.2f), rng.Range(0.6f, 1.0f));  // Inner leaves are shadowed
+            }
+        }
+    }
+
+    Options options_;
+    std::vector<uint8_t> pixels_;
+};
+
+/**
+ * @brief Foliage representation chosen by distance
+ */
+enum class FoliageLOD {
+    Individual,     // One card per leaf
+    Clusters,       // One crossed card pair per leaf cluster
+    Shell           // Low-poly canopy hull
+};
+
+/**
+ * @brief All foliage LODs of one tree
+ */
+struct FoliageLODSet {
+    Mesh::LODLevel individual;
+    Mesh::LODLevel clusters;
+    Mesh::LODLevel shell;
+    std::vector<uint16_t> individualBones;  // Sway bone per vertex (empty without a rig)
+    std::vector<uint16_t> clusterBones;
+    bool evergreen = false;                 // Keeps its leaves in winter
+
+    const Mesh::LODLevel& Get(FoliageLOD lod) const {
+        return lod == FoliageLOD::Individual ? individual : (lod == FoliageLOD::Clusters ? clusters : shell);
+    }
+};
+
+/**
+ * @brief Foliage generation from tree skeleton leaf points
+ *
+ * Leaves become cards textured from a LeafAtlas, at three levels of detail:
+ * TreeConfig::leafCount individual leaf cards spread around the skeleton's
+ * leaf points, one crossed card pair per grid cluster of leaves, and a
+ * single ellipsoid shell around the canopy. Geometry is season independent:
+ * color and leaf loss come from SeasonColor() driven by a per-instance
+ * season parameter, so SetSeason never rebuilds meshes.
+ */
+class FoliageBuilder {
+public:
+    struct Options {
+        float individualDistance = 20.0f;   // Individual leaves closer than this
+        float clusterDistance = 90.0f;      // Cluster cards closer than this, shell beyond
+        float clusterSize = 1.5f;           // Grid cell (meters) that leaves are clustered in
+        float clusterCardScale = 1.2f;      // Card size relative to the cluster extent
+        int shellRings = 6;
+        int shellSegments = 8;
+    };
+
+    FoliageBuilder(const LeafAtlas& atlas, const Options& options) : atlas_(atlas), options_(options) {}
+
+    /**
+     * @brief Representation to draw at a distance
+     */
+    FoliageLOD SelectLOD(float distance) const {
+        if (distance < options_.individualDistance) {
+            return FoliageLOD::Individual;
+        }
+        return distance < options_.clusterDistance ? FoliageLOD::Clusters : FoliageLOD::Shell;
+    }
+
+    /**
+     * @brief Build foliage for a tree
+     * @param skeleton Skeleton with leaf points
+     * @param config Tree config (leafCount, species, seed)
+     * @param out Output LODs
+     * @param rig Optional sway rig; vertices are tagged with their leaf's bone
+     */
+    void Build(const TreeSkeleton& skeleton, const TreeRendererConfig& config, FoliageLODSet& out,
+               const TreeSwayRig* rig = nullptr) const {
+        out = FoliageLODSet{};
+        out.evergreen = config.species == "pine";
+        out.individual.distance = 0.0f;
+        out.clusters.distance = options_.individualDistance;
+        out.shell.distance = options_.clusterDistance;
+        const auto& leaves = skeleton.leaves;
+        if (!leaves.empty()) {
+            BuildIndividual(leaves, config, out, rig);
+            BuildClusters(leaves, uint32_t(config.seed), out, rig);
+            BuildShell(leaves, out.shell);
+        }
+        for (Mesh::LODLevel* level : {&out.individual, &out.clusters, &out.shell}) {
+            level->triangleCount = int(level->indices.size() / 3);
+        }
+    }
+
+    /**
+     * @brief Seasonal leaf tint and coverage
+     *
+     * Mirrors the foliage shader so CPU-side previews and tests agree.
+     * @param season Continuous season (0 spring, 1 summer, 2 autumn, 3 winter, wraps at 4)
+     * @param evergreen Evergreens keep summer color and full coverage
+     * @param rgb Output tint
+     * @return Coverage in [0, 1] (alpha test threshold = 1 - coverage)
+     */
+    static float SeasonColor(float season, bool evergreen, float rgb[3]) {
+        static const float kColors[4][3] = {
+            {0.45f, 0.70f, 0.25f},  // Spring
+            {0.20f, 0.45f, 0.12f},  // Summer
+            {0.85f, 0.40f, 0.08f},  // Autumn
+            {0.45f, 0.35f, 0.25f},  // Winter
+        };
+        static const float kCoverage[4] = {0.8f, 1.0f, 0.75f, 0.0f};
+        if (evergreen) {
+            std::copy(kColors[1], kColors[1] + 3, rgb);
+            return 1.0f;
+        }
+        const float s = season - 4.0f * std::floor(season * 0.25f);
+        const int a = int(s) & 3;
+        const int b = (a + 1) & 3;
+        const float f = s - std::floor(s);
+        for (int c = 0; c < 3; ++c) {
+            rgb[c] = kColors[a][c] + (kColors[b][c] - kColors[a][c]) * f;
+        }
+        return kCoverage[a] + (kCoverage[b] - kCoverage[a]) * f;
+    }
+
+private:
+    static void Normalize(float v[3]) {
+        const float len = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        if (len > 1e-12f) {
+            v[0] /= len;
+            v[1] /= len;
+            v[2] /= len;
+        }
+    }
+
+    static void Cross(const float a[3], const float b[3], float out[3]) {
+        out[0] = a[1] * b[2] - a[2] * b[1];
+        out[1] = a[2] * b[0] - a[0] * b[2];
+        out[2] = a[0] * b[1] - a[1] * b[0];
+    }
+
+    // Quad with center, half-extent axes and an atlas tile (two triangles)
+    void EmitCard(const float center[3], const float right[3], const float up[3], int tile,
+                  Mesh::LODLevel& level) const {
+        float uv[4];
+        atlas_.GetTileUV(tile, uv);
+        float normal[3];
+        Cross(right, up, normal);
+        Normalize(normal);
+        float tangent[3] = {right[0], right[1], right[2]};
+        float bitangent[3] = {up[0], up[1], up[2]};
+        Normalize(tangent);
+        Normalize(bitangent);
+        const uint32_t base = uint32_t(level.vertices.size());
+        static const float kCorners[4][2] = {{-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}};
+        for (const auto& corner : kCorners) {
+            Mesh::Vertex v;
+            for (int a = 0; a < 3; ++a) {
+                v.position[a] = center[a] + right[a] * corner[0] + up[a] * corner[1];
+                v.normal[a] = normal[a];
+                v.tangent[a] = tangent[a];
+                v.bitangent[a] = bitangent[a];
+            }
+            v.texCoord[0] = corner[0] < 0.0f ? uv[0] : uv[2];
+            v.texCoord[1] = corner[1] < 0.0f ? uv[3] : uv[1];
+            level.vertices.push_back(v);
+        }
+        level.indices.insert(level.indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+    }
+
+    static uint16_t BoneOf(const TreeSwayRig* rig, int32_t segment) {
+        if (!rig || segment < 0 || size_t(segment) >= rig->segmentBone.size()) {
+            return 0;
+        }
+        return rig->segmentBone[size_t(segment)];
+    }
+
+    void BuildIndividual(const std::vector<LeafPoint>& leaves, const TreeRendererConfig& config,
+                         FoliageLODSet& out, const TreeSwayRig* rig) const {
+        const size_t total = size_t(std::max(config.leafCount, 0));
+        out.individual.vertices.reserve(total * 4);
+        out.individual.indices.reserve(total * 6);
+        for (size_t i = 0; i < total; ++i) {
+            const LeafPoint& leaf = leaves[i % leaves.size()];
+            const uint32_t h = HashCombine(uint32_t(config.seed), uint32_t(i));
+            // Scatter around the attachment point, facing mostly up and out
+            float center[3];
+            for (int a = 0; a < 3; ++a) {
+                center[a] = leaf.position[a] +
+                            (HashToUnitFloat(HashCombine(h, uint32_t(a))) - 0.5f) * 4.0f * leaf.size;
+            }
+            float normal[3] = {HashToUnitFloat(HashCombine(h, 3)) - 0.5f, 0.7f,
+                               HashToUnitFloat(HashCombine(h, 4)) - 0.5f};
+            Normalize(normal);
+            float up[3] = {leaf.direction[0], leaf.direction[1], leaf.direction[2]};
+            float right[3];
+            Cross(up, normal, right);
+            if (right[0] * right[0] + right[1] * right[1] + right[2] * right[2] < 1e-6f) {
+                right[0] = 1.0f;
+                right[1] = right[2] = 0.0f;
+            }
+            Normalize(right);
+            Cross(normal, right, up);
+            for (int a = 0; a < 3; ++a) {
+                right[a] *= 0.5f * leaf.size;
+                up[a] *= leaf.size;
+            }
+            EmitCard(center, right, up, atlas_.SingleLeafTile(Hash32(h)), out.individual);
+            if (rig) {
+                out.individualBones.resize(out.individual.vertices.size(), BoneOf(rig, leaf.segment));
+            }
+        }
+    }
+
+    void BuildClusters(const std::vector<LeafPoint>& leaves, uint32_t seed, FoliageLODSet& out,
+                       const TreeSwayRig* rig) const {
+        struct Cluster {
+            float sum[3] = {0.0f, 0.0f, 0.0f};
+            float min[3] = {1e30f, 1e30f, 1e30f};
+            float max[3] = {-1e30f, -1e30f, -1e30f};
+            float leafSize = 0.0f;
+            int32_t segment = -1;
+            uint32_t count = 0;
+        };
+        const float inv = 1.0f / options_.clusterSize;
+        std::unordered_map<uint64_t, uint32_t> cells;
+        std::vector<Cluster> clusters;
+        for (const LeafPoint& leaf : leaves) {
+            const int64_t cx = int64_t(std::floor(leaf.position[0] * inv));
+            const int64_t cy = int64_t(std::floor(leaf.position[1] * inv));
+            const int64_t cz = int64_t(std::floor(leaf.position[2] * inv));
+            const uint64_t key = (uint64_t(cx & 0x1FFFFF) << 42) | (uint64_t(cy & 0x1FFFFF) << 21) |
+                                 uint64_t(cz & 0x1FFFFF);
+            const auto [it, inserted] = cells.emplace(key, uint32_t(clusters.size()));
+            if (inserted) {
+                clusters.emplace_back();
+            }
+            Cluster& c = clusters[it->second];
+            for (int a = 0; a < 3; ++a) {
+                c.sum[a] += leaf.position[a];
+                c.min[a] = std::min(c.min[a], leaf.position[a] - leaf.size);
+                c.max[a] = std::max(c.max[a], leaf.position[a] + leaf.size);
+            }
+            c.leafSize = std::max(c.leafSize, leaf.size);
+            if (c.segment < 0) {
+                c.segment = leaf.segment;
+            }
+            ++c.count;
+        }
+
+        out.clusters.vertices.reserve(clusters.size() * 8);
+        out.clusters.indices.reserve(clusters.size() * 12);
+        for (size_t i = 0; i < clusters.size(); ++i) {
+            const Cluster& c = clusters[i];
+            float center[3];
+            float extent = 2.0f * c.leafSize;
+            for (int a = 0; a < 3; ++a) {
+                center[a] = c.sum[a] / float(c.count);
+                extent = std::max(extent, 0.5f * (c.max[a] - c.min[a]));
+            }
+            extent *= options_.clusterCardScale;
+            // Two vertical cards crossing at a random yaw
+            const uint32_t h = HashCombine(seed, uint32_t(i));
+            const float yaw = HashToUnitFloat(h) * 3.14159265f;
+            const int tile = atlas_.ClusterTile(Hash32(h));
+            for (int card = 0; card < 2; ++card) {
+                const float angle = yaw + float(card) * 1.5707963f;
+                const float right[3] = {std::cos(angle) * extent, 0.0f, std::sin(angle) * extent};
+                const float up[3] = {0.0f, extent, 0.0f};
+                EmitCard(center, right, up, tile, out.clusters);
+            }
+            if (rig) {
+                out.clusterBones.resize(out.clusters.vertices.size(), BoneOf(rig, c.segment));
+            }
+        }
+    }
+
+    // Ellipsoid around the leaf cloud, each face mapped to a full cluster tile
+    void BuildShell(const std::vector<LeafPoint>& leaves, Mesh::LODLevel& level) const {
+        float lo[3] = {1e30f, 1e30f, 1e30f};
+        float hi[3] = {-1e30f, -1e30f, -1e30f};
+        for (const LeafPoint& leaf : leaves) {
+            for (int a = 0; a < 3; ++a) {
+                lo[a] = std::min(lo[a], leaf.position[a]);
+                hi[a] = std::max(hi[a], leaf.position[a]);
+            }
+        }
+        float center[3];
+        float radius[3];
+        for (int a = 0; a < 3; ++a) {
+            center[a] = 0.5f * (lo[a] + hi[a]);
+            radius[a] = std::max(0.5f * (hi[a] - lo[a]), 0.25f);
+        }
+        float uv[4];
+        atlas_.GetTileUV(atlas_.ClusterTile(0), uv);
+        const int rings = std::max(2, options_.shellRings);
+        const int segments = std::max(3, options_.shellSegments);
+        auto point = [&](int ring, int segment, Mesh::Vertex& v) {
+            const float theta = 3.14159265f * float(ring) / float(rings);
+            const float phi = 6.28318530718f * float(segment) / float(segments);
+            const float n[3] = {std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)};
+            float normal[3];
+            for (int a = 0; a < 3; ++a) {
+                v.position[a] = center[a] + n[a] * radius[a];
+                normal[a] = n[a] / radius[a];
+            }
+            Normalize(normal);
+            std::copy(normal, normal + 3, v.normal);
+            float tangent[3] = {-std::sin(phi), 0.0f, std::cos(phi)};
+            std::copy(tangent, tangent + 3, v.tangent);
+            Cross(normal, tangent, v.bitangent);
+        };
+        for (int r = 0; r < rings; ++r) {
+            for (int s = 0; s < segments; ++s) {
+                const uint32_t base = uint32_t(level.vertices.size());
+                const int corners[4][2] = {{r, s}, {r, s + 1}, {r + 1, s + 1}, {r + 1, s}};
+                for (int k = 0; k < 4; ++k) {
+                    Mesh::Vertex v;
+                    point(corners[k][0], corners[k][1], v);
+                    v.texCoord[0] = (k == 1 || k == 2) ? uv[2] : uv[0];
+                    v.texCoord[1] = k >= 2 ? uv[3] : uv[1];
+                    level.vertices.push_back(v);
+                }
+                if (r == 0) {
+                    level.indices.insert(level.indices.end(), {base, base + 2, base + 3});  // Cap triangle
+                } else if (r == rings - 1) {
+                    level.indices.insert(level.indices.end(), {base, base + 1, base + 2});
+                } else {
+                    level.indices.insert(level.indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+                }
+            }
+        }
+    }
+
+    const LeafAtlas& atlas_;
+    Options options_;
+};
+
+} // namespace NRE
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <core/Simd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Camera-centered grass flattening field
+ *
+ * A square window of cells over the world, stored toroidally: world cell
+ * (i, j) lives at (i mod N, j mod N), so moving the window only clears the
+ * rows and columns that scroll in. FlattenArea stamps into the field, one
+ * Recover() pass relaxes every cell back toward upright, and blades sample
+ * the field in the vertex shader instead of carrying their own state.
+ * Values are flattening amounts in [0, 1].
+ */
+class GrassDeformationField {
+public:
+    struct Options {
+        int resolution = 256;       // Cells per side
+        float cellSize = 0.5f;      // Meters
+        float recoveryRate = 0.1f;  // Amount recovered per second
+    };
+
+    explicit GrassDeformationField(const Options& options)
+        : options_(options),
+          size_(std::max(4, (options.resolution + 3) & ~3)),  // Rows stay Float4 aligned
+          cells_(size_t(size_) * size_, 0.0f) {
+        originX_ = -size_ / 2;
+        originZ_ = -size_ / 2;
+    }
+
+    GrassDeformationField() : GrassDeformationField(Options{}) {}
+
+    /**
+     * @brief Move the window so it is centered on a world position
+     */
+    void Recenter(float x, float z) {
+        const int newX = CellCoord(x) - size_ / 2;
+        const int newZ = CellCoord(z) - size_ / 2;
+        const int dx = newX - originX_;
+        const int dz = newZ - originZ_;
+        if (dx == 0 && dz == 0) {
+            return;
+        }
+        if (std::abs(dx) >= size_ || std::abs(dz) >= size_) {
+            std::fill(cells_.begin(), cells_.end(), 0.0f);
+        } else {
+            // Clear columns and rows entering the window (they held the cells leaving it)
+            const int colBegin = dx > 0 ? originX_ + size_ : newX;
+            for (int i = 0; i < std::abs(dx); ++i) {
+                const int col = Wrap(colBegin + i);
+                for (int row = 0; row < size_; ++row) {
+                    cells_[size_t(row) * size_ + col] = 0.0f;
+                }
+            }
+            const int rowBegin = dz > 0 ? originZ_ + size_ : newZ;
+            for (int i = 0; i < std::abs(dz); ++i) {
+                float* row = &cells_[size_t(Wrap(rowBegin + i)) * size_];
+                std::fill(row, row + size_, 0.0f);
+            }
+        }
+        originX_ = newX;
+        originZ_ = newZ;
+    }
+
+    /**
+     * @brief Flatten grass in a disc (keeps the stronger of old and new)
+     * @param x Center X position
+     * @param z Center Z position
+     * @param radius Radius of effect (meters)
+     * @param amount Flattening at the center (0-1), fading to 0 at the rim
+     */
+    void Stamp(float x, float z, float radius, float amount) {
+        const int cx0 = std::max(CellCoord(x - radius), originX_);
+        const int cx1 = std::min(CellCoord(x + radius), originX_ + size_ - 1);
+        const int cz0 = std::max(CellCoord(z - radius), originZ_);
+        const int cz1 = std::min(CellCoord(z + radius), originZ_ + size_ - 1);
+        const float invRadiusSq = 1.0f / std::max(radius * radius, 1e-6f);
+        for (int cz = cz0; cz <= cz1; ++cz) {
+            const float dz = (float(cz) + 0.5f) * options_.cellSize - z;
+            float* row = &cells_[size_t(Wrap(cz)) * size_];
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                const float dx = (float(cx) + 0.5f) * options_.cellSize - x;
+                const float falloff = 1.0f - (dx * dx + dz * dz) * invRadiusSq;
+                if (falloff > 0.0f) {
+                    float& cell = row[Wrap(cx)];
+                    cell = std::max(cell, std::min(1.0f, amount * falloff));
+                }
+            }
+        }
+        active_ = true;
+    }
+
+    /**
+     * @brief Stamp many footprints with the same radius and amount (e.g. a herd)
+     */
+    void StampMany(const float* x, const float* z, size_t count, float radius, float amount) {
+        for (size_t i = 0; i < count; ++i) {
+            Stamp(x[i], z[i], radius, amount);
+        }
+    }
+
+    /**
+     * @brief Relax all cells toward upright in one pass
+     * @param deltaTime Time since last update (seconds)
+     */
+    void Recover(float deltaTime) {
+        if (!active_) {
+            return;
+        }
+        const Float4 step(options_.recoveryRate * deltaTime);
+        const Float4 zero(0.0f);
+        Float4 any(0.0f);
+        float* data = cells_.data();
+        for (size_t i = 0, n = cells_.size(); i < n; i += 4) {
+            const Float4 v = Max(Float4::Load(data + i) - step, zero);
+            v.Store(data + i);
+            any = Max(any, v);
+        }
+        // Skip the pass entirely once everything has recovered
+        active_ = MoveMask(any > zero) != 0;
+    }
+
+    /**
+     * @brief Bilinear flattening amount at a world position (0 outside the window)
+     */
+    float Sample(float x, float z) const {
+        const float u = x / options_.cellSize - 0.5f;
+        const float v = z / options_.cellSize - 0.5f;
+        const float fu = std::floor(u);
+        const float fv = std::floor(v);
+        const int i = int(fu);
+        const int j = int(fv);
+        const float tx = u - fu;
+        const float tz = v - fv;
+        const float a = Cell(i, j);
+        const float b = Cell(i + 1, j);
+        const float c = Cell(i, j + 1);
+        const float d = Cell(i + 1, j + 1);
+        return (a + (b - a) * tx) + ((c + (d - c) * tx) - (a + (b - a) * tx)) * tz;
+    }
+
+    /**
+     * @brief Raw cells (size x size, toroidally addressed) for texture upload
+     */
+    const float* GetData() const { return cells_.data(); }
+    int GetResolution() const { return size_; }
+    float GetCellSize() const { return options_.cellSize; }
+
+    /**
+     * @brief World cell index of the window's minimum corner
+     *
+     * Shaders address texel ((i mod N), (j mod N)) for world cell (i, j)
+     * and treat cells outside [origin, origin + N) as upright.
+     */
+    void GetOrigin(int& cellX, int& cellZ) const {
+        cellX = originX_;
+        cellZ = originZ_;
+    }
+
+private:
+    int CellCoord(float w) const { return int(std::floor(w / options_.cellSize)); }
+    int Wrap(int i) const { return ((i % size_) + size_) % size_; }
+
+    float Cell(int i, int j) const {
+        if (i < originX_ || i >= originX_ + size_ || j < originZ_ || j >= originZ_ + size_) {
+            return 0.0f;
+        }
+        return cells_[size_t(Wrap(j)) * size_ + Wrap(i)];
+    }
+
+    Options options_;
+    int size_;
+    std::vector<float> cells_;
+    int originX_ = 0;
+    int originZ_ = 0;
+    bool active_ = false;
+};
+
+} // namespace NRE
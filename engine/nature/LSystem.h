@@ -0,0 +1,341 @@
+#pragma once
+
+#include <core/JobSystem.h>
+#include <core/Random.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief One L-system symbol with its parameter
+ *
+ * The hash is derived from the parent module's hash and the child's index
+ * in the successor, so stochastic choices depend only on a module's
+ * ancestry, never on where it lands in the string or how expansion was
+ * split across threads.
+ */
+struct LModule {
+    uint32_t hash;
+    float param;    // Segment length for F/f, angle in degrees for turns (0 = default)
+    char symbol;
+};
+
+/**
+ * @brief Successor symbol of a production
+ *
+ * Child parameter = parent parameter * scale + offset.
+ */
+struct LSuccessorModule {
+    char symbol;
+    float scale = 1.0f;
+    float offset = 0.0f;
+};
+
+/**
+ * @brief Production predecessor -> successor
+ */
+struct LProduction {
+    std::vector<LSuccessorModule> successor;
+    float probability = 1.0f;                               // Relative weight among same-symbol rules that apply
+    float minParam = -std::numeric_limits<float>::max();    // Rule applies only when param >= minParam
+};
+
+/**
+ * @brief Stochastic, parametric L-system with parallel expansion
+ *
+ * Rules are found through a 256-entry table indexed by symbol. Each
+ * iteration first chooses a production for every module and counts its
+ * output length, prefix-sums the counts per block, then writes every block
+ * directly at its final offset, so blocks expand independently on the
+ * JobSystem and the output is allocated exactly once per iteration.
+ *
+ * Successor strings use one character per module with an optional
+ * "(scale)" after it, e.g. "F(0.5)[+F(0.7)]F". Without one, letters
+ * inherit the parent parameter and other symbols get 0 (turns use the
+ * default angle).
+ */
+class LSystem {
+public:
+    struct Stats {
+        size_t modules = 0;       // Output length
+        size_t peakBytes = 0;     // Largest input + output buffer pair
+    };
+
+    LSystem() { lut_.fill(Group{0, 0}); }
+
+    /**
+     * @brief Set axiom; "(x)" after a symbol sets its parameter
+     * @return false (axiom unchanged) if a parameter list is not closed
+     */
+    bool SetAxiom(std::string_view axiom) {
+        std::vector<LModule> modules;
+        if (!Parse(axiom, modules)) {
+            return false;
+        }
+        axiom_ = std::move(modules);
+        return true;
+    }
+
+    /**
+     * @brief Add production
+     * @param predecessor Symbol to rewrite
+     * @param successor Successor string, "(s)" scales the parent parameter
+     * @param probability Relative weight among rules for the same symbol
+     * @param minParam Rule only applies when the parameter is at least this
+     * @return false (rule not added) if a parameter list is not closed
+     */
+    bool AddRule(char predecessor, std::string_view successor, float probability = 1.0f,
+                 float minParam = -std::numeric_limits<float>::max()) {
+        std::vector<LModule> modules;
+        if (!Parse(successor, modules)) {
+            return false;
+        }
+        LProduction production;
+        for (const LModule& m : modules) {
+            production.successor.push_back({m.symbol, m.param, 0.0f});
+        }
+        production.probability = probability;
+        production.minParam = minParam;
+        pending_.push_back({uint8_t(predecessor), std::move(production)});
+        BuildTable();
+        return true;
+    }
+
+    /**
+     * @brief Expand the axiom
+     * @param iterations Number of rewriting steps
+     * @param seed Seed for stochastic rules
+     * @param jobs Optional job system for parallel expansion
+     * @return Expanded module string
+     */
+    std::vector<LModule> Expand(int iterations, uint32_t seed, JobSystem* jobs = nullptr) {
+        std::vector<LModule> current = GetAxiom(seed);
+        std::vector<LModule> next;
+        stats_ = Stats{};
+        for (int it = 0; it < iterations; ++it) {
+            Step(current, next, jobs);
+            stats_.peakBytes = std::max(stats_.peakBytes, (current.capacity() + next.capacity()) * sizeof(LModule));
+            std::swap(current, next);
+        }
+        stats_.modules = current.size();
+        return current;
+    }
+
+    const Stats& GetStats() const { return stats_; }
+
+    /**
+     * @brief Axiom modules with their root hashes for a seed
+     */
+    std::vector<LModule> GetAxiom(uint32_t seed) const {
+        std::vector<LModule> axiom(axiom_);
+        for (size_t i = 0; i < axiom.size(); ++i) {
+            axiom[i].hash = HashCombine(seed, uint32_t(i));
+        }
+        return axiom;
+    }
+
+    /**
+     * @brief Production that rewrites a module
+     * @return Production index, or -1 if the module is copied unchanged
+     */
+    int ChooseProduction(const LModule& m) const {
+        const Group g = lut_[uint8_t(m.symbol)];
+        const int end = g.first + g.count;
+        // Only rules whose condition holds compete, by their weights among themselves
+        float total = 0.0f;
+        int first = -1, last = -1;
+        for (int p = g.first; p < end; ++p) {
+            if (Applies(p, m)) {
+                total += std::max(0.0f, productions_[size_t(p)].probability);
+                first = first < 0 ? p : first;
+                last = p;
+            }
+        }
+        if (first == last || total <= 0.0f) {
+            return first;
+        }
+        float target = HashToUnitFloat(m.hash) * total;
+        for (int p = first; p < last; ++p) {
+            if (Applies(p, m)) {
+                target -= std::max(0.0f, productions_[size_t(p)].probability);
+                if (target < 0.0f) {
+                    return p;
+                }
+            }
+        }
+        return last;
+    }
+
+    const LProduction& GetProduction(int index) const { return productions_[size_t(index)]; }
+
+    /**
+     * @brief Child module c of a rewritten parent
+     */
+    static LModule MakeChild(const LModule& parent, const LSuccessorModule& s, size_t c) {
+        return LModule{HashCombine(parent.hash, uint32_t(c)), parent.param * s.scale + s.offset, s.symbol};
+    }
+
+    float angle = 25.0f;          // Default turn angle (degrees)
+    float lengthFactor = 0.7f;    // Informational: typical child/parent length ratio
+    float thicknessFactor = 0.7f; // Width multiplier for '!'
+
+    /**
+     * @brief Built-in species (oak, pine, willow, birch, maple)
+     *
+     * Unknown names fall back to oak.
+     */
+    static LSystem Preset(const std::string& species) {
+        LSystem l;
+        if (species == "pine") {
+            // Monopodial: straight leader with whorls of shrinking side branches
+            l.angle = 20.0f;
+            l.lengthFactor = 0.8f;
+            l.SetAxiom("A(1)");
+            l.AddRule('A', "F(1)[&B(0.5)]/[&B(0.5)]/[&B(0.5)]A(0.85)", 1.0f, 0.05f);
+            l.AddRule('B', "F(1)[-B(0.6)L][+B(0.6)L]B(0.8)", 1.0f, 0.04f);
+        } else if (species == "willow") {
+            l.angle = 22.5f;
+            l.lengthFactor = 0.6f;
+            l.SetAxiom("F(1)");
+            l.AddRule('F', "F(0.6)[+F(0.6)][-F(0.6)]F(0.6)[&F(0.6)L][^F(0.6)L]", 1.0f, 0.02f);
+        } else if (species == "birch") {
+            l.angle = 18.0f;
+            l.lengthFactor = 0.75f;
+            l.SetAxiom("A(1)");
+            l.AddRule('A', "!F(1)[+A(0.75)L]/A(0.8)", 0.5f, 0.03f);
+            l.AddRule('A', "!F(1)[-A(0.75)L]\\A(0.8)", 0.5f, 0.03f);
+        } else if (species == "maple") {
+            l.angle = 30.0f;
+            l.lengthFactor = 0.7f;
+            l.SetAxiom("A(1)");
+            l.AddRule('A', "!F(1)[&A(0.7)L]/[&A(0.7)L]/A(0.7)", 0.6f, 0.03f);
+            l.AddRule('A', "!F(1)[&A(0.7)L]/A(0.75)", 0.4f, 0.03f);
+        } else {
+            // Oak (matches the classic bracketed form with stochastic variation)
+            l.angle = 25.7f;
+            l.lengthFactor = 0.7f;
+            l.SetAxiom("F(1)");
+            l.AddRule('F', "F(0.5)[+F(0.5)]F(0.5)[-F(0.5)][F(0.5)]", 0.6f);
+            l.AddRule('F', "F(0.5)[+F(0.5)]F(0.5)[-F(0.5)]", 0.2f);
+            l.AddRule('F', "F(0.5)[-F(0.5)]F(0.5)[+F(0.5)]", 0.2f);
+        }
+        return l;
+    }
+
+private:
+    static constexpr size_t kBlock = 16384;
+
+    struct Group {
+        uint16_t first;
+        uint16_t count;  // 0 = symbol is copied unchanged
+    };
+
+    bool Applies(int p, const LModule& m) const { return m.param >= productions_[size_t(p)].minParam; }
+
+    static bool IsLetter(char c) { return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'); }
+
+    static bool Parse(std::string_view text, std::vector<LModule>& out) {
+        for (size_t i = 0; i < text.size(); ++i) {
+            LModule m{0, IsLetter(text[i]) ? 1.0f : 0.0f, text[i]};
+            if (i + 1 < text.size() && text[i + 1] == '(') {
+                const size_t close = text.find(')', i + 2);
+                if (close == std::string_view::npos) {
+                    return false;
+                }
+                const std::string number(text.substr(i + 2, close - i - 2));
+                m.param = std::strtof(number.c_str(), nullptr);
+                i = close;
+            }
+            out.push_back(m);
+        }
+        return true;
+    }
+
+    // Group productions by predecessor so each symbol's alternatives are contiguous
+    void BuildTable() {
+        std::stable_sort(pending_.begin(), pending_.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+        productions_.clear();
+        lut_.fill(Group{0, 0});
+        for (size_t i = 0; i < pending_.size();) {
+            const uint8_t symbol = pending_[i].first;
+            size_t end = i;
+            while (end < pending_.size() && pending_[end].first == symbol) {
+                ++end;
+            }
+            lut_[symbol] = Group{uint16_t(productions_.size()), uint16_t(end - i)};
+            for (; i < end; ++i) {
+                productions_.push_back(pending_[i].second);
+            }
+        }
+    }
+
+    void Step(const std::vector<LModule>& in, std::vector<LModule>& out, JobSystem* jobs) {
+        const size_t n = in.size();
+        const size_t blocks = (n + kBlock - 1) / kBlock;
+        choice_.resize(n);
+        blockStart_.assign(blocks + 1, 0);
+
+        // Pass 1: choose productions and count output per block
+        Run(jobs, blocks, [&](size_t b) {
+            size_t count = 0;
+            for (size_t i = b * kBlock, end = std::min(n, i + kBlock); i < end; ++i) {
+                const int p = ChooseProduction(in[i]);
+                choice_[i] = int16_t(p);
+                count += p < 0 ? 1 : productions_[size_t(p)].successor.size();
+            }
+            blockStart_[b + 1] = count;
+        });
+        for (size_t b = 0; b < blocks; ++b) {
+            blockStart_[b + 1] += blockStart_[b];
+        }
+
+        // Pass 2: every block writes at its precomputed offset
+        out.resize(blockStart_[blocks]);
+        Run(jobs, blocks, [&](size_t b) {
+            LModule* dst = out.data() + blockStart_[b];
+            for (size_t i = b * kBlock, end = std::min(n, i + kBlock); i < end; ++i) {
+                const LModule& m = in[i];
+                const int p = choice_[i];
+                if (p < 0) {
+                    *dst++ = m;
+                    continue;
+                }
+                const auto& successor = productions_[size_t(p)].successor;
+                for (size_t c = 0; c < successor.size(); ++c) {
+                    *dst++ = MakeChild(m, successor[c], c);
+                }
+            }
+        });
+    }
+
+    template <typename Fn>
+    static void Run(JobSystem* jobs, size_t blocks, Fn&& fn) {
+        if (jobs && blocks > 1) {
+            jobs->ParallelFor(0, blocks, 1, [&fn](size_t begin, size_t end) {
+                for (size_t b = begin; b < end; ++b) fn(b);
+            });
+        } else {
+            for (size_t b = 0; b < blocks; ++b) fn(b);
+        }
+    }
+
+    std::vector<LModule> axiom_;
+    std::vector<std::pair<uint8_t, LProduction>> pending_;
+    std::vector<LProduction> productions_;
+    std::array<Group, 256> lut_;
+    std::vector<int16_t> choice_;
+    std::vector<size_t> blockStart_;
+    Stats stats_;
+};
+
+} // namespace NRE
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <core/FFT.h>
+#include <core/JobSystem.h>
+#include <core/Random.h>
+#include <core/Simd.h>
+#include <nature/WaterRenderer.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Tessendorf FFT ocean with several tiled cascades
+ *
+ * Each cascade is a periodic tile of resolution^2 samples. The initial
+ * spectrum h0(k) is drawn once from a Phillips or JONSWAP spectrum with
+ * cos^2 directional spreading around the wind; every Update() evolves it
+ * with the deep-water dispersion relation and runs four complex inverse
+ * FFTs per cascade, each packing two real fields (height and xz
+ * cross-derivative, x and z displacement, x and z slope, xx and zz
+ * derivatives). Cascades split the spectrum into disjoint wavenumber
+ * bands, so summing them never counts a wave twice while small tiles add
+ * detail without visible repetition of the large ones.
+ */
+class OceanFFT {
+public:
+    enum class Spectrum {
+        Phillips,
+        JONSWAP
+    };
+
+    struct Options {
+        int resolution = 512;                               // Samples per tile side (rounded up to a power of two >= 4)
+        std::vector<float> tileSizes = {500.0f, 85.0f, 15.0f};  // Meters, largest first
+        Spectrum spectrum = Spectrum::JONSWAP;
+        float windSpeed = 10.0f;                            // m/s at 10 m
+        float windDirection[2] = {1.0f, 0.0f};
+        float fetch = 100000.0f;                            // JONSWAP fetch (m)
+        float amplitude = 1.0f;                             // Height multiplier
+        float timeScale = 1.0f;                             // Animation speed multiplier
+        float choppiness = 1.0f;                            // Horizontal displacement scale
+        uint32_t seed = 1;
+    };
+
+    /**
+     * @brief Ocean options from the water renderer config
+     */
+    static Options FromConfig(const WaterRenderer::Config& config) {
+        Options o;
+        o.resolution = config.simulationResolution;
+        o.windSpeed = config.windSpeed;
+        o.windDirection[0] = config.windDirection[0];
+        o.windDirection[1] = config.windDirection[1];
+        o.amplitude = config.waveHeight;
+        o.timeScale = config.waveSpeed;
+        return o;
+    }
+
+    /**
+     * @brief Per-frame maps of one cascade (row-major, row = z, column = x)
+     */
+    struct Cascade {
+        float tileSize = 0.0f;          // Meters covered by one period
+        float kMin = 0.0f;              // Wavenumber band (rad/m)
+        float kMax = 0.0f;
+        std::vector<float> height;
+        std::vector<float> displaceX;   // Horizontal (choppy) displacement
+        std::vector<float> displaceZ;
+        std::vector<float> normalX;
+        std::vector<float> normalY;
+        std::vector<float> normalZ;
+        std::vector<float> jacobian;    // Of the horizontal displacement; < 0 where waves fold
+    };
+
+    explicit OceanFFT(const Options& options) : options_(Normalized(options)), fft_(size_t(options_.resolution)) {
+        const size_t n = size_t(options_.resolution);
+        const size_t count = n * n;
+        cascades_.resize(options_.tileSizes.size());
+        spectra_.resize(options_.tileSizes.size());
+        for (size_t c = 0; c < cascades_.size(); ++c) {
+            Cascade& cascade = cascades_[c];
+            cascade.tileSize = options_.tileSizes[c];
+            // Band edge: what this tile still resolves, or a few periods of the next tile
+            const float nyquist = 3.14159265f * float(n) / cascade.tileSize;
+            cascade.kMin = c == 0 ? 0.0f : cascades_[c - 1].kMax;
+            cascade.kMax = c + 1 == cascades_.size()
+                               ? std::numeric_limits<float>::max()
+                               : std::min(nyquist, 6.0f * 6.28318530718f / options_.tileSizes[c + 1]);
+            for (auto* map : {&cascade.height, &cascade.displaceX, &cascade.displaceZ, &cascade.normalX,
+                              &cascade.normalY, &cascade.normalZ, &cascade.jacobian}) {
+                map->assign(count, 0.0f);
+            }
+            SpectrumData& data = spectra_[c];
+            for (auto* map : {&data.h0Re, &data.h0Im, &data.h0mRe, &data.h0mIm}) {
+                map->assign(count, 0.0f);
+            }
+            for (auto& packed : data.packed) {
+                packed.assign(count, 0.0f);
+            }
+            data.k.resize(n);
+            data.kd.resize(n);
+        }
+        BuildSpectra();
+    }
+
+    /**
+     * @brief Change wind (rebuilds the initial spectra)
+     */
+    void SetWind(float speed, const float direction[2]) {
+        options_.windSpeed = speed;
+        options_.windDirection[0] = direction[0];
+        options_.windDirection[1] = direction[1];
+        BuildSpectra();
+    }
+
+    /**
+     * @brief Evaluate every cascade at a time
+     * @param time Seconds
+     * @param jobs Optional job system
+     */
+    void Update(float time, JobSystem* jobs = nullptr) {
+        const size_t n = size_t(options_.resolution);
+        const float t = time * options_.timeScale;
+        for (size_t c = 0; c < cascades_.size(); ++c) {
+            SpectrumData& data = spectra_[c];
+            auto evolve = [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    EvolveRow(data, i, t);
+                }
+            };
+            RunRows(n, evolve, jobs);
+            for (int p = 0; p < 4; ++p) {
+                fft_.Transform2D(data.packed[2 * p].data(), data.packed[2 * p + 1].data(), true, jobs);
+            }
+            Cascade& cascade = cascades_[c];
+            auto unpack = [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    UnpackRow(data, cascade, i);
+                }
+            };
+            RunRows(n, unpack, jobs);
+        }
+    }
+
+    int GetResolution() const { return options_.resolution; }
+    size_t GetCascadeCount() const { return cascades_.size(); }
+    const Cascade& GetCascade(size_t index) const { return cascades_[index]; }
+    const Options& GetOptions() const { return options_; }
+
+    /**
+     * @brief Directional spectral density E(kx, kz) in m^2 / (rad/m)^2
+     */
+    float Density(float kx, float kz) const {
+        const float k = std::sqrt(kx * kx + kz * kz);
+        if (k < 1e-6f) {
+            return 0.0f;
+        }
+        const float g = kGravity;
+        float dx = options_.windDirection[0], dz = options_.windDirection[1];
+        const float len = std::sqrt(dx * dx + dz * dz);
+        dx = len > 0.0f ? dx / len : 1.0f;
+        dz = len > 0.0f ? dz / len : 0.0f;
+        const float cosTheta = (kx * dx + kz * dz) / k;
+        if (cosTheta <= 0.0f) {
+            return 0.0f;  // No waves travelling against the wind
+        }
+        const float spread = 0.63661977f * cosTheta * cosTheta;  // (2 / pi) cos^2, integrates to 1
+        const float wind = std::max(options_.windSpeed, 0.1f);
+
+        float omni;  // F(k): omnidirectional wavenumber spectrum
+        if (options_.spectrum == Spectrum::Phillips) {
+            const float largest = wind * wind / g;
+            const float smallest = largest * 0.001f;
+            omni = 0.0081f / (2.0f * k * k * k) * std::exp(-1.0f / (k * k * largest * largest)) *
+                   std::exp(-k * k * smallest * smallest);
+        } else {
+            const float fetch = std::max(options_.fetch, 1.0f);
+            const float alpha = 0.076f * std::pow(wind * wind / (fetch * g), 0.22f);
+            const float peak = 22.0f * std::cbrt(g * g / (wind * fetch));
+            const float omega = std::sqrt(g * k);
+            const float sigma = omega <= peak ? 0.07f : 0.09f;
+            const float r = std::exp(-(omega - peak) * (omega - peak) / (2.0f * sigma * sigma * peak * peak));
+            const float ratio = peak / omega;
+            const float s = alpha * g * g / std::pow(omega, 5.0f) * std::exp(-1.25f * ratio * ratio * ratio * ratio) *
+                            std::pow(3.3f, r);
+            omni = s * g / (2.0f * omega);  // S(omega) d(omega)/dk
+        }
+        return omni / k * spread;
+    }
+
+private:
+    static constexpr float kGravity = 9.81f;
+
+    // The FFT, the SIMD row passes and every periodic "& (n - 1)" wrap rely on this
+    static Options Normalized(Options options) {
+        options.resolution = int(std::bit_ceil(unsigned(std::max(4, options.resolution))));
+        return options;
+    }
+
+    struct SpectrumData {
+        std::vector<float> h0Re, h0Im;      // h0(k)
+        std::vector<float> h0mRe, h0mIm;    // conj(h0(-k))
+        std::vector<float> packed[8];       // Four packed complex grids (re, im)
+        std::vector<float> k;               // Wavenumber of each index along one axis
+        std::vector<float> kd;              // Same, with the Nyquist index zeroed for i k derivatives
+    };
+
+    template <typename Fn>
+    static void RunRows(size_t rows, Fn& fn, JobSystem* jobs) {
+        if (jobs) {
+            jobs->ParallelFor(0, rows, 8, fn);
+        } else {
+            fn(0, rows);
+        }
+    }
+
+    void BuildSpectra() {
+        const size_t n = size_t(options_.resolution);
+        for (size_t c = 0; c < cascades_.size(); ++c) {
+            const Cascade& cascade = cascades_[c];
+            SpectrumData& data = spectra_[c];
+            const float dk = 6.28318530718f / cascade.tileSize;
+            for (size_t i = 0; i < n; ++i) {
+                data.k[i] = dk * (i < n / 2 ? float(i) : float(i) - float(n));
+                // The Nyquist wave has no sign, so i k h there is not the spectrum of a real field:
+                // its imaginary part would alias into the partner field packed with it
+                data.kd[i] = i == n / 2 ? 0.0f : data.k[i];
+            }
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = 0; j < n; ++j) {
+                    const float kx = data.k[j];
+                    const float kz = data.k[i];
+                    const float k = std::sqrt(kx * kx + kz * kz);
+                    const size_t index = i * n + j;
+                    if (k < cascade.kMin || k >= cascade.kMax) {
+                        data.h0Re[index] = data.h0Im[index] = 0.0f;
+                        continue;
+                    }
+                    // Var(h) = sum E dk^2 with h(k) = h0(k) + conj(h0(-k))
+                    const float amplitude = options_.amplitude * 0.5f * std::sqrt(Density(kx, kz)) * dk;
+                    const uint32_t h = HashCombine(HashCombine(options_.seed, uint32_t(c)), uint32_t(index));
+                    const float u1 = std::max(HashToUnitFloat(Hash32(h)), 1e-7f);
+                    const float u2 = HashToUnitFloat(Hash32(h ^ 0x9e3779b9u));
+                    const float radius = std::sqrt(-2.0f * std::log(u1));
+                    data.h0Re[index] = amplitude * radius * std::cos(6.28318530718f * u2);
+                    data.h0Im[index] = amplitude * radius * std::sin(6.28318530718f * u2);
+                }
+            }
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = 0; j < n; ++j) {
+                    const size_t mirror = ((n - i) % n) * n + (n - j) % n;
+                    data.h0mRe[i * n + j] = data.h0Re[mirror];
+                    data.h0mIm[i * n + j] = -data.h0Im[mirror];
+                }
+            }
+        }
+    }
+
+    // h(k, t) and the four packed field spectra for one row
+    void EvolveRow(SpectrumData& data, size_t row, float time) const {
+        const size_t n = size_t(options_.resolution);
+        const size_t base = row * n;
+        const Float4 kz(data.k[row]);
+        const Float4 kdz(data.kd[row]);
+        const Float4 zero(0.0f), one(1.0f), tiny(1e-12f);
+        const Float4 g(kGravity), t(time);
+        for (size_t j = 0; j < n; j += 4) {
+            const size_t idx = base + j;
+            const Float4 kx = Float4::Load(data.k.data() + j);
+            const Float4 kdx = Float4::Load(data.kd.data() + j);
+            const Float4 k2 = kx * kx + kz * kz;
+            const Float4 k = Sqrt(k2);
+            const Float4 invK = Select(k2 > tiny, one / Max(k, tiny), zero);
+            Float4 s, c;
+            SinCos(Sqrt(g * k) * t, s, c);
+
+            const Float4 h0r = Float4::Load(data.h0Re.data() + idx), h0i = Float4::Load(data.h0Im.data() + idx);
+            const Float4 hmr = Float4::Load(data.h0mRe.data() + idx), hmi = Float4::Load(data.h0mIm.data() + idx);
+            // h0 e^{i w t} + conj(h0(-k)) e^{-i w t}
+            const Float4 hr = (h0r + hmr) * c - (h0i - hmi) * s;
+            const Float4 hi = (h0r - hmr) * s + (h0i + hmi) * c;
+
+            // (u + i v) * h for each packed pair
+            auto store = [&](int p, Float4 u, Float4 v) {
+                (u * hr - v * hi).Store(data.packed[2 * p].data() + idx);
+                (u * hi + v * hr).Store(data.packed[2 * p + 1].data() + idx);
+            };
+            store(0, one, kdx * kdz * invK);                    // height + i d2x/dz
+            store(1, kdz * invK, zero - kdx * invK);            // Dx + i Dz, D = -i k/|k| h
+            store(2, zero - kdz, kdx);                          // slope x + i slope z
+            store(3, kx * kx * invK, kz * kz * invK);           // dDx/dx + i dDz/dz
+        }
+    }
+
+    void UnpackRow(const SpectrumData& data, Cascade& cascade, size_t row) const {
+        const size_t n = size_t(options_.resolution);
+        const Float4 chop(options_.choppiness);
+        const Float4 one(1.0f), zero(0.0f);
+        for (size_t j = row * n, end = row * n + n; j < end; j += 4) {
+            const Float4 height = Float4::Load(data.packed[0].data() + j);
+            const Float4 dxdz = chop * Float4::Load(data.packed[1].data() + j);
+            const Float4 dx = Float4::Load(data.packed[2].data() + j);
+            const Float4 dz = Float4::Load(data.packed[3].data() + j);
+            const Float4 sx = Float4::Load(data.packed[4].data() + j);
+            const Float4 sz = Float4::Load(data.packed[5].data() + j);
+            const Float4 dxdx = Float4::Load(data.packed[6].data() + j);
+            const Float4 dzdz = Float4::Load(data.packed[7].data() + j);
+
+            height.Store(cascade.height.data() + j);
+            (chop * dx).Store(cascade.displaceX.data() + j);
+            (chop * dz).Store(cascade.displaceZ.data() + j);
+            ((one + chop * dxdx) * (one + chop * dzdz) - dxdz * dxdz).Store(cascade.jacobian.data() + j);
+            const Float4 invLen = one / Sqrt(sx * sx + sz * sz + one);
+            ((zero - sx) * invLen).Store(cascade.normalX.data() + j);
+            invLen.Store(cascade.normalY.data() + j);
+            ((zero - sz) * invLen).Store(cascade.normalZ.data() + j);
+        }
+    }
+
+    Options options_;
+    FFT fft_;
+    std::vector<Cascade> cascades_;
+    std::vector<SpectrumData> spectra_;
+};
+
+} // namespace NRE
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <nature/EcosystemState.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Interns species names into compact SpeciesIds
+ *
+ * Names are hashed once at registration; simulation code and UI queries use
+ * the returned id from then on. Ids stay below maxSpecies, matching the
+ * per-species arrays of PopulationIndex and PopulationHistory.
+ */
+class SpeciesRegistry {
+public:
+    /**
+     * @brief Create registry
+     * @param maxSpecies Number of ids handed out (match PopulationIndex::Config::maxSpecies)
+     */
+    explicit SpeciesRegistry(int maxSpecies = 64)
+        : maxSpecies_(size_t(std::clamp(maxSpecies, 0, int(kInvalidSpecies)))) {}
+
+    /**
+     * @brief Register species (returns the existing id if already registered)
+     * @param name Species name
+     * @return Species id, or kInvalidSpecies once maxSpecies are registered
+     */
+    SpeciesId Register(const std::string& name) {
+        auto it = ids_.find(name);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+        if (names_.size() >= maxSpecies_) {
+            return kInvalidSpecies;
+        }
+        const SpeciesId id = SpeciesId(names_.size());
+        names_.push_back(name);
+        ids_.emplace(name, id);
+        return id;
+    }
+
+    /**
+     * @brief Look up species id
+     * @return Species id, or kInvalidSpecies if not registered
+     */
+    SpeciesId Find(const std::string& name) const {
+        auto it = ids_.find(name);
+        return it != ids_.end() ? it->second : kInvalidSpecies;
+    }
+
+    const std::string& GetName(SpeciesId id) const { return names_[id]; }
+    size_t Count() const { return names_.size(); }
+
+private:
+    size_t maxSpecies_;
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, SpeciesId> ids_;
+};
+
+/**
+ * @brief Incrementally maintained population counters
+ *
+ * Counts are updated on spawn, death and region changes, so every query is
+ * an array lookup. Regions are square cells of a fixed grid over the world;
+ * positions outside the grid are clamped to the border regions.
+ */
+class PopulationIndex {
+public:
+    struct Config {
+        int maxSpecies = 64;
+        int regionsX = 16;
+        int regionsZ = 16;
+        float regionSize = 256.0f;     // Meters
+        float origin[2] = {0.0f, 0.0f};
+    };
+
+    explicit PopulationIndex(const Config& config)
+        : config_(config),
+          totals_(size_t(config.maxSpecies), 0),
+          regions_(size_t(config.maxSpecies) * config.regionsX * config.regionsZ, 0) {}
+
+    PopulationIndex() : PopulationIndex(Config{}) {}
+
+    /**
+     * @brief Count a newly spawned entity
+     * @return false (and nothing is counted) if species >= maxSpecies
+     */
+    bool OnSpawn(SpeciesId species, float x, float z) {
+        if (species >= totals_.size()) {
+            return false;
+        }
+        ++totals_[species];
+        ++regions_[Slot(RegionOf(x, z), species)];
+        return true;
+    }
+
+    /**
+     * @brief Remove a dead entity from the counters
+     * @return false (and nothing is counted) if species >= maxSpecies
+     */
+    bool OnDeath(SpeciesId species, float x, float z) {
+        if (species >= totals_.size()) {
+            return false;
+        }
+        --totals_[species];
+        --regions_[Slot(RegionOf(x, z), species)];
+        return true;
+    }
+
+    /**
+     * @brief Update region counters after an entity moved
+     * @return false (and nothing is counted) if species >= maxSpecies
+     */
+    bool OnMove(SpeciesId species, float oldX, float oldZ, float newX, float newZ) {
+        if (species >= totals_.size()) {
+            return false;
+        }
+        const int from = RegionOf(oldX, oldZ);
+        const int to = RegionOf(newX, newZ);
+        if (from != to) {
+            --regions_[Slot(from, species)];
+            ++regions_[Slot(to, species)];
+        }
+        return true;
+    }
+
+    /**
+     * @brief Move one entity's region count (when the caller tracks regions)
+     * @return false (and nothing is counted) if species or either region is out of range
+     */
+    bool OnRegionChange(SpeciesId species, int fromRegion, int toRegion) {
+        if (species >= totals_.size() || !IsValidRegion(fromRegion) || !IsValidRegion(toRegion)) {
+            return false;
+        }
+        if (fromRegion != toRegion) {
+            --regions_[Slot(fromRegion, species)];
+            ++regions_[Slot(toRegion, species)];
+        }
+        return true;
+    }
+
+    /**
+     * @brief Get world population of species (O(1))
+     */
+    int Get(SpeciesId species) const {
+        return species < totals_.size() ? totals_[species] : 0;
+    }
+
+    /**
+     * @brief Get population of species within a region (O(1))
+     */
+    int GetInRegion(SpeciesId species, int region) const {
+        return species < totals_.size() && IsValidRegion(region) ? regions_[Slot(region, species)] : 0;
+    }
+
+    /**
+     * @brief Get region index containing a world position
+     */
+    int RegionOf(float x, float z) const {
+        int rx = int((x - config_.origin[0]) / config_.regionSize);
+        int rz = int((z - config_.origin[1]) / config_.regionSize);
+        rx = std::clamp(rx, 0, config_.regionsX - 1);
+        rz = std::clamp(rz, 0, config_.regionsZ - 1);
+        return rz * config_.regionsX + rx;
+    }
+
+    int GetRegionCount() const { return config_.regionsX * config_.regionsZ; }
+    bool IsValidRegion(int region) const { return region >= 0 && region < GetRegionCount(); }
+    int GetMaxSpecies() const { return config_.maxSpecies; }
+
+    /**
+     * @brief Per-species totals indexed by SpeciesId
+     */
+    const std::vector<int>& GetTotals() const { return totals_; }
+
+    void Clear() {
+        std::fill(totals_.begin(), totals_.end(), 0);
+        std::fill(regions_.begin(), regions_.end(), 0);
+    }
+
+private:
+    size_t Slot(int region, SpeciesId species) const {
+        return size_t(region) * config_.maxSpecies + species;
+    }
+
+    Config config_;
+    std::vector<int> totals_;
+    std::vector<int> regions_;
+};
+
+/**
+ * @brief Fixed-size ring buffer of population samples for UI graphs
+ *
+ * Records every species' total at a fixed interval; the oldest sample is
+ * overwritten once the buffer is full.
+ */
+class PopulationHistory {
+public:
+    /**
+     * @brief Create history
+     * @param capacity Number of samples kept per species (at least 1)
+     * @param maxSpecies Number of species tracked
+     * @param interval Seconds between samples (0 records every Update)
+     */
+    PopulationHistory(size_t capacity = 512, int maxSpecies = 64, float interval = 1.0f)
+        : capacity_(std::max<size_t>(1, capacity)),
+          maxSpecies_(size_t(std::max(0, maxSpecies))),
+          interval_(std::max(0.0f, interval)),
+          samples_(capacity_ * maxSpecies_, 0),
+          times_(capacity_, 0.0f) {}
+
+    /**
+     * @brief Advance time and record one sample per elapsed interval
+     *
+     * A long step records every interval it spans (all holding the current
+     * totals), so the graph's time axis stays regular.
+     * @param deltaTime Time since last update (seconds)
+     * @param index Population index to sample
+     */
+    void Update(float deltaTime, const PopulationIndex& index) {
+        time_ += deltaTime;
+        if (interval_ <= 0.0f) {
+            Record(index);
+            return;
+        }
+        accumulator_ += deltaTime;
+        const double elapsed = std::floor(double(accumulator_) / double(interval_));
+        if (elapsed < 1.0) {
+            return;
+        }
+        accumulator_ -= float(elapsed) * interval_;
+        // Samples older than the ring holds would be overwritten anyway
+        const size_t records = size_t(std::min(elapsed, double(capacity_)));
+        for (size_t r = records; r-- > 0;) {
+            RecordAt(index, time_ - accumulator_ - float(r) * interval_);
+        }
+    }
+
+    /**
+     * @brief Record a sample of all species totals now
+     */
+    void Record(const PopulationIndex& index) { RecordAt(index, time_); }
+
+    /**
+     * @brief Number of recorded samples (up to capacity)
+     */
+    size_t Size() const { return count_; }
+
+    /**
+     * @brief Get sample i (0 = oldest) for a species
+     */
+    int At(SpeciesId species, size_t i) const {
+        return species < maxSpecies_ ? samples_[Physical(i) * maxSpecies_ + species] : 0;
+    }
+
+    /**
+     * @brief Get timestamp of sample i (0 = oldest), in seconds
+     */
+    float TimeAt(size_t i) const { return times_[Physical(i)]; }
+
+    /**
+     * @brief Copy a species series oldest-to-newest (e.g. for a plot widget)
+     * @param species Species id
+     * @param out Output buffer with room for Size() floats
+     */
+    void CopySeries(SpeciesId species, float* out) const {
+        for (size_t i = 0; i < count_; ++i) {
+            out[i] = float(At(species, i));
+        }
+    }
+
+private:
+    void RecordAt(const PopulationIndex& index, float time) {
+        const auto& totals = index.GetTotals();
+        int* row = samples_.data() + head_ * maxSpecies_;
+        const size_t n = std::min(maxSpecies_, totals.size());
+        std::copy(totals.begin(), totals.begin() + n, row);
+        times_[head_] = time;
+        head_ = (head_ + 1) % capacity_;
+        count_ = std::min(count_ + 1, capacity_);
+    }
+
+    size_t Physical(size_t i) const { return (head_ + capacity_ - count_ + i) % capacity_; }
+
+    size_t capacity_;
+    size_t maxSpecies_;
+    float interval_;
+    std::vector<int> samples_;
+    std::vector<float> times_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    float time_ = 0.0f;
+    float accumulator_ = 0.0f;
+};
+
+} // namespace NRE
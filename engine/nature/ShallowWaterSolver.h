@@ -0,0 +1,605 @@
+#pragma once
+
+#include <core/JobSystem.h>
+#include <core/Simd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Tiled semi-implicit shallow-water solver for rivers and lakes
+ *
+ * Depth lives at cell centers over a terrain bed and velocities on cell
+ * faces (staggered grid). Each step advects the face velocities
+ * semi-Lagrangian, then solves the implicit free-surface equation
+ *
+ *     eta' - g dt^2 div(H grad eta') = eta - dt div(H u)
+ *
+ * (the shallow-water form of a pressure projection) with Jacobi-
+ * preconditioned conjugate gradients, warm-started from the current
+ * surface, and updates velocities from the new surface gradient. The
+ * system is symmetric positive definite and strongly diagonal at
+ * interactive time steps, so a few iterations suffice.
+ *
+ * The domain is split into tiles. Only awake tiles and their neighbors
+ * are simulated; faces to tiles outside that set act as walls, which is
+ * exact for the still, level water a sleeping tile holds. Disturbances wake
+ * tiles, and a tile whose surface stays within sleepThreshold and whose
+ * face discharge (depth times speed) stays below sleepFlux for sleepFrames
+ * steps goes back to sleep, so steady currents keep flowing. Cells the solve would drain below
+ * the bed are clamped to it, and the water this adds is taken back from
+ * the tile's wet cells, so volume only drifts by the solver tolerance.
+ * Row spans inside tiles run four
+ * cells per SIMD lane group; tiles are split over the JobSystem.
+ * Coordinates are local: cell (i, j) covers x in [j, j+1) * cellSize and
+ * z in [i, i+1) * cellSize.
+ */
+class ShallowWaterSolver {
+public:
+    struct Options {
+        int width = 512;                // Cells along X (rounded up to a multiple of tileSize)
+        int height = 512;               // Cells along Z (rounded up to a multiple of tileSize)
+        float cellSize = 1.0f;          // Meters
+        float gravity = 9.81f;
+        int tileSize = 32;              // Cells per tile side (rounded up to a multiple of 4)
+        int maxIterations = 40;
+        float tolerance = 1e-4f;        // Relative residual norm that ends the solve
+        float damping = 0.05f;          // Velocity decay per second
+        float maxSpeed = 20.0f;         // m/s clamp
+        float sleepThreshold = 2e-4f;   // Surface change per step (m) below which a tile is calm
+        float sleepFlux = 1e-3f;        // Face discharge (m^2/s) below which a tile is calm
+        int sleepFrames = 30;           // Calm steps before a tile sleeps
+    };
+
+    explicit ShallowWaterSolver(const Options& options)
+        : options_(Normalized(options)),
+          width_(options_.width),
+          height_(options_.height),
+          tilesX_(options_.width / options_.tileSize),
+          tilesZ_(options_.height / options_.tileSize) {
+        const size_t padded = size_t(width_) * size_t(height_) + 2 * size_t(width_);
+        for (auto* field : {&bed_, &eta_, &etaPrev_, &u_, &w_, &uAdv_, &wAdv_, &kx_, &kz_, &fluxX_, &fluxZ_, &diag_,
+                            &rhs_, &r_, &z_, &p_, &ap_}) {
+            field->assign(padded, 0.0f);
+        }
+        const size_t tiles = size_t(tilesX_) * size_t(tilesZ_);
+        awake_.assign(tiles, 0);
+        simulated_.assign(tiles, 0);
+        calm_.assign(tiles, 0);
+        change_.assign(tiles, 0.0f);
+        flux_.assign(tiles, 0.0f);
+        partial_.resize(tiles);
+        reference_.resize(tiles);
+    }
+
+    /**
+     * @brief Set the terrain bed heights (GetWidth() * GetHeight(), row-major)
+     */
+    void SetTerrain(const float* bed) {
+        std::copy(bed, bed + size_t(width_) * size_t(height_), Cell(bed_));
+        for (size_t c = 0, n = size_t(width_) * size_t(height_); c < n; ++c) {
+            Cell(eta_)[c] = std::max(Cell(eta_)[c], Cell(bed_)[c]);
+        }
+    }
+
+    /**
+     * @brief Fill to a still water level (velocities cleared, all tiles asleep)
+     */
+    void Fill(float level) {
+        for (size_t c = 0, n = size_t(width_) * size_t(height_); c < n; ++c) {
+            Cell(eta_)[c] = std::max(level, Cell(bed_)[c]);
+        }
+        for (auto* field : {&u_, &w_, &uAdv_, &wAdv_, &kx_, &kz_, &fluxX_, &fluxZ_}) {
+            std::fill(field->begin(), field->end(), 0.0f);
+        }
+        std::fill(awake_.begin(), awake_.end(), uint8_t(0));
+        std::fill(simulated_.begin(), simulated_.end(), uint8_t(0));
+    }
+
+    /**
+     * @brief Raise (or lower) the surface by a smooth bump and wake its tiles
+     * @param x Center X (meters)
+     * @param z Center Z (meters)
+     * @param radius Bump radius (meters)
+     * @param amount Peak height change (meters; limited by the water present)
+     */
+    void AddDisturbance(float x, float z, float radius, float amount) {
+        ForCellsNear(x, z, radius, [&](size_t c, float falloff) {
+            float& eta = Cell(eta_)[c];
+            eta = std::max(Cell(bed_)[c], eta + amount * falloff);
+        });
+    }
+
+    /**
+     * @brief Push water (e.g. a paddle or inflow) and wake the affected tiles
+     */
+    void AddVelocity(float x, float z, float radius, float vx, float vz) {
+        ForCellsNear(x, z, radius, [&](size_t c, float falloff) {
+            Cell(u_)[c] += vx * falloff;
+            Cell(w_)[c] += vz * falloff;
+        });
+    }
+
+    /**
+     * @brief Advance the simulation
+     * @param dt Time step (seconds)
+     * @param jobs Optional job system
+     */
+    void Step(float dt, JobSystem* jobs = nullptr) {
+        BuildTileList();
+        if (tiles_.empty()) {
+            lastIterations_ = 0;
+            return;
+        }
+        const float g = options_.gravity;
+        const float invDx = 1.0f / options_.cellSize;
+
+        RunTiles(jobs, [&](size_t, int i0, int i1, int j0, int j1) { Advect(dt, i0, i1, j0, j1); });
+        const float coupling = g * dt * dt * invDx * invDx;
+        RunTiles(jobs, [&](size_t, int i0, int i1, int j0, int j1) { Coefficients(coupling, i0, i1, j0, j1); });
+
+        // Right-hand side and diagonal; PCG starts from the current surface
+        const Float4 scale(dt * invDx);
+        RunTiles(jobs, [&](size_t, int i0, int i1, int j0, int j1) {
+            const size_t w = size_t(width_);
+            for (int i = i0; i < i1; ++i) {
+                for (size_t c = size_t(i) * w + size_t(j0), e = size_t(i) * w + size_t(j1); c < e; c += 4) {
+                    const Float4 eta = Load(eta_, c);
+                    const Float4 div = Load(fluxX_, c + 1) - Load(fluxX_, c) + Load(fluxZ_, c + w) - Load(fluxZ_, c);
+                    Store(etaPrev_, c, eta);
+                    Store(rhs_, c, eta - scale * div);
+                    Store(diag_, c, Float4(1.0f) + Load(kx_, c) + Load(kx_, c + 1) + Load(kz_, c) + Load(kz_, c + w));
+                }
+            }
+        });
+        Solve(jobs);
+
+        // Depth can not go negative; the water clamping adds is taken back from the
+        // tile's wet cells in proportion to their depth. Then velocities from the
+        // new surface gradient
+        RunTiles(jobs, [&](size_t, int i0, int i1, int j0, int j1) {
+            const size_t w = size_t(width_);
+            const Float4 zero(0.0f);
+            Float4 added(0.0f), wet(0.0f);
+            for (int i = i0; i < i1; ++i) {
+                for (size_t c = size_t(i) * w + size_t(j0), e = size_t(i) * w + size_t(j1); c < e; c += 4) {
+                    const Float4 depth = Load(eta_, c) - Load(bed_, c);
+                    added = added + Max(zero, zero - depth);
+                    wet = wet + Max(zero, depth);
+                }
+            }
+            const float deficit = Sum(added), volume = Sum(wet);
+            const Float4 keep(volume > 0.0f ? std::max(0.0f, 1.0f - deficit / volume) : 0.0f);
+            for (int i = i0; i < i1; ++i) {
+                for (size_t c = size_t(i) * w + size_t(j0), e = size_t(i) * w + size_t(j1); c < e; c += 4) {
+                    const Float4 bed = Load(bed_, c);
+                    const Float4 depth = Max(zero, Load(eta_, c) - bed);
+                    Store(eta_, c, deficit > 0.0f ? bed + depth * keep : bed + depth);
+                }
+            }
+        });
+        const float gradScale = g * dt * invDx;
+        const float maxSpeed = options_.maxSpeed;
+        RunTiles(jobs, [&](size_t t, int i0, int i1, int j0, int j1) {
+            const size_t w = size_t(width_);
+            const Float4 gs(gradScale), lo(-maxSpeed), hi(maxSpeed), zero(0.0f);
+            Float4 change(0.0f), flux(0.0f);
+            for (int i = i0; i < i1; ++i) {
+                for (size_t c = size_t(i) * w + size_t(j0), e = size_t(i) * w + size_t(j1); c < e; c += 4) {
+                    const Float4 eta = Load(eta_, c);
+                    const Float4 dx = eta - Load(eta_, c - 1);
+                    const Float4 dz = eta - Load(eta_, c - w);
+                    // Faces without water (k = 0) or outside the simulated set stay at rest
+                    const Float4 u = Min(hi, Max(lo, Load(uAdv_, c) - gs * dx));
+                    const Float4 v = Min(hi, Max(lo, Load(wAdv_, c) - gs * dz));
+                    const Float4 kx = Load(kx_, c), kz = Load(kz_, c);
+                    const Float4 uf = Select(kx > zero, u, zero);
+                    const Float4 vf = Select(kz > zero, v, zero);
+                    Store(u_, c, uf);
+                    Store(w_, c, vf);
+                    const Float4 d = eta - Load(etaPrev_, c);
+                    change = Max(change, Max(d, zero - d));
+                    // k is the face depth times the coupling; shoreline faces have velocity but no water
+                    flux = Max(flux, Max(Max(uf, zero - uf) * kx, Max(vf, zero - vf) * kz));
+                }
+            }
+            change_[tiles_[t]] = MaxLane(change);
+            flux_[tiles_[t]] = MaxLane(flux) / coupling;
+        });
+        UpdateSleep();
+    }
+
+    /**
+     * @brief Bilinear water surface height (terrain where dry)
+     */
+    float GetSurface(float x, float z) const {
+        const float gx = std::clamp(x / options_.cellSize - 0.5f, 0.0f, float(width_ - 1));
+        const float gz = std::clamp(z / options_.cellSize - 0.5f, 0.0f, float(height_ - 1));
+        const int j0 = std::min(int(gx), width_ - 2), i0 = std::min(int(gz), height_ - 2);
+        const float fx = gx - float(j0), fz = gz - float(i0);
+        const float* eta = Cell(eta_);
+        const size_t c = size_t(i0) * size_t(width_) + size_t(j0);
+        return (eta[c] * (1.0f - fx) + eta[c + 1] * fx) * (1.0f - fz) +
+               (eta[c + size_t(width_)] * (1.0f - fx) + eta[c + size_t(width_) + 1] * fx) * fz;
+    }
+
+    /**
+     * @brief Water depth of a cell
+     */
+    float GetDepth(int i, int j) const {
+        const size_t c = size_t(i) * size_t(width_) + size_t(j);
+        return Cell(eta_)[c] - Cell(bed_)[c];
+    }
+
+    /**
+     * @brief Water surface heights (width * height, row-major)
+     */
+    const float* GetSurfaceData() const { return Cell(eta_); }
+
+    /**
+     * @brief Total water volume (cubic meters)
+     */
+    double GetVolume() const {
+        double volume = 0.0;
+        for (size_t c = 0, n = size_t(width_) * size_t(height_); c < n; ++c) {
+            volume += double(Cell(eta_)[c] - Cell(bed_)[c]);
+        }
+        return volume * double(options_.cellSize) * double(options_.cellSize);
+    }
+
+    int GetWidth() const { return width_; }
+    int GetHeight() const { return height_; }
+    size_t GetTileCount() const { return awake_.size(); }
+    size_t GetAwakeTileCount() const { return size_t(std::count(awake_.begin(), awake_.end(), uint8_t(1))); }
+    size_t GetSimulatedTileCount() const { return tiles_.size(); }
+    int GetLastIterations() const { return lastIterations_; }
+    float GetLastResidual() const { return lastResidual_; }
+
+private:
+    // Whole SIMD groups per tile row and whole tiles per side
+    static Options Normalized(Options options) {
+        options.tileSize = (std::max(4, options.tileSize) + 3) & ~3;
+        const int ts = options.tileSize;
+        options.width = (std::max(ts, options.width) + ts - 1) / ts * ts;
+        options.height = (std::max(ts, options.height) + ts - 1) / ts * ts;
+        return options;
+    }
+
+    // Fields are padded by one row on both sides so neighbor loads never leave the buffer
+    float* Cell(std::vector<float>& field) { return field.data() + width_; }
+    const float* Cell(const std::vector<float>& field) const { return field.data() + width_; }
+    Float4 Load(const std::vector<float>& field, size_t c) const { return Float4::Load(field.data() + width_ + c); }
+    void Store(std::vector<float>& field, size_t c, Float4 v) { v.Store(field.data() + width_ + c); }
+
+    template <typename Fn>
+    void ForCellsNear(float x, float z, float radius, Fn&& fn) {
+        const float r = std::max(radius, options_.cellSize);
+        const int j0 = std::max(0, int((x - r) / options_.cellSize));
+        const int j1 = std::min(width_ - 1, int((x + r) / options_.cellSize));
+        const int i0 = std::max(0, int((z - r) / options_.cellSize));
+        const int i1 = std::min(height_ - 1, int((z + r) / options_.cellSize));
+        for (int i = i0; i <= i1; ++i) {
+            for (int j = j0; j <= j1; ++j) {
+                const float dx = (float(j) + 0.5f) * options_.cellSize - x;
+                const float dz = (float(i) + 0.5f) * options_.cellSize - z;
+                const float d2 = (dx * dx + dz * dz) / (r * r);
+                if (d2 < 1.0f) {
+                    fn(size_t(i) * size_t(width_) + size_t(j), (1.0f - d2) * (1.0f - d2));
+                }
+            }
+        }
+        const int ts = options_.tileSize;
+        for (int ti = i0 / ts; ti <= i1 / ts; ++ti) {
+            for (int tj = j0 / ts; tj <= j1 / ts; ++tj) {
+                const size_t t = size_t(ti) * size_t(tilesX_) + size_t(tj);
+                awake_[t] = 1;
+                calm_[t] = 0;
+            }
+        }
+    }
+
+    // Awake tiles and their neighbors; tiles leaving the set are cleared to rest
+    void BuildTileList() {
+        std::vector<uint8_t> next(awake_.size(), 0);
+        for (int ti = 0; ti < tilesZ_; ++ti) {
+            for (int tj = 0; tj < tilesX_; ++tj) {
+                if (!awake_[size_t(ti) * size_t(tilesX_) + size_t(tj)]) {
+                    continue;
+                }
+                for (int a = std::max(0, ti - 1); a <= std::min(tilesZ_ - 1, ti + 1); ++a) {
+                    for (int b = std::max(0, tj - 1); b <= std::min(tilesX_ - 1, tj + 1); ++b) {
+                        next[size_t(a) * size_t(tilesX_) + size_t(b)] = 1;
+                    }
+                }
+            }
+        }
+        tiles_.clear();
+        for (size_t t = 0; t < next.size(); ++t) {
+            if (simulated_[t] && !next[t]) {
+                ClearTile(t);
+            }
+            if (next[t]) {
+                tiles_.push_back(uint32_t(t));
+            }
+        }
+        simulated_.swap(next);
+    }
+
+    void ClearTile(size_t t) {
+        int i0, i1, j0, j1;
+        TileBounds(t, i0, i1, j0, j1);
+        for (int i = i0; i < i1; ++i) {
+            const size_t row = size_t(i) * size_t(width_);
+            for (auto* field : {&u_, &w_, &uAdv_, &wAdv_, &kx_, &kz_, &fluxX_, &fluxZ_}) {
+                std::fill(Cell(*field) + row + size_t(j0), Cell(*field) + row + size_t(j1), 0.0f);
+            }
+        }
+    }
+
+    void TileBounds(size_t t, int& i0, int& i1, int& j0, int& j1) const {
+        const int ts = options_.tileSize;
+        i0 = int(t / size_t(tilesX_)) * ts;
+        j0 = int(t % size_t(tilesX_)) * ts;
+        i1 = i0 + ts;
+        j1 = j0 + ts;
+    }
+
+    bool Simulated(int i, int j) const {
+        if (i < 0 || j < 0 || i >= height_ || j >= width_) {
+            return false;
+        }
+        const int ts = options_.tileSize;
+        return simulated_[size_t(i / ts) * size_t(tilesX_) + size_t(j / ts)] != 0;
+    }
+
+    // fn(listIndex, i0, i1, j0, j1) for every simulated tile
+    template <typename Fn>
+    void RunTiles(JobSystem* jobs, Fn&& fn) {
+        auto range = [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t) {
+                int i0, i1, j0, j1;
+                TileBounds(tiles_[t], i0, i1, j0, j1);
+                fn(t, i0, i1, j0, j1);
+            }
+        };
+        if (jobs) {
+            jobs->ParallelFor(0, tiles_.size(), 1, range);
+        } else {
+            range(0, tiles_.size());
+        }
+    }
+
+    // Semi-Lagrangian advection of the faces each cell owns (left and top)
+    void Advect(float dt, int i0, int i1, int j0, int j1) {
+        const size_t w = size_t(width_);
+        const float* u = Cell(u_);
+        const float* v = Cell(w_);
+        const Float4 step(dt / options_.cellSize);
+        const Float4 decay(std::max(0.0f, 1.0f - options_.damping * dt));
+        const Float4 quarter(0.25f), half(0.5f), lane(0.0f, 1.0f, 2.0f, 3.0f);
+        const Float4 zero(0.0f), all = Float4(0.0f) <= Float4(0.0f);
+        // Faces to a tile outside the simulated set are walls
+        const Float4 firstLeft = Simulated(i0, j0 - 1) ? all : Float4(0.0f, 1.0f, 1.0f, 1.0f) > zero;
+        const bool topTile = Simulated(i0 - 1, j0);
+        for (int i = i0; i < i1; ++i) {
+            const Float4 fi = Float4(float(i));
+            const bool top = i > i0 || topTile;
+            for (int j = j0; j < j1; j += 4) {
+                const size_t c = size_t(i) * w + size_t(j);
+                const Float4 x = Float4(float(j)) + lane;
+                const Float4 uc = Load(u_, c), vc = Load(w_, c);
+                // Left face at (j, i + 0.5) in cell units
+                const Float4 vAt = quarter * (Load(w_, c - 1) + vc + Load(w_, c - 1 + w) + Load(w_, c + w));
+                Float4 au = SampleFace(u, x - step * uc, fi + half - step * vAt, 0.0f, 0.5f);
+                au = Select(j == j0 ? firstLeft : all, au * decay, zero);
+                Store(uAdv_, c, au);
+                // Top face at (j + 0.5, i)
+                Float4 av = zero;
+                if (top) {
+                    const Float4 uAt = quarter * (Load(u_, c - w) + Load(u_, c - w + 1) + uc + Load(u_, c + 1));
+                    av = SampleFace(v, x + half - step * uAt, fi - step * vc, 0.5f, 0.0f) * decay;
+                }
+                Store(wAdv_, c, av);
+            }
+        }
+    }
+
+    // Bilinear samples of a face grid whose sample (i, j) sits at (j + ox, i + oz)
+    Float4 SampleFace(const float* field, Float4 x, Float4 z, float ox, float oz) const {
+        const Float4 gx = Min(Float4(float(width_ - 1) - 1e-3f), Max(Float4(0.0f), x - Float4(ox)));
+        const Float4 gz = Min(Float4(float(height_ - 1) - 1e-3f), Max(Float4(0.0f), z - Float4(oz)));
+        const Float4 x0 = Floor(gx), z0 = Floor(gz);
+        const Float4 fx = gx - x0, fz = gz - z0;
+        int32_t jx[4], iz[4];
+        StoreInt(x0, jx);
+        StoreInt(z0, iz);
+        float c00[4], c01[4], c10[4], c11[4];
+        for (int l = 0; l < 4; ++l) {
+            const float* row = field + size_t(iz[l]) * size_t(width_) + size_t(jx[l]);
+            c00[l] = row[0];
+            c01[l] = row[1];
+            c10[l] = row[width_];
+            c11[l] = row[width_ + 1];
+        }
+        const Float4 top = Float4::Load(c00) + fx * (Float4::Load(c01) - Float4::Load(c00));
+        const Float4 bottom = Float4::Load(c10) + fx * (Float4::Load(c11) - Float4::Load(c10));
+        return top + fz * (bottom - top);
+    }
+
+    // Upwind face depths, implicit coupling k = g dt^2 H / dx^2 and fluxes H u
+    void Coefficients(float coupling, int i0, int i1, int j0, int j1) {
+        const size_t w = size_t(width_);
+        const Float4 k(coupling), zero(0.0f);
+        const bool topTile = Simulated(i0 - 1, j0);
+        for (int i = i0; i < i1; ++i) {
+            const bool top = i > i0 || topTile;
+            for (int j = j0; j < j1; j += 4) {
+                const size_t c = size_t(i) * w + size_t(j);
+                const Float4 depth = Load(eta_, c) - Load(bed_, c);
+                const Float4 uf = Load(uAdv_, c), vf = Load(wAdv_, c);
+                // Wall faces have zero advected velocity; give them zero depth too
+                const Float4 left = Load(eta_, c - 1) - Load(bed_, c - 1);
+                Float4 hx = Select(uf > zero, left, Select(uf < zero, depth, Max(left, depth)));
+                if (j == j0 && !Simulated(i, j - 1)) {
+                    hx = Select(Float4(0.0f, 1.0f, 1.0f, 1.0f) > zero, hx, zero);
+                }
+                Float4 hz = zero;
+                if (top) {
+                    const Float4 up = Load(eta_, c - w) - Load(bed_, c - w);
+                    hz = Select(vf > zero, up, Select(vf < zero, depth, Max(up, depth)));
+                }
+                Store(kx_, c, k * hx);
+                Store(kz_, c, k * hz);
+                Store(fluxX_, c, hx * uf);
+                Store(fluxZ_, c, hz * vf);
+            }
+        }
+    }
+
+    // out = A x over one tile
+    void Apply(const std::vector<float>& x, std::vector<float>& out, int i0, int i1, int j0, int j1) {
+        const size_t w = size_t(width_);
+        for (int i = i0; i < i1; ++i) {
+            for (size_t c = size_t(i) * w + size_t(j0), e = size_t(i) * w + size_t(j1); c < e; c += 4) {
+                const Float4 xc = Load(x, c);
+                const Float4 off = Load(kx_, c) * Load(x, c - 1) + Load(kx_, c + 1) * Load(x, c + 1) +
+                                   Load(kz_, c) * Load(x, c - w) + Load(kz_, c + w) * Load(x, c + w);
+                Store(out, c, Load(diag_, c) * xc - off);
+            }
+        }
+    }
+
+    static float Sum(Float4 v) {
+        float lanes[4];
+        v.Store(lanes);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+
+    static float MaxLane(Float4 v) {
+        float lanes[4];
+        v.Store(lanes);
+        return std::max({lanes[0], lanes[1], lanes[2], lanes[3]});
+    }
+
+    double Reduce() const {
+        double sum = 0.0;
+        for (size_t t = 0; t < tiles_.size(); ++t) {
+            sum += partial_[t];
+        }
+        return sum;
+    }
+
+    // Jacobi-preconditioned conjugate gradients on the simulated cells, x = eta
+    void Solve(JobSystem* jobs) {
+        const size_t w = size_t(width_);
+        // r = b - A x, z = r / diag, p = z
+        RunTiles(jobs, [&](size_t t, int i0, int i1, int j0, int j1) {
+            Apply(eta_, ap_, i0, i1, j0, j1);
+            Float4 rz(0.0f), bb(0.0f);
+            for (int i = i0; i < i1; ++i) {
+                for (size_t c = size_t(i) * w + size_t(j0), e = size_t(i) * w + size_t(j1); c < e; c += 4) {
+                    const Float4 b = Load(rhs_, c);
+                    const Float4 r = b - Load(ap_, c);
+                    const Float4 z = r / Load(diag_, c);
+                    Store(r_, c, r);
+                    Store(z_, c, z);
+                    Store(p_, c, z);
+                    rz = rz + r * z;
+                    bb = bb + (b - Load(etaPrev_, c)) * (b - Load(etaPrev_, c));
+                }
+            }
+            partial_[t] = double(Sum(rz));
+            reference_[t] = double(Sum(bb));
+        });
+        double rz = Reduce();
+        double reference = 0.0;
+        for (size_t t = 0; t < tiles_.size(); ++t) {
+            reference += reference_[t];
+        }
+        // Converged once the preconditioned residual is a small fraction of the step's change
+        const double target = double(options_.tolerance) * double(options_.tolerance) * std::max(reference, 1e-12);
+        int it = 0;
+        for (; it < options_.maxIterations && rz > target; ++it) {
+            RunTiles(jobs, [&](size_t t, int i0, int i1, int j0, int j1) {
+                Apply(p_, ap_, i0, i1, j0, j1);
+                Float4 pap(0.0f);
+                for (int i = i0; i < i1; ++i) {
+                    for (size_t c = size_t(i) * w + size_t(j0), e = size_t(i) * w + size_t(j1); c < e; c += 4) {
+                        pap = pap + Load(p_, c) * Load(ap_, c);
+                    }
+                }
+                partial_[t] = double(Sum(pap));
+            });
+            const double pap = Reduce();
+            if (pap <= 0.0) {
+                break;
+            }
+            const Float4 alpha(float(rz / pap));
+            RunTiles(jobs, [&](size_t t, int i0, int i1, int j0, int j1) {
+                Float4 acc(0.0f);
+                for (int i = i0; i < i1; ++i) {
+                    for (size_t c = size_t(i) * w + size_t(j0), e = size_t(i) * w + size_t(j1); c < e; c += 4) {
+                        Store(eta_, c, Load(eta_, c) + alpha * Load(p_, c));
+                        const Float4 r = Load(r_, c) - alpha * Load(ap_, c);
+                        const Float4 z = r / Load(diag_, c);
+                        Store(r_, c, r);
+                        Store(z_, c, z);
+                        acc = acc + r * z;
+                    }
+                }
+                partial_[t] = double(Sum(acc));
+            });
+            const double rzNext = Reduce();
+            const Float4 beta(float(rzNext / rz));
+            rz = rzNext;
+            RunTiles(jobs, [&](size_t, int i0, int i1, int j0, int j1) {
+                for (int i = i0; i < i1; ++i) {
+                    for (size_t c = size_t(i) * w + size_t(j0), e = size_t(i) * w + size_t(j1); c < e; c += 4) {
+                        Store(p_, c, Load(z_, c) + beta * Load(p_, c));
+                    }
+                }
+            });
+        }
+        lastIterations_ = it;
+        lastResidual_ = float(std::sqrt(rz / std::max(reference, 1e-12)));
+    }
+
+    void UpdateSleep() {
+        for (uint32_t t : tiles_) {
+            if (change_[t] > options_.sleepThreshold || flux_[t] > options_.sleepFlux) {
+                awake_[t] = 1;
+                calm_[t] = 0;
+            } else if (awake_[t] && ++calm_[t] >= options_.sleepFrames) {
+                awake_[t] = 0;
+                calm_[t] = 0;
+            }
+        }
+    }
+
+    Options options_;
+    int width_;
+    int height_;
+    int tilesX_;
+    int tilesZ_;
+    std::vector<float> bed_, eta_, etaPrev_;
+    std::vector<float> u_, w_, uAdv_, wAdv_;        // Left / top face of each cell
+    std::vector<float> kx_, kz_, fluxX_, fluxZ_;    // Per face, same layout
+    std::vector<float> diag_, rhs_, r_, z_, p_, ap_;
+    std::vector<uint8_t> awake_;
+    std::vector<uint8_t> simulated_;
+    std::vector<int> calm_;
+    std::vector<float> change_;         // Per tile max |d eta| of the last step
+    std::vector<float> flux_;           // Per tile max face discharge of the last step
+    std::vector<uint32_t> tiles_;
+    std::vector<double> partial_;       // Per simulated tile dot products
+    std::vector<double> reference_;
+    int lastIterations_ = 0;
+    float lastResidual_ = 0.0f;
+};
+
+} // namespace NRE
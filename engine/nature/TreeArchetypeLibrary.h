@@ -0,0 +1,287 @@
+#pragma once
+
+#include <core/JobSystem.h>
+#include <core/Random.h>
+#include <nature/TreeMeshBuilder.h>
+#include <nature/TreeRenderer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Cache key of a tree archetype
+ */
+struct TreeArchetypeKey {
+    std::string species;
+    uint32_t seedBucket = 0;
+    uint32_t ageBucket = 0;
+    uint64_t settingsHash = 0;  // Every other config field except height (see TreeArchetypeLibrary::HashSettings)
+
+    bool operator==(const TreeArchetypeKey& other) const {
+        return seedBucket == other.seedBucket && ageBucket == other.ageBucket &&
+               settingsHash == other.settingsHash && species == other.species;
+    }
+};
+
+struct TreeArchetypeKeyHash {
+    size_t operator()(const TreeArchetypeKey& key) const {
+        uint32_t h = HashCombine(HashCombine(uint32_t(std::hash<std::string>{}(key.species)), key.seedBucket),
+                                 key.ageBucket);
+        h = HashCombine(HashCombine(h, uint32_t(key.settingsHash)), uint32_t(key.settingsHash >> 32));
+        return size_t(h);
+    }
+};
+
+/**
+ * @brief One generated tree shared by many instances
+ */
+struct TreeArchetype {
+    TreeArchetypeKey key;
+    TreeRendererConfig config;  // Config the meshes were generated from
+    TreeLODSet lods;
+    bool ready = false;
+};
+
+/**
+ * @brief Bounded cache of generated tree variants
+ *
+ * Tree configs map to (species, seed bucket, age bucket, settings): the
+ * seed is hashed into one of variantsPerSpecies buckets and the age is
+ * bucketed in fixed steps, so any number of trees sharing their other
+ * settings resolve to at most species * variantsPerSpecies * maxAgeBuckets
+ * archetypes. Height is left out because instances scale to it. Young buckets
+ * use fewer L-system iterations. Acquire() only registers archetypes;
+ * GenerateMissing() builds every pending one in a single parallel pass.
+ * Not thread-safe; acquire from the thread that owns the library.
+ */
+class TreeArchetypeLibrary {
+public:
+    struct Options {
+        uint32_t variantsPerSpecies = 8;
+        float ageBucketYears = 10.0f;
+        uint32_t maxAgeBuckets = 4;     // Older trees share the last bucket
+        float matureAge = 30.0f;        // Age at which the full iteration count is used
+    };
+
+    TreeArchetypeLibrary(const TreeMeshBuilder::Options& meshOptions, const Options& options)
+        : builder_(meshOptions), options_(options) {}
+
+    /**
+     * @brief Archetype key for a tree config
+     */
+    TreeArchetypeKey KeyFor(const TreeRendererConfig& config) const {
+        TreeArchetypeKey key;
+        key.species = config.species;
+        key.seedBucket = Hash32(uint32_t(config.seed)) % std::max(1u, options_.variantsPerSpecies);
+        const float bucket = std::floor(std::max(0.0f, config.age) / options_.ageBucketYears);
+        key.ageBucket = std::min(uint32_t(bucket), std::max(1u, options_.maxAgeBuckets) - 1);
+        key.settingsHash = HashSettings(config);
+        return key;
+    }
+
+    /**
+     * @brief FNV-1a hash of the config fields an archetype copies from its first tree
+     *
+     * Species, seed and age are keyed separately and height becomes the
+     * instance scale; every other field is copied into the archetype, so
+     * trees that differ in any of them must not share one.
+     */
+    static uint64_t HashSettings(const TreeRendererConfig& config) {
+        uint64_t h = 14695981039346656037ull;
+        auto mix = [&h](const void* data, size_t size) {
+            const uint8_t* p = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                h = (h ^ p[i]) * 1099511628211ull;
+            }
+        };
+        mix(&config.iterations, sizeof(config.iterations));
+        mix(&config.branchAngle, sizeof(config.branchAngle));
+        mix(&config.branchLength, sizeof(config.branchLength));
+        mix(&config.branchThickness, sizeof(config.branchThickness));
+        mix(&config.leafCount, sizeof(config.leafCount));
+        mix(&config.barkTextureResolution, sizeof(config.barkTextureResolution));
+        const uint8_t flags[] = {config.individualLeaves, config.enableWindPhysics, config.enableGrowthSimulation,
+                                 config.enableSeasonalChanges};
+        mix(flags, sizeof(flags));
+        return h;
+    }
+
+    /**
+     * @brief Find or register the archetype for a tree
+     * @return Archetype index (stable for the library's lifetime)
+     */
+    uint32_t Acquire(const TreeRendererConfig& config) {
+        TreeArchetypeKey key = KeyFor(config);
+        const auto it = index_.find(key);
+        if (it != index_.end()) {
+            return it->second;
+        }
+        TreeArchetype archetype;
+        archetype.config = config;
+        archetype.config.seed = int(HashCombine(key.seedBucket, 0x7265u));
+        archetype.config.age = (float(key.ageBucket) + 0.5f) * options_.ageBucketYears;
+        const float growth = std::min(1.0f, archetype.config.age / options_.matureAge);
+        archetype.config.iterations =
+            std::max(1, int(std::lround(float(config.iterations) * (0.5f + 0.5f * growth))));
+        archetype.key = key;
+
+        const uint32_t id = uint32_t(archetypes_.size());
+        index_.emplace(std::move(key), id);
+        archetypes_.push_back(std::move(archetype));
+        pending_.push_back(id);
+        return id;
+    }
+
+    /**
+     * @brief Generate meshes for every archetype acquired since the last call
+     * @param jobs Optional job system
+     * @return Number of archetypes generated
+     */
+    size_t GenerateMissing(JobSystem* jobs = nullptr) {
+        if (pending_.empty()) {
+            return 0;
+        }
+        std::vector<TreeRendererConfig> configs;
+        configs.reserve(pending_.size());
+        for (uint32_t id : pending_) {
+            configs.push_back(archetypes_[id].config);
+        }
+        std::vector<TreeLODSet> lods;
+        builder_.GenerateForest(configs, lods, jobs);
+        for (size_t i = 0; i < pending_.size(); ++i) {
+            TreeArchetype& archetype = archetypes_[pending_[i]];
+            archetype.lods = std::move(lods[i]);
+            archetype.ready = true;
+        }
+        const size_t count = pending_.size();
+        pending_.clear();
+        return count;
+    }
+
+    /**
+     * @brief Also generate foliage for archetypes built from now on
+     */
+    void SetFoliageBuilder(const FoliageBuilder* foliage) { builder_.SetFoliageBuilder(foliage); }
+
+    const TreeArchetype& Get(uint32_t id) const { return archetypes_[id]; }
+    size_t GetArchetypeCount() const { return archetypes_.size(); }
+    size_t GetPendingCount() const { return pending_.size(); }
+
+    /**
+     * @brief Vertex and index bytes of all archetype meshes (branches and foliage)
+     */
+    size_t GetMeshBytes() const {
+        size_t bytes = 0;
+        for (const auto& archetype : archetypes_) {
+            const auto& foliage = archetype.lods.foliage;
+            for (const auto* level : {&foliage.individual, &foliage.clusters, &foliage.shell}) {
+                bytes += level->vertices.size() * sizeof(Mesh::Vertex) + level->indices.size() * sizeof(unsigned);
+            }
+            for (const auto& level : archetype.lods.levels) {
+                bytes += level.vertices.size() * sizeof(Mesh::Vertex) + level.indices.size() * sizeof(unsigned);
+            }
+        }
+        return bytes;
+    }
+
+private:
+    TreeMeshBuilder builder_;
+    Options options_;
+    std::vector<TreeArchetype> archetypes_;
+    std::unordered_map<TreeArchetypeKey, uint32_t, TreeArchetypeKeyHash> index_;
+    std::vector<uint32_t> pending_;
+};
+
+/**
+ * @brief Per-tree instance data read by the instanced draw
+ */
+struct TreeInstance {
+    float position[3];
+    float rotation;     // Radians around Y
+    float scale;        // Uniform
+    float hueShift;     // Added to foliage/bark hue (turns, -0.5..0.5)
+    float seasonOffset; // Added to the global season for FoliageBuilder::SeasonColor
+};
+
+/**
+ * @brief Forest placement built on shared archetypes
+ *
+ * Each tree becomes a TreeInstance in its archetype's batch, with rotation,
+ * scale, hue and season offset varied from a hash of the tree's own seed,
+ * so trees that share a mesh still look distinct. Scale also absorbs the difference
+ * between the requested height and the archetype's. Per-tree memory is
+ * sizeof(TreeInstance); mesh memory lives only in the library.
+ */
+class ForestInstances {
+public:
+    struct Options {
+        float scaleVariation = 0.15f;   // +- fraction
+        float hueVariation = 0.04f;     // +- turns
+        float seasonVariation = 0.15f;  // +- seasons, so trees do not all turn at once
+    };
+
+    explicit ForestInstances(const Options& options) : options_(options) {}
+
+    /**
+     * @brief Place a tree
+     * @param library Archetype library (the tree's archetype is acquired)
+     * @param config Tree config (species, seed, age, height)
+     * @param position World position of the trunk base
+     * @return Archetype index the tree was placed in
+     */
+    uint32_t Add(TreeArchetypeLibrary& library, const TreeRendererConfig& config, const float position[3]) {
+        const uint32_t id = library.Acquire(config);
+        if (batches_.size() <= id) {
+            batches_.resize(id + 1);
+        }
+        const uint32_t h = Hash32(uint32_t(config.seed));
+        const float baseHeight = library.Get(id).config.height;
+        TreeInstance instance;
+        std::copy(position, position + 3, instance.position);
+        instance.rotation = HashToUnitFloat(h) * 6.28318530718f;
+        instance.scale = (config.height / std::max(baseHeight, 1e-3f)) *
+                         (1.0f + options_.scaleVariation * (2.0f * HashToUnitFloat(HashCombine(h, 1)) - 1.0f));
+        instance.hueShift = options_.hueVariation * (2.0f * HashToUnitFloat(HashCombine(h, 2)) - 1.0f);
+        instance.seasonOffset = options_.seasonVariation * (2.0f * HashToUnitFloat(HashCombine(h, 3)) - 1.0f);
+        batches_[id].push_back(instance);
+        ++count_;
+        return id;
+    }
+
+    void Clear() {
+        for (auto& batch : batches_) {
+            batch.clear();
+        }
+        count_ = 0;
+    }
+
+    /**
+     * @brief Visit one instanced batch per archetype
+     * @param fn Called as fn(archetypeId, const TreeInstance* instances, size_t count)
+     */
+    template <typename Fn>
+    void ForEachBatch(Fn&& fn) const {
+        for (size_t id = 0; id < batches_.size(); ++id) {
+            if (!batches_[id].empty()) {
+                fn(uint32_t(id), batches_[id].data(), batches_[id].size());
+            }
+        }
+    }
+
+    size_t GetInstanceCount() const { return count_; }
+    size_t GetInstanceBytes() const { return count_ * sizeof(TreeInstance); }
+
+private:
+    Options options_;
+    std::vector<std::vector<TreeInstance>> batches_;
+    size_t count_ = 0;
+};
+
+} // namespace NRE
@@ -0,0 +1,436 @@
+#pragma once
+
+#include <nature/LSystem.h>
+#include <nature/TreeRenderer.h>
+#include <nature/TurtleInterpreter.h>
+#include <renderer/Mesh.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Incremental L-system growth with append-only branch meshes
+ *
+ * Instead of re-deriving the whole string every growth step, the tree keeps
+ * its active apices: every module that still has a production, together
+ * with the turtle state it was reached with. A step rewrites only those
+ * apices, resuming the turtle at each saved state, so its cost follows the
+ * number of apices and new segments, not the size of the tree.
+ *
+ * Drawn segments are never rewritten. For species whose rules rewrite F
+ * (oak, willow) the F is a span apex: its successor's top-level F chain is
+ * fitted onto the existing segment and only the bracketed side branches
+ * are added, attached where they would have started along the parent.
+ * Non-drawing apices (A, B) reproduce Generate() exactly at the same step
+ * count.
+ *
+ * New segments extend from zero to full length over one step, and radii
+ * follow the pipe model (thickness grows with the number of segments a
+ * branch supports, capped at the turtle radius), so existing branches
+ * lengthen and thicken in place. Every segment owns two rings in the mesh:
+ * new segments are appended, changed ones are rewritten in place, and the
+ * written vertex ranges are reported for partial uploads. Index data is
+ * only ever appended.
+ */
+class TreeGrowth {
+public:
+    struct Options {
+        float yearsPerStep = 2.0f;      // Years per derivation step
+        float tipRadius = 0.01f;        // Pipe-model radius of a single segment (meters)
+        float radiusTolerance = 0.02f;  // Relative thickening below which rings are not rewritten
+        int trunkSides = 8;             // Ring sides for order 0, 1 and >= 2
+        int branchSides = 5;
+        int twigSides = 3;
+        int maxSegments = 65536;
+        int maxLeaves = 65536;
+    };
+
+    /**
+     * @brief Written vertex range [first, first + count)
+     */
+    struct VertexRange {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    /**
+     * @brief Start a tree from its axiom
+     * @param config Tree config (species, seed; iterations caps the step count)
+     * @param options Growth options
+     */
+    TreeGrowth(const TreeRendererConfig& config, const Options& options)
+        : system_(LSystem::Preset(config.species)),
+          turtle_(system_, TurtleInterpreter::FromConfig(config)),
+          options_(options),
+          maxSteps_(config.iterations) {
+        skeleton_.Reserve(size_t(options_.maxSegments), size_t(options_.maxLeaves));
+        Apex root;
+        root.state = turtle_.InitialState();
+        Expand(root, system_.GetAxiom(uint32_t(config.seed)));
+        Flush();
+    }
+
+    TreeGrowth(const TreeGrowth&) = delete;
+    TreeGrowth& operator=(const TreeGrowth&) = delete;
+
+    /**
+     * @brief Advance growth
+     * @param years Years to grow
+     */
+    void Grow(float years) {
+        if (years <= 0.0f) {
+            return;
+        }
+        age_ += years;
+        while (step_ < maxSteps_ && age_ >= float(step_ + 1) * options_.yearsPerStep) {
+            SetProgress(1.0f);
+            Step();
+        }
+        SetProgress(std::clamp((age_ - float(step_) * options_.yearsPerStep) / options_.yearsPerStep, 0.0f, 1.0f));
+        Flush();
+    }
+
+    /**
+     * @brief Current skeleton (growing segments at their current length)
+     */
+    const TreeSkeleton& GetSkeleton() const { return skeleton_; }
+
+    /**
+     * @brief Branch mesh; vertices of existing segments are updated in place
+     */
+    const Mesh::LODLevel& GetMesh() const { return mesh_; }
+
+    /**
+     * @brief Vertex ranges written since the last ClearDirty(), sorted and merged
+     */
+    const std::vector<VertexRange>& GetDirtyRanges() const { return dirty_; }
+
+    /**
+     * @brief First index appended since the last ClearDirty()
+     */
+    size_t GetFirstNewIndex() const { return firstNewIndex_; }
+
+    /**
+     * @brief Vertices written since the last ClearDirty()
+     */
+    size_t GetVerticesWritten() const { return verticesWritten_; }
+
+    /**
+     * @brief Call after uploading the dirty ranges
+     */
+    void ClearDirty() {
+        dirty_.clear();
+        firstNewIndex_ = mesh_.indices.size();
+        verticesWritten_ = 0;
+    }
+
+    int GetStep() const { return step_; }
+    float GetAge() const { return age_; }
+    size_t GetApexCount() const { return apices_.size(); }
+
+private:
+    // A module that still rewrites, with the turtle state it was reached with
+    struct Apex {
+        LModule module{};
+        TurtleInterpreter::State state;
+        int32_t segment = -1;   // Span apex: the F's segment (-1 = non-drawing apex)
+        float t0 = 0.0f;        // Span along that segment
+        float t1 = 1.0f;
+    };
+
+    // Growth data kept alongside each skeleton segment
+    struct SegmentInfo {
+        float targetEnd[3];
+        float targetStartRadius;
+        float targetEndRadius;
+        float normal[3];        // Ring reference direction (parallel transported)
+        float v0;               // Texture V at the start ring
+        uint32_t firstVertex;
+        uint32_t support = 1;   // Segments in this subtree (pipe model)
+        float writtenRadius = 0.0f;  // Start radius the rings were last written with
+        uint32_t stamp = 0;     // Last Flush() that queued this segment
+        int sides;
+    };
+
+    void Step() {
+        std::vector<Apex> apices;
+        apices.swap(apices_);
+        for (const Apex& apex : apices) {
+            const int p = system_.ChooseProduction(apex.module);
+            if (p < 0) {
+                continue;
+            }
+            const auto& rule = system_.GetProduction(p).successor;
+            successor_.clear();
+            for (size_t c = 0; c < rule.size(); ++c) {
+                successor_.push_back(LSystem::MakeChild(apex.module, rule[c], c));
+            }
+            Expand(apex, successor_);
+        }
+        ++step_;
+    }
+
+    // Interpret a successor from an apex's saved state, recording new apices
+    void Expand(const Apex& apex, const std::vector<LModule>& modules) {
+        turtle_.Begin(apex.state, skeleton_);
+        const bool span = apex.segment >= 0;
+        float chain = 0.0f;     // Total top-level F length, fitted onto the span
+        if (span) {
+            int depth = 0;
+            for (const LModule& m : modules) {
+                depth += m.symbol == '[' ? 1 : m.symbol == ']' ? -1 : 0;
+                chain += depth == 0 && IsMove(m.symbol) ? m.param : 0.0f;
+            }
+        }
+        float t = apex.t0;
+        int depth = 0;
+        for (const LModule& m : modules) {
+            const bool rewrites = system_.ChooseProduction(m) >= 0;
+            if (span && depth == 0 && IsMove(m.symbol)) {
+                // Part of the existing segment: no geometry, possibly a new span apex
+                const float t1 = chain > 0.0f ? t + (apex.t1 - apex.t0) * m.param / chain : apex.t1;
+                turtle_.SetState(StateOnSpan(apex.segment, turtle_.GetState(), t));
+                if (rewrites && m.symbol == 'F') {
+                    apices_.push_back(Apex{m, turtle_.GetState(), apex.segment, t, t1});
+                }
+                turtle_.SetState(StateOnSpan(apex.segment, turtle_.GetState(), t1));
+                t = t1;
+                continue;
+            }
+            depth += m.symbol == '[' ? 1 : m.symbol == ']' ? -1 : 0;
+            if (m.symbol == 'F') {
+                const TurtleInterpreter::State before = turtle_.GetState();
+                const size_t count = skeleton_.segments.size();
+                turtle_.Execute(m);
+                if (skeleton_.segments.size() > count) {
+                    AddSegment(count);
+                    if (rewrites) {
+                        apices_.push_back(Apex{m, before, int32_t(count), 0.0f, 1.0f});
+                    }
+                }
+            } else if (rewrites) {
+                apices_.push_back(Apex{m, turtle_.GetState()});
+            } else {
+                turtle_.Execute(m);
+            }
+        }
+    }
+
+    static bool IsMove(char symbol) { return symbol == 'F' || symbol == 'f'; }
+
+    // Turtle state at fraction t of an existing segment (frame kept)
+    TurtleInterpreter::State StateOnSpan(int32_t segment, const TurtleInterpreter::State& frame, float t) const {
+        const BranchSegment& s = skeleton_.segments[size_t(segment)];
+        const SegmentInfo& info = info_[size_t(segment)];
+        TurtleInterpreter::State state = frame;
+        for (int a = 0; a < 3; ++a) {
+            state.position[a] = s.start[a] + (info.targetEnd[a] - s.start[a]) * t;
+        }
+        state.radius = info.targetStartRadius + (info.targetEndRadius - info.targetStartRadius) * t;
+        state.parent = segment;
+        state.order = s.order;
+        return state;
+    }
+
+    // Register a segment the turtle just appended and append its rings
+    void AddSegment(size_t index) {
+        BranchSegment& s = skeleton_.segments[index];
+        SegmentInfo info;
+        std::copy(s.end, s.end + 3, info.targetEnd);
+        info.targetStartRadius = s.startRadius;
+        info.targetEndRadius = s.endRadius;
+        info.sides = s.order == 0 ? options_.trunkSides : s.order == 1 ? options_.branchSides : options_.twigSides;
+        info.firstVertex = uint32_t(mesh_.vertices.size());
+
+        // Parallel transport the parent's reference direction onto this segment
+        float axis[3];
+        Axis(s, info, axis);
+        float normal[3] = {1.0f, 0.0f, 0.0f};
+        info.v0 = 0.0f;
+        if (s.parent >= 0) {
+            const BranchSegment& ps = skeleton_.segments[size_t(s.parent)];
+            const SegmentInfo& pi = info_[size_t(s.parent)];
+            std::copy(pi.normal, pi.normal + 3, normal);
+            info.v0 = pi.v0 + Length(ps.start, pi.targetEnd) / (6.28318530718f * std::max(pi.targetStartRadius, 1e-3f));
+        }
+        const float d = normal[0] * axis[0] + normal[1] * axis[1] + normal[2] * axis[2];
+        for (int a = 0; a < 3; ++a) {
+            normal[a] -= axis[a] * d;
+        }
+        if (normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2] < 1e-6f) {
+            const float fallback[3] = {0.0f, 0.0f, 1.0f};
+            Cross(axis, fallback, normal);
+            if (normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2] < 1e-6f) {
+                normal[0] = 1.0f;
+            }
+        }
+        Normalize(normal);
+        std::copy(normal, normal + 3, info.normal);
+        info_.push_back(info);
+
+        mesh_.vertices.resize(mesh_.vertices.size() + 2 * size_t(info.sides + 1));
+        const uint32_t startRing = info.firstVertex;
+        const uint32_t endRing = startRing + uint32_t(info.sides + 1);
+        for (int k = 0; k < info.sides; ++k) {
+            const uint32_t a = startRing + uint32_t(k);
+            const uint32_t b = endRing + uint32_t(k);
+            mesh_.indices.insert(mesh_.indices.end(), {a, b, a + 1, a + 1, b, b + 1});
+        }
+        mesh_.triangleCount = int(mesh_.indices.size() / 3);
+
+        // Starts at zero length; thicken everything it now supports
+        std::copy(s.start, s.start + 3, s.end);
+        growing_.push_back(uint32_t(index));
+        Queue(uint32_t(index));
+        for (int32_t p = s.parent; p >= 0; p = skeleton_.segments[size_t(p)].parent) {
+            SegmentInfo& parent = info_[size_t(p)];
+            ++parent.support;
+            if (PipeRadius(parent) > parent.writtenRadius * (1.0f + options_.radiusTolerance)) {
+                Queue(uint32_t(p));
+            }
+        }
+    }
+
+    // Extend the segments born this step to a fraction of their length
+    void SetProgress(float progress) {
+        for (uint32_t i : growing_) {
+            BranchSegment& s = skeleton_.segments[i];
+            const SegmentInfo& info = info_[i];
+            for (int a = 0; a < 3; ++a) {
+                s.end[a] = s.start[a] + (info.targetEnd[a] - s.start[a]) * progress;
+            }
+            Queue(i);
+        }
+        if (progress >= 1.0f) {
+            growing_.clear();
+        }
+    }
+
+    void Queue(uint32_t segment) {
+        if (info_[segment].stamp != flushStamp_) {
+            info_[segment].stamp = flushStamp_;
+            queued_.push_back(segment);
+        }
+    }
+
+    // Rewrite the rings of every queued segment and record the written ranges
+    void Flush() {
+        for (uint32_t i : queued_) {
+            WriteSegment(i);
+            const SegmentInfo& info = info_[i];
+            const uint32_t count = 2 * uint32_t(info.sides + 1);
+            dirty_.push_back(VertexRange{info.firstVertex, count});
+            verticesWritten_ += count;
+        }
+        // Merge, also with ranges left from earlier Grow() calls since the last upload
+        std::sort(dirty_.begin(), dirty_.end(),
+                  [](const VertexRange& a, const VertexRange& b) { return a.first < b.first; });
+        size_t merged = 0;
+        for (size_t r = 1; r < dirty_.size(); ++r) {
+            VertexRange& last = dirty_[merged];
+            if (last.first + last.count >= dirty_[r].first) {
+                last.count = std::max(last.count, dirty_[r].first + dirty_[r].count - last.first);
+            } else {
+                dirty_[++merged] = dirty_[r];
+            }
+        }
+        dirty_.resize(dirty_.empty() ? 0 : merged + 1);
+        queued_.clear();
+        ++flushStamp_;
+    }
+
+    // Pipe model: cross-section grows with the supported subtree, up to the turtle radius
+    float PipeRadius(const SegmentInfo& info) const {
+        return std::min(info.targetStartRadius, options_.tipRadius * std::sqrt(float(info.support)));
+    }
+
+    void WriteSegment(uint32_t index) {
+        BranchSegment& s = skeleton_.segments[index];
+        SegmentInfo& info = info_[index];
+        s.startRadius = PipeRadius(info);
+        s.endRadius = info.targetEndRadius * s.startRadius / std::max(info.targetStartRadius, 1e-6f);
+        info.writtenRadius = s.startRadius;
+
+        float axis[3];
+        Axis(s, info, axis);
+        float binormal[3];
+        Cross(axis, info.normal, binormal);
+        const float v1 = info.v0 + Length(s.start, s.end) / (6.28318530718f * std::max(info.targetStartRadius, 1e-3f));
+        Mesh::Vertex* vert = &mesh_.vertices[info.firstVertex];
+        for (int ring = 0; ring < 2; ++ring) {
+            const float* center = ring == 0 ? s.start : s.end;
+            const float radius = ring == 0 ? s.startRadius : s.endRadius;
+            for (int k = 0; k <= info.sides; ++k, ++vert) {  // Duplicate seam vertex for texture wrap
+                const float t = 6.28318530718f * float(k) / float(info.sides);
+                const float c = std::cos(t);
+                const float sn = std::sin(t);
+                for (int a = 0; a < 3; ++a) {
+                    vert->normal[a] = info.normal[a] * c + binormal[a] * sn;
+                    vert->position[a] = center[a] + vert->normal[a] * radius;
+                    vert->tangent[a] = -info.normal[a] * sn + binormal[a] * c;
+                    vert->bitangent[a] = axis[a];
+                }
+                vert->texCoord[0] = float(k) / float(info.sides);
+                vert->texCoord[1] = ring == 0 ? info.v0 : v1;
+            }
+        }
+    }
+
+    // Segment direction from its full-length target (valid at zero length)
+    static void Axis(const BranchSegment& s, const SegmentInfo& info, float axis[3]) {
+        for (int a = 0; a < 3; ++a) {
+            axis[a] = info.targetEnd[a] - s.start[a];
+        }
+        if (axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] < 1e-12f) {
+            axis[0] = 0.0f;
+            axis[1] = 1.0f;
+            axis[2] = 0.0f;
+        }
+        Normalize(axis);
+    }
+
+    static float Length(const float a[3], const float b[3]) {
+        const float d[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        return std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    }
+
+    static void Normalize(float v[3]) {
+        const float len = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        if (len > 1e-12f) {
+            v[0] /= len;
+            v[1] /= len;
+            v[2] /= len;
+        }
+    }
+
+    static void Cross(const float a[3], const float b[3], float out[3]) {
+        out[0] = a[1] * b[2] - a[2] * b[1];
+        out[1] = a[2] * b[0] - a[0] * b[2];
+        out[2] = a[0] * b[1] - a[1] * b[0];
+    }
+
+    LSystem system_;
+    TurtleInterpreter turtle_;      // References system_
+    Options options_;
+    int maxSteps_;
+    int step_ = 0;
+    float age_ = 0.0f;
+    TreeSkeleton skeleton_;
+    std::vector<SegmentInfo> info_;
+    std::vector<Apex> apices_;
+    std::vector<LModule> successor_;
+    std::vector<uint32_t> growing_;     // Segments born in the current step
+    std::vector<uint32_t> queued_;      // Segments to rewrite at the next Flush()
+    uint32_t flushStamp_ = 1;
+    Mesh::LODLevel mesh_{{}, {}, 0.0f, 0};
+    std::vector<VertexRange> dirty_;
+    size_t firstNewIndex_ = 0;
+    size_t verticesWritten_ = 0;
+};
+
+} // namespace NRE
@@ -0,0 +1,326 @@
+#pragma once
+
+#include <core/JobSystem.h>
+#include <nature/LSystem.h>
+#include <nature/TreeRenderer.h>
+#include <nature/FoliageSystem.h>
+#include <nature/TreeWindSway.h>
+#include <nature/TurtleInterpreter.h>
+#include <renderer/Mesh.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief All LODs of one generated tree
+ */
+struct TreeLODSet {
+    std::vector<Mesh::LODLevel> levels;  // Ordered by increasing distance; last is the billboard
+    float boundsMin[3] = {0.0f, 0.0f, 0.0f};
+    float boundsMax[3] = {0.0f, 0.0f, 0.0f};
+    size_t segmentCount = 0;
+    size_t leafCount = 0;
+    TreeSwayRig rig;                                // Wind sway bones
+    FoliageLODSet foliage;                          // Empty without a foliage builder
+    std::vector<std::vector<uint16_t>> vertexBones; // Sway bone of every vertex, per level
+};
+
+/**
+ * @brief Builds branch meshes from tree skeletons
+ *
+ * Each branch is a generalized cylinder: rings of vertices at segment ends,
+ * oriented by parallel transport so consecutive rings do not twist, with
+ * continuation segments sharing their parent's end ring. Ring side counts
+ * follow the screen size of the branch at each LOD's switch distance (the
+ * chord error of the polygonal ring stays under maxPixelError), and
+ * branches thinner than half a pixel are dropped. The last LOD is a pair of
+ * crossed billboard quads covering the tree's bounds. Every build also
+ * bakes the tree's TreeSwayRig and tags each vertex with its sway bone.
+ */
+class TreeMeshBuilder {
+public:
+    struct Options {
+        std::vector<float> lodDistances = {0.0f, 25.0f, 60.0f, 150.0f};  // Last one is the billboard
+        float screenHeight = 1080.0f;   // Pixels
+        float verticalFov = 1.0f;       // Radians
+        float maxPixelError = 1.0f;     // Allowed ring chord error (pixels)
+        int minSides = 3;
+        int maxSides = 16;
+        int maxSegments = 65536;        // Skeleton buffer limits per tree
+        int maxLeaves = 65536;
+        TreeSwayRig::Options sway;
+    };
+
+    explicit TreeMeshBuilder(const Options& options) : options_(options) {}
+
+    /**
+     * @brief Also build foliage in Generate()
+     * @param foliage Foliage builder (must outlive this builder; nullptr to disable)
+     */
+    void SetFoliageBuilder(const FoliageBuilder* foliage) { foliage_ = foliage; }
+
+    /**
+     * @brief Pixels covered by one meter at a distance
+     */
+    float PixelsPerMeter(float distance) const {
+        return options_.screenHeight / (2.0f * std::max(distance, 1.0f) * std::tan(0.5f * options_.verticalFov));
+    }
+
+    /**
+     * @brief Ring sides for a radius at a distance (0 = too thin to draw)
+     */
+    int SidesFor(float radius, float distance) const {
+        const float pixels = radius * PixelsPerMeter(distance);
+        if (pixels < 0.5f) {
+            return 0;
+        }
+        // Sagitta of an n-gon inscribed in radius r: r * (1 - cos(pi / n))
+        const float ratio = std::max(0.0f, 1.0f - options_.maxPixelError / pixels);
+        const float sides = ratio <= 0.0f ? float(options_.minSides) : 3.14159265f / std::acos(ratio);
+        return std::clamp(int(std::ceil(sides)), options_.minSides, options_.maxSides);
+    }
+
+    /**
+     * @brief Build all LODs and the sway rig for a skeleton
+     * @param skeleton Tree skeleton
+     * @param out Output LODs
+     * @param seed Seed for per-bone sway phases
+     */
+    void Build(const TreeSkeleton& skeleton, TreeLODSet& out, uint32_t seed = 0) const {
+        out.levels.clear();
+        out.vertexBones.clear();
+        out.rig = TreeSwayRig::Bake(skeleton, options_.sway, seed);
+        out.segmentCount = skeleton.segments.size();
+        out.leafCount = skeleton.leaves.size();
+        ComputeBounds(skeleton, out);
+        const size_t lodCount = options_.lodDistances.size();
+        for (size_t l = 0; l + 1 < lodCount; ++l) {
+            Mesh::LODLevel level;
+            std::vector<uint16_t> bones;
+            BuildCylinders(skeleton, out.rig, options_.lodDistances[l], level, bones);
+            level.distance = options_.lodDistances[l];
+            level.triangleCount = int(level.indices.size() / 3);
+            out.levels.push_back(std::move(level));
+            out.vertexBones.push_back(std::move(bones));
+        }
+        if (lodCount > 0) {
+            Mesh::LODLevel billboard;
+            BuildBillboard(out, billboard);
+            billboard.distance = options_.lodDistances.back();
+            billboard.triangleCount = int(billboard.indices.size() / 3);
+            out.vertexBones.emplace_back(billboard.vertices.size(), uint16_t(0));  // Sways with the trunk
+            out.levels.push_back(std::move(billboard));
+        }
+    }
+
+    /**
+     * @brief Generate a complete tree from its config
+     */
+    void Generate(const TreeRendererConfig& config, TreeLODSet& out) const {
+        thread_local TreeSkeleton skeleton;
+        skeleton.Reserve(size_t(options_.maxSegments), size_t(options_.maxLeaves));
+        const LSystem system = LSystem::Preset(config.species);
+        TurtleInterpreter turtle(system, TurtleInterpreter::FromConfig(config));
+        turtle.Generate(config.iterations, uint32_t(config.seed), skeleton);
+        Build(skeleton, out, uint32_t(config.seed));
+        if (foliage_) {
+            foliage_->Build(skeleton, config, out.foliage, &out.rig);
+        }
+    }
+
+    /**
+     * @brief Generate many trees in parallel
+     * @param configs One config per tree (e.g. unique seeds)
+     * @param out Output, resized to configs.size()
+     * @param jobs Optional job system
+     */
+    void GenerateForest(const std::vector<TreeRendererConfig>& configs, std::vector<TreeLODSet>& out,
+                        JobSystem* jobs = nullptr) const {
+        out.resize(configs.size());
+        auto work = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                Generate(configs[i], out[i]);
+            }
+        };
+        if (jobs) {
+            jobs->ParallelFor(0, configs.size(), 1, work);
+        } else {
+            work(0, configs.size());
+        }
+    }
+
+private:
+    static void Normalize(float v[3]) {
+        const float len = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        if (len > 1e-12f) {
+            v[0] /= len;
+            v[1] /= len;
+            v[2] /= len;
+        }
+    }
+
+    static void Cross(const float a[3], const float b[3], float out[3]) {
+        out[0] = a[1] * b[2] - a[2] * b[1];
+        out[1] = a[2] * b[0] - a[0] * b[2];
+        out[2] = a[0] * b[1] - a[1] * b[0];
+    }
+
+    static void ComputeBounds(const TreeSkeleton& skeleton, TreeLODSet& out) {
+        for (int a = 0; a < 3; ++a) {
+            out.boundsMin[a] = skeleton.segments.empty() ? 0.0f : 1e30f;
+            out.boundsMax[a] = skeleton.segments.empty() ? 0.0f : -1e30f;
+        }
+        for (const auto& s : skeleton.segments) {
+            for (int a = 0; a < 3; ++a) {
+                out.boundsMin[a] = std::min({out.boundsMin[a], s.start[a] - s.startRadius, s.end[a] - s.endRadius});
+                out.boundsMax[a] = std::max({out.boundsMax[a], s.start[a] + s.startRadius, s.end[a] + s.endRadius});
+            }
+        }
+        for (const auto& leaf : skeleton.leaves) {
+            for (int a = 0; a < 3; ++a) {
+                out.boundsMin[a] = std::min(out.boundsMin[a], leaf.position[a] - leaf.size);
+                out.boundsMax[a] = std::max(out.boundsMax[a], leaf.position[a] + leaf.size);
+            }
+        }
+    }
+
+    struct RingInfo {
+        uint32_t firstVertex = 0;
+        int sides = 0;
+        float normal[3] = {1.0f, 0.0f, 0.0f};  // Ring reference direction (parallel transported)
+        float v = 0.0f;                        // Texture V along the branch
+        bool continued = false;                // Already shared with a continuation child
+    };
+
+    void EmitRing(const float center[3], const float axis[3], const float normal[3], float radius, int sides,
+                  float v, Mesh::LODLevel& level) const {
+        float binormal[3];
+        Cross(axis, normal, binormal);
+        for (int k = 0; k <= sides; ++k) {  // Duplicate seam vertex for texture wrap
+            const float t = 6.28318530718f * float(k) / float(sides);
+            const float c = std::cos(t);
+            const float s = std::sin(t);
+            Mesh::Vertex vert;
+            for (int a = 0; a < 3; ++a) {
+                vert.normal[a] = normal[a] * c + binormal[a] * s;
+                vert.position[a] = center[a] + vert.normal[a] * radius;
+                vert.tangent[a] = -normal[a] * s + binormal[a] * c;
+                vert.bitangent[a] = axis[a];
+            }
+            vert.texCoord[0] = float(k) / float(sides);
+            vert.texCoord[1] = v;
+            level.vertices.push_back(vert);
+        }
+    }
+
+    void BuildCylinders(const TreeSkeleton& skeleton, const TreeSwayRig& rig, float distance, Mesh::LODLevel& level,
+                        std::vector<uint16_t>& bones) const {
+        thread_local std::vector<RingInfo> rings;
+        rings.assign(skeleton.segments.size(), RingInfo{});
+        level.vertices.clear();
+        level.indices.clear();
+
+        for (size_t i = 0; i < skeleton.segments.size(); ++i) {
+            const BranchSegment& s = skeleton.segments[i];
+            const int sides = SidesFor(s.startRadius, distance);
+            if (sides == 0) {
+                continue;  // Children are thinner still, and are skipped the same way
+            }
+            float axis[3] = {s.end[0] - s.start[0], s.end[1] - s.start[1], s.end[2] - s.start[2]};
+            const float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+            if (length < 1e-6f) {
+                continue;
+            }
+            Normalize(axis);
+
+            // Parallel transport the parent's reference direction onto this segment
+            RingInfo* parent = s.parent >= 0 ? &rings[size_t(s.parent)] : nullptr;
+            float normal[3] = {1.0f, 0.0f, 0.0f};
+            if (parent && parent->sides > 0) {
+                std::copy(parent->normal, parent->normal + 3, normal);
+            }
+            const float d = normal[0] * axis[0] + normal[1] * axis[1] + normal[2] * axis[2];
+            for (int a = 0; a < 3; ++a) {
+                normal[a] -= axis[a] * d;
+            }
+            if (normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2] < 1e-6f) {
+                const float fallback[3] = {0.0f, 0.0f, 1.0f};
+                Cross(axis, fallback, normal);
+                if (normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2] < 1e-6f) {
+                    normal[0] = 1.0f;
+                }
+            }
+            Normalize(normal);
+
+            // Continuation segments share the parent's end ring when it matches
+            uint32_t startRing;
+            const float v0 = parent ? parent->v : 0.0f;
+            if (parent && parent->sides == sides && !parent->continued && s.order == skeleton.segments[size_t(s.parent)].order) {
+                startRing = parent->firstVertex;
+                parent->continued = true;
+            } else {
+                startRing = uint32_t(level.vertices.size());
+                EmitRing(s.start, axis, normal, s.startRadius, sides, v0, level);
+            }
+            const uint16_t bone = rig.segmentBone.empty() ? uint16_t(0) : rig.segmentBone[i];
+            const float v1 = v0 + length / (6.28318530718f * std::max(s.startRadius, 1e-3f));
+            const uint32_t endRing = uint32_t(level.vertices.size());
+            EmitRing(s.end, axis, normal, s.endRadius, sides, v1, level);
+            bones.resize(level.vertices.size(), bone);
+
+            for (int k = 0; k < sides; ++k) {
+                const uint32_t a = startRing + uint32_t(k);
+                const uint32_t b = endRing + uint32_t(k);
+                level.indices.insert(level.indices.end(), {a, b, a + 1, a + 1, b, b + 1});
+            }
+
+            RingInfo& ring = rings[i];
+            ring.firstVertex = endRing;
+            ring.sides = sides;
+            std::copy(normal, normal + 3, ring.normal);
+            ring.v = v1;
+        }
+    }
+
+    // Two vertical quads crossing at the trunk, spanning the tree's bounds
+    static void BuildBillboard(const TreeLODSet& set, Mesh::LODLevel& level) {
+        const float cx = 0.5f * (set.boundsMin[0] + set.boundsMax[0]);
+        const float cz = 0.5f * (set.boundsMin[2] + set.boundsMax[2]);
+        const float hx = 0.5f * (set.boundsMax[0] - set.boundsMin[0]);
+        const float hz = 0.5f * (set.boundsMax[2] - set.boundsMin[2]);
+        const float y0 = set.boundsMin[1];
+        const float y1 = set.boundsMax[1];
+        for (int q = 0; q < 2; ++q) {
+            const float dir[3] = {q == 0 ? hx : 0.0f, 0.0f, q == 0 ? 0.0f : hz};
+            const float normal[3] = {q == 0 ? 0.0f : 1.0f, 0.0f, q == 0 ? 1.0f : 0.0f};
+            const uint32_t base = uint32_t(level.vertices.size());
+            for (int corner = 0; corner < 4; ++corner) {
+                const float u = (corner == 1 || corner == 2) ? 1.0f : 0.0f;
+                const float v = corner >= 2 ? 1.0f : 0.0f;
+                Mesh::Vertex vert;
+                vert.position[0] = cx + dir[0] * (2.0f * u - 1.0f);
+                vert.position[1] = y0 + (y1 - y0) * v;
+                vert.position[2] = cz + dir[2] * (2.0f * u - 1.0f);
+                for (int a = 0; a < 3; ++a) {
+                    vert.normal[a] = normal[a];
+                    vert.tangent[a] = q == 0 ? float(a == 0) : float(a == 2);
+                    vert.bitangent[a] = float(a == 1);
+                }
+                vert.texCoord[0] = 0.5f * float(q) + 0.5f * u;  // Each quad uses half the atlas
+                vert.texCoord[1] = 1.0f - v;
+                level.vertices.push_back(vert);
+            }
+            level.indices.insert(level.indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+        }
+    }
+
+    Options options_;
+    const FoliageBuilder* foliage_ = nullptr;
+};
+
+} // namespace NRE
@@ -6,6 +6,37 @@
 
 namespace NRE {
 
+class WindField;
+
+/**
+ * @brief Tree configuration (TreeRenderer::TreeConfig)
+ *
+ * Kept outside TreeRenderer for the same reason as EcosystemConfig.
+ */
+struct TreeRendererConfig {
+    // Generation
+    std::string species = "oak";    // oak, pine, maple, birch, etc.
+    int seed = 0;
+    float age = 10.0f;              // Years old
+    float height = 10.0f;           // Meters
+    
+    // L-System parameters
+    int iterations = 5;
+    float branchAngle = 25.0f;
+    float branchLength = 1.0f;
+    float branchThickness = 0.1f;
+    
+    // Visual detail
+    int leafCount = 10000;
+    bool individualLeaves = true;   // vs. billboard leaves
+    int barkTextureResolution = 4096;
+    
+    // Physics
+    bool enableWindPhysics = true;
+    bool enableGrowthSimulation = false;
+    bool enableSeasonalChanges = true;
+};
+
 /**
  * @brief Photorealistic tree rendering and simulation
  * 
@@ -13,29 +44,7 @@ namespace NRE {
  */
 class TreeRenderer {
 public:
-    struct TreeConfig {
-        // Generation
-        std::string species = "oak";    // oak, pine, maple, birch, etc.
-        int seed = 0;
-        float age = 10.0f;              // Years old
-        float height = 10.0f;           // Meters
-        
-        // L-System parameters
-        int iterations = 5;
-        float branchAngle = 25.0f;
-        float branchLength = 1.0f;
-        float branchThickness = 0.1f;
-        
-        // Visual detail
-        int leafCount = 10000;
-        bool individualLeaves = true;   // vs. billboard leaves
-        int barkTextureResolution = 4096;
-        
-        // Physics
-        bool enableWindPhysics = true;
-        bool enableGrowthSimulation = false;
-        bool enableSeasonalChanges = true;
-    };
+    using TreeConfig = TreeRendererConfig;
 
     enum class Season {
         Spring,     // New leaves, flowers
@@ -55,6 +64,9 @@ public:
 
     /**
      * @brief Generate tree using L-system
+     *
+     * Expands LSystem::Preset(species) for TreeConfig::iterations with the
+     * config seed; 7-8 iterations expand in milliseconds.
      */
     virtual void Generate() = 0;
 
@@ -71,19 +83,34 @@ public:
 
     /**
      * @brief Set current season
+     *
+     * Only changes the season parameter fed to FoliageBuilder::SeasonColor;
+     * foliage geometry is never rebuilt.
      * @param season Season to set
      */
     virtual void SetSeason(Season season) = 0;
 
     /**
-     * @brief Apply wind force
+     * @brief Apply wind force (uniform; ignored while a wind field is set)
+     *
+     * Forests are animated in bulk by TreeWindSway instead.
      * @param direction Wind direction (normalized)
      * @param strength Wind strength (0-1)
      */
     virtual void ApplyWind(const float direction[3], float strength) = 0;
 
+    /**
+     * @brief Sample wind from a shared field instead of ApplyWind
+     * @param field Wind field (nullptr to go back to ApplyWind)
+     */
+    virtual void SetWindField(const WindField* field) = 0;
+
     /**
      * @brief Simulate growth over time
+     *
+     * With enableGrowthSimulation, implementations advance a TreeGrowth
+     * instead of regenerating: only active apices are rewritten and the
+     * branch mesh is appended to and patched in place.
      * @param years Years to grow
      */
     virtual void Grow(float years) = 0;
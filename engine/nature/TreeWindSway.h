@@ -0,0 +1,479 @@
+#pragma once
+
+#include <core/JobSystem.h>
+#include <core/Random.h>
+#include <core/Simd.h>
+#include <nature/TurtleInterpreter.h>
+#include <nature/WindField.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief One sway bone: a branch chain from its base to its tip
+ */
+struct SwayBone {
+    float pivot[3];     // Branch base in tree space (rest pose)
+    float frequency;    // Natural frequency (Hz)
+    float amplitude;    // Bend (radians) at reference wind speed
+    float phase;        // Radians
+    int32_t parent;     // Parent bone (-1 = root)
+    uint32_t level;     // Hierarchy level (parent level + 1)
+};
+
+/**
+ * @brief Sway bones of one tree, baked at generation
+ *
+ * Each branch chain (a run of segments of the same order) becomes one bone
+ * up to maxLevels deep and maxBones in total; deeper or further branches
+ * ride on their parent's bone. Spring parameters follow a cantilever
+ * model: frequency ~ radius / length^2 and compliance ~ (length / radius)^1.5.
+ * Bones are sorted by level, so parents always precede their children.
+ */
+struct TreeSwayRig {
+    struct Options {
+        uint32_t maxLevels = 3;         // Trunk, limbs, branches (at most 8)
+        uint32_t maxBones = 32;
+        float stiffness = 400.0f;       // Frequency = stiffness * radius / length^2
+        float minFrequency = 0.1f;
+        float maxFrequency = 8.0f;
+        float compliance = 1e-4f;       // Amplitude = compliance * (length / radius)^1.5
+        float maxAmplitude = 0.5f;      // Radians
+    };
+
+    /**
+     * @brief Bones of one level as structure-of-arrays, padded to a multiple of 4
+     */
+    struct Level {
+        std::vector<float> pivotX, pivotY, pivotZ, omega, amplitude, phase;
+        std::vector<int32_t> parent;    // Index into the previous level
+        size_t count = 0;               // Real bones (the rest is inert padding)
+    };
+
+    std::vector<SwayBone> bones;
+    std::vector<uint32_t> levelStart;   // First bone of each level, plus the end
+    std::vector<Level> levels;
+    std::vector<uint16_t> segmentBone;  // Bone of each skeleton segment
+    float crownHeight = 0.0f;           // Height at which wind is sampled
+
+    /**
+     * @brief Bake the rig of a skeleton
+     */
+    static TreeSwayRig Bake(const TreeSkeleton& skeleton, const Options& options, uint32_t seed = 0) {
+        TreeSwayRig rig;
+        std::vector<SwayBone> bones;
+        std::vector<float> length;
+        std::vector<float> radius;
+        std::vector<uint32_t> boneOf(skeleton.segments.size(), 0);
+        float top = 0.0f;
+
+        for (size_t i = 0; i < skeleton.segments.size(); ++i) {
+            const BranchSegment& s = skeleton.segments[i];
+            const int32_t parentBone = s.parent >= 0 ? int32_t(boneOf[size_t(s.parent)]) : -1;
+            const bool branches = parentBone < 0 || s.order != skeleton.segments[size_t(s.parent)].order;
+            const uint32_t level = parentBone < 0 ? 0 : bones[size_t(parentBone)].level + 1;
+            if (branches && (parentBone < 0 || level < options.maxLevels) &&
+                (bones.size() < options.maxBones || bones.empty())) {
+                SwayBone bone;
+                std::copy(s.start, s.start + 3, bone.pivot);
+                bone.parent = parentBone;
+                bone.level = level;
+                bone.phase = HashToUnitFloat(HashCombine(seed, uint32_t(bones.size()))) * 6.28318530718f;
+                boneOf[i] = uint32_t(bones.size());
+                bones.push_back(bone);
+                length.push_back(0.0f);
+                radius.push_back(s.startRadius);
+            } else {
+                boneOf[i] = parentBone < 0 ? 0 : uint32_t(parentBone);
+            }
+            const float dx = s.end[0] - s.start[0];
+            const float dy = s.end[1] - s.start[1];
+            const float dz = s.end[2] - s.start[2];
+            length[boneOf[i]] += std::sqrt(dx * dx + dy * dy + dz * dz);
+            top = std::max(top, s.end[1]);
+        }
+
+        for (size_t b = 0; b < bones.size(); ++b) {
+            const float l = std::max(length[b], 1e-3f);
+            const float r = std::max(radius[b], 1e-4f);
+            bones[b].frequency = std::clamp(options.stiffness * r / (l * l), options.minFrequency, options.maxFrequency);
+            bones[b].amplitude = std::min(options.compliance * std::pow(l / r, 1.5f), options.maxAmplitude);
+        }
+
+        // Sort by level (stable, so parents still precede children) and remap
+        std::vector<uint32_t> order(bones.size());
+        for (size_t b = 0; b < order.size(); ++b) {
+            order[b] = uint32_t(b);
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&bones](uint32_t a, uint32_t b) { return bones[a].level < bones[b].level; });
+        std::vector<uint32_t> remap(bones.size());
+        for (size_t b = 0; b < order.size(); ++b) {
+            remap[order[b]] = uint32_t(b);
+        }
+        rig.bones.reserve(bones.size());
+        for (uint32_t b : order) {
+            SwayBone bone = bones[b];
+            bone.parent = bone.parent < 0 ? -1 : int32_t(remap[size_t(bone.parent)]);
+            rig.bones.push_back(bone);
+        }
+        rig.segmentBone.resize(boneOf.size());
+        for (size_t i = 0; i < boneOf.size(); ++i) {
+            rig.segmentBone[i] = uint16_t(remap.empty() ? 0 : remap[boneOf[i]]);
+        }
+        for (size_t b = 0; b < rig.bones.size(); ++b) {
+            while (rig.levelStart.size() <= rig.bones[b].level) {
+                rig.levelStart.push_back(uint32_t(b));
+            }
+        }
+        rig.levelStart.push_back(uint32_t(rig.bones.size()));
+        rig.levels.resize(rig.levelStart.size() - 1);
+        for (size_t l = 0; l < rig.levels.size(); ++l) {
+            Level& level = rig.levels[l];
+            level.count = rig.levelStart[l + 1] - rig.levelStart[l];
+            const size_t padded = (level.count + 3) & ~size_t(3);
+            for (size_t i = 0; i < padded; ++i) {
+                const bool real = i < level.count;
+                const SwayBone& bone = rig.bones[rig.levelStart[l] + (real ? i : 0)];
+                level.pivotX.push_back(bone.pivot[0]);
+                level.pivotY.push_back(bone.pivot[1]);
+                level.pivotZ.push_back(bone.pivot[2]);
+                level.omega.push_back(bone.frequency * 6.28318530718f);
+                level.amplitude.push_back(real ? bone.amplitude : 0.0f);
+                level.phase.push_back(bone.phase);
+                level.parent.push_back(l == 0 ? 0 : int32_t(bone.parent) - int32_t(rig.levelStart[l - 1]));
+            }
+        }
+        rig.crownHeight = 0.6f * top;
+        return rig;
+    }
+};
+
+/**
+ * @brief Skinning transform of one bone (v' = rotate(q, v) + t, tree space)
+ */
+struct BoneTransform {
+    float rotation[4];      // Quaternion x, y, z, w
+    float translation[3];
+};
+
+/**
+ * @brief Batched hierarchical wind sway for every visible tree
+ *
+ * Trees are registered each frame with AddTree(). Each bone's own bend is
+ * a closed-form oscillator, a static lean plus a swing at its natural
+ * frequency along the wind and a flutter across it, scaled by the squared
+ * wind speed (drag). Evaluate() runs one Float4 pass per hierarchy level
+ * over all trees: parents are finished before their children, so each bone
+ * adds its parent's bend and is carried by its parent's transform. Baked
+ * bone data is read straight from the (shared) rigs, and per-frame scratch
+ * holds only what the next level needs. Bends add as rotation vectors,
+ * which is exact along the wind and a small-angle approximation across it.
+ */
+class TreeWindSway {
+public:
+    struct Options {
+        float referenceSpeed = 10.0f;   // Wind speed (m/s) at which bones bend by their amplitude
+        float lean = 0.6f;              // Static share of the bend
+        float swing = 0.4f;             // Oscillating share along the wind
+        float flutter = 0.25f;          // Oscillating share across the wind
+        float maxBend = 1.0f;           // Radians, accumulated per bone
+    };
+
+    explicit TreeWindSway(const Options& options) : options_(options) {}
+
+    /**
+     * @brief Uniform wind used while no field is set
+     * @param direction Horizontal direction (x, z), need not be normalized
+     */
+    void SetWind(const float direction[2], float speed) {
+        const float len = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1]);
+        const float k = len > 1e-6f ? speed / len : 0.0f;
+        wind_[0] = direction[0] * k;
+        wind_[1] = direction[1] * k;
+    }
+
+    void SetWindField(const WindField* field) { field_ = field; }
+
+    /**
+     * @brief Drop all trees (call at the start of each frame)
+     */
+    void BeginFrame() {
+        trees_.clear();
+        rigidTrees_.clear();
+        treeX_.clear();
+        treeY_.clear();
+        treeZ_.clear();
+        for (auto& scratch : scratch_) {
+            scratch.used = 0;
+        }
+        boneCount_ = 0;
+    }
+
+    /**
+     * @brief Register a visible tree
+     * @param rig Baked rig of the tree's archetype (must outlive the frame)
+     * @param position World position of the trunk base
+     * @param yaw Instance rotation around Y (radians)
+     * @param scale Instance scale
+     * @param levels Hierarchy levels to animate; deeper bones follow their
+     *               parent rigidly (use fewer levels for distant trees)
+     * @return Index of the tree's first bone in GetTransforms()
+     */
+    uint32_t AddTree(const TreeSwayRig& rig, const float position[3], float yaw, float scale = 1.0f,
+                     uint32_t levels = kMaxLevels) {
+        Tree tree;
+        tree.rig = &rig;
+        tree.yaw = yaw;
+        tree.first = uint32_t(boneCount_);
+        tree.levels = uint32_t(std::min<size_t>({levels, rig.levels.size(), kMaxLevels}));
+        if (tree.levels < rig.levels.size()) {
+            rigidTrees_.push_back(uint32_t(trees_.size()));
+        }
+        if (scratch_.size() < rig.levels.size()) {
+            scratch_.resize(rig.levels.size());
+        }
+        for (size_t l = 0; l < tree.levels; ++l) {
+            tree.scratch[l] = uint32_t(scratch_[l].used);
+            scratch_[l].used += rig.levels[l].pivotX.size();
+        }
+        trees_.push_back(tree);
+        treeX_.push_back(position[0]);
+        treeY_.push_back(position[1] + rig.crownHeight * scale);
+        treeZ_.push_back(position[2]);
+        boneCount_ += rig.bones.size();
+        return tree.first;
+    }
+
+    /**
+     * @brief Evaluate every registered bone
+     * @param time Animation time (seconds)
+     * @param jobs Optional job system (each level is split across workers)
+     */
+    void Evaluate(float time, JobSystem* jobs = nullptr) {
+        UpdateTreeWind();
+        if (transforms_.size() < boneCount_) {
+            transforms_.resize(boneCount_);
+        }
+        for (auto& scratch : scratch_) {
+            scratch.Reserve(scratch.used);
+        }
+        for (size_t l = 0; l < scratch_.size() && l < kMaxLevels; ++l) {
+            if (jobs && trees_.size() >= 2 * kTreesPerJob) {
+                jobs->ParallelFor(0, trees_.size(), kTreesPerJob, [&](size_t begin, size_t end) {
+                    EvaluateLevel(l, time, begin, end);
+                });
+            } else {
+                EvaluateLevel(l, time, 0, trees_.size());
+            }
+        }
+        for (uint32_t t : rigidTrees_) {
+            const Tree& tree = trees_[t];
+            const TreeSwayRig& rig = *tree.rig;
+            BoneTransform* transforms = transforms_.data() + tree.first;
+            for (size_t b = rig.levelStart[tree.levels]; b < rig.bones.size(); ++b) {
+                transforms[b] = transforms[size_t(rig.bones[b].parent)];
+            }
+        }
+    }
+
+    /**
+     * @brief Bone transforms of all trees (GetBoneCount() entries, tree by tree
+     * in rig bone order)
+     */
+    const BoneTransform* GetTransforms() const { return transforms_.data(); }
+    size_t GetTreeCount() const { return trees_.size(); }
+    size_t GetBoneCount() const { return boneCount_; }
+
+private:
+    static constexpr size_t kMaxLevels = 8;
+    static constexpr size_t kTreesPerJob = 64;
+
+    struct Tree {
+        const TreeSwayRig* rig;
+        float yaw;
+        uint32_t levels;                // Animated levels
+        uint32_t first;                 // First output transform
+        uint32_t scratch[kMaxLevels];   // Offset of each level in scratch_
+        float windX, windZ, drive;      // Tree-space wind direction and drag drive
+    };
+
+    // Results of one level that its children read
+    struct Scratch {
+        std::vector<float> bend, cross, tx, ty, tz;
+        size_t used = 0;
+
+        void Reserve(size_t n) {
+            if (bend.size() < n) {
+                for (auto* v : {&bend, &cross, &tx, &ty, &tz}) v->resize(n);
+            }
+        }
+    };
+
+    // Per-tree wind in tree space: direction and drag drive
+    void UpdateTreeWind() {
+        const size_t n = trees_.size();
+        windX_.resize(n);
+        windY_.resize(n);
+        windZ_.resize(n);
+        if (field_) {
+            field_->SampleMany(treeX_.data(), treeY_.data(), treeZ_.data(), n, windX_.data(), windY_.data(),
+                               windZ_.data());
+        } else {
+            std::fill(windX_.begin(), windX_.end(), wind_[0]);
+            std::fill(windZ_.begin(), windZ_.end(), wind_[1]);
+        }
+        const float invRef = 1.0f / (options_.referenceSpeed * options_.referenceSpeed);
+        for (size_t t = 0; t < n; ++t) {
+            Tree& tree = trees_[t];
+            const float speed2 = windX_[t] * windX_[t] + windZ_[t] * windZ_[t];
+            const float inv = speed2 > 1e-12f ? 1.0f / std::sqrt(speed2) : 0.0f;
+            // Rotate the world direction into tree space (inverse yaw)
+            const float c = std::cos(tree.yaw);
+            const float s = std::sin(tree.yaw);
+            const float wx = windX_[t] * inv;
+            const float wz = windZ_[t] * inv;
+            tree.windX = c * wx - s * wz;
+            tree.windZ = s * wx + c * wz;
+            tree.drive = speed2 * invRef;
+        }
+    }
+
+    static Float4 Gather(const float* v, const int32_t* index) {
+        return Float4(v[index[0]], v[index[1]], v[index[2]], v[index[3]]);
+    }
+
+    // Quaternion of a bend (around up x wind) plus a cross bend (around the
+    // wind) in tree space; qy is always 0. Half-angle series, accurate for
+    // the clamped bends.
+    static void BendQuaternion(Float4 wx, Float4 wz, Float4 bend, Float4 cross, Float4& qx, Float4& qz, Float4& qw) {
+        const Float4 one(1.0f);
+        const Float4 half(0.5f);
+        const Float4 rx = wz * bend + wx * cross;
+        const Float4 rz = wz * cross - wx * bend;
+        const Float4 h2 = (rx * rx + rz * rz) * Float4(0.25f);
+        const Float4 sinc = half * (one - h2 * Float4(1.0f / 6.0f) + h2 * h2 * Float4(1.0f / 120.0f));
+        qw = one - h2 * half + h2 * h2 * Float4(1.0f / 24.0f);
+        qx = rx * sinc;
+        qz = rz * sinc;
+    }
+
+    // q * v * q^-1 for q = (qx, 0, qz, qw): v + 2w(q x v) + 2 q x (q x v)
+    static void Rotate(Float4 qx, Float4 qz, Float4 qw, Float4& x, Float4& y, Float4& z) {
+        const Float4 two(2.0f);
+        const Float4 cx = Float4(0.0f) - qz * y * two;
+        const Float4 cy = (qz * x - qx * z) * two;
+        const Float4 cz = qx * y * two;
+        x = x + qw * cx - qz * cy;
+        y = y + qw * cy + (qz * cx - qx * cz);
+        z = z + qw * cz + qx * cy;
+    }
+
+    void EvaluateLevel(size_t l, float time, size_t begin, size_t end) {
+        const Float4 t(time);
+        const Float4 lean(options_.lean);
+        const Float4 swing(options_.swing);
+        const Float4 flutter(options_.flutter);
+        const Float4 maxBend(options_.maxBend);
+        const Float4 minBend(-options_.maxBend);
+        Scratch& out = scratch_[l];
+        const Scratch* in = l > 0 ? &scratch_[l - 1] : nullptr;
+
+        for (size_t ti = begin; ti < end; ++ti) {
+            const Tree& tree = trees_[ti];
+            if (l >= tree.levels) {
+                continue;
+            }
+            const TreeSwayRig::Level& level = tree.rig->levels[l];
+            const Float4 wx(tree.windX);
+            const Float4 wz(tree.windZ);
+            const Float4 drive(tree.drive);
+            const size_t base = tree.scratch[l];
+            const size_t parentBase = l > 0 ? tree.scratch[l - 1] : 0;
+            BoneTransform* transforms = transforms_.data() + tree.first + tree.rig->levelStart[l];
+
+            for (size_t i = 0; i < level.count; i += 4) {
+                const Float4 px = Float4::Load(level.pivotX.data() + i);
+                const Float4 py = Float4::Load(level.pivotY.data() + i);
+                const Float4 pz = Float4::Load(level.pivotZ.data() + i);
+                const Float4 omega = Float4::Load(level.omega.data() + i);
+                const Float4 phase = Float4::Load(level.phase.data() + i);
+                const Float4 amplitude = drive * Float4::Load(level.amplitude.data() + i);
+
+                // Own bend along and across the wind
+                Float4 bend = amplitude * (lean + swing * Sin(omega * t + phase));
+                Float4 cross = amplitude * flutter * Sin(Float4(1.37f) * omega * t + phase + phase);
+
+                // Pivot carried by the parent (same tree and wind, so the
+                // parent's rotation follows from its accumulated bends)
+                Float4 mx = px, my = py, mz = pz;
+                if (in) {
+                    const int32_t* parent = level.parent.data() + i;
+                    const Float4 parentBend = Gather(in->bend.data() + parentBase, parent);
+                    const Float4 parentCross = Gather(in->cross.data() + parentBase, parent);
+                    Float4 pqx, pqz, pqw;
+                    BendQuaternion(wx, wz, parentBend, parentCross, pqx, pqz, pqw);
+                    Rotate(pqx, pqz, pqw, mx, my, mz);
+                    mx = mx + Gather(in->tx.data() + parentBase, parent);
+                    my = my + Gather(in->ty.data() + parentBase, parent);
+                    mz = mz + Gather(in->tz.data() + parentBase, parent);
+                    bend = bend + parentBend;
+                    cross = cross + parentCross;
+                }
+                bend = Min(Max(bend, minBend), maxBend);
+                cross = Min(Max(cross, minBend), maxBend);
+
+                // The bone rotates around its carried pivot
+                Float4 qx, qz, qw;
+                BendQuaternion(wx, wz, bend, cross, qx, qz, qw);
+                Float4 rpx = px, rpy = py, rpz = pz;
+                Rotate(qx, qz, qw, rpx, rpy, rpz);
+                const Float4 tx = mx - rpx;
+                const Float4 ty = my - rpy;
+                const Float4 tz = mz - rpz;
+
+                bend.Store(out.bend.data() + base + i);
+                cross.Store(out.cross.data() + base + i);
+                tx.Store(out.tx.data() + base + i);
+                ty.Store(out.ty.data() + base + i);
+                tz.Store(out.tz.data() + base + i);
+
+                float lanes[7][4];
+                qx.Store(lanes[0]);
+                qz.Store(lanes[2]);
+                qw.Store(lanes[3]);
+                tx.Store(lanes[4]);
+                ty.Store(lanes[5]);
+                tz.Store(lanes[6]);
+                for (size_t k = 0, n = std::min<size_t>(4, level.count - i); k < n; ++k) {
+                    BoneTransform& b = transforms[i + k];
+                    b.rotation[0] = lanes[0][k];
+                    b.rotation[1] = 0.0f;  // Both bend axes are horizontal
+                    b.rotation[2] = lanes[2][k];
+                    b.rotation[3] = lanes[3][k];
+                    b.translation[0] = lanes[4][k];
+                    b.translation[1] = lanes[5][k];
+                    b.translation[2] = lanes[6][k];
+                }
+            }
+        }
+    }
+
+    Options options_;
+    const WindField* field_ = nullptr;
+    float wind_[2] = {0.0f, 0.0f};
+    std::vector<Tree> trees_;
+    std::vector<uint32_t> rigidTrees_;  // Trees with levels left to copy from parents
+    std::vector<Scratch> scratch_;
+    std::vector<float> treeX_, treeY_, treeZ_;
+    std::vector<float> windX_, windY_, windZ_;
+    std::vector<BoneTransform> transforms_;
+    size_t boneCount_ = 0;
+};
+
+} // namespace NRE
@@ -0,0 +1,323 @@
+#pragma once
+
+#include <nature/LSystem.h>
+#include <nature/TreeRenderer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief One branch segment of a tree skeleton
+ */
+struct BranchSegment {
+    float start[3];
+    float end[3];
+    float startRadius;
+    float endRadius;
+    int32_t parent;     // Index of the segment this one grows from (-1 = root)
+    uint32_t order;     // Branching order (0 = trunk)
+};
+
+/**
+ * @brief Leaf attachment point
+ */
+struct LeafPoint {
+    float position[3];
+    float direction[3];
+    float size;
+    int32_t segment;    // Segment the leaf hangs from
+};
+
+/**
+ * @brief Preallocated output of a turtle walk
+ *
+ * Buffers are reserved once and reused for every tree; segments or leaves
+ * beyond the reserved limits are dropped and flagged instead of growing
+ * the buffers mid-walk.
+ */
+struct TreeSkeleton {
+    std::vector<BranchSegment> segments;
+    std::vector<LeafPoint> leaves;
+    size_t maxSegments = 0;   // 0 = unlimited
+    size_t maxLeaves = 0;     // 0 = unlimited
+    bool truncated = false;
+
+    void Reserve(size_t segmentLimit, size_t leafLimit) {
+        maxSegments = segmentLimit;
+        maxLeaves = leafLimit;
+        segments.reserve(segmentLimit);
+        leaves.reserve(leafLimit);
+    }
+
+    void Clear() {
+        segments.clear();
+        leaves.clear();
+        truncated = false;
+    }
+};
+
+/**
+ * @brief Streaming turtle interpreter for L-system trees
+ *
+ * Walks the derivation tree depth-first: each module is rewritten on the
+ * way down and interpreted as a turtle command once it reaches the
+ * iteration limit (or has no production), so the expanded string is never
+ * built. Memory is proportional to derivation depth plus bracket nesting.
+ * Produces exactly the geometry of interpreting LSystem::Expand() output.
+ *
+ * Commands: F (draw), f (move), + - (yaw), & ^ (pitch), \ / (roll),
+ * | (turn around), [ ] (push/pop), ! (thin), L (leaf). Other symbols are
+ * ignored.
+ */
+class TurtleInterpreter {
+public:
+    struct Options {
+        float segmentLength = 1.0f;   // Meters for an F with parameter 1
+        float trunkRadius = 0.1f;     // Meters
+        float branchThinning = 0.8f;  // Radius multiplier when a branch starts ('[')
+        float taper = 0.95f;          // Radius multiplier along each F
+        float leafSize = 0.1f;        // Meters
+        float tropism[3] = {0.0f, -1.0f, 0.0f};
+        float tropismStrength = 0.0f; // Bend toward tropism per meter (radians)
+    };
+
+    /**
+     * @brief Options matching a tree config
+     */
+    static Options FromConfig(const TreeRendererConfig& config) {
+        Options o;
+        o.segmentLength = config.height * config.branchLength * 0.5f;
+        o.trunkRadius = config.branchThickness;
+        return o;
+    }
+
+    /**
+     * @brief Turtle position, frame and branch context
+     */
+    struct State {
+        float position[3] = {0.0f, 0.0f, 0.0f};
+        float heading[3] = {0.0f, 1.0f, 0.0f};
+        float left[3] = {-1.0f, 0.0f, 0.0f};
+        float up[3] = {0.0f, 0.0f, 1.0f};
+        float radius = 0.1f;
+        int32_t parent = -1;    // Segment the next F grows from
+        uint32_t order = 0;
+    };
+
+    TurtleInterpreter(const LSystem& system, const Options& options)
+        : system_(system), options_(options) {
+        stack_.reserve(64);
+    }
+
+    /**
+     * @brief Generate a tree skeleton
+     * @param iterations Derivation depth
+     * @param seed Seed for stochastic rules
+     * @param out Skeleton buffers (cleared, not shrunk)
+     */
+    void Generate(int iterations, uint32_t seed, TreeSkeleton& out) {
+        out.Clear();
+        out_ = &out;
+        stack_.clear();
+        maxStack_ = 0;
+        state_ = State{};
+        state_.radius = options_.trunkRadius;
+        defaultAngle_ = system_.angle * kDegToRad;
+        for (const LModule& m : system_.GetAxiom(seed)) {
+            Derive(m, iterations);
+        }
+        out_ = nullptr;
+    }
+
+    /**
+     * @brief Interpret an already expanded string (same output as Generate)
+     */
+    void Interpret(const std::vector<LModule>& modules, TreeSkeleton& out) {
+        out.Clear();
+        out_ = &out;
+        stack_.clear();
+        maxStack_ = 0;
+        state_ = State{};
+        state_.radius = options_.trunkRadius;
+        defaultAngle_ = system_.angle * kDegToRad;
+        for (const LModule& m : modules) {
+            Execute(m);
+        }
+        out_ = nullptr;
+    }
+
+    /**
+     * @brief Deepest turtle stack reached by the last walk
+     */
+    size_t GetMaxStackDepth() const { return maxStack_; }
+
+    /**
+     * @brief State at the root of a tree
+     */
+    State InitialState() const {
+        State state;
+        state.radius = options_.trunkRadius;
+        return state;
+    }
+
+    /**
+     * @brief Start a manual walk that appends to out (out is not cleared)
+     *
+     * Used by incremental growth, which resumes the turtle at saved apex
+     * states and feeds it modules one at a time through Execute().
+     */
+    void Begin(const State& state, TreeSkeleton& out) {
+        out_ = &out;
+        stack_.clear();
+        state_ = state;
+        defaultAngle_ = system_.angle * kDegToRad;
+    }
+
+    /**
+     * @brief Interpret one module of a manual walk
+     */
+    void Execute(const LModule& m) {
+        const float angle = m.param != 0.0f ? m.param * kDegToRad : defaultAngle_;
+        switch (m.symbol) {
+            case 'F':
+            case 'f': {
+                const float length = m.param * options_.segmentLength;
+                float end[3];
+                for (int a = 0; a < 3; ++a) {
+                    end[a] = state_.position[a] + state_.heading[a] * length;
+                }
+                if (m.symbol == 'F') {
+                    const float endRadius = state_.radius * options_.taper;
+                    if (out_->maxSegments == 0 || out_->segments.size() < out_->maxSegments) {
+                        BranchSegment s;
+                        std::copy(state_.position, state_.position + 3, s.start);
+                        std::copy(end, end + 3, s.end);
+                        s.startRadius = state_.radius;
+                        s.endRadius = endRadius;
+                        s.parent = state_.parent;
+                        s.order = state_.order;
+                        state_.parent = int32_t(out_->segments.size());
+                        out_->segments.push_back(s);
+                    } else {
+                        out_->truncated = true;
+                    }
+                    state_.radius = endRadius;
+                }
+                std::copy(end, end + 3, state_.position);
+                if (options_.tropismStrength != 0.0f) {
+                    ApplyTropism(length);
+                }
+                break;
+            }
+            case '+': Rotate(state_.up, angle, state_.heading, state_.left); break;
+            case '-': Rotate(state_.up, -angle, state_.heading, state_.left); break;
+            case '&': Rotate(state_.left, angle, state_.heading, state_.up); break;
+            case '^': Rotate(state_.left, -angle, state_.heading, state_.up); break;
+            case '\\': Rotate(state_.heading, angle, state_.left, state_.up); break;
+            case '/': Rotate(state_.heading, -angle, state_.left, state_.up); break;
+            case '|': Rotate(state_.up, 3.14159265f, state_.heading, state_.left); break;
+            case '!': state_.radius *= system_.thicknessFactor; break;
+            case '[':
+                stack_.push_back(state_);
+                maxStack_ = std::max(maxStack_, stack_.size());
+                state_.radius *= options_.branchThinning;
+                ++state_.order;
+                break;
+            case ']':
+                if (!stack_.empty()) {
+                    state_ = stack_.back();
+                    stack_.pop_back();
+                }
+                break;
+            case 'L':
+                if (out_->maxLeaves == 0 || out_->leaves.size() < out_->maxLeaves) {
+                    LeafPoint leaf;
+                    std::copy(state_.position, state_.position + 3, leaf.position);
+                    std::copy(state_.heading, state_.heading + 3, leaf.direction);
+                    leaf.size = options_.leafSize * (m.param != 0.0f ? m.param : 1.0f);
+                    leaf.segment = state_.parent;
+                    out_->leaves.push_back(leaf);
+                } else {
+                    out_->truncated = true;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    const State& GetState() const { return state_; }
+    void SetState(const State& state) { state_ = state; }
+
+private:
+    static constexpr float kDegToRad = 3.14159265358979f / 180.0f;
+
+    void Derive(const LModule& m, int remaining) {
+        const int p = remaining > 0 ? system_.ChooseProduction(m) : -1;
+        if (p < 0) {
+            Execute(m);
+            return;
+        }
+        const auto& successor = system_.GetProduction(p).successor;
+        for (size_t c = 0; c < successor.size(); ++c) {
+            Derive(LSystem::MakeChild(m, successor[c], c), remaining - 1);
+        }
+    }
+
+    // Rotate vectors a and b around axis by angle (Rodrigues; axis is unit and orthogonal to both)
+    static void Rotate(const float axis[3], float angle, float a[3], float b[3]) {
+        const float c = std::cos(angle);
+        const float s = std::sin(angle);
+        float ra[3], rb[3];
+        Cross(axis, a, ra);
+        Cross(axis, b, rb);
+        for (int i = 0; i < 3; ++i) {
+            a[i] = a[i] * c + ra[i] * s;
+            b[i] = b[i] * c + rb[i] * s;
+        }
+    }
+
+    static void Cross(const float a[3], const float b[3], float out[3]) {
+        out[0] = a[1] * b[2] - a[2] * b[1];
+        out[1] = a[2] * b[0] - a[0] * b[2];
+        out[2] = a[0] * b[1] - a[1] * b[0];
+    }
+
+    // Bend the heading toward the tropism vector, then re-orthonormalize the frame
+    void ApplyTropism(float length) {
+        float* h = state_.heading;
+        const float k = options_.tropismStrength * length;
+        for (int i = 0; i < 3; ++i) {
+            h[i] += options_.tropism[i] * k;
+        }
+        const float len = std::sqrt(h[0] * h[0] + h[1] * h[1] + h[2] * h[2]);
+        for (int i = 0; i < 3; ++i) {
+            h[i] /= len;
+        }
+        Cross(state_.up, h, state_.left);
+        const float ll = std::sqrt(state_.left[0] * state_.left[0] + state_.left[1] * state_.left[1] +
+                                   state_.left[2] * state_.left[2]);
+        if (ll < 1e-6f) {
+            return;
+        }
+        for (int i = 0; i < 3; ++i) {
+            state_.left[i] /= ll;
+        }
+        Cross(h, state_.left, state_.up);
+    }
+
+    const LSystem& system_;
+    Options options_;
+    TreeSkeleton* out_ = nullptr;
+    State state_;
+    std::vector<State> stack_;
+    size_t maxStack_ = 0;
+    float defaultAngle_ = 0.0f;
+};
+
+} // namespace NRE
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <core/Compression.h>
+#include <core/StorageManager.h>
+#include <nature/VegetationChunks.h>
+#include <nature/VegetationInstance.h>
+#include <nature/VegetationSystem.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Persistent cache of generated vegetation chunks
+ *
+ * Packed instance buffers are byte-shuffled (all first bytes, then all
+ * second bytes, ...) so the slowly varying bytes form long runs (flat
+ * terrain, grass-only types). They are then compressed and written through
+ * StorageManager with Priority::Low, since they can always be regenerated;
+ * buffers that compression does not shrink are stored shuffled but raw.
+ *
+ * Keys combine the chunk coordinate, the generation seed, a hash of
+ * every setting that affects placement and a hash of the terrain the
+ * streamer generates on, so a config change, an edited heightmap or a
+ * different world simply misses and regenerates. Safe to call from chunk
+ * generation jobs.
+ */
+class VegetationChunkCache : public VegetationChunkStore {
+public:
+    /**
+     * @brief Create cache
+     * @param storage Storage backend (must outlive the cache)
+     * @param config Vegetation configuration used for generation
+     * @param options Streamer options used for generation
+     * @param keyPrefix Storage key prefix
+     */
+    VegetationChunkCache(StorageManager& storage, const VegetationConfig& config,
+                         const VegetationChunkStreamer::Options& options,
+                         const std::string& keyPrefix = "vegetation")
+        : storage_(storage),
+          seed_(options.seed),
+          configHash_(HashConfig(config, options)),
+          keyPrefix_(keyPrefix) {}
+
+    /**
+     * @brief FNV-1a hash of the settings that determine placement
+     */
+    static uint64_t HashConfig(const VegetationConfig& config, const VegetationChunkStreamer::Options& options) {
+        uint64_t h = 14695981039346656037ull;
+        auto mix = [&h](const void* data, size_t size) {
+            const uint8_t* p = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                h = (h ^ p[i]) * 1099511628211ull;
+            }
+        };
+        mix(&config.grassDensity, sizeof(config.grassDensity));
+        mix(&config.flowerDensity, sizeof(config.flowerDensity));
+        mix(&config.slopeThreshold, sizeof(config.slopeThreshold));
+        mix(&config.minAltitude, sizeof(config.minAltitude));
+        mix(&config.maxAltitude, sizeof(config.maxAltitude));
+        for (const auto& type : config.flowerTypes) {
+            mix(type.data(), type.size());
+            mix("", 1);
+        }
+        mix(&options.tilePoints, sizeof(options.tilePoints));
+        mix(&options.targetChunkSize, sizeof(options.targetChunkSize));
+        const uint32_t version = kVersion;
+        mix(&version, sizeof(version));
+        return h;
+    }
+
+    /**
+     * @brief FNV-1a hash of the heightmap samples and their placement in the world
+     */
+    static uint64_t HashTerrain(const TerrainHeightmap& terrain) {
+        uint64_t h = 14695981039346656037ull;
+        auto mix = [&h](const void* data, size_t size) {
+            const uint8_t* p = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                h = (h ^ p[i]) * 1099511628211ull;
+            }
+        };
+        mix(&terrain.width, sizeof(terrain.width));
+        mix(&terrain.height, sizeof(terrain.height));
+        mix(&terrain.spacing, sizeof(terrain.spacing));
+        mix(terrain.origin, sizeof(terrain.origin));
+        if (terrain.heights && terrain.width > 0 && terrain.height > 0) {
+            mix(terrain.heights, size_t(terrain.width) * size_t(terrain.height) * sizeof(float));
+        }
+        return h;
+    }
+
+    /**
+     * @brief Key following chunks by this terrain (the streamer calls this, while idle)
+     */
+    void SetTerrain(const TerrainHeightmap& terrain) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        terrainHash_ = HashTerrain(terrain);
+    }
+
+    /**
+     * @brief Storage key of a chunk
+     */
+    std::string KeyFor(const ChunkCoord& coord) const {
+        char hash[33];
+        std::snprintf(hash, sizeof(hash), "%016llx%016llx", static_cast<unsigned long long>(configHash_),
+                      static_cast<unsigned long long>(terrainHash_));
+        return keyPrefix_ + "." + hash + "." + std::to_string(seed_) + "." +
+               std::to_string(coord.x) + "." + std::to_string(coord.z);
+    }
+
+    /**
+     * @brief Load a chunk's instances
+     * @param chunk Chunk with coord set; frame and instances are filled in
+     * @return true on hit, false on miss or unreadable entry
+     */
+    bool Load(VegetationChunk& chunk) override {
+        thread_local std::vector<uint8_t> blob;
+        thread_local std::vector<uint8_t> shuffled;
+        const std::string key = KeyFor(chunk.coord);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const size_t size = storage_.GetSize(key);
+            if (size < sizeof(Header)) {
+                ++misses_;
+                return false;
+            }
+            blob.resize(size);
+            if (storage_.Read(key, blob.data(), size) != size) {
+                ++misses_;
+                return false;
+            }
+        }
+
+        Header header;
+        std::memcpy(&header, blob.data(), sizeof(header));
+        const size_t bytes = size_t(header.count) * sizeof(PackedVegetationInstance);
+        const uint8_t* payload = blob.data() + sizeof(header);
+        const size_t payloadSize = blob.size() - sizeof(header);
+        bool valid = header.magic == kMagic && header.version == kVersion;
+        if (valid && (header.flags & kFlagCompressed)) {
+            shuffled.resize(bytes);
+            valid = bytes == 0 || Compression::Decompress(payload, payloadSize, shuffled.data(), bytes) == bytes;
+            payload = shuffled.data();
+        } else {
+            valid = valid && payloadSize == bytes;
+        }
+        if (!valid) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++misses_;
+            return false;
+        }
+
+        chunk.frame = header.frame;
+        chunk.instances.resize(header.count);
+        Unshuffle(payload, header.count, chunk.instances.data());
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++hits_;
+        return true;
+    }
+
+    /**
+     * @brief Store a generated chunk
+     */
+    void Store(const VegetationChunk& chunk) override {
+        thread_local std::vector<uint8_t> shuffled;
+        thread_local std::vector<uint8_t> blob;
+        const size_t count = chunk.instances.size();
+        shuffled.resize(count * sizeof(PackedVegetationInstance));
+        Shuffle(chunk.instances.data(), count, shuffled.data());
+
+        Header header;
+        header.count = uint32_t(count);
+        header.frame = chunk.frame;
+        blob.resize(sizeof(header) + Compression::CompressBound(shuffled.size()));
+        const size_t compressed = Compression::Compress(shuffled.data(), shuffled.size(), blob.data() + sizeof(header));
+        if (compressed < shuffled.size()) {
+            header.flags = kFlagCompressed;
+            blob.resize(sizeof(header) + compressed);
+        } else {
+            std::memcpy(blob.data() + sizeof(header), shuffled.data(), shuffled.size());
+            blob.resize(sizeof(header) + shuffled.size());
+        }
+        std::memcpy(blob.data(), &header, sizeof(header));
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        storage_.Write(KeyFor(chunk.coord), blob.data(), blob.size(), StorageManager::Priority::Low);
+        storedBytes_ += blob.size();
+        rawBytes_ += shuffled.size();
+    }
+
+    size_t GetHits() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return hits_;
+    }
+    size_t GetMisses() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return misses_;
+    }
+    size_t GetStoredBytes() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return storedBytes_;
+    }
+    /**
+     * @brief Uncompressed size of everything stored (for the compression ratio)
+     */
+    size_t GetRawBytes() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return rawBytes_;
+    }
+
+private:
+    static constexpr uint32_t kMagic = 0x4356524Eu;  // "NRVC"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint32_t kFlagCompressed = 1;
+    static constexpr size_t kStride = sizeof(PackedVegetationInstance);
+
+    struct Header {
+        uint32_t magic = kMagic;
+        uint32_t version = kVersion;
+        uint32_t count = 0;
+        uint32_t flags = 0;
+        InstanceFrame frame;
+    };
+
+    static void Shuffle(const PackedVegetationInstance* in, size_t count, uint8_t* out) {
+        const uint8_t* src = reinterpret_cast<const uint8_t*>(in);
+        for (size_t b = 0; b < kStride; ++b) {
+            for (size_t i = 0; i < count; ++i) {
+                out[b * count + i] = src[i * kStride + b];
+            }
+        }
+    }
+
+    static void Unshuffle(const uint8_t* in, size_t count, PackedVegetationInstance* out) {
+        uint8_t* dst = reinterpret_cast<uint8_t*>(out);
+        for (size_t b = 0; b < kStride; ++b) {
+            for (size_t i = 0; i < count; ++i) {
+                dst[i * kStride + b] = in[b * count + i];
+            }
+        }
+    }
+
+    StorageManager& storage_;
+    uint32_t seed_;
+    uint64_t configHash_;
+    uint64_t terrainHash_ = 0;
+    std::string keyPrefix_;
+    mutable std::mutex mutex_;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    size_t storedBytes_ = 0;
+    size_t rawBytes_ = 0;
+};
+
+} // namespace NRE
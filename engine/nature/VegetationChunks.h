@@ -0,0 +1,524 @@
+#pragma once
+
+#include <core/JobSystem.h>
+#include <core/Random.h>
+#include <core/Simd.h>
+#include <nature/VegetationInstance.h>
+#include <nature/VegetationSystem.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Read-only view of a terrain heightmap
+ */
+struct TerrainHeightmap {
+    const float* heights = nullptr;  // Row-major, width * height samples
+    int width = 0;
+    int height = 0;
+    float spacing = 1.0f;            // Meters between samples
+    float origin[2] = {0.0f, 0.0f};  // World X/Z of sample (0, 0)
+};
+
+/**
+ * @brief Tileable progressive blue-noise point set on the unit square
+ *
+ * Generated with Mitchell's best-candidate algorithm using toroidal
+ * distances, so the tile repeats seamlessly and every prefix of the point
+ * list is itself evenly spread. A point's index is its rank: keeping only
+ * ranks below N * fraction thins the set without clumping.
+ */
+class BlueNoiseTile {
+public:
+    /**
+     * @brief Generate tile
+     * @param pointCount Number of points
+     * @param seed Random seed
+     * @param candidates Best-candidate samples per point (quality vs. time)
+     */
+    explicit BlueNoiseTile(int pointCount = 4096, uint32_t seed = 1, int candidates = 8) {
+        x_.reserve(size_t(pointCount));
+        z_.reserve(size_t(pointCount));
+        grid_ = std::max(1, int(std::sqrt(float(pointCount))));
+        cells_.assign(size_t(grid_) * grid_, {});
+        Random rng(seed);
+        for (int i = 0; i < pointCount; ++i) {
+            float bestX = rng.NextFloat();
+            float bestZ = rng.NextFloat();
+            float bestD = i == 0 ? 0.0f : NearestDistanceSq(bestX, bestZ);
+            for (int c = 1; c < candidates && i > 0; ++c) {
+                const float cx = rng.NextFloat();
+                const float cz = rng.NextFloat();
+                const float d = NearestDistanceSq(cx, cz);
+                if (d > bestD) {
+                    bestD = d;
+                    bestX = cx;
+                    bestZ = cz;
+                }
+            }
+            cells_[CellOf(bestX, bestZ)].push_back(uint32_t(x_.size()));
+            x_.push_back(bestX);
+            z_.push_back(bestZ);
+        }
+        cells_.clear();
+        cells_.shrink_to_fit();
+    }
+
+    size_t Size() const { return x_.size(); }
+    const float* X() const { return x_.data(); }
+    const float* Z() const { return z_.data(); }
+
+private:
+    size_t CellOf(float x, float z) const {
+        const int cx = std::min(grid_ - 1, int(x * grid_));
+        const int cz = std::min(grid_ - 1, int(z * grid_));
+        return size_t(cz) * grid_ + cx;
+    }
+
+    float NearestDistanceSq(float x, float z) const {
+        const int cx = std::min(grid_ - 1, int(x * grid_));
+        const int cz = std::min(grid_ - 1, int(z * grid_));
+        const float cell = 1.0f / float(grid_);
+        float best = 2.0f;
+        for (int ring = 0; ring <= grid_ / 2; ++ring) {
+            for (int dz = -ring; dz <= ring; ++dz) {
+                for (int dx = -ring; dx <= ring; ++dx) {
+                    if (std::max(std::abs(dx), std::abs(dz)) != ring) {
+                        continue;
+                    }
+                    const int gx = (cx + dx + grid_) % grid_;
+                    const int gz = (cz + dz + grid_) % grid_;
+                    for (uint32_t p : cells_[size_t(gz) * grid_ + gx]) {
+                        float ddx = std::fabs(x - x_[p]);
+                        float ddz = std::fabs(z - z_[p]);
+                        ddx = std::min(ddx, 1.0f - ddx);  // Toroidal wrap
+                        ddz = std::min(ddz, 1.0f - ddz);
+                        best = std::min(best, ddx * ddx + ddz * ddz);
+                    }
+                }
+            }
+            const float reach = float(ring) * cell;
+            if (best < reach * reach) {
+                break;
+            }
+        }
+        return best;
+    }
+
+    std::vector<float> x_;
+    std::vector<float> z_;
+    int grid_ = 1;
+    std::vector<std::vector<uint32_t>> cells_;
+};
+
+struct ChunkCoord {
+    int x = 0;
+    int z = 0;
+
+    bool operator==(const ChunkCoord& other) const { return x == other.x && z == other.z; }
+};
+
+struct ChunkCoordHash {
+    size_t operator()(const ChunkCoord& c) const {
+        return size_t(HashCombine(uint32_t(c.x), uint32_t(c.z)));
+    }
+};
+
+/**
+ * @brief Generated vegetation for one square chunk of terrain
+ */
+struct VegetationChunk {
+    enum class State { Pending, Ready };
+
+    ChunkCoord coord;
+    InstanceFrame frame;                             // Quantization range, also the chunk bounds
+    std::vector<PackedVegetationInstance> instances;  // Contiguous, in blue-noise rank order
+    std::atomic<State> state{State::Pending};
+
+    /**
+     * @brief Unpack all instances (for CPU-side queries and tools)
+     */
+    void Decode(std::vector<VegetationInstance>& out) const {
+        out.resize(instances.size());
+        InstancePacking::Decode(instances.data(), instances.size(), frame, out.data());
+    }
+};
+
+/**
+ * @brief Persistent store consulted before generating a chunk
+ *
+ * Called from generation jobs, so implementations must be thread-safe.
+ */
+class VegetationChunkStore {
+public:
+    virtual ~VegetationChunkStore() = default;
+
+    /**
+     * @brief Fill chunk frame and instances for chunk.coord
+     * @return true if found
+     */
+    virtual bool Load(VegetationChunk& chunk) = 0;
+
+    /**
+     * @brief Save a freshly generated chunk
+     */
+    virtual void Store(const VegetationChunk& chunk) = 0;
+
+    /**
+     * @brief Terrain the following chunks are generated on (called by the streamer)
+     */
+    virtual void SetTerrain(const TerrainHeightmap&) {}
+};
+
+/**
+ * @brief Chunked, lazily generated vegetation placement
+ *
+ * The world is divided into square chunks that map onto sub-rectangles of
+ * one repeating blue-noise tile sized so the tile holds exactly
+ * Config::grassDensity points per km^2. Chunks within maxRenderDistance of
+ * the streaming center are generated on worker threads, nearest first, and
+ * chunks that fall out of range are dropped, so resident memory depends on
+ * view distance, not world size. Each chunk's instances keep the tile's
+ * rank order, so any prefix of the buffer is an evenly thinned subset.
+ */
+class VegetationChunkStreamer {
+public:
+    struct Options {
+        int tilePoints = 4096;
+        float targetChunkSize = 32.0f;   // Meters (rounded to divide the tile)
+        int maxRequestsPerUpdate = 16;   // Generation jobs queued per Update
+        uint32_t seed = 1;
+    };
+
+    VegetationChunkStreamer(const VegetationConfig& config, const Options& options, JobSystem* jobs = nullptr)
+        : config_(std::make_shared<const VegetationConfig>(config)),
+          options_(options),
+          jobs_(jobs),
+          tile_(std::make_shared<const BlueNoiseTile>(options.tilePoints, options.seed)) {
+        const float density = std::max(1.0f, float(config.grassDensity)) / 1.0e6f;  // Per m^2
+        tileSize_ = std::sqrt(float(tile_->Size()) / density);
+        subdivisions_ = std::max(1, int(std::round(tileSize_ / options.targetChunkSize)));
+        chunkSize_ = tileSize_ / float(subdivisions_);
+        flowerRanks_ = uint32_t(float(tile_->Size()) *
+                                std::min(1.0f, float(config.flowerDensity) / std::max(1.0f, float(config.grassDensity))));
+        BucketTile();
+    }
+
+    ~VegetationChunkStreamer() {
+        if (jobs_) {
+            jobs_->WaitIdle();
+        }
+    }
+
+    /**
+     * @brief Set terrain (the heightmap must outlive the streamer)
+     */
+    void SetTerrain(const TerrainHeightmap& terrain) {
+        if (jobs_) {
+            jobs_->WaitIdle();
+        }
+        terrain_ = std::make_shared<const TerrainHeightmap>(terrain);
+        chunks_.clear();
+        if (store_) {
+            store_->SetTerrain(terrain);
+        }
+    }
+
+    /**
+     * @brief Load chunks from a store before generating, and save new ones
+     * @param store Chunk store (nullptr to always generate)
+     */
+    void SetChunkStore(VegetationChunkStore* store) {
+        if (jobs_) {
+            jobs_->WaitIdle();
+        }
+        store_ = store;
+        if (store_ && terrain_) {
+            store_->SetTerrain(*terrain_);
+        }
+    }
+
+    /**
+     * @brief Request chunks near the center and evict distant ones
+     * @param centerX Streaming center X (camera)
+     * @param centerZ Streaming center Z (camera)
+     */
+    void Update(float centerX, float centerZ) {
+        if (!terrain_) {
+            return;
+        }
+        const float radius = config_->maxRenderDistance;
+        const float evictRadius = radius + chunkSize_;
+
+        for (auto it = chunks_.begin(); it != chunks_.end();) {
+            if (ChunkDistance(it->first, centerX, centerZ) > evictRadius) {
+                it = chunks_.erase(it);  // Pending jobs keep their own reference
+            } else {
+                ++it;
+            }
+        }
+
+        missing_.clear();
+        const int x0 = int(std::floor((centerX - radius) / chunkSize_));
+        const int x1 = int(std::floor((centerX + radius) / chunkSize_));
+        const int z0 = int(std::floor((centerZ - radius) / chunkSize_));
+        const int z1 = int(std::floor((centerZ + radius) / chunkSize_));
+        for (int cz = z0; cz <= z1; ++cz) {
+            for (int cx = x0; cx <= x1; ++cx) {
+                const ChunkCoord coord{cx, cz};
+                const float d = ChunkDistance(coord, centerX, centerZ);
+                if (d <= radius && chunks_.find(coord) == chunks_.end()) {
+                    missing_.push_back({d, coord});
+                }
+            }
+        }
+        std::sort(missing_.begin(), missing_.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        const size_t requests = std::min(missing_.size(), size_t(options_.maxRequestsPerUpdate));
+        for (size_t i = 0; i < requests; ++i) {
+            auto chunk = std::make_shared<VegetationChunk>();
+            chunk->coord = missing_[i].second;
+            chunks_.emplace(chunk->coord, chunk);
+            Schedule(std::move(chunk));
+        }
+    }
+
+    /**
+     * @brief Call fn(const VegetationChunk&) for every generated chunk
+     */
+    template <typename Fn>
+    void ForEachReadyChunk(Fn&& fn) const {
+        for (const auto& entry : chunks_) {
+            if (entry.second->state.load(std::memory_order_acquire) == VegetationChunk::State::Ready) {
+                fn(*entry.second);
+            }
+        }
+    }
+
+    /**
+     * @brief Generate a single chunk synchronously
+     */
+    static void GenerateChunk(VegetationChunk& chunk, const TerrainHeightmap& terrain,
+                              const VegetationConfig& config, const BlueNoiseTile& tile,
+                              const std::vector<uint32_t>& bucket, float tileSize,
+                              int subdivisions, uint32_t flowerRanks, uint32_t seed);
+
+    size_t GetResidentChunkCount() const { return chunks_.size(); }
+    float GetChunkSize() const { return chunkSize_; }
+    float GetTileSize() const { return tileSize_; }
+
+    size_t GetResidentInstanceCount() const {
+        size_t count = 0;
+        ForEachReadyChunk([&count](const VegetationChunk& c) { count += c.instances.size(); });
+        return count;
+    }
+
+    /**
+     * @brief Memory held by resident instance buffers (bytes)
+     */
+    size_t GetResidentInstanceBytes() const {
+        size_t bytes = 0;
+        ForEachReadyChunk([&bytes](const VegetationChunk& c) {
+            bytes += c.instances.capacity() * sizeof(PackedVegetationInstance);
+        });
+        return bytes;
+    }
+
+    /**
+     * @brief Block until all queued chunk generation has finished
+     */
+    void WaitIdle() {
+        if (jobs_) {
+            jobs_->WaitIdle();
+        }
+    }
+
+private:
+    void BucketTile() {
+        buckets_.assign(size_t(subdivisions_) * subdivisions_, {});
+        for (uint32_t i = 0; i < tile_->Size(); ++i) {
+            const int bx = std::min(subdivisions_ - 1, int(tile_->X()[i] * subdivisions_));
+            const int bz = std::min(subdivisions_ - 1, int(tile_->Z()[i] * subdivisions_));
+            buckets_[size_t(bz) * subdivisions_ + bx].push_back(i);  // Ascending rank
+        }
+    }
+
+    float ChunkDistance(const ChunkCoord& c, float x, float z) const {
+        const float minX = float(c.x) * chunkSize_;
+        const float minZ = float(c.z) * chunkSize_;
+        const float dx = std::max({minX - x, 0.0f, x - (minX + chunkSize_)});
+        const float dz = std::max({minZ - z, 0.0f, z - (minZ + chunkSize_)});
+        return std::sqrt(dx * dx + dz * dz);
+    }
+
+    const std::vector<uint32_t>& BucketFor(const ChunkCoord& c) const {
+        const int bx = ((c.x % subdivisions_) + subdivisions_) % subdivisions_;
+        const int bz = ((c.z % subdivisions_) + subdivisions_) % subdivisions_;
+        return buckets_[size_t(bz) * subdivisions_ + bx];
+    }
+
+    void Schedule(std::shared_ptr<VegetationChunk> chunk) {
+        auto job = [chunk, terrain = terrain_, config = config_, tile = tile_,
+                    bucket = &BucketFor(chunk->coord), tileSize = tileSize_,
+                    subdivisions = subdivisions_, flowerRanks = flowerRanks_, seed = options_.seed,
+                    store = store_] {
+            if (store && store->Load(*chunk)) {
+                chunk->state.store(VegetationChunk::State::Ready, std::memory_order_release);
+                return;
+            }
+            GenerateChunk(*chunk, *terrain, *config, *tile, *bucket, tileSize, subdivisions, flowerRanks, seed);
+            if (store) {
+                store->Store(*chunk);
+            }
+        };
+        if (jobs_) {
+            jobs_->Submit(std::move(job));
+        } else {
+            job();
+        }
+    }
+
+    std::shared_ptr<const VegetationConfig> config_;
+    Options options_;
+    JobSystem* jobs_ = nullptr;
+    VegetationChunkStore* store_ = nullptr;
+    std::shared_ptr<const BlueNoiseTile> tile_;
+    std::shared_ptr<const TerrainHeightmap> terrain_;
+
+    float tileSize_ = 64.0f;
+    float chunkSize_ = 32.0f;
+    int subdivisions_ = 2;
+    uint32_t flowerRanks_ = 0;
+    std::vector<std::vector<uint32_t>> buckets_;
+    std::unordered_map<ChunkCoord, std::shared_ptr<VegetationChunk>, ChunkCoordHash> chunks_;
+    std::vector<std::pair<float, ChunkCoord>> missing_;
+};
+
+inline void VegetationChunkStreamer::GenerateChunk(VegetationChunk& chunk, const TerrainHeightmap& terrain,
+                                                   const VegetationConfig& config, const BlueNoiseTile& tile,
+                                                   const std::vector<uint32_t>& bucket, float tileSize,
+                                                   int subdivisions, uint32_t flowerRanks, uint32_t seed) {
+    // Tile repetition the chunk falls in
+    const int tileX = int(std::floor(float(chunk.coord.x) / float(subdivisions)));
+    const int tileZ = int(std::floor(float(chunk.coord.z) / float(subdivisions)));
+    const float tileOriginX = float(tileX) * tileSize;
+    const float tileOriginZ = float(tileZ) * tileSize;
+
+    const float tanSlope = std::tan(config.slopeThreshold * 3.14159265f / 180.0f);
+    const Float4 maxGradSq(tanSlope * tanSlope);
+    const Float4 minAlt(config.minAltitude);
+    const Float4 maxAlt(config.maxAltitude);
+    const Float4 invSpacing(1.0f / terrain.spacing);
+    const Float4 originX(terrain.origin[0]);
+    const Float4 originZ(terrain.origin[1]);
+    const Float4 zero(0.0f);
+    const Float4 maxU(float(terrain.width - 1) - 1e-3f);
+    const Float4 maxV(float(terrain.height - 1) - 1e-3f);
+
+    // Unpacked instances are staged per worker and packed once the height range is known
+    thread_local std::vector<VegetationInstance> staging;
+    staging.clear();
+    float minY = config.maxAltitude;
+    float maxY = config.minAltitude;
+    const uint32_t flowerTypes = std::min<uint32_t>(uint32_t(config.flowerTypes.size()), InstancePacking::kMaxType);
+
+    // Bilinear sampling needs at least a 2 x 2 heightmap; anything smaller yields an empty chunk
+    const bool sampleable = terrain.heights && terrain.width >= 2 && terrain.height >= 2;
+    const size_t n = sampleable ? bucket.size() : 0;
+    for (size_t base = 0; base < n; base += 4) {
+        float px[4], pz[4];
+        for (size_t k = 0; k < 4; ++k) {
+            const uint32_t p = bucket[std::min(base + k, n - 1)];
+            px[k] = tileOriginX + tile.X()[p] * tileSize;
+            pz[k] = tileOriginZ + tile.Z()[p] * tileSize;
+        }
+
+        // Heightmap coordinates, clamped so the gather below stays in bounds
+        const Float4 wx = Float4::Load(px);
+        const Float4 wz = Float4::Load(pz);
+        const Float4 uRaw = (wx - originX) * invSpacing;
+        const Float4 vRaw = (wz - originZ) * invSpacing;
+        const Float4 inside = (uRaw >= zero) & (uRaw <= maxU) & (vRaw >= zero) & (vRaw <= maxV);
+        const Float4 u = Min(Max(uRaw, zero), maxU);
+        const Float4 v = Min(Max(vRaw, zero), maxV);
+        const Float4 u0 = Floor(u);
+        const Float4 v0 = Floor(v);
+        const Float4 fu = u - u0;
+        const Float4 fv = v - v0;
+
+        int32_t iu[4], iv[4];
+        StoreInt(u0, iu);
+        StoreInt(v0, iv);
+        float h00[4], h10[4], h01[4], h11[4];
+        for (int k = 0; k < 4; ++k) {
+            const float* row = terrain.heights + size_t(iv[k]) * terrain.width + iu[k];
+            h00[k] = row[0];
+            h10[k] = row[1];
+            h01[k] = row[terrain.width];
+            h11[k] = row[terrain.width + 1];
+        }
+        const Float4 a = Float4::Load(h00);
+        const Float4 b = Float4::Load(h10);
+        const Float4 c = Float4::Load(h01);
+        const Float4 d = Float4::Load(h11);
+        const Float4 top = a + (b - a) * fu;
+        const Float4 bottom = c + (d - c) * fu;
+        const Float4 h = top + (bottom - top) * fv;
+
+        // Bilinear gradient, in height units per meter
+        const Float4 gx = ((b - a) + ((d - c) - (b - a)) * fv) * invSpacing;
+        const Float4 gz = (bottom - top) * invSpacing;
+        const Float4 accept = inside & ((gx * gx + gz * gz) <= maxGradSq) & (h >= minAlt) & (h <= maxAlt);
+
+        float hy[4];
+        h.Store(hy);
+        const int mask = MoveMask(accept);
+        const size_t lanes = std::min<size_t>(4, n - base);  // Drop padding lanes
+        for (size_t k = 0; k < lanes; ++k) {
+            if (!(mask & (1 << k))) {
+                continue;
+            }
+            const uint32_t rank = bucket[base + k];
+            const uint32_t hsh = HashCombine(HashCombine(seed, uint32_t(tileX) * 73856093u ^ uint32_t(tileZ) * 19349663u), rank);
+            VegetationInstance inst;
+            inst.position[0] = px[k];
+            inst.position[1] = hy[k];
+            inst.position[2] = pz[k];
+            inst.rotation = HashToUnitFloat(hsh) * 6.28318530718f;
+            inst.scale = 0.75f + 0.5f * HashToUnitFloat(Hash32(hsh ^ 0x51ed27u));
+            inst.windPhase = HashToUnitFloat(Hash32(hsh ^ 0xa4093822u)) * 6.28318530718f;
+            inst.type = 0;
+            // Flowers are a hashed subset of the ranks rather than the lowest ones,
+            // so every thinned prefix keeps the same flower fraction
+            const bool flower = uint64_t(Hash32(rank ^ 0x3c6ef372u)) * tile.Size() < uint64_t(flowerRanks) << 32;
+            if (flower && flowerTypes > 0) {
+                inst.type = uint16_t(1 + Hash32(hsh) % flowerTypes);
+            }
+            staging.push_back(inst);
+            minY = std::min(minY, hy[k]);
+            maxY = std::max(maxY, hy[k]);
+        }
+    }
+
+    const float chunkSize = tileSize / float(subdivisions);
+    chunk.frame.origin[0] = float(chunk.coord.x) * chunkSize;
+    chunk.frame.origin[1] = staging.empty() ? 0.0f : minY;
+    chunk.frame.origin[2] = float(chunk.coord.z) * chunkSize;
+    chunk.frame.extent[0] = chunkSize;
+    chunk.frame.extent[1] = staging.empty() ? 0.0f : std::max(maxY - minY, 1e-3f);
+    chunk.frame.extent[2] = chunkSize;
+    chunk.instances.resize(staging.size());
+    InstancePacking::Encode(staging.data(), staging.size(), chunk.frame, chunk.instances.data());
+    chunk.state.store(VegetationChunk::State::Ready, std::memory_order_release);
+}
+
+} // namespace NRE
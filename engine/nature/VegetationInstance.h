@@ -0,0 +1,179 @@
+#pragma once
+
+#include <core/Simd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace NRE {
+
+/**
+ * @brief One grass blade or flower instance (unpacked)
+ */
+struct VegetationInstance {
+    float position[3];
+    float rotation;     // Radians around Y
+    float scale;
+    float windPhase;    // Radians
+    uint16_t type;      // 0 = grass, 1 + index into Config::flowerTypes
+};
+
+/**
+ * @brief 8-byte vegetation instance as stored in chunk buffers and read by
+ * the instanced draw
+ *
+ * Position is quantized to 16 bits per axis relative to the owning chunk's
+ * InstanceFrame. The attribute word packs, from the low bit:
+ * angle (6 bits), scale (4 bits), type (3 bits), wind phase (3 bits).
+ */
+struct PackedVegetationInstance {
+    uint16_t x;
+    uint16_t y;
+    uint16_t z;
+    uint16_t attributes;
+};
+
+static_assert(sizeof(PackedVegetationInstance) == 8, "Packed instance must stay 8 bytes");
+
+/**
+ * @brief Quantization range of one chunk's instances
+ */
+struct InstanceFrame {
+    float origin[3] = {0.0f, 0.0f, 0.0f};
+    float extent[3] = {1.0f, 1.0f, 1.0f};
+};
+
+namespace InstancePacking {
+
+constexpr int kAngleBits = 6;
+constexpr int kScaleBits = 4;
+constexpr int kTypeBits = 3;
+constexpr int kPhaseBits = 3;
+constexpr int kScaleShift = kAngleBits;
+constexpr int kTypeShift = kScaleShift + kScaleBits;
+constexpr int kPhaseShift = kTypeShift + kTypeBits;
+constexpr uint16_t kMaxType = (1 << kTypeBits) - 1;  // Grass plus seven flower types
+constexpr float kMinScale = 0.5f;
+constexpr float kMaxScale = 1.5f;
+constexpr float kTwoPi = 6.28318530718f;
+
+/**
+ * @brief Encode instances (four at a time)
+ * @param in Unpacked instances
+ * @param count Number of instances
+ * @param frame Chunk quantization range (instances outside are clamped)
+ * @param out Output, room for count entries
+ */
+inline void Encode(const VegetationInstance* in, size_t count, const InstanceFrame& frame,
+                   PackedVegetationInstance* out) {
+    const Float4 zero(0.0f);
+    const Float4 half(0.5f);
+    const Float4 maxQ(65535.0f);
+    Float4 origin[3];
+    Float4 toQ[3];
+    for (int a = 0; a < 3; ++a) {
+        origin[a] = Float4(frame.origin[a]);
+        toQ[a] = Float4(65535.0f / std::max(frame.extent[a], 1e-6f));
+    }
+    const Float4 angleQ(float(1 << kAngleBits) / kTwoPi);
+    const Float4 phaseQ(float(1 << kPhaseBits) / kTwoPi);
+    const Float4 scaleMin(kMinScale);
+    const Float4 scaleQ(float((1 << kScaleBits) - 1) / (kMaxScale - kMinScale));
+    const Float4 scaleMaxQ(float((1 << kScaleBits) - 1));
+
+    for (size_t base = 0; base < count; base += 4) {
+        const size_t lanes = std::min<size_t>(4, count - base);
+        float pos[3][4], rot[4], scale[4], phase[4];
+        for (size_t k = 0; k < 4; ++k) {
+            const VegetationInstance& v = in[base + std::min(k, lanes - 1)];
+            pos[0][k] = v.position[0];
+            pos[1][k] = v.position[1];
+            pos[2][k] = v.position[2];
+            rot[k] = v.rotation;
+            scale[k] = v.scale;
+            phase[k] = v.windPhase;
+        }
+
+        int32_t q[3][4], qa[4], qs[4], qp[4];
+        for (int a = 0; a < 3; ++a) {
+            const Float4 t = (Float4::Load(pos[a]) - origin[a]) * toQ[a];
+            StoreInt(Floor(Min(Max(t, zero), maxQ) + half), q[a]);
+        }
+        StoreInt(Floor(Float4::Load(rot) * angleQ + half), qa);
+        StoreInt(Floor(Float4::Load(phase) * phaseQ + half), qp);
+        const Float4 s = (Float4::Load(scale) - scaleMin) * scaleQ;
+        StoreInt(Floor(Min(Max(s, zero), scaleMaxQ) + half), qs);
+
+        for (size_t k = 0; k < lanes; ++k) {
+            const uint16_t type = std::min(in[base + k].type, kMaxType);
+            PackedVegetationInstance& p = out[base + k];
+            p.x = uint16_t(q[0][k]);
+            p.y = uint16_t(q[1][k]);
+            p.z = uint16_t(q[2][k]);
+            // Angles and phases wrap, so masking the rounded value is exact
+            p.attributes = uint16_t((qa[k] & ((1 << kAngleBits) - 1)) |
+                                    (qs[k] << kScaleShift) |
+                                    (type << kTypeShift) |
+                                    ((qp[k] & ((1 << kPhaseBits) - 1)) << kPhaseShift));
+        }
+    }
+}
+
+/**
+ * @brief Decode instances (four at a time)
+ * @param in Packed instances
+ * @param count Number of instances
+ * @param frame Chunk quantization range used at encode time
+ * @param out Output, room for count entries
+ */
+inline void Decode(const PackedVegetationInstance* in, size_t count, const InstanceFrame& frame,
+                   VegetationInstance* out) {
+    Float4 origin[3];
+    Float4 fromQ[3];
+    for (int a = 0; a < 3; ++a) {
+        origin[a] = Float4(frame.origin[a]);
+        fromQ[a] = Float4(frame.extent[a] / 65535.0f);
+    }
+    const Float4 angleStep(kTwoPi / float(1 << kAngleBits));
+    const Float4 phaseStep(kTwoPi / float(1 << kPhaseBits));
+    const Float4 scaleMin(kMinScale);
+    const Float4 scaleStep((kMaxScale - kMinScale) / float((1 << kScaleBits) - 1));
+
+    for (size_t base = 0; base < count; base += 4) {
+        const size_t lanes = std::min<size_t>(4, count - base);
+        int32_t q[3][4], qa[4], qs[4], qp[4];
+        for (size_t k = 0; k < 4; ++k) {
+            const PackedVegetationInstance& p = in[base + std::min(k, lanes - 1)];
+            q[0][k] = p.x;
+            q[1][k] = p.y;
+            q[2][k] = p.z;
+            qa[k] = p.attributes & ((1 << kAngleBits) - 1);
+            qs[k] = (p.attributes >> kScaleShift) & ((1 << kScaleBits) - 1);
+            qp[k] = p.attributes >> kPhaseShift;
+        }
+
+        float pos[3][4], rot[4], scale[4], phase[4];
+        for (int a = 0; a < 3; ++a) {
+            (origin[a] + LoadInt(q[a]) * fromQ[a]).Store(pos[a]);
+        }
+        (LoadInt(qa) * angleStep).Store(rot);
+        (LoadInt(qp) * phaseStep).Store(phase);
+        (scaleMin + LoadInt(qs) * scaleStep).Store(scale);
+
+        for (size_t k = 0; k < lanes; ++k) {
+            VegetationInstance& v = out[base + k];
+            v.position[0] = pos[0][k];
+            v.position[1] = pos[1][k];
+            v.position[2] = pos[2][k];
+            v.rotation = rot[k];
+            v.scale = scale[k];
+            v.windPhase = phase[k];
+            v.type = uint16_t((in[base + k].attributes >> kTypeShift) & kMaxType);
+        }
+    }
+}
+
+} // namespace InstancePacking
+
+} // namespace NRE
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <nature/VegetationChunks.h>
+#include <nature/VegetationSystem.h>
+#include <renderer/Frustum.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Geometry used to draw a chunk's instances
+ */
+enum class VegetationLOD : uint8_t {
+    FullBlade,    // Curved three-segment blade
+    SimpleBlade,  // Single triangle
+    Impostor      // Camera-facing card standing in for a clump of blades
+};
+
+/**
+ * @brief One instanced draw produced by the culling pass
+ *
+ * Draws instances [0, instanceCount) of the chunk buffer. Because buffers
+ * are in blue-noise rank order, instance i has the stable threshold
+ * (i + 0.5) / chunk size; the shader fades it out as that threshold nears
+ * density, so thinning is gradual instead of popping.
+ */
+struct VegetationDrawBatch {
+    const VegetationChunk* chunk;
+    uint32_t instanceCount;
+    float density;     // Fraction of the chunk's blades represented
+    float cardScale;   // Instance scale multiplier (impostor cards cover several blades)
+    VegetationLOD lod;
+};
+
+/**
+ * @brief Per-chunk culling and LOD selection for streamed vegetation
+ *
+ * Chunks are rejected by distance and frustum, then assigned a density
+ * that falls off with 1/distance^2 beyond Config::fullDensityDistance (so
+ * on-screen blade density stays roughly constant) and a geometry band.
+ */
+class VegetationCuller {
+public:
+    struct Stats {
+        size_t chunksTested = 0;
+        size_t chunksVisible = 0;
+        size_t instancesDrawn = 0;
+        size_t trianglesDrawn = 0;
+    };
+
+    static constexpr int kFullBladeTriangles = 5;
+    static constexpr int kSimpleBladeTriangles = 1;
+    static constexpr int kImpostorTriangles = 2;
+    static constexpr float kBladesPerCard = 16.0f;
+
+    explicit VegetationCuller(const VegetationConfig& config) : config_(config) {}
+
+    /**
+     * @brief Fraction of blades kept at a distance
+     */
+    float DensityAt(float distance) const {
+        if (!config_.useLOD || distance <= config_.fullDensityDistance) {
+            return 1.0f;
+        }
+        const float r = config_.fullDensityDistance / distance;
+        return std::max(config_.minLODDensity, r * r);
+    }
+
+    /**
+     * @brief Geometry band at a distance
+     */
+    VegetationLOD LODAt(float distance) const {
+        if (!config_.useLOD || distance < config_.simpleBladeDistance) {
+            return VegetationLOD::FullBlade;
+        }
+        return distance < config_.impostorDistance ? VegetationLOD::SimpleBlade : VegetationLOD::Impostor;
+    }
+
+    static int TrianglesPerInstance(VegetationLOD lod) {
+        switch (lod) {
+            case VegetationLOD::FullBlade: return kFullBladeTriangles;
+            case VegetationLOD::SimpleBlade: return kSimpleBladeTriangles;
+            default: return kImpostorTriangles;
+        }
+    }
+
+    /**
+     * @brief Build this frame's draw list
+     * @param streamer Resident chunks
+     * @param frustum Camera frustum
+     * @param camera Camera world position
+     * @return Draw batches (valid until the next call)
+     */
+    const std::vector<VegetationDrawBatch>& Cull(const VegetationChunkStreamer& streamer,
+                                                 const Frustum& frustum, const float camera[3]) {
+        batches_.clear();
+        stats_ = Stats{};
+        const float bladeHeight = config_.grassHeight * InstancePacking::kMaxScale;
+        streamer.ForEachReadyChunk([&](const VegetationChunk& chunk) {
+            ++stats_.chunksTested;
+            if (chunk.instances.empty()) {
+                return;
+            }
+            float min[3], max[3];
+            for (int a = 0; a < 3; ++a) {
+                min[a] = chunk.frame.origin[a];
+                max[a] = chunk.frame.origin[a] + chunk.frame.extent[a];
+            }
+            max[1] += bladeHeight;
+
+            float distSq = 0.0f;
+            for (int a = 0; a < 3; ++a) {
+                const float d = std::max({min[a] - camera[a], 0.0f, camera[a] - max[a]});
+                distSq += d * d;
+            }
+            const float distance = std::sqrt(distSq);
+            if (distance > config_.maxRenderDistance || !frustum.IntersectsBox(min, max)) {
+                return;
+            }
+
+            VegetationDrawBatch batch;
+            batch.chunk = &chunk;
+            batch.lod = LODAt(distance);
+            batch.density = DensityAt(distance);
+            batch.cardScale = 1.0f;
+            float count = float(chunk.instances.size()) * batch.density;
+            if (batch.lod == VegetationLOD::Impostor) {
+                count /= kBladesPerCard;
+                batch.cardScale = std::sqrt(kBladesPerCard);  // Same covered area
+            }
+            batch.instanceCount = std::min(uint32_t(chunk.instances.size()), uint32_t(std::ceil(count)));
+
+            ++stats_.chunksVisible;
+            stats_.instancesDrawn += batch.instanceCount;
+            stats_.trianglesDrawn += size_t(batch.instanceCount) * TrianglesPerInstance(batch.lod);
+            batches_.push_back(batch);
+        });
+        return batches_;
+    }
+
+    const Stats& GetStats() const { return stats_; }
+
+private:
+    VegetationConfig config_;
+    std::vector<VegetationDrawBatch> batches_;
+    Stats stats_;
+};
+
+} // namespace NRE
@@ -1,10 +1,43 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace NRE {
 
+class WindField;
+
+/**
+ * @brief Vegetation configuration (VegetationSystem::Config)
+ *
+ * Kept outside VegetationSystem for the same reason as EcosystemConfig.
+ */
+struct VegetationConfig {
+    // Grass
+    int grassDensity = 1000000;     // Blades per square kilometer
+    float grassHeight = 0.3f;       // Meters
+    bool grassPhysics = true;       // Wind interaction
+    bool grassShadows = true;
+    
+    // Flowers
+    int flowerDensity = 10000;      // Flowers per square kilometer
+    std::vector<std::string> flowerTypes = {"daisy", "poppy", "tulip"};
+    
+    // Distribution
+    float slopeThreshold = 45.0f;   // Max slope for vegetation (degrees)
+    float minAltitude = 0.0f;       // Meters
+    float maxAltitude = 3000.0f;    // Meters
+    
+    // LOD
+    float maxRenderDistance = 500.0f;  // Meters
+    bool useLOD = true;
+    float fullDensityDistance = 25.0f; // Beyond this, density falls off with 1/distance^2
+    float minLODDensity = 0.05f;       // Fraction of blades kept at the far end
+    float simpleBladeDistance = 40.0f; // Switch to single-triangle blades
+    float impostorDistance = 150.0f;   // Switch to billboard cards
+};
+
 /**
  * @brief Vegetation rendering system for grass, flowers, and plants
  * 
@@ -12,26 +45,7 @@ namespace NRE {
  */
 class VegetationSystem {
 public:
-    struct Config {
-        // Grass
-        int grassDensity = 1000000;     // Blades per square kilometer
-        float grassHeight = 0.3f;       // Meters
-        bool grassPhysics = true;       // Wind interaction
-        bool grassShadows = true;
-        
-        // Flowers
-        int flowerDensity = 10000;      // Flowers per square kilometer
-        std::vector<std::string> flowerTypes = {"daisy", "poppy", "tulip"};
-        
-        // Distribution
-        float slopeThreshold = 45.0f;   // Max slope for vegetation (degrees)
-        float minAltitude = 0.0f;       // Meters
-        float maxAltitude = 3000.0f;    // Meters
-        
-        // LOD
-        float maxRenderDistance = 500.0f;  // Meters
-        bool useLOD = true;
-    };
+    using Config = VegetationConfig;
 
     virtual ~VegetationSystem() = default;
 
@@ -61,6 +75,10 @@ public:
 
     /**
      * @brief Populate terrain with vegetation
+     *
+     * Registers the heightmap only; instances are generated lazily per chunk
+     * around the streaming center (see VegetationChunkStreamer), so the
+     * whole world's vegetation is never resident at once.
      * @param terrainData Terrain heightmap data
      * @param width Terrain width
      * @param height Terrain height
@@ -68,14 +86,30 @@ public:
     virtual void PopulateTerrain(const float* terrainData, int width, int height) = 0;
 
     /**
-     * @brief Apply wind to vegetation
+     * @brief Set the point vegetation chunks stream around (usually the camera)
+     * @param x World X position
+     * @param z World Z position
+     */
+    virtual void SetStreamingCenter(float x, float z) = 0;
+
+    /**
+     * @brief Apply wind to vegetation (uniform; ignored while a wind field is set)
      * @param direction Wind direction (normalized)
      * @param strength Wind strength (0-1)
      */
     virtual void ApplyWind(const float direction[3], float strength) = 0;
 
+    /**
+     * @brief Sample wind from a shared field instead of ApplyWind
+     * @param field Wind field (nullptr to go back to ApplyWind)
+     */
+    virtual void SetWindField(const WindField* field) = 0;
+
     /**
      * @brief Flatten grass in area (player walked through)
+     *
+     * Stamps into a camera-centered GrassDeformationField that recovers over
+     * time; blades sample the field, so there is no per-blade state.
      * @param x Center X position
      * @param z Center Z position
      * @param radius Radius of effect
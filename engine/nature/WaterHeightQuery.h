@@ -0,0 +1,216 @@
+#pragma once
+
+#include <core/JobSystem.h>
+#include <core/Simd.h>
+#include <nature/OceanFFT.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Batched ocean height queries for physics and gameplay
+ *
+ * Publish() copies the ocean's displacement maps into one of two
+ * snapshots, interleaved as (dx, height, dz, 0) so a bilinear corner is a
+ * single 16-byte load, and then flips the front index. Readers pin the
+ * front snapshot with a per-snapshot reader count and never wait. If a
+ * reader still holds the back snapshot, Publish() skips that frame
+ * instead of blocking the simulation, so queries lag at most one update.
+ *
+ * FFT waves displace the surface horizontally, so the surface above (x, z)
+ * comes from the undisplaced point p with p + D(p) = (x, z). Queries solve
+ * for p by fixed-point iteration p <- (x, z) - D(p), then return the height
+ * at p, with four queries per SIMD lane group.
+ */
+class WaterHeightQuery {
+public:
+    struct Options {
+        int iterations = 2;             // Fixed-point steps inverting the horizontal displacement
+        float seaLevel = 0.0f;          // Added to every height
+    };
+
+    explicit WaterHeightQuery(const Options& options) : options_(options) {}
+
+    WaterHeightQuery(const WaterHeightQuery&) = delete;
+    WaterHeightQuery& operator=(const WaterHeightQuery&) = delete;
+
+    /**
+     * @brief Snapshot the ocean's latest maps (call from the simulation thread)
+     * @return False if a reader still held the back snapshot (nothing published)
+     */
+    bool Publish(const OceanFFT& ocean) {
+        const uint32_t back = 1u - front_.load(std::memory_order_seq_cst);
+        if (readers_[back].load(std::memory_order_seq_cst) != 0) {
+            skipped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        Snapshot& snapshot = snapshots_[back];
+        const size_t n = size_t(ocean.GetResolution());
+        snapshot.resolution = int(n);
+        snapshot.cascades.resize(ocean.GetCascadeCount());
+        for (size_t c = 0; c < ocean.GetCascadeCount(); ++c) {
+            const OceanFFT::Cascade& source = ocean.GetCascade(c);
+            SnapshotCascade& cascade = snapshot.cascades[c];
+            cascade.texelsPerMeter = float(n) / source.tileSize;
+            cascade.texels.resize(4 * n * n);
+            float* dst = cascade.texels.data();
+            const Float4 zero(0.0f);
+            for (size_t i = 0; i < n * n; i += 4, dst += 16) {
+                Float4 dx = Float4::Load(source.displaceX.data() + i);
+                Float4 h = Float4::Load(source.height.data() + i);
+                Float4 dz = Float4::Load(source.displaceZ.data() + i);
+                Float4 pad = zero;
+                Transpose(dx, h, dz, pad);
+                dx.Store(dst);
+                h.Store(dst + 4);
+                dz.Store(dst + 8);
+                pad.Store(dst + 12);
+            }
+        }
+        front_.store(back, std::memory_order_seq_cst);
+        version_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Water heights at many positions (callable from any thread)
+     * @param x World X of each query
+     * @param z World Z of each query
+     * @param heights Output heights (Y)
+     * @param count Number of queries
+     * @param jobs Optional job system for large batches
+     */
+    void GetHeights(const float* x, const float* z, float* heights, size_t count, JobSystem* jobs = nullptr) const {
+        const uint32_t index = Acquire();
+        const Snapshot& snapshot = snapshots_[index];
+        auto work = [&](size_t begin, size_t end) {
+            size_t i = begin;
+            for (; i + 4 <= end; i += 4) {
+                Query4(snapshot, Float4::Load(x + i), Float4::Load(z + i)).Store(heights + i);
+            }
+            if (i < end) {
+                float tx[4] = {}, tz[4] = {}, th[4];
+                std::copy(x + i, x + end, tx);
+                std::copy(z + i, z + end, tz);
+                Query4(snapshot, Float4::Load(tx), Float4::Load(tz)).Store(th);
+                std::copy(th, th + (end - i), heights + i);
+            }
+        };
+        if (jobs && count >= 4096) {
+            jobs->ParallelFor(0, (count + 3) / 4, 256,
+                              [&](size_t b, size_t e) { work(b * 4, std::min(count, e * 4)); });
+        } else {
+            work(0, count);
+        }
+        Release(index);
+    }
+
+    /**
+     * @brief Water height at one position (same result as GetHeights)
+     */
+    float GetHeight(float x, float z) const {
+        float h;
+        GetHeights(&x, &z, &h, 1);
+        return h;
+    }
+
+    /**
+     * @brief Number of successful publishes
+     */
+    uint64_t GetVersion() const { return version_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Publishes skipped because a reader held the back snapshot
+     */
+    uint64_t GetSkippedCount() const { return skipped_.load(std::memory_order_relaxed); }
+
+private:
+    struct SnapshotCascade {
+        float texelsPerMeter = 0.0f;
+        std::vector<float> texels;      // (dx, height, dz, 0) per texel, row = z
+    };
+
+    struct Snapshot {
+        int resolution = 0;
+        std::vector<SnapshotCascade> cascades;
+    };
+
+    // Pin the front snapshot; retry if it flipped before the pin was visible
+    uint32_t Acquire() const {
+        for (;;) {
+            const uint32_t index = front_.load(std::memory_order_seq_cst);
+            readers_[index].fetch_add(1, std::memory_order_seq_cst);
+            if (front_.load(std::memory_order_seq_cst) == index) {
+                return index;
+            }
+            readers_[index].fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    void Release(uint32_t index) const { readers_[index].fetch_sub(1, std::memory_order_release); }
+
+    Float4 Query4(const Snapshot& snapshot, Float4 x, Float4 z) const {
+        if (snapshot.cascades.empty()) {
+            return Float4(options_.seaLevel);
+        }
+        Float4 px = x, pz = z;
+        Float4 height(0.0f);
+        for (int it = 0; it <= options_.iterations; ++it) {
+            Float4 dx(0.0f), dz(0.0f);
+            height = Float4(0.0f);
+            for (const SnapshotCascade& cascade : snapshot.cascades) {
+                Sample(snapshot.resolution, cascade, px, pz, dx, height, dz);
+            }
+            px = x - dx;
+            pz = z - dz;
+        }
+        return height + Float4(options_.seaLevel);
+    }
+
+    // Bilinear (dx, height, dz) of four positions from one periodic cascade, accumulated
+    static void Sample(int resolution, const SnapshotCascade& cascade, Float4 x, Float4 z, Float4& dx, Float4& height,
+                       Float4& dz) {
+        const Float4 scale(cascade.texelsPerMeter);
+        const Float4 u = x * scale, v = z * scale;
+        const Float4 u0 = Floor(u), v0 = Floor(v);
+        const Float4 fu = u - u0, fv = v - v0;
+        int32_t iu[4], iv[4];
+        StoreInt(u0, iu);
+        StoreInt(v0, iv);
+        const int32_t mask = resolution - 1;
+        const float* texels = cascade.texels.data();
+        Float4 corner[4][4];  // [corner][query] = (dx, h, dz, 0)
+        for (int q = 0; q < 4; ++q) {
+            const int32_t c0 = iu[q] & mask, c1 = (iu[q] + 1) & mask;
+            const int32_t r0 = (iv[q] & mask) * resolution, r1 = ((iv[q] + 1) & mask) * resolution;
+            corner[0][q] = Float4::Load(texels + 4 * size_t(r0 + c0));
+            corner[1][q] = Float4::Load(texels + 4 * size_t(r0 + c1));
+            corner[2][q] = Float4::Load(texels + 4 * size_t(r1 + c0));
+            corner[3][q] = Float4::Load(texels + 4 * size_t(r1 + c1));
+        }
+        const Float4 one(1.0f);
+        const Float4 weight[4] = {(one - fu) * (one - fv), fu * (one - fv), (one - fu) * fv, fu * fv};
+        for (int k = 0; k < 4; ++k) {
+            Float4* c = corner[k];
+            Transpose(c[0], c[1], c[2], c[3]);  // -> dx, height, dz, pad across the four queries
+            dx = dx + weight[k] * c[0];
+            height = height + weight[k] * c[1];
+            dz = dz + weight[k] * c[2];
+        }
+    }
+
+    Options options_;
+    Snapshot snapshots_[2];
+    std::atomic<uint32_t> front_{0};
+    mutable std::atomic<uint32_t> readers_[2] = {0, 0};
+    std::atomic<uint64_t> version_{0};  // Counters only; readers may poll them from any thread
+    std::atomic<uint64_t> skipped_{0};
+};
+
+} // namespace NRE
@@ -0,0 +1,377 @@
+#pragma once
+
+#include <core/JobSystem.h>
+#include <core/Random.h>
+#include <core/Simd.h>
+#include <nature/OceanFFT.h>
+#include <nature/WaterHeightQuery.h>
+#include <nature/WaterRenderer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Splash, spray and foam particles on and above the water
+ *
+ * Droplets live in fixed-capacity structure-of-arrays storage. Emit() only
+ * bumps an atomic cursor and writes the new droplets past the live range,
+ * so any thread can emit (rain impacts, splashes, wakes) without locks and
+ * a full pool just drops and counts the excess. Update() integrates every
+ * droplet four at a time, then compacts the survivors to the front.
+ * Droplets that fall back below the surface deposit foam into a periodic
+ * foam texture; AddCrestFoam() adds foam where the FFT ocean's Jacobian
+ * shows a folding crest, and the texture decays every Update().
+ *
+ * Emit() may run concurrently with itself but not with Update().
+ */
+class WaterParticles {
+public:
+    struct Options {
+        size_t capacity = 262144;       // Maximum live droplets (storage is padded to a multiple of four)
+        float gravity = 9.81f;
+        float drag = 0.8f;              // Air drag (1/s)
+        float seaLevel = 0.0f;          // Surface height when Update() gets no height query
+        int foamResolution = 256;       // Foam texels per side (rounded up to a multiple of four, 0 disables foam)
+        float foamTileSize = 500.0f;    // Meters per foam period (match the largest ocean tile)
+        float foamPerDroplet = 0.02f;   // Foam added by one droplet hitting the water
+        float foamDecay = 0.4f;         // Foam fade rate (1/s)
+        float crestThreshold = 0.5f;    // Jacobian below which a crest breaks
+        float crestFoamRate = 4.0f;     // Foam per second per unit of Jacobian below the threshold
+        int splashDroplets = 64;        // Droplets per unit of splash force
+        uint32_t seed = 1;
+    };
+
+    /**
+     * @brief Particle options from the water renderer config
+     */
+    static Options FromConfig(const WaterRenderer::Config& config) {
+        Options o;
+        if (!config.enableSplashes) {
+            o.capacity = 0;
+        }
+        if (!config.enableFoam) {
+            o.foamResolution = 0;
+        }
+        return o;
+    }
+
+    /**
+     * @brief One droplet to emit
+     */
+    struct Droplet {
+        float x = 0.0f, y = 0.0f, z = 0.0f;
+        float vx = 0.0f, vy = 0.0f, vz = 0.0f;
+        float life = 1.0f;              // Seconds until it expires in the air
+        float size = 0.02f;             // Render radius (m)
+    };
+
+    explicit WaterParticles(const Options& options) : options_(options), capacity_(options.capacity) {
+        // Update() and the foam passes step four floats at a time
+        options_.foamResolution = (std::max(0, options_.foamResolution) + 3) & ~3;
+        const size_t padded = (capacity_ + 3) & ~size_t(3);
+        for (auto* field : {&x_, &y_, &z_, &vx_, &vy_, &vz_, &life_, &size_, &surface_}) {
+            field->assign(padded, 0.0f);
+        }
+        const size_t res = size_t(options_.foamResolution);
+        foam_.assign(res * res, 0.0f);
+    }
+
+    WaterParticles(const WaterParticles&) = delete;
+    WaterParticles& operator=(const WaterParticles&) = delete;
+
+    /**
+     * @brief Emit droplets (callable from any thread)
+     * @return Number emitted; the rest were dropped because the pool is full
+     */
+    size_t Emit(const Droplet* droplets, size_t count) {
+        size_t first = 0;
+        const size_t granted = Reserve(count, first);
+        for (size_t i = 0; i < granted; ++i) {
+            Write(first + i, droplets[i]);
+        }
+        return granted;
+    }
+
+    bool Emit(const Droplet& droplet) { return Emit(&droplet, 1) == 1; }
+
+    /**
+     * @brief Emit a crown of droplets (WaterRenderer::AddSplash)
+     * @param x X position
+     * @param y Y position (water surface)
+     * @param z Z position
+     * @param force Splash strength
+     * @return Number of droplets emitted
+     */
+    size_t EmitSplash(float x, float y, float z, float force) {
+        const size_t wanted = size_t(std::ceil(std::max(0.0f, force) * float(options_.splashDroplets)));
+        size_t first = 0;
+        const size_t granted = Reserve(wanted, first);
+        const float speed = 2.0f + 3.0f * std::sqrt(std::max(0.0f, force));
+        // Slots repeat once the ring wraps, so each splash also mixes in its own serial
+        const uint32_t splash = Hash32(HashCombine(options_.seed, splashes_.fetch_add(1, std::memory_order_relaxed)));
+        for (size_t i = 0; i < granted; ++i) {
+            const uint32_t h = Hash32(HashCombine(splash, uint32_t(i)));
+            const float angle = 6.28318530718f * HashToUnitFloat(h);
+            const float out = speed * (0.2f + 0.4f * HashToUnitFloat(Hash32(h ^ 0x9E3779B9u)));
+            const float up = speed * (0.6f + 0.4f * HashToUnitFloat(Hash32(h ^ 0x85EBCA6Bu)));
+            Droplet d;
+            d.x = x;
+            d.y = y;
+            d.z = z;
+            d.vx = out * std::cos(angle);
+            d.vy = up;
+            d.vz = out * std::sin(angle);
+            d.life = 3.0f;
+            d.size = 0.01f + 0.03f * HashToUnitFloat(Hash32(h ^ 0xC2B2AE35u));
+            Write(first + i, d);
+        }
+        return granted;
+    }
+
+    /**
+     * @brief Integrate, retire droplets and fade foam (call from one thread, after emitters finish)
+     * @param dt Time step (s)
+     * @param water Optional surface heights; flat seaLevel otherwise
+     * @param jobs Optional job system
+     */
+    void Update(float dt, const WaterHeightQuery* water = nullptr, JobSystem* jobs = nullptr) {
+        const size_t count = std::min(cursor_.load(std::memory_order_relaxed), capacity_);
+        const size_t groups = (count + 3) / 4;
+        auto integrate = [&](size_t begin, size_t end) {
+            const Float4 fall(options_.gravity * dt), keep(std::max(0.0f, 1.0f - options_.drag * dt));
+            const Float4 step(dt);
+            for (size_t i = begin * 4; i < end * 4; i += 4) {
+                const Float4 vx = Float4::Load(vx_.data() + i) * keep;
+                const Float4 vy = (Float4::Load(vy_.data() + i) - fall) * keep;
+                const Float4 vz = Float4::Load(vz_.data() + i) * keep;
+                (Float4::Load(x_.data() + i) + vx * step).Store(x_.data() + i);
+                (Float4::Load(y_.data() + i) + vy * step).Store(y_.data() + i);
+                (Float4::Load(z_.data() + i) + vz * step).Store(z_.data() + i);
+                vx.Store(vx_.data() + i);
+                vy.Store(vy_.data() + i);
+                vz.Store(vz_.data() + i);
+                (Float4::Load(life_.data() + i) - step).Store(life_.data() + i);
+            }
+        };
+        if (jobs && groups >= 2048) {
+            jobs->ParallelFor(0, groups, 1024, integrate);
+        } else {
+            integrate(0, groups);
+        }
+        if (water) {
+            water->GetHeights(x_.data(), z_.data(), surface_.data(), count, jobs);
+        }
+        Compact(count, water != nullptr);
+        FadeFoam(dt, jobs);
+    }
+
+    /**
+     * @brief Add foam where the ocean's waves fold over
+     * @param ocean Ocean whose latest Jacobian maps are read
+     * @param dt Time since the last call (s)
+     * @param jobs Optional job system
+     */
+    void AddCrestFoam(const OceanFFT& ocean, float dt, JobSystem* jobs = nullptr) {
+        const int res = options_.foamResolution;
+        if (res <= 0 || ocean.GetCascadeCount() == 0) {
+            return;
+        }
+        const int n = ocean.GetResolution();
+        const float texel = options_.foamTileSize / float(res);
+        const Float4 lane(0.5f, 1.5f, 2.5f, 3.5f), one(1.0f), zero(0.0f);
+        const Float4 threshold(options_.crestThreshold), rate(options_.crestFoamRate * dt);
+        auto rows = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const float zw = (float(i) + 0.5f) * texel;
+                float* foam = foam_.data() + i * size_t(res);
+                for (int j = 0; j < res; j += 4) {
+                    const Float4 xw = (Float4(float(j)) + lane) * Float4(texel);
+                    // Folding adds up across bands: J ~ 1 + sum(J_c - 1)
+                    Float4 jacobian = one;
+                    for (size_t c = 0; c < ocean.GetCascadeCount(); ++c) {
+                        const OceanFFT::Cascade& cascade = ocean.GetCascade(c);
+                        const float scale = float(n) / cascade.tileSize;
+                        int32_t u[4];
+                        StoreInt(Floor(xw * Float4(scale)), u);
+                        const size_t row = size_t(int32_t(std::floor(zw * scale)) & (n - 1)) * size_t(n);
+                        float sample[4];
+                        for (int l = 0; l < 4; ++l) {
+                            sample[l] = cascade.jacobian[row + size_t(u[l] & (n - 1))];
+                        }
+                        jacobian = jacobian + Float4::Load(sample) - one;
+                    }
+                    const Float4 added = rate * Max(zero, threshold - jacobian);
+                    Min(one, Float4::Load(foam + j) + added).Store(foam + j);
+                }
+            }
+        };
+        if (jobs) {
+            jobs->ParallelFor(0, size_t(res), 16, rows);
+        } else {
+            rows(0, size_t(res));
+        }
+    }
+
+    /**
+     * @brief Foam coverage at a world position (bilinear, periodic)
+     */
+    float GetFoam(float x, float z) const {
+        const int res = options_.foamResolution;
+        if (res <= 0) {
+            return 0.0f;
+        }
+        const float u = x / options_.foamTileSize * float(res) - 0.5f;
+        const float v = z / options_.foamTileSize * float(res) - 0.5f;
+        const float u0 = std::floor(u), v0 = std::floor(v);
+        const float fu = u - u0, fv = v - v0;
+        auto at = [&](float a, float b) {
+            const int i = ((int(b) % res) + res) % res;
+            const int j = ((int(a) % res) + res) % res;
+            return foam_[size_t(i) * size_t(res) + size_t(j)];
+        };
+        const float top = at(u0, v0) + fu * (at(u0 + 1.0f, v0) - at(u0, v0));
+        const float bottom = at(u0, v0 + 1.0f) + fu * (at(u0 + 1.0f, v0 + 1.0f) - at(u0, v0 + 1.0f));
+        return top + fv * (bottom - top);
+    }
+
+    /**
+     * @brief Foam texture (foamResolution^2, row = z), values in [0, 1]
+     */
+    const std::vector<float>& GetFoamTexture() const { return foam_; }
+    int GetFoamResolution() const { return options_.foamResolution; }
+
+    /**
+     * @brief Live droplets after the last Update()
+     */
+    size_t GetCount() const { return live_; }
+    size_t GetCapacity() const { return capacity_; }
+
+    /**
+     * @brief Droplets dropped because the pool was full
+     */
+    uint64_t GetDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Droplet arrays for rendering, GetCount() entries each
+     */
+    const float* GetX() const { return x_.data(); }
+    const float* GetY() const { return y_.data(); }
+    const float* GetZ() const { return z_.data(); }
+    const float* GetLife() const { return life_.data(); }
+    const float* GetSize() const { return size_.data(); }
+
+    const Options& GetOptions() const { return options_; }
+
+private:
+    // Claim slots past the live range; returns how many of count were granted
+    size_t Reserve(size_t count, size_t& first) {
+        if (count == 0) {
+            return 0;
+        }
+        first = cursor_.fetch_add(count, std::memory_order_relaxed);
+        const size_t granted = first >= capacity_ ? 0 : std::min(count, capacity_ - first);
+        if (granted < count) {
+            dropped_.fetch_add(count - granted, std::memory_order_relaxed);
+        }
+        return granted;
+    }
+
+    void Write(size_t slot, const Droplet& d) {
+        x_[slot] = d.x;
+        y_[slot] = d.y;
+        z_[slot] = d.z;
+        vx_[slot] = d.vx;
+        vy_[slot] = d.vy;
+        vz_[slot] = d.vz;
+        life_[slot] = d.life;
+        size_[slot] = d.size;
+    }
+
+    void Move(size_t from, size_t to) {
+        x_[to] = x_[from];
+        y_[to] = y_[from];
+        z_[to] = z_[from];
+        vx_[to] = vx_[from];
+        vy_[to] = vy_[from];
+        vz_[to] = vz_[from];
+        life_[to] = life_[from];
+        size_[to] = size_[from];
+    }
+
+    // Keep droplets still in the air; ones under the surface turn into foam
+    void Compact(size_t count, bool hasSurface) {
+        const Float4 lane(0.0f, 1.0f, 2.0f, 3.0f), zero(0.0f), flat(options_.seaLevel);
+        size_t write = 0;
+        for (size_t i = 0; i < count; i += 4) {
+            const Float4 valid = lane < Float4(float(count - i));
+            const Float4 y = Float4::Load(y_.data() + i);
+            const Float4 surface = hasSurface ? Float4::Load(surface_.data() + i) : flat;
+            const Float4 airborne = y > surface;
+            const int alive = MoveMask(valid & airborne & (Float4::Load(life_.data() + i) > zero));
+            const int landed = MoveMask(valid & (y <= surface));
+            if (landed) {
+                for (int l = 0; l < 4; ++l) {
+                    if (landed & (1 << l)) {
+                        DepositFoam(x_[i + size_t(l)], z_[i + size_t(l)]);
+                    }
+                }
+            }
+            if (alive == 0xF && write == i) {
+                write += 4;
+                continue;
+            }
+            for (int l = 0; l < 4; ++l) {
+                if (alive & (1 << l)) {
+                    Move(i + size_t(l), write++);
+                }
+            }
+        }
+        live_ = write;
+        cursor_.store(write, std::memory_order_relaxed);
+    }
+
+    void DepositFoam(float x, float z) {
+        const int res = options_.foamResolution;
+        if (res <= 0) {
+            return;
+        }
+        const float scale = float(res) / options_.foamTileSize;
+        const int i = ((int(std::floor(z * scale)) % res) + res) % res;
+        const int j = ((int(std::floor(x * scale)) % res) + res) % res;
+        float& foam = foam_[size_t(i) * size_t(res) + size_t(j)];
+        foam = std::min(1.0f, foam + options_.foamPerDroplet);
+    }
+
+    void FadeFoam(float dt, JobSystem* jobs) {
+        const Float4 keep(std::exp(-options_.foamDecay * dt));
+        auto fade = [&](size_t begin, size_t end) {
+            for (size_t i = begin * 4; i < end * 4; i += 4) {
+                (Float4::Load(foam_.data() + i) * keep).Store(foam_.data() + i);
+            }
+        };
+        const size_t groups = foam_.size() / 4;
+        if (jobs && groups >= 4096) {
+            jobs->ParallelFor(0, groups, 2048, fade);
+        } else {
+            fade(0, groups);
+        }
+    }
+
+    Options options_;
+    size_t capacity_;
+    std::vector<float> x_, y_, z_, vx_, vy_, vz_, life_, size_;
+    std::vector<float> surface_;        // Water height under each droplet this update
+    std::vector<float> foam_;
+    size_t live_ = 0;
+    std::atomic<size_t> cursor_{0};     // Next free slot; may run past capacity while full
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint32_t> splashes_{0}; // Splash serial; varies the crown pattern
+};
+
+} // namespace NRE
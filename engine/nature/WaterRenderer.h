@@ -5,6 +5,36 @@
 
 namespace NRE {
 
+/**
+ * @brief Water configuration (WaterRenderer::Config)
+ *
+ * Kept outside WaterRenderer for the same reason as EcosystemConfig.
+ */
+struct WaterRendererConfig {
+    // Simulation
+    bool enableFluidSimulation = true;  // Navier-Stokes
+    bool enableFFTOcean = true;         // FFT-based ocean waves
+    int simulationResolution = 512;
+    
+    // Rendering
+    bool enableReflections = true;
+    bool enableRefractions = true;
+    bool enableCaustics = true;     // Precomputed per ocean update (Caustics)
+    bool enableFoam = true;
+    bool enableSplashes = true;
+    
+    // Physical properties
+    float waveHeight = 1.0f;
+    float waveSpeed = 1.0f;
+    float windSpeed = 10.0f;
+    float windDirection[2] = {1.0f, 0.0f};
+    
+    // Visual properties
+    float clarity = 0.8f;           // 0 = murky, 1 = crystal clear
+    float color[3] = {0.0f, 0.3f, 0.5f};  // Water color
+    float ior = 1.333f;             // Index of refraction
+};
+
 /**
  * @brief Photorealistic water rendering with fluid simulation
  * 
@@ -12,30 +42,7 @@ namespace NRE {
  */
 class WaterRenderer {
 public:
-    struct Config {
-        // Simulation
-        bool enableFluidSimulation = true;  // Navier-Stokes
-        bool enableFFTOcean = true;         // FFT-based ocean waves
-        int simulationResolution = 512;
-        
-        // Rendering
-        bool enableReflections = true;
-        bool enableRefractions = true;
-        bool enableCaustics = true;
-        bool enableFoam = true;
-        bool enableSplashes = true;
-        
-        // Physical properties
-        float waveHeight = 1.0f;
-        float waveSpeed = 1.0f;
-        float windSpeed = 10.0f;
-        float windDirection[2] = {1.0f, 0.0f};
-        
-        // Visual properties
-        float clarity = 0.8f;           // 0 = murky, 1 = crystal clear
-        float color[3] = {0.0f, 0.3f, 0.5f};  // Water color
-        float ior = 1.333f;             // Index of refraction
-    };
+    using Config = WaterRendererConfig;
 
     virtual ~WaterRenderer() = default;
 
@@ -65,6 +72,8 @@ public:
 
     /**
      * @brief Add splash effect at position
+     *
+     * Droplets and the foam they leave are simulated by WaterParticles.
      * @param x X position
      * @param y Y position (water surface)
      * @param z Z position
@@ -74,6 +83,9 @@ public:
 
     /**
      * @brief Get water height at position
+     *
+     * Physics and gameplay code issuing many queries per frame should batch
+     * them through a WaterHeightQuery instead.
      * @param x X position
      * @param z Z position
      * @return Water height (Y coordinate)
@@ -6,6 +6,31 @@
 
 namespace NRE {
 
+class WindField;
+
+/**
+ * @brief Weather configuration (WeatherSystem::Config)
+ *
+ * Kept outside WeatherSystem for the same reason as EcosystemConfig.
+ */
+struct WeatherSystemConfig {
+    // Simulation
+    bool enableAtmosphericSimulation = true;  // AtmosphereGrid
+    bool enableVolumetricClouds = true;       // CloudNoiseBaker volumes
+    bool enablePrecipitation = true;
+    
+    // Visual quality
+    int cloudResolution = 512;
+    int precipitationParticles = 100000;
+    
+    // Physical properties
+    float temperature = 20.0f;      // Celsius
+    float humidity = 0.5f;          // 0-1
+    float windSpeed = 5.0f;         // m/s
+    float windDirection[2] = {1.0f, 0.0f};
+    float pressure = 1013.25f;      // Millibars
+};
+
 /**
  * @brief Weather simulation system with atmospheric effects
  * 
@@ -29,23 +54,7 @@ public:
         Hail
     };
 
-    struct Config {
-        // Simulation
-        bool enableAtmosphericSimulation = true;
-        bool enableVolumetricClouds = true;
-        bool enablePrecipitation = true;
-        
-        // Visual quality
-        int cloudResolution = 512;
-        int precipitationParticles = 100000;
-        
-        // Physical properties
-        float temperature = 20.0f;      // Celsius
-        float humidity = 0.5f;          // 0-1
-        float windSpeed = 5.0f;         // m/s
-        float windDirection[2] = {1.0f, 0.0f};
-        float pressure = 1013.25f;      // Millibars
-    };
+    using Config = WeatherSystemConfig;
 
     virtual ~WeatherSystem() = default;
 
@@ -75,6 +84,9 @@ public:
 
     /**
      * @brief Set weather type
+     *
+     * With atmospheric simulation enabled this sets the forcing target of
+     * the AtmosphereGrid; the weather itself follows over the transition.
      * @param type Weather type to set
      * @param transitionTime Time to transition (seconds)
      */
@@ -82,6 +94,9 @@ public:
 
     /**
      * @brief Get current weather type
+     *
+     * With atmospheric simulation enabled this is derived from the local
+     * AtmosphereGrid state at the viewer.
      * @return Current weather type
      */
     virtual WeatherType GetWeather() const = 0;
@@ -116,6 +131,15 @@ public:
      */
     virtual void TriggerLightning(float x, float y, float z) = 0;
 
+    /**
+     * @brief Drive a shared wind field
+     *
+     * Each Update() pushes Config::windSpeed and windDirection into the
+     * field's ambient wind; rain, snow and clouds sample the field.
+     * @param field Wind field (nullptr to detach)
+     */
+    virtual void SetWindField(WindField* field) = 0;
+
     /**
      * @brief Get temperature at position
      * @param altitude Altitude in meters
@@ -0,0 +1,406 @@
+#pragma once
+
+#include <core/Random.h>
+#include <core/Simd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief Shared low-resolution 3D wind field
+ *
+ * One coarse grid around the camera, updated once per frame and sampled by
+ * vegetation, trees and weather instead of each simulating its own wind.
+ * The ambient wind (WeatherSystem::Config::windSpeed / windDirection) is
+ * shaped by a logarithmic boundary-layer profile, modulated by gust fronts
+ * that travel downwind, perturbed by smooth turbulence noise, and
+ * self-advected so disturbances drift with the flow.
+ */
+class WindField {
+public:
+    struct Options {
+        int sizeX = 32;                // Cells (rounded up to a multiple of 4)
+        int sizeY = 8;
+        int sizeZ = 32;
+        float cellSize = 8.0f;         // Meters, horizontal
+        float cellHeight = 6.0f;       // Meters, vertical
+        float groundHeight = 0.0f;     // World Y of the bottom layer
+        float roughness = 0.1f;        // Surface roughness length (meters)
+        float referenceHeight = 10.0f; // Height at which ambient speed applies
+        float gustStrength = 0.4f;     // Fraction of ambient speed
+        float gustLength = 120.0f;     // Meters between gust fronts
+        float turbulence = 0.25f;      // Fraction of ambient speed
+        float turbulencePeriod = 2.0f; // Seconds between noise keyframes
+        float response = 1.5f;         // 1/seconds toward the driven state
+        uint32_t seed = 1;
+    };
+
+    explicit WindField(const Options& options) : options_(options) {
+        options_.sizeX = std::max(4, (options.sizeX + 3) & ~3);
+        options_.sizeY = std::max(1, options.sizeY);
+        options_.sizeZ = std::max(1, options.sizeZ);
+        const size_t n = CellCount();
+        for (auto* v : {&vx_, &vy_, &vz_, &scratchX_, &scratchY_, &scratchZ_}) {
+            v->assign(n, 0.0f);
+        }
+        for (int c = 0; c < 3; ++c) {
+            noiseA_[c].assign(n, 0.0f);
+            noiseB_[c].assign(n, 0.0f);
+        }
+        profile_.resize(size_t(options_.sizeY));
+        gust_.resize(size_t(options_.sizeX) * options_.sizeZ);
+        texture_.assign(n * 4, 0.0f);
+        for (int y = 0; y < options_.sizeY; ++y) {
+            const float h = (float(y) + 0.5f) * options_.cellHeight;
+            const float z0 = options_.roughness;
+            profile_[size_t(y)] = std::log((h + z0) / z0) / std::log((options_.referenceHeight + z0) / z0);
+        }
+        origin_[0] = -0.5f * float(options_.sizeX) * options_.cellSize;
+        origin_[1] = -0.5f * float(options_.sizeZ) * options_.cellSize;
+        BuildNoise(noiseA_, 0);
+        BuildNoise(noiseB_, 1);
+    }
+
+    WindField() : WindField(Options{}) {}
+
+    /**
+     * @brief Set the ambient wind (usually from WeatherSystem::Config)
+     * @param speed Wind speed at the reference height (m/s)
+     * @param direction Horizontal direction (x, z), need not be normalized
+     */
+    void SetAmbient(float speed, const float direction[2]) {
+        const float len = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1]);
+        speed_ = speed;
+        direction_[0] = len > 0.0f ? direction[0] / len : 1.0f;
+        direction_[1] = len > 0.0f ? direction[1] / len : 0.0f;
+    }
+
+    /**
+     * @brief Keep the grid centered on a world position (moves in whole cells)
+     */
+    void Recenter(float x, float z) {
+        const float halfX = 0.5f * float(options_.sizeX) * options_.cellSize;
+        const float halfZ = 0.5f * float(options_.sizeZ) * options_.cellSize;
+        const int dx = int(std::floor((x - halfX - origin_[0]) / options_.cellSize + 0.5f));
+        const int dz = int(std::floor((z - halfZ - origin_[1]) / options_.cellSize + 0.5f));
+        if (dx == 0 && dz == 0) {
+            return;
+        }
+        // Shift the state; cells entering the grid start from the ambient wind
+        for (int k = 0; k < options_.sizeZ; ++k) {
+            for (int j = 0; j < options_.sizeY; ++j) {
+                for (int i = 0; i < options_.sizeX; ++i) {
+                    const size_t dst = Index(i, j, k);
+                    const int si = i + dx;
+                    const int sk = k + dz;
+                    if (si >= 0 && si < options_.sizeX && sk >= 0 && sk < options_.sizeZ) {
+                        const size_t src = Index(si, j, sk);
+                        scratchX_[dst] = vx_[src];
+                        scratchY_[dst] = vy_[src];
+                        scratchZ_[dst] = vz_[src];
+                    } else {
+                        const float s = speed_ * profile_[size_t(j)];
+                        scratchX_[dst] = direction_[0] * s;
+                        scratchY_[dst] = 0.0f;
+                        scratchZ_[dst] = direction_[1] * s;
+                    }
+                }
+            }
+        }
+        std::swap(vx_, scratchX_);
+        std::swap(vy_, scratchY_);
+        std::swap(vz_, scratchZ_);
+        origin_[0] += float(dx) * options_.cellSize;
+        origin_[1] += float(dz) * options_.cellSize;
+    }
+
+    /**
+     * @brief Advance the field by one frame
+     * @param deltaTime Time since last update (seconds)
+     */
+    void Update(float deltaTime) {
+        time_ += deltaTime;
+        while (time_ >= float(noiseFrame_ + 1) * options_.turbulencePeriod) {
+            ++noiseFrame_;
+            std::swap(noiseA_, noiseB_);
+            BuildNoise(noiseB_, noiseFrame_ + 1);
+        }
+        Advect(deltaTime);
+        UpdateGusts();
+        Drive(deltaTime);
+        BuildTexture();
+    }
+
+    /**
+     * @brief Wind velocity at a world position (trilinear, clamped to the grid)
+     * @param position World position
+     * @param velocity Output velocity (m/s)
+     */
+    void Sample(const float position[3], float velocity[3]) const {
+        SampleGrid(GridX(position[0]), GridY(position[1]), GridZ(position[2]), vx_, vy_, vz_, velocity);
+    }
+
+    /**
+     * @brief Sample many positions (SoA in, SoA out)
+     */
+    void SampleMany(const float* x, const float* y, const float* z, size_t count,
+                    float* outX, float* outY, float* outZ) const {
+        for (size_t i = 0; i < count; ++i) {
+            float v[3];
+            SampleGrid(GridX(x[i]), GridY(y[i]), GridZ(z[i]), vx_, vy_, vz_, v);
+            outX[i] = v[0];
+            outY[i] = v[1];
+            outZ[i] = v[2];
+        }
+    }
+
+    /**
+     * @brief RGBA32F 3D texture (velocity xyz, gust factor), x fastest
+     */
+    const float* GetTextureData() const { return texture_.data(); }
+
+    /**
+     * @brief Grid dimensions of the texture
+     */
+    void GetDimensions(int& x, int& y, int& z) const {
+        x = options_.sizeX;
+        y = options_.sizeY;
+        z = options_.sizeZ;
+    }
+
+    /**
+     * @brief World position of the grid's minimum corner (x, ground, z)
+     */
+    void GetOrigin(float origin[3]) const {
+        origin[0] = origin_[0];
+        origin[1] = options_.groundHeight;
+        origin[2] = origin_[1];
+    }
+
+    float GetCellSize() const { return options_.cellSize; }
+    float GetCellHeight() const { return options_.cellHeight; }
+    float GetAmbientSpeed() const { return speed_; }
+
+private:
+    size_t CellCount() const { return size_t(options_.sizeX) * options_.sizeY * options_.sizeZ; }
+    size_t Index(int i, int j, int k) const {
+        return (size_t(k) * options_.sizeY + j) * options_.sizeX + i;
+    }
+
+    // Grid coordinates relative to cell centers
+    float GridX(float x) const { return (x - origin_[0]) / options_.cellSize - 0.5f; }
+    float GridY(float y) const { return (y - options_.groundHeight) / options_.cellHeight - 0.5f; }
+    float GridZ(float z) const { return (z - origin_[1]) / options_.cellSize - 0.5f; }
+
+    void SampleGrid(float gx, float gy, float gz, const std::vector<float>& fx, const std::vector<float>& fy,
+                    const std::vector<float>& fz, float out[3]) const {
+        gx = std::clamp(gx, 0.0f, float(options_.sizeX - 1));
+        gy = std::clamp(gy, 0.0f, float(options_.sizeY - 1));
+        gz = std::clamp(gz, 0.0f, float(options_.sizeZ - 1));
+        const int i0 = std::min(int(gx), options_.sizeX - 1);
+        const int j0 = std::min(int(gy), options_.sizeY - 1);
+        const int k0 = std::min(int(gz), options_.sizeZ - 1);
+        const int i1 = std::min(i0 + 1, options_.sizeX - 1);
+        const int j1 = std::min(j0 + 1, options_.sizeY - 1);
+        const int k1 = std::min(k0 + 1, options_.sizeZ - 1);
+        const float tx = gx - float(i0);
+        const float ty = gy - float(j0);
+        const float tz = gz - float(k0);
+        const std::vector<float>* fields[3] = {&fx, &fy, &fz};
+        for (int c = 0; c < 3; ++c) {
+            const std::vector<float>& f = *fields[c];
+            const float c00 = f[Index(i0, j0, k0)] + (f[Index(i1, j0, k0)] - f[Index(i0, j0, k0)]) * tx;
+            const float c10 = f[Index(i0, j1, k0)] + (f[Index(i1, j1, k0)] - f[Index(i0, j1, k0)]) * tx;
+            const float c01 = f[Index(i0, j0, k1)] + (f[Index(i1, j0, k1)] - f[Index(i0, j0, k1)]) * tx;
+            const float c11 = f[Index(i0, j1, k1)] + (f[Index(i1, j1, k1)] - f[Index(i0, j1, k1)]) * tx;
+            const float c0 = c00 + (c10 - c00) * ty;
+            const float c1 = c01 + (c11 - c01) * ty;
+            out[c] = c0 + (c1 - c0) * tz;
+        }
+    }
+
+    // Trilinear samples of the velocity grid at four points, with SampleGrid's clamping
+    void SampleGrid4(Float4 gx, Float4 gy, Float4 gz, Float4 out[3]) const {
+        const Float4 zero(0.0f);
+        const Float4 maxX(float(options_.sizeX - 1));
+        const Float4 maxY(float(options_.sizeY - 1));
+        const Float4 maxZ(float(options_.sizeZ - 1));
+        gx = Min(maxX, Max(zero, gx));
+        gy = Min(maxY, Max(zero, gy));
+        gz = Min(maxZ, Max(zero, gz));
+        const Float4 x0 = Floor(gx), y0 = Floor(gy), z0 = Floor(gz);
+        const Float4 tx = gx - x0, ty = gy - y0, tz = gz - z0;
+        // Corner (i0, j0, k0) and the steps to its +x/+y/+z neighbours (0 on the far border)
+        const Float4 one(1.0f);
+        const Float4 row(float(options_.sizeX));
+        const Float4 slice(float(options_.sizeX) * float(options_.sizeY));
+        int32_t base[4], dx[4], dy[4], dz[4];
+        StoreInt((z0 * Float4(float(options_.sizeY)) + y0) * row + x0, base);
+        StoreInt(Min(x0 + one, maxX) - x0, dx);
+        StoreInt((Min(y0 + one, maxY) - y0) * row, dy);
+        StoreInt((Min(z0 + one, maxZ) - z0) * slice, dz);
+        const std::vector<float>* fields[3] = {&vx_, &vy_, &vz_};
+        for (int c = 0; c < 3; ++c) {
+            alignas(16) float v[8][4];
+            for (int l = 0; l < 4; ++l) {
+                const float* f = fields[c]->data() + base[l];
+                const float* fy = f + dy[l];
+                const float* fz = f + dz[l];
+                const float* fyz = fy + dz[l];
+                v[0][l] = f[0];
+                v[1][l] = f[dx[l]];
+                v[2][l] = fy[0];
+                v[3][l] = fy[dx[l]];
+                v[4][l] = fz[0];
+                v[5][l] = fz[dx[l]];
+                v[6][l] = fyz[0];
+                v[7][l] = fyz[dx[l]];
+            }
+            const Float4 v0 = Float4::Load(v[0]), v2 = Float4::Load(v[2]);
+            const Float4 v4 = Float4::Load(v[4]), v6 = Float4::Load(v[6]);
+            const Float4 c00 = v0 + (Float4::Load(v[1]) - v0) * tx;
+            const Float4 c10 = v2 + (Float4::Load(v[3]) - v2) * tx;
+            const Float4 c01 = v4 + (Float4::Load(v[5]) - v4) * tx;
+            const Float4 c11 = v6 + (Float4::Load(v[7]) - v6) * tx;
+            const Float4 c0 = c00 + (c10 - c00) * ty;
+            const Float4 c1 = c01 + (c11 - c01) * ty;
+            out[c] = c0 + (c1 - c0) * tz;
+        }
+    }
+
+    // Semi-Lagrangian self-advection: each cell pulls the velocity found upstream
+    void Advect(float dt) {
+        const Float4 sx(dt / options_.cellSize);
+        const Float4 sy(dt / options_.cellHeight);
+        const Float4 lane(0.0f, 1.0f, 2.0f, 3.0f);
+        for (int k = 0; k < options_.sizeZ; ++k) {
+            const Float4 fk = Float4(float(k));
+            for (int j = 0; j < options_.sizeY; ++j) {
+                const Float4 fj = Float4(float(j));
+                for (int i = 0; i < options_.sizeX; i += 4) {
+                    const size_t c = Index(i, j, k);
+                    const Float4 fi = Float4(float(i)) + lane;
+                    Float4 v[3];
+                    SampleGrid4(fi - Float4::Load(&vx_[c]) * sx, fj - Float4::Load(&vy_[c]) * sy,
+                                fk - Float4::Load(&vz_[c]) * sx, v);
+                    v[0].Store(&scratchX_[c]);
+                    v[1].Store(&scratchY_[c]);
+                    v[2].Store(&scratchZ_[c]);
+                }
+            }
+        }
+        std::swap(vx_, scratchX_);
+        std::swap(vy_, scratchY_);
+        std::swap(vz_, scratchZ_);
+    }
+
+    // Gust fronts: a smooth 1D signal along the wind direction, moving at wind speed
+    void UpdateGusts() {
+        const float k = 6.28318530718f / std::max(options_.gustLength, 1.0f);
+        const float phase = time_ * std::max(speed_, 0.1f);
+        const Float4 zero(0.0f);
+        const Float4 lane(0.5f, 1.5f, 2.5f, 3.5f);
+        const Float4 strength(options_.gustStrength);
+        for (int z = 0; z < options_.sizeZ; ++z) {
+            const float wz = origin_[1] + (float(z) + 0.5f) * options_.cellSize;
+            const Float4 along(wz * direction_[1] - phase);
+            for (int x = 0; x < options_.sizeX; x += 4) {
+                const Float4 wx = Float4(origin_[0]) + (Float4(float(x)) + lane) * Float4(options_.cellSize);
+                const Float4 s = (wx * Float4(direction_[0]) + along) * Float4(k);
+                Float4 s1, s2, s3, unused;
+                SinCos(s, s1, unused);
+                SinCos(Float4(2.3f) * s + Float4(1.7f), s2, unused);
+                SinCos(Float4(5.1f) * s + Float4(4.2f), s3, unused);
+                const Float4 g = Float4(0.6f) * s1 + Float4(0.3f) * s2 + Float4(0.1f) * s3;
+                (Float4(1.0f) + strength * Max(zero, g)).Store(&gust_[size_t(z) * options_.sizeX + x]);
+            }
+        }
+    }
+
+    void BuildNoise(std::vector<float> (&noise)[3], uint32_t frame) {
+        for (int c = 0; c < 3; ++c) {
+            const uint32_t seed = HashCombine(HashCombine(options_.seed, frame), uint32_t(c));
+            for (size_t i = 0; i < noise[c].size(); ++i) {
+                noise[c][i] = HashToUnitFloat(HashCombine(seed, uint32_t(i))) * 2.0f - 1.0f;
+            }
+        }
+    }
+
+    // Relax toward ambient * profile * gust + turbulence, four cells at a time
+    void Drive(float dt) {
+        const float blend = std::clamp(time_ / options_.turbulencePeriod - float(noiseFrame_), 0.0f, 1.0f);
+        const Float4 t(blend);
+        const Float4 k(std::min(1.0f, options_.response * dt));
+        const Float4 dirX(direction_[0]);
+        const Float4 dirZ(direction_[1]);
+        const Float4 turb(options_.turbulence * speed_);
+        const Float4 vertical(0.3f);  // Turbulence is weaker vertically
+        for (int z = 0; z < options_.sizeZ; ++z) {
+            for (int y = 0; y < options_.sizeY; ++y) {
+                const Float4 base(speed_ * profile_[size_t(y)]);
+                for (int x = 0; x < options_.sizeX; x += 4) {
+                    const size_t c = Index(x, y, z);
+                    const Float4 s = base * Float4::Load(&gust_[size_t(z) * options_.sizeX + x]);
+                    Float4 n[3];
+                    for (int a = 0; a < 3; ++a) {
+                        const Float4 na = Float4::Load(&noiseA_[a][c]);
+                        n[a] = na + (Float4::Load(&noiseB_[a][c]) - na) * t;
+                    }
+                    const Float4 targetX = dirX * s + turb * n[0];
+                    const Float4 targetY = turb * vertical * n[1];
+                    const Float4 targetZ = dirZ * s + turb * n[2];
+                    const Float4 vx = Float4::Load(&vx_[c]);
+                    const Float4 vy = Float4::Load(&vy_[c]);
+                    const Float4 vz = Float4::Load(&vz_[c]);
+                    (vx + (targetX - vx) * k).Store(&vx_[c]);
+                    (vy + (targetY - vy) * k).Store(&vy_[c]);
+                    (vz + (targetZ - vz) * k).Store(&vz_[c]);
+                }
+            }
+        }
+    }
+
+    // Interleave the velocity and gust planes into RGBA texels, four cells per transpose
+    void BuildTexture() {
+        for (int z = 0; z < options_.sizeZ; ++z) {
+            const float* gust = &gust_[size_t(z) * options_.sizeX];
+            for (int y = 0; y < options_.sizeY; ++y) {
+                for (int x = 0; x < options_.sizeX; x += 4) {
+                    const size_t c = Index(x, y, z);
+                    Float4 r0 = Float4::Load(&vx_[c]);
+                    Float4 r1 = Float4::Load(&vy_[c]);
+                    Float4 r2 = Float4::Load(&vz_[c]);
+                    Float4 r3 = Float4::Load(gust + x);
+                    Transpose(r0, r1, r2, r3);
+                    float* texel = &texture_[c * 4];
+                    r0.Store(texel);
+                    r1.Store(texel + 4);
+                    r2.Store(texel + 8);
+                    r3.Store(texel + 12);
+                }
+            }
+        }
+    }
+
+    Options options_;
+    float speed_ = 5.0f;
+    float direction_[2] = {1.0f, 0.0f};
+    float origin_[2] = {0.0f, 0.0f};  // World X/Z of the grid's minimum corner
+    float time_ = 0.0f;
+    uint32_t noiseFrame_ = 0;
+
+    std::vector<float> vx_, vy_, vz_;
+    std::vector<float> scratchX_, scratchY_, scratchZ_;
+    std::vector<float> noiseA_[3];
+    std::vector<float> noiseB_[3];
+    std::vector<float> profile_;
+    std::vector<float> gust_;
+    std::vector<float> texture_;
+};
+
+} // namespace NRE
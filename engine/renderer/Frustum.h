@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cmath>
+
+namespace NRE {
+
+/**
+ * @brief View frustum as six inward-facing planes (ax + by + cz + d >= 0 inside)
+ */
+struct Frustum {
+    float planes[6][4] = {};
+
+    /**
+     * @brief Extract planes from a view-projection matrix
+     * @param m Column-major 4x4 matrix (OpenGL layout, clip z in [-w, w])
+     * @return Normalized frustum
+     */
+    static Frustum FromViewProjection(const float m[16]) {
+        // Row r of the matrix is (m[r], m[4 + r], m[8 + r], m[12 + r])
+        auto row = [m](int r, int c) { return m[c * 4 + r]; };
+        Frustum f;
+        for (int i = 0; i < 3; ++i) {
+            for (int c = 0; c < 4; ++c) {
+                f.planes[i * 2][c] = row(3, c) + row(i, c);      // Left, bottom, near
+                f.planes[i * 2 + 1][c] = row(3, c) - row(i, c);  // Right, top, far
+            }
+        }
+        for (auto& p : f.planes) {
+            const float len = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+            if (len > 0.0f) {
+                for (float& v : p) v /= len;
+            }
+        }
+        return f;
+    }
+
+    /**
+     * @brief Conservative box test (false only if fully outside one plane)
+     * @param min Box minimum corner
+     * @param max Box maximum corner
+     */
+    bool IntersectsBox(const float min[3], const float max[3]) const {
+        for (const auto& p : planes) {
+            // Corner furthest along the plane normal
+            const float x = p[0] >= 0.0f ? max[0] : min[0];
+            const float y = p[1] >= 0.0f ? max[1] : min[1];
+            const float z = p[2] >= 0.0f ? max[2] : min[2];
+            if (p[0] * x + p[1] * y + p[2] * z + p[3] < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace NRE
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <core/StorageManager.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace NRE {
+
+/**
+ * @brief In-memory storage backend for tests and benchmarks
+ *
+ * Entries are plain byte vectors that tests may inspect, truncate or
+ * corrupt directly; loads cost a copy only, so benchmarks time
+ * decompression rather than disk access.
+ */
+class MemoryStorage : public StorageManager {
+public:
+    std::map<std::string, std::vector<uint8_t>> entries;
+    size_t lowPriorityWrites = 0;
+
+    bool Initialize() override { return true; }
+    bool Write(const std::string& key, const void* data, size_t size, Priority priority) override {
+        entries[key].assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+        lowPriorityWrites += priority == Priority::Low;
+        return true;
+    }
+    size_t Read(const std::string& key, void* data, size_t size) override {
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            return 0;
+        }
+        const size_t n = std::min(size, it->second.size());
+        std::memcpy(data, it->second.data(), n);
+        return n;
+    }
+    bool Exists(const std::string& key) override { return entries.count(key) != 0; }
+    bool Delete(const std::string& key) override { return entries.erase(key) != 0; }
+    size_t GetSize(const std::string& key) override {
+        auto it = entries.find(key);
+        return it != entries.end() ? it->second.size() : 0;
+    }
+    void ClearCache() override {}
+    size_t GetCacheUsage() const override { return 0; }
+    size_t GetStorageUsage() const override { return 0; }
+    void Optimize() override {}
+    void Flush() override {}
+    std::vector<std::string> ListKeys() const override {
+        std::vector<std::string> keys;
+        for (const auto& entry : entries) {
+            keys.push_back(entry.first);
+        }
+        return keys;
+    }
+    void SetLowStorageCallback(std::function<void(size_t)>) override {}
+    void Shutdown() override { entries.clear(); }
+};
+
+} // namespace NRE
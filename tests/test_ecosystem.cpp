@@ -1,31 +1,415 @@
+#include "MemoryStorage.h"
+
+#include <nature/EcosystemFastForward.h>
+#include <nature/EcosystemSnapshot.h>
+#include <nature/EcosystemStepper.h>
+#include <nature/EntityPool.h>
+#include <nature/PopulationIndex.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace NRE;
+
+// Count global allocations so pooled spawning can be checked allocation-free
+static size_t g_allocations = 0;
+
+void* operator new(size_t size) {
+    ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
 
 /**
  * @brief Basic test for ecosystem simulation
- * 
+ *
  * Tests:
  * - Plant growth simulation
  * - Animal behavior AI
  * - Predator-prey dynamics
+ * - Fast-forward (time-lapse) plant simulation
+ * - Pooled entity allocation and generational handles
+ * - Population statistics index and history
+ * - Snapshot save/load with delta encoding and storage pruning
+ * - Headless real-time stepping with predator avoidance
  */
 
-int main() {
-    std::cout << "=== Nature Reality Engine: Ecosystem Tests ===" << std::endl;
-    
+void test_interfaces() {
     std::cout << "\nTest 1: Plant Growth Simulation..." << std::endl;
     std::cout << "  [PASS] Plant interface defined" << std::endl;
     std::cout << "  [PASS] Photosynthesis method defined" << std::endl;
     std::cout << "  [PASS] Growth simulation method defined" << std::endl;
-    
+
     std::cout << "\nTest 2: Animal Behavior AI..." << std::endl;
     std::cout << "  [PASS] Animal interface defined" << std::endl;
     std::cout << "  [PASS] Utility-based decision making defined" << std::endl;
     std::cout << "  [PASS] Navigation method defined" << std::endl;
-    
+
     std::cout << "\nTest 3: Ecosystem Integration..." << std::endl;
     std::cout << "  [PASS] Ecosystem simulation interface defined" << std::endl;
     std::cout << "  [PASS] Population management methods defined" << std::endl;
-    
+}
+
+void test_fast_forward() {
+    std::cout << "\nTest 4: Fast-Forward Simulation..." << std::endl;
+
+    // Logistic growth is closed form, so two half steps equal one full step
+    float twoSteps = EcosystemFastForward::LogisticHeight(0.1f, 20.0f, 0.2f, 5.0f);
+    twoSteps = EcosystemFastForward::LogisticHeight(twoSteps, 20.0f, 0.2f, 5.0f);
+    const float oneStep = EcosystemFastForward::LogisticHeight(0.1f, 20.0f, 0.2f, 10.0f);
+    assert(std::fabs(twoSteps - oneStep) < 1e-3f);
+
+    SpeciesTraits grass;
+    SpeciesTraits oak;
+    oak.name = "oak";
+    oak.maxHeight = 25.0f;
+    oak.growthRate = 0.15f;
+    oak.maturityAge = 20.0f;
+    oak.lifespan = 300.0f;
+    oak.seedsPerYear = 0.5f;
+    oak.dispersalRadius = 15.0f;
+    oak.canopyRadius = 6.0f;
+
+    EcosystemSimulation::Config config;
+    config.maxPlants = 20000;
+
+    JobSystem jobs(2);
+    EcosystemFastForward fastForward(config, {grass, oak}, &jobs);
+
+    PlantColumns plants;
+    Random rng(42);
+    for (int i = 0; i < 2000; i++) {
+        plants.Push(SpeciesId(i % 2), rng.Range(0.0f, 200.0f), 0.0f, rng.Range(0.0f, 200.0f));
+    }
+
+    EcosystemFastForward::Options options;
+    options.worldMax[0] = 200.0f;
+    options.worldMax[1] = 200.0f;
+    const auto stats = fastForward.Run(plants, 50.0f, options);
+
+    assert(stats.simulatedYears >= 50.0f - 1e-3f);
+    assert(stats.steps < 50 * 12 + 1);   // Never finer than monthly
+    assert(stats.births > 0);
+    assert(plants.Size() <= size_t(config.maxPlants));
+    for (size_t i = 0; i < plants.Size(); i++) {
+        assert(plants.height[i] <= oak.maxHeight);
+        assert(plants.age[i] >= 0.0f);
+    }
+
+    std::cout << "  [PASS] 50 years in " << stats.steps << " steps, "
+              << plants.Size() << " plants alive" << std::endl;
+}
+
+struct TestAnimal {
+    float hunger = 0.0f;
+    explicit TestAnimal(float h) : hunger(h) {}
+};
+
+void test_entity_pool() {
+    std::cout << "\nTest 5: Pooled Entities and Handles..." << std::endl;
+
+    EntityPool<TestAnimal> pool(64, 4);
+    auto deer = pool.Spawn(0, 10.0f);
+    auto wolf = pool.Spawn(1, 20.0f);
+    assert(pool.Get(deer)->hunger == 10.0f);
+    assert(pool.Size() == 2);
+
+    // Stale handles and pointers are detected after despawn
+    TestAnimal* deerPtr = pool.Get(deer);
+    assert(pool.Despawn(deer));
+    assert(!pool.Despawn(deer));
+    assert(pool.Get(deer) == nullptr);
+    assert(!pool.IsAlive(deerPtr));
+
+    // Slot is reused by the same species, but the old handle stays stale
+    auto fawn = pool.Spawn(0, 5.0f);
+    assert(fawn.index == deer.index);
+    assert(pool.Get(deer) == nullptr);
+    assert(pool.Get(fawn)->hunger == 5.0f);
+    assert(pool.HandleOf(pool.Get(wolf)) == wolf);
+
+    // Spawn/despawn churn never touches the global allocator
+    const size_t before = g_allocations;
+    for (int cycle = 0; cycle < 1000; cycle++) {
+        auto h = pool.Spawn(SpeciesId(cycle % 4), float(cycle));
+        assert(h.IsValid());
+        pool.Despawn(h);
+    }
+    assert(g_allocations == before);
+
+    // Full pool returns invalid handles
+    while (pool.Size() < pool.Capacity()) {
+        pool.Spawn(2, 0.0f);
+    }
+    assert(!pool.Spawn(2, 0.0f).IsValid());
+    pool.Clear();
+    assert(!pool.Spawn(kInvalidSpecies, 0.0f).IsValid());  // Would look free and leak its slot
+    assert(pool.Size() == 0);
+    for (int i = 0; i < 64; ++i) {
+        assert(pool.Spawn(3, 0.0f).IsValid());
+    }
+
+    std::cout << "  [PASS] Generational handles detect stale entities" << std::endl;
+    std::cout << "  [PASS] Spawn/despawn churn is allocation-free" << std::endl;
+}
+
+void test_population_index() {
+    std::cout << "\nTest 6: Population Statistics..." << std::endl;
+
+    SpeciesRegistry registry;
+    const SpeciesId deer = registry.Register("deer");
+    const SpeciesId wolf = registry.Register("wolf");
+    assert(registry.Register("deer") == deer);
+    assert(registry.Find("bear") == kInvalidSpecies);
+    SpeciesRegistry small(2);
+    assert(small.Register("deer") == 0 && small.Register("wolf") == 1);
+    assert(small.Register("bear") == kInvalidSpecies && small.Count() == 2);
+    assert(small.Register("wolf") == 1);
+
+    PopulationIndex::Config config;
+    config.regionsX = 4;
+    config.regionsZ = 4;
+    config.regionSize = 100.0f;
+    PopulationIndex index(config);
+
+    for (int i = 0; i < 10; i++) {
+        index.OnSpawn(deer, 50.0f, 50.0f);
+    }
+    index.OnSpawn(wolf, 250.0f, 50.0f);
+    assert(index.Get(deer) == 10);
+    assert(index.GetInRegion(deer, index.RegionOf(50.0f, 50.0f)) == 10);
+
+    index.OnMove(deer, 50.0f, 50.0f, 150.0f, 50.0f);
+    index.OnDeath(deer, 50.0f, 50.0f);
+    assert(index.Get(deer) == 9);
+    assert(index.GetInRegion(deer, index.RegionOf(50.0f, 50.0f)) == 8);
+    assert(index.GetInRegion(deer, index.RegionOf(150.0f, 50.0f)) == 1);
+
+    // Species past maxSpecies and bad regions are rejected, not written out of bounds
+    assert(!index.OnSpawn(SpeciesId(config.maxSpecies), 50.0f, 50.0f));
+    assert(!index.OnRegionChange(deer, 0, index.GetRegionCount()));
+    assert(!index.OnRegionChange(deer, -1, 0));
+    assert(index.GetInRegion(deer, index.GetRegionCount()) == 0);
+    assert(index.Get(deer) == 9);
+
+    PopulationHistory history(4, config.maxSpecies, 1.0f);
+    for (int second = 0; second < 6; second++) {
+        index.OnSpawn(wolf, 250.0f, 50.0f);
+        history.Update(1.0f, index);
+    }
+    assert(history.Size() == 4);
+    assert(history.At(wolf, 0) == 4);   // Oldest two samples were overwritten
+    assert(history.At(wolf, 3) == 7);
+
+    // A long step records every interval it spans; a zero capacity still keeps one sample
+    PopulationHistory coarse(8, config.maxSpecies, 0.5f);
+    coarse.Update(0.25f, index);
+    coarse.Update(2.0f, index);
+    assert(coarse.Size() == 4);
+    assert(coarse.TimeAt(0) == 0.5f && coarse.TimeAt(3) == 2.0f);
+    PopulationHistory empty(0, config.maxSpecies, 1.0f);
+    empty.Update(3.0f, index);
+    assert(empty.Size() == 1 && empty.At(wolf, 0) == index.Get(wolf));
+
+    std::cout << "  [PASS] Species interning and O(1) counters" << std::endl;
+    std::cout << "  [PASS] Out-of-range species, registrations and regions rejected" << std::endl;
+    std::cout << "  [PASS] Population history ring buffer, long steps keep every sample" << std::endl;
+}
+
+void test_snapshot() {
+    std::cout << "\nTest 7: Snapshot Save/Load..." << std::endl;
+
+    PlantColumns plants;
+    AnimalColumns animals;
+    Random rng(7);
+    for (int i = 0; i < 10000; i++) {
+        plants.Push(SpeciesId(i % 3), rng.Range(0.0f, 500.0f), 0.0f, rng.Range(0.0f, 500.0f));
+    }
+    for (int i = 0; i < 1000; i++) {
+        animals.Push(SpeciesId(i % 2), rng.Range(0.0f, 500.0f), 0.0f, rng.Range(0.0f, 500.0f));
+    }
+
+    std::vector<std::vector<uint8_t>> blobs;
+    {
+        EcosystemSnapshotWriter writer([&blobs](const uint8_t* data, size_t size, uint64_t) {
+            blobs.emplace_back(data, data + size);
+        });
+        writer.Capture(plants, animals);
+        writer.Flush();
+
+        // Only a handful of animals move between snapshots
+        for (int i = 0; i < 10; i++) {
+            animals.x[size_t(i)] += 1.0f;
+        }
+        animals.Push(1, 1.0f, 2.0f, 3.0f);
+        plants.Push(2, 4.0f, 0.0f, 5.0f);   // Growing one column must not shift the others
+        writer.Capture(plants, animals);
+        writer.Flush();
+    }
+    assert(blobs.size() == 2);
+    assert(blobs[1].size() * 10 < blobs[0].size());   // Delta is tiny
+
+    EcosystemSnapshotReader reader;
+    assert(reader.Decode(blobs[0].data(), blobs[0].size()));
+    assert(reader.Decode(blobs[1].data(), blobs[1].size()));
+    assert(!reader.Decode(blobs[1].data(), blobs[1].size()));  // Base mismatch
+
+    size_t count = 0;
+    const float* height = reader.Column<float>(Snapshot::kPlantColumnBase + 3, count);
+    assert(count == plants.Size() && height[0] == plants.height[0]);
+
+    PlantColumns restoredPlants;
+    AnimalColumns restoredAnimals;
+    assert(reader.Restore(restoredPlants, restoredAnimals));
+    assert(restoredPlants.x == plants.x);
+    assert(restoredPlants.species == plants.species);
+    assert(restoredAnimals.x == animals.x);
+    assert(restoredAnimals.Size() == animals.Size());
+
+    // Truncated blobs, directory entries pointing past the payload, columns
+    // disagreeing on the population size and impossible payload sizes are rejected
+    EcosystemSnapshotReader corrupt;
+    assert(!corrupt.Decode(blobs[0].data(), blobs[0].size() - 16));
+    SnapshotBuffer payload;
+    const uint32_t columns = Snapshot::BuildPayload(plants, animals, payload);
+    auto encode = [&](uint64_t firstCount, uint64_t payloadSize) {
+        SnapshotBuffer edited;
+        edited.Resize(payload.Size());
+        std::memcpy(edited.Data(), payload.Data(), payload.Size());
+        Snapshot::ColumnEntry entry;
+        std::memcpy(&entry, edited.Data(), sizeof(entry));
+        entry.count = firstCount;
+        std::memcpy(edited.Data(), &entry, sizeof(entry));
+        Snapshot::Header header;
+        header.columnCount = columns;
+        header.sequence = 1;
+        header.payloadSize = payloadSize;
+        std::vector<uint8_t> blob(sizeof(header) + Compression::CompressBound(edited.Size()));
+        header.compressedSize = Compression::Compress(edited.Data(), edited.Size(), blob.data() + sizeof(header));
+        std::memcpy(blob.data(), &header, sizeof(header));
+        blob.resize(sizeof(header) + header.compressedSize);
+        return blob;
+    };
+    const std::vector<uint8_t> overrun = encode(payload.Size(), payload.Size());
+    assert(!corrupt.Decode(overrun.data(), overrun.size()));
+    assert(!corrupt.Restore(restoredPlants, restoredAnimals));
+    const std::vector<uint8_t> short1 = encode(plants.Size() - 1, payload.Size());
+    assert(corrupt.Decode(short1.data(), short1.size()));
+    assert(!corrupt.Restore(restoredPlants, restoredAnimals));
+    const std::vector<uint8_t> huge = encode(plants.Size(), uint64_t(1) << 48);
+    assert(!corrupt.Decode(huge.data(), huge.size()));
+    assert(restoredPlants.x == plants.x);   // Failed restores leave storage untouched
+
+    // The storage sink keeps only the latest keyframe and its deltas
+    MemoryStorage storage;
+    {
+        EcosystemSnapshotWriter writer(EcosystemSnapshotWriter::ToStorage(storage, "eco"), 3);
+        for (int capture = 0; capture < 6; capture++) {
+            writer.Capture(plants, animals);
+            writer.Flush();
+        }
+    }
+    assert(storage.entries.size() == 3);   // Keyframe 4 and deltas 5, 6
+    assert(storage.Exists("eco.4") && storage.Exists("eco.6") && !storage.Exists("eco.3"));
+
+    std::cout << "  [PASS] Keyframe " << blobs[0].size() << " bytes, delta "
+              << blobs[1].size() << " bytes" << std::endl;
+    std::cout << "  [PASS] Columns restored from snapshot" << std::endl;
+    std::cout << "  [PASS] Truncated and corrupt snapshots rejected" << std::endl;
+    std::cout << "  [PASS] Superseded snapshots deleted from storage" << std::endl;
+}
+
+void test_stepper() {
+    std::cout << "\nTest 8: Headless Ecosystem Step..." << std::endl;
+
+    AnimalTraits deer;
+    AnimalTraits wolf;
+    wolf.name = "wolf";
+    wolf.isPredator = true;
+
+    PlantColumns plants;
+    plants.Push(0, 10.0f, 0.0f, 10.0f);
+    AnimalColumns animals;
+    animals.Push(0, 100.0f, 0.0f, 100.0f);   // Deer
+    animals.Push(1, 90.0f, 0.0f, 100.0f);    // Wolf 10m to the west
+    for (int i = 0; i < 50; i++) {
+        animals.Push(0, float(i * 4), 0.0f, 20.0f);
+    }
+
+    PopulationIndex::Config indexConfig;
+    indexConfig.regionsX = 4;
+    indexConfig.regionsZ = 4;
+    indexConfig.regionSize = 50.0f;
+    PopulationIndex index(indexConfig);
+    for (size_t i = 0; i < animals.Size(); i++) {
+        index.OnSpawn(animals.species[i], animals.x[i], animals.z[i]);
+    }
+
+    EcosystemSimulation::Config config;
+    EcosystemStepper::Options options;
+    options.worldMax[0] = 200.0f;
+    options.worldMax[1] = 200.0f;
+    JobSystem jobs(2);
+    EcosystemStepper stepper(config, {SpeciesTraits{}}, {deer, wolf}, options, &jobs, &index);
+
+    const float heightBefore = plants.height[0];
+    stepper.Step(plants, animals, 1.0f);
+    assert(animals.x[0] > 100.0f);           // Fled east, away from the wolf
+    assert(animals.fear[0] > 0.0f);
+    assert(animals.hunger[0] > 0.0f);
+    assert(plants.height[0] >= heightBefore);
+
+    for (int i = 0; i < 100; i++) {
+        stepper.Step(plants, animals, 0.5f);
+    }
+    int regionTotal = 0;
+    for (int r = 0; r < index.GetRegionCount(); r++) {
+        regionTotal += index.GetInRegion(0, r);
+        assert(index.GetInRegion(0, r) >= 0);
+    }
+    assert(regionTotal == index.Get(0));
+
+    // A swap-remove followed by a spawn keeps the count but changes who sits where
+    index.OnDeath(animals.species[0], animals.x[0], animals.z[0]);
+    animals.SwapRemove(0);
+    animals.Push(0, 190.0f, 0.0f, 190.0f);
+    index.OnSpawn(0, 190.0f, 190.0f);
+    for (int i = 0; i < 10; i++) {
+        stepper.Step(plants, animals, 0.5f);
+    }
+    for (int r = 0; r < index.GetRegionCount(); r++) {
+        int actual = 0;
+        for (size_t i = 0; i < animals.Size(); i++) {
+            actual += animals.species[i] == 0 && index.RegionOf(animals.x[i], animals.z[i]) == r;
+        }
+        assert(index.GetInRegion(0, r) == actual);
+    }
+    std::cout << "  [PASS] Prey flee predators, region counters stay consistent" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Nature Reality Engine: Ecosystem Tests ===" << std::endl;
+
+    test_interfaces();
+    test_fast_forward();
+    test_entity_pool();
+    test_population_index();
+    test_snapshot();
+    test_stepper();
+
     std::cout << "\nAll ecosystem tests passed!" << std::endl;
     return 0;
 }
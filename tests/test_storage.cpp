@@ -1,4 +1,5 @@
 #include <core/StorageManager.h>
+#include <core/Compression.h>
 #include <cassert>
 #include <iostream>
 #include <vector>
@@ -233,6 +234,32 @@ void test_mobile_config() {
     std::cout << "  ✓ Mobile configuration successful" << std::endl;
 }
 
+void test_compression_roundtrip() {
+    std::cout << "Test: Compression Roundtrip" << std::endl;
+    
+    std::vector<uint8_t> input(100000);
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = (i % 1000 < 900) ? 0 : uint8_t(i * 31);   // Mostly zeros
+    }
+    
+    std::vector<uint8_t> compressed;
+    Compression::Compress(input.data(), input.size(), compressed);
+    assert(compressed.size() < input.size() / 4);
+    
+    std::vector<uint8_t> output(input.size());
+    size_t size = Compression::Decompress(compressed.data(), compressed.size(), 
+                                          output.data(), output.size());
+    assert(size == input.size());
+    assert(output == input);
+    
+    // Truncated input must be rejected rather than overrun
+    assert(Compression::Decompress(compressed.data(), compressed.size() / 2,
+                                   output.data(), 100) == 0);
+    
+    std::cout << "  ✓ Compression roundtrip successful (" << input.size() << " -> " 
+              << compressed.size() << " bytes)" << std::endl;
+}
+
 int main() {
     std::cout << "=== StorageManager Test Suite ===" << std::endl << std::endl;
     
@@ -241,6 +268,7 @@ int main() {
     test_storage_usage();
     test_list_keys();
     test_mobile_config();
+    test_compression_roundtrip();
     
     std::cout << std::endl << "=== All tests passed! ===" << std::endl;
     
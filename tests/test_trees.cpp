@@ -0,0 +1,642 @@
+#include <core/JobSystem.h>
+#include <nature/FoliageSystem.h>
+#include <nature/LSystem.h>
+#include <nature/TreeArchetypeLibrary.h>
+#include <nature/TreeGrowth.h>
+#include <nature/TreeMeshBuilder.h>
+#include <nature/TreeWindSway.h>
+#include <nature/TurtleInterpreter.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace NRE;
+
+/**
+ * @brief Basic test for procedural trees
+ *
+ * Tests:
+ * - L-system expansion (deterministic, stochastic, parametric)
+ * - Streaming turtle interpretation
+ * - Generalized-cylinder meshes and LODs
+ * - Archetype library and forest instancing
+ * - Batched hierarchical wind sway
+ * - Foliage cards, leaf atlas and seasonal color
+ * - Incremental growth with append-only meshes
+ */
+
+static std::string Symbols(const std::vector<LModule>& modules) {
+    std::string s;
+    s.reserve(modules.size());
+    for (const auto& m : modules) {
+        s += m.symbol;
+    }
+    return s;
+}
+
+void test_lsystem() {
+    std::cout << "\nTest 1: L-System Expansion..." << std::endl;
+
+    // Matches plain string rewriting for a deterministic rule
+    LSystem plain;
+    plain.SetAxiom("F");
+    plain.AddRule('F', "F[+F]F[-F][F]");
+    std::string reference = "F";
+    for (int i = 0; i < 4; ++i) {
+        std::string next;
+        for (char c : reference) {
+            next += c == 'F' ? std::string("F[+F]F[-F][F]") : std::string(1, c);
+        }
+        reference = next;
+    }
+    const auto expanded = plain.Expand(4, 1);
+    assert(Symbols(expanded) == reference);
+    assert(plain.GetStats().modules == reference.size());
+    std::cout << "  [PASS] Deterministic expansion matches string rewriting" << std::endl;
+
+    // Stochastic rules depend only on the seed, not on threading
+    LSystem oak = LSystem::Preset("oak");
+    const auto a = oak.Expand(7, 42);
+    const auto b = oak.Expand(7, 42);
+    const auto c = oak.Expand(7, 43);
+    assert(a.size() > 16384 * 2);  // Several expansion blocks
+    assert(Symbols(a) == Symbols(b));
+    assert(Symbols(a) != Symbols(c));
+    JobSystem jobs(3);
+    const auto parallel = oak.Expand(7, 42, &jobs);
+    assert(Symbols(parallel) == Symbols(a));
+    for (size_t i = 0; i < a.size(); ++i) {
+        assert(parallel[i].param == a[i].param && parallel[i].hash == a[i].hash);
+    }
+    std::cout << "  [PASS] Stochastic expansion is seeded and thread independent ("
+              << a.size() << " modules)" << std::endl;
+
+    // Parametric: successors scale the parameter and stop below minParam
+    LSystem shrinking;
+    shrinking.SetAxiom("A(1)");
+    shrinking.AddRule('A', "F(1)[+A(0.5)]A(0.5)", 1.0f, 0.2f);
+    const auto grown = shrinking.Expand(12, 7);
+    const auto grownMore = shrinking.Expand(20, 7);
+    assert(grown.size() == grownMore.size());
+    for (const auto& m : grown) {
+        if (m.symbol == 'A') {
+            assert(m.param < 0.2f);
+        }
+        if (m.symbol == '+') {
+            assert(m.param == 0.0f);  // Turns default to the system angle
+        }
+    }
+    std::cout << "  [PASS] Parametric rules scale parameters and terminate" << std::endl;
+
+    // Conditions filter before the weighted pick: a rule that cannot apply
+    // never leaves a module unrewritten, and the rest keep their ratio
+    LSystem conditional;
+    conditional.SetAxiom(std::string(4000, 'A'));
+    conditional.AddRule('A', "X", 1.0f, 10.0f);   // Never applies at param 1
+    conditional.AddRule('A', "B", 1.0f);
+    conditional.AddRule('A', "C", 3.0f);
+    const std::string picked = Symbols(conditional.Expand(1, 5));
+    const auto bs = std::count(picked.begin(), picked.end(), 'B');
+    const auto cs = std::count(picked.begin(), picked.end(), 'C');
+    assert(bs + cs == 4000);
+    assert(std::abs(double(cs) / double(bs) - 3.0) < 0.4);
+    std::cout << "  [PASS] Conditions filter rules before the weighted choice (B:C = " << bs << ":" << cs << ")"
+              << std::endl;
+
+    // Unbalanced parameter lists are rejected instead of looping forever
+    LSystem malformed;
+    assert(malformed.SetAxiom("A(1)"));
+    assert(!malformed.AddRule('A', "F(1)[+A(0.5"));
+    assert(!malformed.SetAxiom("A("));
+    assert(malformed.Expand(3, 1).size() == 1);  // Axiom kept, no rule added
+    std::cout << "  [PASS] Unbalanced parameter lists rejected" << std::endl;
+
+    for (const char* species : {"oak", "pine", "willow", "birch", "maple"}) {
+        LSystem preset = LSystem::Preset(species);
+        assert(preset.Expand(4, 1).size() > 10);
+    }
+    std::cout << "  [PASS] Species presets expand" << std::endl;
+}
+
+void test_turtle() {
+    std::cout << "\nTest 2: Streaming Turtle Interpreter..." << std::endl;
+    LSystem oak = LSystem::Preset("oak");
+    TreeRenderer::TreeConfig config;
+    TurtleInterpreter turtle(oak, TurtleInterpreter::FromConfig(config));
+
+    // Streaming walk matches interpreting the expanded string
+    TreeSkeleton streamed;
+    TreeSkeleton expanded;
+    turtle.Generate(5, 9, streamed);
+    turtle.Interpret(oak.Expand(5, 9), expanded);
+    assert(!streamed.segments.empty());
+    assert(streamed.segments.size() == expanded.segments.size());
+    for (size_t i = 0; i < streamed.segments.size(); ++i) {
+        const auto& a = streamed.segments[i];
+        const auto& b = expanded.segments[i];
+        for (int k = 0; k < 3; ++k) {
+            assert(a.start[k] == b.start[k] && a.end[k] == b.end[k]);
+        }
+        assert(a.parent == b.parent && a.order == b.order);
+        assert(a.parent < int32_t(i));
+    }
+    std::cout << "  [PASS] Depth-first walk emits the same skeleton ("
+              << streamed.segments.size() << " segments)" << std::endl;
+
+    // Branches connect: every segment starts where its parent ends
+    for (const auto& s : streamed.segments) {
+        if (s.parent >= 0) {
+            const auto& p = streamed.segments[size_t(s.parent)];
+            for (int k = 0; k < 3; ++k) {
+                assert(std::fabs(s.start[k] - p.end[k]) < 1e-4f);
+            }
+            assert(s.startRadius <= p.startRadius);
+        }
+    }
+    assert(streamed.segments[0].start[1] == 0.0f && streamed.segments[0].end[1] > 0.0f);
+    std::cout << "  [PASS] Segments form a connected, tapering hierarchy" << std::endl;
+
+    // Fixed buffers: output stops at the limit instead of growing
+    TreeSkeleton limited;
+    limited.Reserve(100, 10);
+    const auto* data = limited.segments.data();
+    turtle.Generate(5, 9, limited);
+    assert(limited.truncated && limited.segments.size() == 100);
+    assert(limited.segments.data() == data);
+    assert(turtle.GetMaxStackDepth() <= 5 * 3);
+    std::cout << "  [PASS] Preallocated buffers are never reallocated" << std::endl;
+}
+
+void test_tree_mesh() {
+    std::cout << "\nTest 3: Tree Meshes and LODs..." << std::endl;
+    TreeMeshBuilder::Options options;
+    TreeMeshBuilder builder(options);
+
+    // Ring sides shrink with screen size and vanish below half a pixel
+    assert(builder.SidesFor(0.3f, 1.0f) == options.maxSides);
+    assert(builder.SidesFor(0.3f, 100.0f) < builder.SidesFor(0.3f, 10.0f));
+    assert(builder.SidesFor(0.01f, 1000.0f) == 0);
+    std::cout << "  [PASS] Ring sides follow projected radius" << std::endl;
+
+    TreeRenderer::TreeConfig config;
+    config.seed = 3;
+    TreeLODSet tree;
+    builder.Generate(config, tree);
+    assert(tree.levels.size() == options.lodDistances.size());
+    for (size_t l = 0; l < tree.levels.size(); ++l) {
+        const auto& level = tree.levels[l];
+        assert(level.triangleCount == int(level.indices.size() / 3));
+        if (l > 0) {
+            assert(level.triangleCount < tree.levels[l - 1].triangleCount);
+            assert(level.distance > tree.levels[l - 1].distance);
+        }
+        for (unsigned index : level.indices) {
+            assert(index < level.vertices.size());
+        }
+        for (const auto& v : level.vertices) {
+            for (int a = 0; a < 3; ++a) {
+                assert(v.position[a] >= tree.boundsMin[a] - 1e-3f && v.position[a] <= tree.boundsMax[a] + 1e-3f);
+            }
+        }
+    }
+    assert(tree.levels.back().triangleCount == 4);
+    std::cout << "  [PASS] " << tree.levels.size() << " LODs from " << tree.levels[0].triangleCount
+              << " triangles down to a crossed billboard" << std::endl;
+
+    // Ring normals are unit length and perpendicular to the branch
+    for (const auto& v : tree.levels[0].vertices) {
+        const float n = v.normal[0] * v.normal[0] + v.normal[1] * v.normal[1] + v.normal[2] * v.normal[2];
+        const float d = v.normal[0] * v.bitangent[0] + v.normal[1] * v.bitangent[1] + v.normal[2] * v.bitangent[2];
+        assert(std::fabs(n - 1.0f) < 1e-3f && std::fabs(d) < 1e-3f);
+    }
+    std::cout << "  [PASS] Cylinder frames are orthonormal" << std::endl;
+
+    // Parallel forest generation matches serial generation
+    std::vector<TreeRenderer::TreeConfig> forest(8, config);
+    for (size_t i = 0; i < forest.size(); ++i) {
+        forest[i].seed = int(i);
+        forest[i].species = i % 2 ? "birch" : "oak";
+    }
+    std::vector<TreeLODSet> serial;
+    std::vector<TreeLODSet> parallel;
+    JobSystem jobs(4);
+    builder.GenerateForest(forest, serial);
+    builder.GenerateForest(forest, parallel, &jobs);
+    for (size_t i = 0; i < forest.size(); ++i) {
+        assert(serial[i].levels.size() == parallel[i].levels.size());
+        for (size_t l = 0; l < serial[i].levels.size(); ++l) {
+            assert(serial[i].levels[l].indices == parallel[i].levels[l].indices);
+        }
+    }
+    assert(serial[0].segmentCount != serial[2].segmentCount || serial[0].levels[0].vertices[5].position[0] !=
+                                                                   serial[2].levels[0].vertices[5].position[0]);
+    std::cout << "  [PASS] Parallel forest generation is deterministic" << std::endl;
+}
+
+void test_archetypes() {
+    std::cout << "\nTest 4: Tree Archetypes and Forest Instancing..." << std::endl;
+    TreeArchetypeLibrary::Options libraryOptions;
+    TreeArchetypeLibrary library(TreeMeshBuilder::Options{}, libraryOptions);
+    ForestInstances forest(ForestInstances::Options{});
+
+    // Thousands of unique trees resolve to a bounded set of archetypes
+    Random rng(5);
+    TreeRenderer::TreeConfig config;
+    config.iterations = 4;
+    const int treeCount = 3000;
+    for (int i = 0; i < treeCount; ++i) {
+        config.species = i % 2 ? "birch" : "oak";
+        config.seed = i;
+        config.age = rng.Range(1.0f, 80.0f);
+        config.height = rng.Range(8.0f, 14.0f);
+        const float position[3] = {rng.Range(0.0f, 500.0f), 0.0f, rng.Range(0.0f, 500.0f)};
+        forest.Add(library, config, position);
+    }
+    const size_t bound = 2 * libraryOptions.variantsPerSpecies * libraryOptions.maxAgeBuckets;
+    assert(library.GetArchetypeCount() <= bound);
+    assert(library.GetArchetypeCount() > bound / 2);
+    assert(library.GetPendingCount() == library.GetArchetypeCount());
+    assert(forest.GetInstanceCount() == size_t(treeCount));
+    std::cout << "  [PASS] " << treeCount << " trees use " << library.GetArchetypeCount() << " archetypes" << std::endl;
+
+    // Same key, same archetype
+    config.species = "oak";
+    config.seed = 42;
+    config.age = 15.0f;
+    assert(library.Acquire(config) == library.Acquire(config));
+    TreeRenderer::TreeConfig taller = config;
+    taller.height *= 2.0f;
+    assert(library.Acquire(taller) == library.Acquire(config));  // Height is the instance scale
+    TreeRenderer::TreeConfig older = config;
+    older.age = 500.0f;
+    assert(library.KeyFor(older).ageBucket == libraryOptions.maxAgeBuckets - 1);
+
+    JobSystem jobs(4);
+    assert(library.GenerateMissing(&jobs) == library.GetArchetypeCount());
+    assert(library.GetPendingCount() == 0 && library.GenerateMissing(&jobs) == 0);
+    const size_t meshBytes = library.GetMeshBytes();
+    for (size_t id = 0; id < library.GetArchetypeCount(); ++id) {
+        assert(library.Get(uint32_t(id)).ready && !library.Get(uint32_t(id)).lods.levels.empty());
+    }
+
+    // More trees add instances, not meshes
+    for (int i = 0; i < 1000; ++i) {
+        config.seed = treeCount + i;
+        config.age = float(i % 40);
+        const float position[3] = {float(i), 0.0f, 0.0f};
+        forest.Add(library, config, position);
+    }
+    assert(library.GenerateMissing(&jobs) == 0);
+    assert(library.GetMeshBytes() == meshBytes);
+    std::cout << "  [PASS] Mesh memory " << meshBytes / 1024 << " KB is independent of tree count ("
+              << forest.GetInstanceBytes() / 1024 << " KB of instances)" << std::endl;
+
+    // Batches cover every instance; variation stays within bounds
+    size_t total = 0;
+    size_t batches = 0;
+    float minHue = 1.0f;
+    float maxHue = -1.0f;
+    forest.ForEachBatch([&](uint32_t id, const TreeInstance* instances, size_t count) {
+        assert(id < library.GetArchetypeCount());
+        total += count;
+        ++batches;
+        for (size_t i = 0; i < count; ++i) {
+            assert(instances[i].rotation >= 0.0f && instances[i].rotation < 6.2832f);
+            assert(instances[i].scale > 0.4f && instances[i].scale < 2.5f);
+            minHue = std::min(minHue, instances[i].hueShift);
+            maxHue = std::max(maxHue, instances[i].hueShift);
+        }
+    });
+    assert(total == forest.GetInstanceCount());
+    assert(batches == library.GetArchetypeCount());
+    assert(minHue < 0.0f && maxHue > 0.0f && maxHue <= 0.04f);
+    std::cout << "  [PASS] " << batches << " instanced batches with per-tree hue, scale and rotation" << std::endl;
+
+    // Settings outside the buckets are never taken from whichever tree came first
+    TreeRenderer::TreeConfig wider = config;
+    wider.branchAngle = 40.0f;
+    const uint32_t widerId = library.Acquire(wider);
+    assert(widerId != library.Acquire(config));
+    assert(library.Get(widerId).config.branchAngle == 40.0f);
+    std::cout << "  [PASS] Differing branch settings get their own archetype" << std::endl;
+}
+
+static void ApplyBone(const BoneTransform& b, const float p[3], float out[3]) {
+    const float* q = b.rotation;
+    const float c[3] = {2.0f * (q[1] * p[2] - q[2] * p[1]), 2.0f * (q[2] * p[0] - q[0] * p[2]),
+                        2.0f * (q[0] * p[1] - q[1] * p[0])};
+    out[0] = p[0] + q[3] * c[0] + (q[1] * c[2] - q[2] * c[1]) + b.translation[0];
+    out[1] = p[1] + q[3] * c[1] + (q[2] * c[0] - q[0] * c[2]) + b.translation[1];
+    out[2] = p[2] + q[3] * c[2] + (q[0] * c[1] - q[1] * c[0]) + b.translation[2];
+}
+
+void test_wind_sway() {
+    std::cout << "\nTest 5: Hierarchical Wind Sway..." << std::endl;
+    TreeMeshBuilder builder(TreeMeshBuilder::Options{});
+    TreeRenderer::TreeConfig config;
+    config.seed = 11;
+    TreeLODSet tree;
+    builder.Generate(config, tree);
+    const TreeSwayRig& rig = tree.rig;
+    assert(rig.bones.size() > 4 && rig.bones.size() <= 64);
+    assert(rig.bones[0].parent == -1 && rig.bones[0].level == 0);
+    for (size_t b = 1; b < rig.bones.size(); ++b) {
+        const SwayBone& bone = rig.bones[b];
+        assert(bone.level >= rig.bones[b - 1].level);
+        if (bone.parent >= 0) {
+            assert(size_t(bone.parent) < b && rig.bones[size_t(bone.parent)].level + 1 == bone.level);
+            assert(bone.frequency >= rig.bones[0].frequency);
+        }
+    }
+    assert(tree.vertexBones.size() == tree.levels.size());
+    for (size_t l = 0; l < tree.levels.size(); ++l) {
+        assert(tree.vertexBones[l].size() == tree.levels[l].vertices.size());
+        for (uint16_t bone : tree.vertexBones[l]) {
+            assert(bone < rig.bones.size());
+        }
+    }
+    std::cout << "  [PASS] Baked " << rig.bones.size() << " bones, stiffer toward the trunk" << std::endl;
+
+    // Calm air: every bone stays at rest
+    TreeWindSway sway(TreeWindSway::Options{});
+    const float origin[3] = {0.0f, 0.0f, 0.0f};
+    sway.BeginFrame();
+    sway.AddTree(rig, origin, 0.0f);
+    sway.Evaluate(1.0f);
+    for (size_t i = 0; i < sway.GetBoneCount(); ++i) {
+        const BoneTransform& b = sway.GetTransforms()[i];
+        assert(std::fabs(b.rotation[3] - 1.0f) < 1e-6f);
+        assert(std::fabs(b.translation[0]) + std::fabs(b.translation[1]) + std::fabs(b.translation[2]) < 1e-6f);
+    }
+
+    // Wind along +x leans the trunk toward +x; branches stay attached
+    const float east[2] = {1.0f, 0.0f};
+    sway.SetWind(east, 10.0f);
+    sway.BeginFrame();
+    const uint32_t first = sway.AddTree(rig, origin, 0.0f);
+    sway.Evaluate(0.0f);
+    const BoneTransform* transforms = sway.GetTransforms();
+    const float top[3] = {0.0f, 5.0f, 0.0f};
+    float moved[3];
+    ApplyBone(transforms[first], top, moved);
+    assert(moved[0] > 0.0f && moved[1] < 5.0f);
+    for (size_t b = 0; b < rig.bones.size(); ++b) {
+        const SwayBone& bone = rig.bones[b];
+        if (bone.parent < 0) {
+            continue;
+        }
+        float own[3], viaParent[3];
+        ApplyBone(transforms[first + b], bone.pivot, own);
+        ApplyBone(transforms[first + size_t(bone.parent)], bone.pivot, viaParent);
+        for (int a = 0; a < 3; ++a) {
+            assert(std::fabs(own[a] - viaParent[a]) < 1e-3f);
+        }
+    }
+    std::cout << "  [PASS] Wind bends the hierarchy without detaching branches" << std::endl;
+
+    // Batched: many trees in one pass match single-tree evaluation
+    sway.BeginFrame();
+    std::vector<uint32_t> firsts;
+    for (int i = 0; i < 257; ++i) {
+        const float position[3] = {float(i), 0.0f, 0.0f};
+        firsts.push_back(sway.AddTree(rig, position, 0.0f));
+    }
+    sway.Evaluate(2.5f);
+    const std::vector<BoneTransform> batch(sway.GetTransforms(), sway.GetTransforms() + sway.GetBoneCount());
+    assert(sway.GetTreeCount() == 257 && batch.size() == 257 * rig.bones.size());
+    sway.BeginFrame();
+    sway.AddTree(rig, origin, 0.0f);
+    sway.Evaluate(2.5f);
+    for (uint32_t f : firsts) {
+        for (size_t b = 0; b < rig.bones.size(); ++b) {
+            for (int k = 0; k < 4; ++k) {
+                assert(std::fabs(batch[f + b].rotation[k] - sway.GetTransforms()[b].rotation[k]) < 1e-6f);
+            }
+        }
+    }
+    std::cout << "  [PASS] " << batch.size() << " bones of 257 trees evaluated in one batched pass" << std::endl;
+
+    // Distant trees animate only the trunk; branches follow it rigidly
+    sway.BeginFrame();
+    const uint32_t far = sway.AddTree(rig, origin, 0.0f, 1.0f, 1);
+    sway.Evaluate(2.5f);
+    for (size_t b = rig.levelStart[1]; b < rig.bones.size(); ++b) {
+        size_t root = b;
+        while (rig.bones[root].parent >= 0) {
+            root = size_t(rig.bones[root].parent);
+        }
+        const BoneTransform& own = sway.GetTransforms()[far + b];
+        const BoneTransform& trunk = sway.GetTransforms()[far + root];
+        for (int k = 0; k < 4; ++k) {
+            assert(own.rotation[k] == trunk.rotation[k]);
+        }
+    }
+    std::cout << "  [PASS] Reduced levels copy parent transforms" << std::endl;
+}
+
+void test_foliage() {
+    std::cout << "\nTest 6: Foliage LODs and Leaf Atlas..." << std::endl;
+    LeafAtlas::Options atlasOptions;
+    atlasOptions.resolution = 256;
+    JobSystem jobs(4);
+    LeafAtlas atlas(atlasOptions, &jobs);
+    LeafAtlas serialAtlas(atlasOptions);
+    const size_t bytes = size_t(atlas.GetResolution()) * size_t(atlas.GetResolution()) * 4;
+    assert(std::equal(atlas.GetData(), atlas.GetData() + bytes, serialAtlas.GetData()));
+    for (int tile = 0; tile < atlas.GetTileCount(); ++tile) {
+        const float coverage = atlas.GetTileCoverage(tile);
+        assert(coverage > 0.05f && coverage < 0.95f);
+        if (tile >= atlas.GetSingleLeafTiles()) {
+            assert(coverage > atlas.GetTileCoverage(atlas.SingleLeafTile(uint32_t(tile))));
+        }
+    }
+    float uv[4];
+    atlas.GetTileUV(atlas.GetTileCount() - 1, uv);
+    assert(uv[2] == 1.0f && uv[3] == 1.0f);
+
+    // A one-tile request is clamped so leaves and clusters each keep a tile
+    LeafAtlas::Options tinyOptions;
+    tinyOptions.resolution = 32;
+    tinyOptions.tilesPerSide = 1;
+    LeafAtlas tiny(tinyOptions);
+    assert(tiny.GetSingleLeafTiles() >= 1 && tiny.GetTileCount() > tiny.GetSingleLeafTiles());
+    assert(tiny.SingleLeafTile(7) < tiny.ClusterTile(7));
+    std::cout << "  [PASS] " << atlas.GetTileCount() << " leaf and cluster tiles baked" << std::endl;
+
+    // Leaf points from a real tree
+    TreeRenderer::TreeConfig config;
+    config.species = "birch";
+    config.iterations = 8;
+    config.seed = 4;
+    config.leafCount = 10000;
+    const LSystem birch = LSystem::Preset(config.species);
+    TurtleInterpreter turtle(birch, TurtleInterpreter::FromConfig(config));
+    TreeSkeleton skeleton;
+    turtle.Generate(config.iterations, uint32_t(config.seed), skeleton);
+    assert(!skeleton.leaves.empty());
+
+    FoliageBuilder::Options options;
+    FoliageBuilder foliage(atlas, options);
+    FoliageLODSet set;
+    foliage.Build(skeleton, config, set);
+    assert(set.individual.triangleCount == 2 * config.leafCount);
+    assert(set.clusters.triangleCount > 0 && set.clusters.triangleCount * 10 < set.individual.triangleCount);
+    assert(set.shell.triangleCount > 0 && set.shell.triangleCount < set.clusters.triangleCount);
+    assert(!set.evergreen);
+    for (const auto* level : {&set.individual, &set.clusters, &set.shell}) {
+        for (unsigned index : level->indices) {
+            assert(index < level->vertices.size());
+        }
+        for (const auto& v : level->vertices) {
+            assert(v.texCoord[0] >= 0.0f && v.texCoord[0] <= 1.0f && v.texCoord[1] >= 0.0f && v.texCoord[1] <= 1.0f);
+        }
+    }
+    assert(foliage.SelectLOD(5.0f) == FoliageLOD::Individual);
+    assert(foliage.SelectLOD(50.0f) == FoliageLOD::Clusters);
+    assert(foliage.SelectLOD(500.0f) == FoliageLOD::Shell);
+    std::cout << "  [PASS] " << set.individual.triangleCount << " leaf triangles -> " << set.clusters.triangleCount
+              << " cluster -> " << set.shell.triangleCount << " shell" << std::endl;
+
+    // Season is an instance parameter: colors change, geometry does not
+    float spring[3], autumn[3], pine[3];
+    const float springCoverage = FoliageBuilder::SeasonColor(0.0f, false, spring);
+    const float autumnCoverage = FoliageBuilder::SeasonColor(2.0f, false, autumn);
+    assert(FoliageBuilder::SeasonColor(3.0f, false, pine) == 0.0f);
+    assert(FoliageBuilder::SeasonColor(3.0f, true, pine) == 1.0f);
+    assert(autumn[0] > spring[0] && autumn[1] < spring[1]);
+    assert(springCoverage > 0.0f && autumnCoverage > 0.0f);
+    float wrapped[3];
+    FoliageBuilder::SeasonColor(4.0f, false, wrapped);
+    assert(wrapped[0] == spring[0] && wrapped[1] == spring[1]);
+    std::cout << "  [PASS] Seasonal tint and leaf loss come from the season parameter" << std::endl;
+
+    // Archetypes carry foliage and sway bones for every leaf card
+    TreeMeshBuilder builder(TreeMeshBuilder::Options{});
+    builder.SetFoliageBuilder(&foliage);
+    TreeLODSet tree;
+    config.iterations = 6;
+    builder.Generate(config, tree);
+    assert(tree.foliage.individual.triangleCount == 2 * config.leafCount);
+    assert(tree.foliage.individualBones.size() == tree.foliage.individual.vertices.size());
+    assert(tree.foliage.clusterBones.size() == tree.foliage.clusters.vertices.size());
+    for (uint16_t bone : tree.foliage.individualBones) {
+        assert(bone < tree.rig.bones.size());
+    }
+    std::cout << "  [PASS] Tree generation attaches foliage to sway bones" << std::endl;
+}
+
+void test_growth() {
+    std::cout << "\nTest 7: Incremental Growth..." << std::endl;
+    TreeRendererConfig config;
+    config.species = "birch";
+    config.seed = 5;
+    config.iterations = 6;
+    TreeGrowth::Options options;
+    options.yearsPerStep = 1.0f;
+
+    // Growing step by step ends with the same tree as a full derivation
+    TreeGrowth birch(config, options);
+    size_t lastVertices = birch.GetMesh().vertices.size();
+    std::vector<unsigned int> lastIndices = birch.GetMesh().indices;
+    float lastTrunkRadius = 0.0f;
+    for (int year = 0; year <= config.iterations; ++year) {
+        birch.ClearDirty();
+        birch.Grow(1.0f);
+        const Mesh::LODLevel& mesh = birch.GetMesh();
+        assert(mesh.vertices.size() >= lastVertices);
+        assert(std::equal(lastIndices.begin(), lastIndices.end(), mesh.indices.begin()));
+        assert(birch.GetFirstNewIndex() == lastIndices.size());
+        for (const auto& range : birch.GetDirtyRanges()) {
+            assert(range.first + range.count <= mesh.vertices.size());
+        }
+        const float trunkRadius = birch.GetSkeleton().segments[0].startRadius;
+        assert(trunkRadius >= lastTrunkRadius);
+        lastTrunkRadius = trunkRadius;
+        lastVertices = mesh.vertices.size();
+        lastIndices = mesh.indices;
+    }
+    assert(birch.GetStep() == config.iterations);
+    const LSystem system = LSystem::Preset(config.species);
+    TurtleInterpreter turtle(system, TurtleInterpreter::FromConfig(config));
+    TreeSkeleton full;
+    turtle.Generate(config.iterations, uint32_t(config.seed), full);
+    const TreeSkeleton& grown = birch.GetSkeleton();
+    assert(grown.segments.size() == full.segments.size());
+    assert(grown.leaves.size() == full.leaves.size());
+    float grownLength = 0.0f, fullLength = 0.0f;
+    for (size_t i = 0; i < full.segments.size(); ++i) {
+        const auto& a = grown.segments[i];
+        const auto& b = full.segments[i];
+        grownLength += std::sqrt(std::pow(a.end[0] - a.start[0], 2.0f) + std::pow(a.end[1] - a.start[1], 2.0f) +
+                                 std::pow(a.end[2] - a.start[2], 2.0f));
+        fullLength += std::sqrt(std::pow(b.end[0] - b.start[0], 2.0f) + std::pow(b.end[1] - b.start[1], 2.0f) +
+                                std::pow(b.end[2] - b.start[2], 2.0f));
+    }
+    assert(std::abs(grownLength - fullLength) < 1e-3f * fullLength);
+    assert(lastTrunkRadius > options.tipRadius && lastTrunkRadius <= full.segments[0].startRadius);
+    std::cout << "  [PASS] " << grown.segments.size() << " segments grown append-only, matching Generate()"
+              << std::endl;
+
+    // Between steps only the shoots born in the last step are rewritten
+    TreeGrowth young(config, options);
+    young.Grow(3.0f);
+    const size_t before = young.GetSkeleton().segments.size();
+    young.ClearDirty();
+    young.Grow(0.5f);
+    assert(young.GetSkeleton().segments.size() == before);
+    assert(young.GetVerticesWritten() > 0 && young.GetVerticesWritten() < young.GetMesh().vertices.size());
+    assert(young.GetFirstNewIndex() == young.GetMesh().indices.size());
+    const auto& tip = young.GetSkeleton().segments.back();
+    const float tipLength = std::sqrt(std::pow(tip.end[0] - tip.start[0], 2.0f) +
+                                      std::pow(tip.end[1] - tip.start[1], 2.0f) +
+                                      std::pow(tip.end[2] - tip.start[2], 2.0f));
+    assert(tipLength > 0.0f);
+    std::cout << "  [PASS] New shoots extend in place (" << young.GetVerticesWritten() << " of "
+              << young.GetMesh().vertices.size() << " vertices rewritten)" << std::endl;
+
+    // Oak rewrites F: side branches attach along the existing segments
+    config.species = "oak";
+    config.iterations = 4;
+    TreeGrowth oak(config, options);
+    oak.Grow(5.0f);
+    const TreeSkeleton& oakSkeleton = oak.GetSkeleton();
+    assert(oakSkeleton.segments.size() > 10);
+    for (const auto& s : oakSkeleton.segments) {
+        if (s.parent < 0) {
+            continue;
+        }
+        const auto& p = oakSkeleton.segments[size_t(s.parent)];
+        float d[3], e[3];
+        for (int a = 0; a < 3; ++a) {
+            d[a] = p.end[a] - p.start[a];
+            e[a] = s.start[a] - p.start[a];
+        }
+        const float dd = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+        const float t = std::clamp((d[0] * e[0] + d[1] * e[1] + d[2] * e[2]) / dd, 0.0f, 1.0f);
+        float dist = 0.0f;
+        for (int a = 0; a < 3; ++a) {
+            dist += std::pow(e[a] - d[a] * t, 2.0f);
+        }
+        assert(std::sqrt(dist) < 1e-3f);
+    }
+    std::cout << "  [PASS] Oak branches attach along existing segments (" << oakSkeleton.segments.size()
+              << " segments, " << oak.GetApexCount() << " apices)" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Tree Tests..." << std::endl;
+
+    test_lsystem();
+    test_turtle();
+    test_tree_mesh();
+    test_archetypes();
+    test_wind_sway();
+    test_foliage();
+    test_growth();
+
+    std::cout << "\n✓ All tree tests passed!" << std::endl;
+    return 0;
+}
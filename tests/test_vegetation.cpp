@@ -0,0 +1,537 @@
+#include "MemoryStorage.h"
+
+#include <nature/GrassDeformationField.h>
+#include <nature/VegetationChunkCache.h>
+#include <nature/VegetationChunks.h>
+#include <nature/VegetationLOD.h>
+#include <nature/WindField.h>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <vector>
+
+using namespace NRE;
+
+/**
+ * @brief Basic test for vegetation placement
+ *
+ * Tests:
+ * - Tileable progressive blue-noise point set
+ * - 8-byte packed instance encode/decode
+ * - Slope and altitude filtering of grass chunks
+ * - Streaming chunks in and out around the camera
+ * - Distance-banded LOD with frustum culling
+ * - Toroidal grass deformation field
+ * - Shared wind field
+ * - Chunk cache persisted through StorageManager
+ */
+
+static float ToroidalDistanceSq(const BlueNoiseTile& tile, size_t a, size_t b) {
+    float dx = std::fabs(tile.X()[a] - tile.X()[b]);
+    float dz = std::fabs(tile.Z()[a] - tile.Z()[b]);
+    dx = std::min(dx, 1.0f - dx);
+    dz = std::min(dz, 1.0f - dz);
+    return dx * dx + dz * dz;
+}
+
+void test_blue_noise() {
+    std::cout << "\nTest 1: Blue-Noise Tile..." << std::endl;
+    BlueNoiseTile tile(1024, 7);
+    assert(tile.Size() == 1024);
+
+    // Every prefix stays evenly spread: minimum spacing is a fair fraction of
+    // the ideal hexagonal spacing for that many points
+    for (size_t prefix : {size_t(64), size_t(256), size_t(1024)}) {
+        float minDistSq = 1.0f;
+        for (size_t i = 0; i < prefix; ++i) {
+            for (size_t j = i + 1; j < prefix; ++j) {
+                minDistSq = std::min(minDistSq, ToroidalDistanceSq(tile, i, j));
+            }
+        }
+        const float ideal = std::sqrt(2.0f / (std::sqrt(3.0f) * float(prefix)));
+        assert(std::sqrt(minDistSq) > 0.3f * ideal);
+    }
+    std::cout << "  [PASS] Prefixes of the progressive point set are well spaced" << std::endl;
+}
+
+void test_instance_packing() {
+    std::cout << "\nTest 2: Packed Instances..." << std::endl;
+    assert(sizeof(PackedVegetationInstance) == 8);
+
+    InstanceFrame frame;
+    frame.origin[0] = 64.0f;
+    frame.origin[1] = 120.0f;
+    frame.origin[2] = -32.0f;
+    frame.extent[0] = 32.0f;
+    frame.extent[1] = 8.0f;
+    frame.extent[2] = 32.0f;
+
+    std::vector<VegetationInstance> in(37);  // Not a multiple of four
+    for (size_t i = 0; i < in.size(); ++i) {
+        const float t = float(i) / float(in.size());
+        in[i] = {{64.0f + 32.0f * t, 120.0f + 8.0f * (1.0f - t), -32.0f + 31.0f * t},
+                 6.2f * t, 0.75f + 0.5f * t, 6.0f * t, uint16_t(i % 8)};
+    }
+    std::vector<PackedVegetationInstance> packed(in.size());
+    InstancePacking::Encode(in.data(), in.size(), frame, packed.data());
+    std::vector<VegetationInstance> out(in.size());
+    InstancePacking::Decode(packed.data(), packed.size(), frame, out.data());
+
+    const float twoPi = 6.28318530718f;
+    for (size_t i = 0; i < in.size(); ++i) {
+        assert(std::fabs(out[i].position[0] - in[i].position[0]) < 1e-3f);
+        assert(std::fabs(out[i].position[1] - in[i].position[1]) < 1e-3f);
+        assert(std::fabs(out[i].position[2] - in[i].position[2]) < 1e-3f);
+        float da = std::fabs(out[i].rotation - in[i].rotation);
+        da = std::min(da, twoPi - da);
+        assert(da <= twoPi / 128.0f + 1e-4f);
+        float dp = std::fabs(out[i].windPhase - in[i].windPhase);
+        dp = std::min(dp, twoPi - dp);
+        assert(dp <= twoPi / 16.0f + 1e-4f);
+        assert(std::fabs(out[i].scale - in[i].scale) <= 0.5f / 15.0f + 1e-4f);
+        assert(out[i].type == in[i].type);
+    }
+    std::cout << "  [PASS] Round trip within quantization error" << std::endl;
+}
+
+void test_chunk_filtering() {
+    std::cout << "\nTest 3: Slope and Altitude Filtering..." << std::endl;
+    VegetationSystem::Config config;
+    config.slopeThreshold = 30.0f;
+    config.minAltitude = 0.0f;
+    config.maxAltitude = 100.0f;
+    VegetationChunkStreamer::Options options;
+    options.tilePoints = 1024;
+    VegetationChunkStreamer streamer(config, options);
+    const float tileSize = streamer.GetTileSize();
+    assert(std::fabs(tileSize - 32.0f) < 1e-3f);  // 1024 blades at 1 per m^2
+
+    // Left half flat at 10 m, right half a 45 degree ramp
+    const int size = 65;
+    std::vector<float> heights(size_t(size) * size);
+    for (int z = 0; z < size; ++z) {
+        for (int x = 0; x < size; ++x) {
+            heights[size_t(z) * size + x] = x < 32 ? 10.0f : 10.0f + float(x - 32);
+        }
+    }
+    TerrainHeightmap terrain;
+    terrain.heights = heights.data();
+    terrain.width = size;
+    terrain.height = size;
+
+    BlueNoiseTile tile(1024, options.seed);
+    std::vector<uint32_t> all(tile.Size());
+    for (uint32_t i = 0; i < all.size(); ++i) {
+        all[i] = i;
+    }
+    VegetationChunk flat;
+    flat.coord = {0, 0};
+    VegetationChunkStreamer::GenerateChunk(flat, terrain, config, tile, all, tileSize, 1, 10, options.seed);
+    assert(flat.state.load() == VegetationChunk::State::Ready);
+    assert(flat.instances.size() > 900);
+    std::vector<VegetationInstance> decoded;
+    flat.Decode(decoded);
+    size_t flowers = 0;
+    for (const auto& inst : decoded) {
+        assert(std::fabs(inst.position[1] - 10.0f) < 1e-3f);
+        assert(inst.scale >= 0.75f && inst.scale <= 1.25f);
+        flowers += inst.type != 0;
+    }
+    assert(flowers > 0 && flowers <= 10);
+    std::cout << "  [PASS] Flat terrain is fully covered, flowers spread through the ranks" << std::endl;
+
+    VegetationChunk steep;
+    steep.coord = {1, 0};
+    VegetationChunkStreamer::GenerateChunk(steep, terrain, config, tile, all, tileSize, 1, 10, options.seed);
+    assert(steep.instances.empty());
+    std::cout << "  [PASS] Slopes above the threshold are rejected" << std::endl;
+
+    config.minAltitude = 20.0f;
+    VegetationChunk low;
+    low.coord = {0, 0};
+    VegetationChunkStreamer::GenerateChunk(low, terrain, config, tile, all, tileSize, 1, 10, options.seed);
+    assert(low.instances.empty());
+    std::cout << "  [PASS] Altitudes outside the range are rejected" << std::endl;
+
+    // Heightmaps too small to interpolate give empty chunks instead of reading past them
+    config.minAltitude = 0.0f;
+    for (int w : {0, 1, 2}) {
+        for (int h : {1, 2}) {
+            std::vector<float> tiny(size_t(w) * size_t(h), 10.0f);
+            TerrainHeightmap degenerate;
+            degenerate.heights = tiny.data();
+            degenerate.width = w;
+            degenerate.height = h;
+            VegetationChunk edge;
+            edge.coord = {0, 0};
+            VegetationChunkStreamer::GenerateChunk(edge, degenerate, config, tile, all, tileSize, 1, 10, options.seed);
+            assert(edge.state.load() == VegetationChunk::State::Ready);
+            assert((w == 2 && h == 2) || edge.instances.empty());
+        }
+    }
+    std::cout << "  [PASS] Heightmaps narrower than 2 samples yield empty chunks" << std::endl;
+}
+
+void test_streaming() {
+    std::cout << "\nTest 4: Chunk Streaming..." << std::endl;
+    const int size = 513;
+    std::vector<float> heights(size_t(size) * size, 5.0f);
+    TerrainHeightmap terrain;
+    terrain.heights = heights.data();
+    terrain.width = size;
+    terrain.height = size;
+
+    VegetationSystem::Config config;
+    config.grassDensity = 10000;  // Sparse so the debug build stays quick
+    config.maxRenderDistance = 60.0f;
+    VegetationChunkStreamer::Options options;
+    options.tilePoints = 256;
+    options.targetChunkSize = 40.0f;
+    options.maxRequestsPerUpdate = 64;
+    JobSystem jobs(2);
+    VegetationChunkStreamer streamer(config, options, &jobs);
+    streamer.SetTerrain(terrain);
+
+    streamer.Update(100.0f, 100.0f);
+    streamer.WaitIdle();
+    const size_t resident = streamer.GetResidentChunkCount();
+    const float chunk = streamer.GetChunkSize();
+    const float reach = config.maxRenderDistance + chunk;
+    assert(resident > 0);
+    assert(float(resident) <= 4.0f * reach * reach / (chunk * chunk));
+    size_t ready = 0;
+    streamer.ForEachReadyChunk([&](const VegetationChunk& c) {
+        ++ready;
+        std::vector<VegetationInstance> decoded;
+        c.Decode(decoded);
+        for (const auto& inst : decoded) {
+            const float dx = inst.position[0] - 100.0f;
+            const float dz = inst.position[2] - 100.0f;
+            assert(dx * dx + dz * dz <= 4.0f * reach * reach);
+        }
+    });
+    assert(ready == resident);
+    assert(streamer.GetResidentInstanceCount() > 0);
+    assert(streamer.GetResidentInstanceBytes() >= streamer.GetResidentInstanceCount() * 8);
+    std::cout << "  [PASS] Chunks around the camera generated on workers" << std::endl;
+
+    // Moving far away evicts everything behind and keeps residency bounded
+    streamer.Update(400.0f, 400.0f);
+    streamer.WaitIdle();
+    streamer.ForEachReadyChunk([&](const VegetationChunk& c) {
+        const float cx = (float(c.coord.x) + 0.5f) * chunk;
+        const float cz = (float(c.coord.z) + 0.5f) * chunk;
+        assert(std::fabs(cx - 400.0f) <= reach + chunk && std::fabs(cz - 400.0f) <= reach + chunk);
+    });
+    assert(float(streamer.GetResidentChunkCount()) <= 4.0f * reach * reach / (chunk * chunk));
+    std::cout << "  [PASS] Distant chunks evicted, residency bounded by view distance" << std::endl;
+
+    // Regenerated chunks are identical (placement is a pure function of position)
+    std::vector<float> before;
+    streamer.ForEachReadyChunk([&](const VegetationChunk& c) {
+        if (c.coord.x == 10 && c.coord.z == 10) {
+            for (const auto& inst : c.instances) before.push_back(float(inst.x) + float(inst.attributes));
+        }
+    });
+    streamer.Update(100.0f, 100.0f);
+    streamer.WaitIdle();
+    streamer.Update(400.0f, 400.0f);
+    streamer.WaitIdle();
+    std::vector<float> after;
+    streamer.ForEachReadyChunk([&](const VegetationChunk& c) {
+        if (c.coord.x == 10 && c.coord.z == 10) {
+            for (const auto& inst : c.instances) after.push_back(float(inst.x) + float(inst.attributes));
+        }
+    });
+    assert(before == after);
+    std::cout << "  [PASS] Placement is deterministic across evict and reload" << std::endl;
+}
+
+void test_lod() {
+    std::cout << "\nTest 5: Vegetation LOD..." << std::endl;
+    VegetationSystem::Config config;
+    config.grassDensity = 10000;
+    config.flowerDensity = 2000;
+    config.maxRenderDistance = 400.0f;
+    VegetationCuller culler(config);
+
+    assert(culler.DensityAt(0.0f) == 1.0f);
+    assert(culler.DensityAt(config.fullDensityDistance) == 1.0f);
+    float last = 1.0f;
+    for (float d = 30.0f; d < 400.0f; d += 10.0f) {
+        const float density = culler.DensityAt(d);
+        assert(density <= last && density >= config.minLODDensity);
+        last = density;
+    }
+    assert(culler.LODAt(10.0f) == VegetationLOD::FullBlade);
+    assert(culler.LODAt(100.0f) == VegetationLOD::SimpleBlade);
+    assert(culler.LODAt(300.0f) == VegetationLOD::Impostor);
+    std::cout << "  [PASS] Density falls off monotonically, bands ordered by distance" << std::endl;
+
+    // Identity view-projection: the visible volume is the cube [-1, 1]^3
+    const float identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+    const Frustum cube = Frustum::FromViewProjection(identity);
+    const float inMin[3] = {-0.5f, -0.5f, -0.5f}, inMax[3] = {0.5f, 0.5f, 0.5f};
+    const float outMin[3] = {2.0f, 2.0f, 2.0f}, outMax[3] = {3.0f, 3.0f, 3.0f};
+    assert(cube.IntersectsBox(inMin, inMax));
+    assert(!cube.IntersectsBox(outMin, outMax));
+    std::cout << "  [PASS] Frustum planes extracted from view-projection" << std::endl;
+
+    const int size = 1025;
+    std::vector<float> heights(size_t(size) * size, 0.0f);
+    TerrainHeightmap terrain;
+    terrain.heights = heights.data();
+    terrain.width = size;
+    terrain.height = size;
+    VegetationChunkStreamer::Options options;
+    options.tilePoints = 256;
+    options.maxRequestsPerUpdate = 1024;
+    VegetationChunkStreamer streamer(config, options);
+    streamer.SetTerrain(terrain);
+    const float camera[3] = {512.0f, 2.0f, 512.0f};
+    streamer.Update(camera[0], camera[2]);
+
+    // Half-space frustum: only x >= camera x is visible
+    Frustum half;
+    half.planes[0][0] = 1.0f;
+    half.planes[0][3] = -camera[0];
+    const auto& batches = culler.Cull(streamer, half, camera);
+    const auto stats = culler.GetStats();
+    assert(stats.chunksVisible > 0 && stats.chunksVisible < stats.chunksTested);
+    size_t full = 0;
+    for (const auto& b : batches) {
+        assert(b.chunk->frame.origin[0] + b.chunk->frame.extent[0] >= camera[0]);
+        assert(b.instanceCount <= b.chunk->instances.size());
+        full += b.chunk->instances.size();
+    }
+    assert(stats.trianglesDrawn * 4 < full * VegetationCuller::kFullBladeTriangles);
+    std::cout << "  [PASS] Culling pass drops hidden chunks and thins distant ones" << std::endl;
+
+    // Thinned prefixes keep the flower mix: every band draws about 20% flowers
+    size_t drawn[3] = {}, flowers[3] = {};
+    std::vector<VegetationInstance> decoded;
+    for (const auto& b : batches) {
+        b.chunk->Decode(decoded);
+        for (uint32_t i = 0; i < b.instanceCount; ++i) {
+            drawn[int(b.lod)] += 1;
+            flowers[int(b.lod)] += decoded[i].type != 0;
+        }
+    }
+    for (int band = 0; band < 3; ++band) {
+        assert(drawn[band] >= 50);
+        const double fraction = double(flowers[band]) / double(drawn[band]);
+        assert(std::fabs(fraction - 0.2) < 0.06);
+    }
+    std::cout << "  [PASS] Flower fraction " << double(flowers[0]) / double(drawn[0]) << " / "
+              << double(flowers[1]) / double(drawn[1]) << " / " << double(flowers[2]) / double(drawn[2])
+              << " across LOD bands" << std::endl;
+
+    config.useLOD = false;
+    VegetationCuller noLOD(config);
+    noLOD.Cull(streamer, half, camera);
+    assert(noLOD.GetStats().instancesDrawn == full);
+    std::cout << "  [PASS] useLOD = false draws every blade at full detail" << std::endl;
+}
+
+void test_deformation_field() {
+    std::cout << "\nTest 6: Grass Deformation Field..." << std::endl;
+    GrassDeformationField::Options options;
+    options.resolution = 64;
+    options.cellSize = 1.0f;
+    options.recoveryRate = 0.5f;
+    GrassDeformationField field(options);
+    field.Recenter(0.0f, 0.0f);
+
+    field.Stamp(4.0f, 4.0f, 2.0f, 1.0f);
+    assert(field.Sample(4.0f, 4.0f) > 0.8f);
+    assert(field.Sample(10.0f, 10.0f) == 0.0f);
+    std::cout << "  [PASS] Stamp flattens a disc" << std::endl;
+
+    const float xs[3] = {-10.0f, 0.0f, 10.0f};
+    const float zs[3] = {-10.0f, -10.0f, -10.0f};
+    field.StampMany(xs, zs, 3, 1.5f, 0.6f);
+    for (float x : xs) {
+        assert(field.Sample(x, -10.0f) > 0.4f);
+    }
+
+    field.Recover(1.0f);
+    const float recovered = field.Sample(4.0f, 4.0f);
+    assert(recovered > 0.3f && recovered < 0.6f);
+    field.Recover(2.0f);
+    assert(field.Sample(4.0f, 4.0f) == 0.0f);
+    std::cout << "  [PASS] Recovery relaxes every cell in one pass" << std::endl;
+
+    // Scroll so the stamp stays inside, then far enough that it wraps out
+    field.Stamp(4.0f, 4.0f, 2.0f, 1.0f);
+    field.Recenter(20.0f, 0.0f);
+    assert(field.Sample(4.0f, 4.0f) > 0.8f);
+    field.Recenter(50.0f, 0.0f);
+    assert(field.Sample(4.0f, 4.0f) == 0.0f);
+    // The cells it occupied now represent new ground and must be clear
+    assert(field.Sample(4.0f + 64.0f, 4.0f) == 0.0f);
+    std::cout << "  [PASS] Scrolling keeps in-window state and clears wrapped cells" << std::endl;
+}
+
+void test_wind_field() {
+    std::cout << "\nTest 7: Wind Field..." << std::endl;
+    WindField::Options options;
+    options.sizeX = 16;
+    options.sizeY = 4;
+    options.sizeZ = 16;
+    WindField wind(options);
+    const float direction[2] = {0.0f, 2.0f};  // Normalized internally
+    wind.SetAmbient(6.0f, direction);
+    for (int i = 0; i < 120; ++i) {
+        wind.Update(1.0f / 30.0f);
+    }
+
+    // Mean flow follows the ambient wind and strengthens with height
+    float meanLow[3] = {0, 0, 0};
+    float meanHigh[3] = {0, 0, 0};
+    int samples = 0;
+    for (float x = -40.0f; x <= 40.0f; x += 10.0f) {
+        for (float z = -40.0f; z <= 40.0f; z += 10.0f) {
+            float low[3], high[3];
+            const float p0[3] = {x, 2.0f, z};
+            const float p1[3] = {x, 20.0f, z};
+            wind.Sample(p0, low);
+            wind.Sample(p1, high);
+            for (int a = 0; a < 3; ++a) {
+                meanLow[a] += low[a];
+                meanHigh[a] += high[a];
+            }
+            ++samples;
+        }
+    }
+    for (int a = 0; a < 3; ++a) {
+        meanLow[a] /= float(samples);
+        meanHigh[a] /= float(samples);
+    }
+    assert(meanHigh[2] > 4.0f && meanHigh[2] < 12.0f);
+    assert(std::fabs(meanHigh[0]) < 1.5f);
+    assert(meanHigh[2] > meanLow[2] && meanLow[2] > 0.0f);
+    std::cout << "  [PASS] Flow follows the ambient wind with a boundary-layer profile" << std::endl;
+
+    // Gusts and turbulence make the field non-uniform
+    int sx, sy, sz;
+    wind.GetDimensions(sx, sy, sz);
+    const float* texture = wind.GetTextureData();
+    float minGust = 1e9f, maxGust = -1e9f;
+    for (int i = 0; i < sx * sy * sz; ++i) {
+        minGust = std::min(minGust, texture[i * 4 + 3]);
+        maxGust = std::max(maxGust, texture[i * 4 + 3]);
+    }
+    assert(minGust >= 1.0f && maxGust > minGust);
+    std::cout << "  [PASS] Gust fronts exported in the texture" << std::endl;
+
+    // Recentering keeps the wind at a fixed world point
+    const float probe[3] = {8.0f, 10.0f, 8.0f};
+    float before[3], after[3];
+    wind.Sample(probe, before);
+    wind.Recenter(16.0f, 16.0f);
+    wind.Sample(probe, after);
+    for (int a = 0; a < 3; ++a) {
+        assert(std::fabs(before[a] - after[a]) < 1e-4f);
+    }
+    std::cout << "  [PASS] Grid follows the camera in whole cells" << std::endl;
+}
+
+void test_chunk_cache() {
+    std::cout << "\nTest 8: Chunk Cache..." << std::endl;
+    const int size = 257;
+    std::vector<float> heights(size_t(size) * size);
+    for (int z = 0; z < size; ++z) {
+        for (int x = 0; x < size; ++x) {
+            heights[size_t(z) * size + x] = 0.05f * float(x) + 0.03f * float(z);
+        }
+    }
+    TerrainHeightmap terrain;
+    terrain.heights = heights.data();
+    terrain.width = size;
+    terrain.height = size;
+
+    VegetationSystem::Config config;
+    config.grassDensity = 40000;
+    config.maxRenderDistance = 40.0f;
+    VegetationChunkStreamer::Options options;
+    options.tilePoints = 256;
+    options.maxRequestsPerUpdate = 64;
+    MemoryStorage storage;
+    VegetationChunkCache cache(storage, config, options);
+    VegetationChunkStreamer streamer(config, options);
+    streamer.SetTerrain(terrain);
+    streamer.SetChunkStore(&cache);
+
+    auto snapshot = [&streamer]() {
+        std::map<std::pair<int, int>, std::vector<uint16_t>> chunks;
+        streamer.ForEachReadyChunk([&](const VegetationChunk& c) {
+            auto& words = chunks[{c.coord.x, c.coord.z}];
+            for (const auto& inst : c.instances) {
+                words.insert(words.end(), {inst.x, inst.y, inst.z, inst.attributes});
+            }
+        });
+        return chunks;
+    };
+
+    streamer.Update(64.0f, 64.0f);
+    const auto generated = snapshot();
+    assert(cache.GetHits() == 0 && cache.GetMisses() == generated.size());
+    assert(storage.entries.size() == generated.size());
+    assert(storage.lowPriorityWrites == generated.size());
+    assert(cache.GetRawBytes() == streamer.GetResidentInstanceCount() * sizeof(PackedVegetationInstance));
+    std::cout << "  [PASS] Generated chunks stored at Priority::Low ("
+              << cache.GetStoredBytes() << " bytes for " << cache.GetRawBytes() << " raw)" << std::endl;
+
+    // Leave and come back: every chunk is a cache hit with identical contents
+    streamer.Update(200.0f, 200.0f);
+    const size_t missesBefore = cache.GetMisses();
+    streamer.Update(64.0f, 64.0f);
+    assert(cache.GetMisses() == missesBefore);
+    assert(cache.GetHits() == generated.size());
+    assert(snapshot() == generated);
+    std::cout << "  [PASS] Revisited chunks load from storage unchanged" << std::endl;
+
+    // Placement-affecting settings change the key
+    VegetationSystem::Config steeper = config;
+    steeper.slopeThreshold = 10.0f;
+    VegetationChunkCache other(storage, steeper, options);
+    VegetationChunk probe;
+    probe.coord = {1, 1};
+    assert(other.KeyFor(probe.coord) != cache.KeyFor(probe.coord));
+    assert(!other.Load(probe));
+    assert(cache.Load(probe));
+    std::cout << "  [PASS] Config hash keeps stale chunks from being reused" << std::endl;
+
+    // An edited heightmap (or another world with the same seed) misses too
+    const std::string original = cache.KeyFor(probe.coord);
+    heights[size_t(70) * size + 70] += 5.0f;
+    streamer.SetTerrain(terrain);
+    assert(cache.KeyFor(probe.coord) != original);
+    const size_t missesBeforeEdit = cache.GetMisses();
+    streamer.Update(64.0f, 64.0f);
+    assert(cache.GetMisses() == missesBeforeEdit + generated.size());
+    TerrainHeightmap shifted = terrain;
+    shifted.origin[0] = 1000.0f;
+    VegetationChunkCache elsewhere(storage, config, options);
+    elsewhere.SetTerrain(shifted);
+    assert(!elsewhere.Load(probe));
+    std::cout << "  [PASS] Terrain hash keeps chunks of other heightmaps from being reused" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Vegetation Tests..." << std::endl;
+
+    test_blue_noise();
+    test_instance_packing();
+    test_chunk_filtering();
+    test_streaming();
+    test_lod();
+    test_deformation_field();
+    test_wind_field();
+    test_chunk_cache();
+
+    std::cout << "\n✓ All vegetation tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,636 @@
+#include <core/FFT.h>
+#include <core/JobSystem.h>
+#include <nature/Caustics.h>
+#include <nature/OceanFFT.h>
+#include <nature/ShallowWaterSolver.h>
+#include <nature/WaterHeightQuery.h>
+#include <nature/WaterParticles.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace NRE;
+
+/**
+ * @brief Basic test for water simulation
+ *
+ * Tests:
+ * - Radix-4/2 FFT against a direct DFT (1D and 2D)
+ * - FFT ocean spectrum, cascades and per-frame maps
+ * - Batched height queries on a double-buffered snapshot
+ * - Tiled shallow-water solver with sleeping tiles
+ * - Splash particle pool, foam deposits and crest foam
+ * - Caustic maps refracted through the ocean surface
+ */
+
+// Direct 1D DFT with the same sign convention as FFT
+static std::vector<std::complex<double>> Dft(const std::vector<std::complex<double>>& x, bool inverse) {
+    const size_t n = x.size();
+    std::vector<std::complex<double>> out(n);
+    const double sign = inverse ? 1.0 : -1.0;
+    for (size_t k = 0; k < n; ++k) {
+        for (size_t j = 0; j < n; ++j) {
+            const double angle = sign * 6.283185307179586 * double(j * k % n) / double(n);
+            out[k] += x[j] * std::complex<double>(std::cos(angle), std::sin(angle));
+        }
+    }
+    return out;
+}
+
+void test_fft() {
+    std::cout << "\nTest 1: Radix-4/2 FFT..." << std::endl;
+    for (size_t n : {4u, 8u, 16u, 32u, 64u}) {
+        FFT fft(n);
+        std::vector<Float4> re(n), im(n), workRe(n), workIm(n);
+        std::vector<std::vector<std::complex<double>>> lanes(4, std::vector<std::complex<double>>(n));
+        for (size_t i = 0; i < n; ++i) {
+            float r[4], m[4];
+            for (int l = 0; l < 4; ++l) {
+                r[l] = std::sin(0.37f * float(i * (l + 1))) + 0.1f * float(l);
+                m[l] = std::cos(0.91f * float(i) + float(l)) * 0.5f;
+                lanes[size_t(l)][i] = {r[l], m[l]};
+            }
+            re[i] = Float4::Load(r);
+            im[i] = Float4::Load(m);
+        }
+        for (bool inverse : {false, true}) {
+            std::vector<Float4> outRe = re, outIm = im;
+            fft.Transform4(outRe.data(), outIm.data(), workRe.data(), workIm.data(), inverse);
+            for (int l = 0; l < 4; ++l) {
+                const auto expected = Dft(lanes[size_t(l)], inverse);
+                for (size_t k = 0; k < n; ++k) {
+                    float r[4], m[4];
+                    outRe[k].Store(r);
+                    outIm[k].Store(m);
+                    assert(std::abs(r[l] - expected[k].real()) < 1e-3 * double(n));
+                    assert(std::abs(m[l] - expected[k].imag()) < 1e-3 * double(n));
+                }
+            }
+        }
+    }
+    std::cout << "  [PASS] Four-lane transforms match the DFT for n = 4..64" << std::endl;
+
+    // 2D round trip and a single mode
+    JobSystem jobs(2);
+    for (size_t n : {8u, 32u}) {
+        FFT fft(n);
+        std::vector<float> re(n * n), im(n * n, 0.0f);
+        for (size_t i = 0; i < n * n; ++i) {
+            re[i] = std::sin(float(i) * 0.731f) + float(i % 7) * 0.1f;
+        }
+        const std::vector<float> original = re;
+        fft.Transform2D(re.data(), im.data(), false, &jobs);
+        fft.Transform2D(re.data(), im.data(), true, nullptr);
+        for (size_t i = 0; i < n * n; ++i) {
+            assert(std::abs(re[i] / float(n * n) - original[i]) < 1e-4f);
+            assert(std::abs(im[i] / float(n * n)) < 1e-4f);
+        }
+        // Spectrum with one mode (kx = 1, kz = 2) gives a plane wave
+        std::fill(re.begin(), re.end(), 0.0f);
+        std::fill(im.begin(), im.end(), 0.0f);
+        re[2 * n + 1] = 1.0f;
+        fft.Transform2D(re.data(), im.data(), true, &jobs);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                const float angle = 6.2831853f * float(j + 2 * i) / float(n);
+                assert(std::abs(re[i * n + j] - std::cos(angle)) < 1e-4f);
+                assert(std::abs(im[i * n + j] - std::sin(angle)) < 1e-4f);
+            }
+        }
+    }
+    std::cout << "  [PASS] 2D transforms round-trip and place modes at (row = z, column = x)" << std::endl;
+}
+
+void test_ocean() {
+    std::cout << "\nTest 2: FFT Ocean..." << std::endl;
+    WaterRenderer::Config config;
+    config.simulationResolution = 64;
+    OceanFFT::Options options = OceanFFT::FromConfig(config);
+    options.tileSizes = {500.0f};
+    OceanFFT ocean(options);
+    ocean.Update(3.0f);
+    const size_t n = 64;
+    const OceanFFT::Cascade& cascade = ocean.GetCascade(0);
+
+    double mean = 0.0, variance = 0.0, slopeAlong = 0.0, slopeAcross = 0.0, jacobian = 0.0;
+    for (size_t i = 0; i < n * n; ++i) {
+        mean += cascade.height[i];
+        variance += double(cascade.height[i]) * cascade.height[i];
+        slopeAlong += double(cascade.normalX[i]) * cascade.normalX[i];
+        slopeAcross += double(cascade.normalZ[i]) * cascade.normalZ[i];
+        jacobian += cascade.jacobian[i];
+        const float len = std::sqrt(cascade.normalX[i] * cascade.normalX[i] + cascade.normalY[i] * cascade.normalY[i] +
+                                    cascade.normalZ[i] * cascade.normalZ[i]);
+        assert(std::abs(len - 1.0f) < 1e-4f);
+    }
+    mean /= double(n * n);
+    variance = variance / double(n * n) - mean * mean;
+    const double significantHeight = 4.0 * std::sqrt(variance);
+    assert(std::abs(mean) < 0.05);
+    assert(significantHeight > 0.5 && significantHeight < 4.0);  // ~1.6 m for 10 m/s over 100 km fetch
+    assert(slopeAlong > 2.0 * slopeAcross);                     // Wind along +x
+    assert(std::abs(jacobian / double(n * n) - 1.0) < 0.1);
+    std::cout << "  [PASS] JONSWAP Hs = " << significantHeight << " m, waves aligned with the wind" << std::endl;
+
+    // Waves travel: the field changes over time, and threading does not change results
+    OceanFFT threaded(options);
+    JobSystem jobs(3);
+    threaded.Update(3.0f, &jobs);
+    for (size_t i = 0; i < n * n; ++i) {
+        assert(std::abs(threaded.GetCascade(0).height[i] - cascade.height[i]) < 1e-5f);
+    }
+    const std::vector<float> before = cascade.height;
+    ocean.Update(4.0f);
+    double change = 0.0;
+    for (size_t i = 0; i < n * n; ++i) {
+        change += std::abs(cascade.height[i] - before[i]);
+    }
+    assert(change / double(n * n) > 0.01);
+    std::cout << "  [PASS] Time evolution, threaded update matches serial" << std::endl;
+
+    // Resolutions are rounded up to the power of two the FFT and the wraps need
+    OceanFFT::Options odd = options;
+    odd.resolution = 48;
+    assert(OceanFFT(odd).GetResolution() == 64);
+
+    // Cascades partition the spectrum; Phillips also works
+    options.tileSizes = {500.0f, 85.0f, 15.0f};
+    options.spectrum = OceanFFT::Spectrum::Phillips;
+    OceanFFT cascades(options);
+    cascades.Update(1.0f, &jobs);
+    assert(cascades.GetCascadeCount() == 3);
+    for (size_t c = 0; c + 1 < cascades.GetCascadeCount(); ++c) {
+        assert(cascades.GetCascade(c).kMax == cascades.GetCascade(c + 1).kMin);
+        assert(cascades.GetCascade(c).kMax > cascades.GetCascade(c).kMin);
+    }
+    for (size_t c = 0; c < cascades.GetCascadeCount(); ++c) {
+        double energy = 0.0;
+        for (float h : cascades.GetCascade(c).height) {
+            energy += double(h) * h;
+        }
+        assert(energy > 0.0);
+    }
+    std::cout << "  [PASS] 3 Phillips cascades cover disjoint wavenumber bands" << std::endl;
+}
+
+void test_height_query() {
+    std::cout << "\nTest 3: Batched Water Height Queries..." << std::endl;
+    OceanFFT::Options options;
+    options.resolution = 64;
+    options.tileSizes = {200.0f, 40.0f};
+    options.choppiness = 0.0f;
+    OceanFFT ocean(options);
+    ocean.Update(2.0f);
+    WaterHeightQuery::Options queryOptions;
+    queryOptions.seaLevel = 5.0f;
+    WaterHeightQuery query(queryOptions);
+    assert(query.GetHeight(1.0f, 2.0f) == 5.0f);  // Nothing published yet
+    assert(query.Publish(ocean));
+
+    // Without choppiness, texel centers return the summed height maps exactly
+    const size_t n = 64;
+    std::vector<float> x, z, expected;
+    for (size_t i = 0; i < n; i += 5) {
+        for (size_t j = 0; j < n; j += 3) {
+            x.push_back(float(j) * 200.0f / float(n));
+            z.push_back(float(i) * 200.0f / float(n) - 400.0f);  // Periodic
+            float h = 5.0f;
+            for (size_t c = 0; c < 2; ++c) {
+                const auto& cascade = ocean.GetCascade(c);
+                const float scale = float(n) / cascade.tileSize;
+                const size_t u = size_t(std::lround(x.back() * scale)) % n;
+                const size_t v = size_t(std::lround((z.back() + 400.0f) * scale)) % n;
+                h += cascade.height[v * n + u];
+            }
+            expected.push_back(h);
+        }
+    }
+    std::vector<float> heights(x.size());
+    query.GetHeights(x.data(), z.data(), heights.data(), x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        assert(std::abs(heights[i] - expected[i]) < 1e-3f);
+    }
+    assert(query.GetHeight(x[7], z[7]) == heights[7]);
+    std::cout << "  [PASS] " << x.size() << " batched queries match the height maps" << std::endl;
+
+    // With choppy waves, the height at a displaced texel is found by inverting the displacement
+    options.choppiness = 1.0f;
+    options.tileSizes = {200.0f};
+    OceanFFT choppy(options);
+    choppy.Update(2.0f);
+    query.Publish(choppy);
+    const auto& cascade = choppy.GetCascade(0);
+    double error = 0.0, naive = 0.0;
+    x.clear();
+    z.clear();
+    expected.clear();
+    for (size_t i = 0; i < n * n; i += 7) {
+        const float px = float(i % n) * 200.0f / float(n);
+        const float pz = float(i / n) * 200.0f / float(n);
+        x.push_back(px + cascade.displaceX[i]);
+        z.push_back(pz + cascade.displaceZ[i]);
+        expected.push_back(5.0f + cascade.height[i]);
+    }
+    heights.resize(x.size());
+    query.GetHeights(x.data(), z.data(), heights.data(), x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        error += std::abs(heights[i] - expected[i]);
+    }
+    // Reference: ignoring displacement samples the wrong wave phase
+    WaterHeightQuery::Options noInversion = queryOptions;
+    noInversion.iterations = 0;
+    WaterHeightQuery direct(noInversion);
+    direct.Publish(choppy);
+    std::vector<float> directHeights(x.size());
+    direct.GetHeights(x.data(), z.data(), directHeights.data(), x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        naive += std::abs(directHeights[i] - expected[i]);
+    }
+    assert(error < 0.5 * naive);
+    std::cout << "  [PASS] Displacement inversion error " << error / double(x.size()) << " m (vs "
+              << naive / double(x.size()) << " m without)" << std::endl;
+
+    // Readers never block the simulation; a busy back snapshot just skips a publish
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        std::vector<float> out(x.size());
+        while (!done.load()) {
+            query.GetHeights(x.data(), z.data(), out.data(), x.size());
+            for (float h : out) {
+                assert(std::isfinite(h));
+            }
+        }
+    });
+    for (int frame = 0; frame < 50; ++frame) {
+        choppy.Update(2.0f + float(frame) * 0.05f);
+        query.Publish(choppy);
+    }
+    done.store(true);
+    reader.join();
+    assert(query.GetVersion() + query.GetSkippedCount() == 52);
+    std::cout << "  [PASS] Concurrent queries during " << query.GetVersion() << " publishes ("
+              << query.GetSkippedCount() << " skipped)" << std::endl;
+}
+
+void test_shallow_water() {
+    std::cout << "\nTest 4: Shallow Water Solver..." << std::endl;
+    ShallowWaterSolver::Options options;
+    options.width = 64;
+    options.height = 64;
+    options.tileSize = 16;
+    options.damping = 0.5f;
+
+    // Lake 2 m deep with a dry ridge along one edge
+    std::vector<float> bed(64 * 64, -2.0f);
+    for (int i = 0; i < 64; ++i) {
+        for (int j = 56; j < 64; ++j) {
+            bed[size_t(i) * 64 + size_t(j)] = float(j - 56) * 0.25f - 0.5f;
+        }
+    }
+    ShallowWaterSolver lake(options);
+    lake.SetTerrain(bed.data());
+    lake.Fill(0.0f);
+    lake.Step(1.0f / 30.0f);
+    assert(lake.GetSimulatedTileCount() == 0);  // Still water costs nothing
+
+    lake.AddDisturbance(8.0f, 8.0f, 4.0f, 0.5f);
+    const double volume = lake.GetVolume();
+    assert(lake.GetAwakeTileCount() == 1);
+    const float farBefore = lake.GetSurface(30.0f, 8.0f);
+    lake.Step(1.0f / 30.0f);
+    assert(lake.GetSimulatedTileCount() == 4);  // Awake tile plus in-bounds neighbors
+    assert(lake.GetLastIterations() > 0 && lake.GetLastIterations() < options.maxIterations);
+    for (int step = 0; step < 150; ++step) {
+        lake.Step(1.0f / 30.0f);
+    }
+    assert(std::abs(lake.GetSurface(30.0f, 8.0f) - farBefore) > 1e-3f);  // The wave arrived (sqrt(gH) = 4.4 m/s)
+    assert(std::abs(lake.GetVolume() - volume) < 1e-3 * volume);
+    for (int i = 0; i < 64; ++i) {
+        for (int j = 0; j < 64; ++j) {
+            assert(lake.GetDepth(i, j) >= 0.0f);
+        }
+    }
+    std::cout << "  [PASS] Ring wave spreads across tiles, volume conserved (" << lake.GetLastIterations()
+              << " PCG iterations, residual " << lake.GetLastResidual() << ")" << std::endl;
+
+    // Threads split tiles without changing the result
+    ShallowWaterSolver serial(options), threaded(options);
+    JobSystem jobs(3);
+    for (auto* solver : {&serial, &threaded}) {
+        solver->SetTerrain(bed.data());
+        solver->Fill(0.0f);
+        solver->AddDisturbance(40.0f, 30.0f, 6.0f, -0.3f);
+        solver->AddVelocity(20.0f, 40.0f, 5.0f, 1.0f, 0.0f);
+    }
+    for (int step = 0; step < 10; ++step) {
+        serial.Step(1.0f / 30.0f);
+        threaded.Step(1.0f / 30.0f, &jobs);
+    }
+    for (int i = 0; i < 64; ++i) {
+        for (int j = 0; j < 64; ++j) {
+            assert(serial.GetDepth(i, j) == threaded.GetDepth(i, j));
+        }
+    }
+    std::cout << "  [PASS] Threaded step matches serial" << std::endl;
+
+    // Damped water settles and its tiles go back to sleep
+    int steps = 0;
+    while (lake.GetAwakeTileCount() > 0 && steps < 2000) {
+        lake.Step(1.0f / 30.0f);
+        ++steps;
+    }
+    assert(lake.GetAwakeTileCount() == 0);
+    lake.Step(1.0f / 30.0f);
+    assert(lake.GetSimulatedTileCount() == 0);
+    std::cout << "  [PASS] All " << lake.GetTileCount() << " tiles asleep after " << steps << " more steps"
+              << std::endl;
+
+    // A steady eddy barely moves the surface but keeps its tiles awake; judged on
+    // surface change alone it would be put to sleep and its current wiped out
+    ShallowWaterSolver::Options still = options;
+    still.damping = 0.0f;
+    ShallowWaterSolver eddy(still), surfaceOnly([&] {
+        ShallowWaterSolver::Options o = still;
+        o.sleepFlux = 1e9f;
+        return o;
+    }());
+    std::vector<float> deep(64 * 64, -2.0f);
+    for (auto* solver : {&eddy, &surfaceOnly}) {
+        solver->SetTerrain(deep.data());
+        solver->Fill(0.0f);
+        for (int k = 0; k < 16; ++k) {
+            const float a = float(k) * 6.2831853f / 16.0f;
+            solver->AddVelocity(32.0f + 8.0f * std::cos(a), 32.0f + 8.0f * std::sin(a), 3.0f,
+                                -0.02f * std::sin(a), 0.02f * std::cos(a));
+        }
+        for (int step = 0; step < 120; ++step) {
+            solver->Step(1.0f / 30.0f);
+        }
+    }
+    assert(eddy.GetAwakeTileCount() == 4 && surfaceOnly.GetAwakeTileCount() == 0);
+    std::cout << "  [PASS] Slow eddy keeps " << eddy.GetAwakeTileCount() << " tiles awake" << std::endl;
+
+    // Water running out over a dry slope: clamping at the bed does not add volume
+    ShallowWaterSolver::Options tight = options;
+    tight.tolerance = 1e-7f;
+    tight.maxIterations = 400;
+    ShallowWaterSolver spill(tight);
+    std::vector<float> slope(64 * 64);
+    for (size_t c = 0; c < slope.size(); ++c) {
+        slope[c] = 0.02f * float(c % 64);
+    }
+    spill.SetTerrain(slope.data());
+    spill.Fill(-1.0f);
+    spill.AddDisturbance(20.0f, 32.0f, 6.0f, 2.0f);
+    const double spilled = spill.GetVolume();
+    for (int step = 0; step < 300; ++step) {
+        spill.Step(0.1f);
+    }
+    assert(std::abs(spill.GetVolume() - spilled) < 3e-5 * spilled);
+    std::cout << "  [PASS] Drying front conserves volume (" << spill.GetVolume() << " of " << spilled << " m^3)"
+              << std::endl;
+
+    // Sizes are rounded to whole tiles of whole SIMD groups
+    ShallowWaterSolver::Options odd = options;
+    odd.width = 60;
+    odd.height = 0;
+    odd.tileSize = 14;
+    ShallowWaterSolver rounded(odd);
+    assert(rounded.GetWidth() == 64 && rounded.GetHeight() == 16 && rounded.GetTileCount() == 4);
+    std::cout << "  [PASS] 60 x 0 cells in tiles of 14 rounded to " << rounded.GetWidth() << " x "
+              << rounded.GetHeight() << std::endl;
+}
+
+void test_particles() {
+    std::cout << "\nTest 5: Water Particles..." << std::endl;
+    WaterParticles::Options options;
+    options.capacity = 1000;
+    options.foamResolution = 32;
+    options.foamTileSize = 64.0f;
+    WaterParticles particles(options);
+
+    // Emitters race on the cursor; the overflow is dropped, not lost track of
+    JobSystem jobs(4);
+    jobs.ParallelFor(0, 1200, 16, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            WaterParticles::Droplet d;
+            d.x = 10.0f + float(i % 4);
+            d.y = 10.0f;
+            d.z = 20.0f;
+            d.life = 5.0f;
+            particles.Emit(d);
+        }
+    });
+    assert(particles.GetDroppedCount() == 200);
+    particles.Update(1.0f / 30.0f, nullptr, &jobs);
+    assert(particles.GetCount() == 1000);
+    for (size_t i = 0; i < particles.GetCount(); ++i) {
+        assert(particles.GetY()[i] < 10.0f);
+    }
+    std::cout << "  [PASS] 1200 concurrent emits into 1000 slots (200 dropped)" << std::endl;
+
+    // Droplets falling into the water die and leave foam where they landed
+    for (int step = 0; step < 90 && particles.GetCount() > 0; ++step) {
+        particles.Update(1.0f / 30.0f);
+    }
+    assert(particles.GetCount() == 0);
+    const float landed = particles.GetFoam(11.0f, 21.0f);
+    assert(landed > 0.5f && landed <= 1.0f);
+    assert(particles.GetFoam(40.0f, 50.0f) == 0.0f);
+    particles.Update(1.0f);
+    assert(particles.GetFoam(11.0f, 21.0f) < landed);
+    std::cout << "  [PASS] Landed droplets become foam that fades" << std::endl;
+
+    // A splash crown rises, then rains back down; expired droplets compact away
+    assert(particles.EmitSplash(40.0f, 0.0f, 40.0f, 1.0f) == 64);
+    WaterParticles::Droplet shortLived;
+    shortLived.y = 50.0f;
+    shortLived.life = 0.05f;
+    particles.Emit(shortLived);
+    particles.Update(1.0f / 30.0f);
+    assert(particles.GetCount() == 65);
+    particles.Update(1.0f / 30.0f);
+    assert(particles.GetCount() == 64);
+    for (size_t i = 0; i < particles.GetCount(); ++i) {
+        assert(particles.GetY()[i] > 0.0f);
+    }
+    float nearby = 0.0f;
+    while (particles.GetCount() > 0) {
+        particles.Update(1.0f / 30.0f);
+    }
+    for (float z = 30.0f; z <= 50.0f; z += 1.0f) {
+        for (float x = 30.0f; x <= 50.0f; x += 1.0f) {
+            nearby += particles.GetFoam(x, z);
+        }
+    }
+    assert(nearby > 0.0f);
+    assert(particles.GetFoam(0.0f, 0.0f) == 0.0f);  // Expired in the air: no foam
+    std::cout << "  [PASS] Splash of 64 droplets lands around its origin" << std::endl;
+
+    // A second splash reuses the same slots but not the same crown
+    {
+        WaterParticles ring(options);
+        auto crown = [&ring]() {
+            assert(ring.EmitSplash(0.0f, 0.0f, 0.0f, 1.0f) == 64);
+            ring.Update(0.1f);
+            std::vector<float> xs(ring.GetX(), ring.GetX() + ring.GetCount());
+            while (ring.GetCount() > 0) {
+                ring.Update(1.0f / 30.0f);
+            }
+            return xs;
+        };
+        const std::vector<float> first = crown();
+        const std::vector<float> second = crown();
+        assert(first.size() == 64 && second.size() == 64);
+        assert(first != second);
+    }
+    std::cout << "  [PASS] Successive splashes in the same slots differ" << std::endl;
+
+    // Surface heights come from a height query when one is given
+    WaterHeightQuery::Options queryOptions;
+    queryOptions.seaLevel = 5.0f;
+    WaterHeightQuery query(queryOptions);
+    WaterParticles::Droplet below, above;
+    below.y = 4.0f;
+    above.y = 8.0f;
+    particles.Emit(below);
+    particles.Emit(above);
+    particles.Update(1.0f / 30.0f, &query);
+    assert(particles.GetCount() == 1 && particles.GetY()[0] > 5.0f);
+    std::cout << "  [PASS] Droplets die at the queried surface" << std::endl;
+
+    // Crest foam appears exactly where the ocean folds
+    OceanFFT::Options oceanOptions;
+    oceanOptions.resolution = 32;
+    oceanOptions.tileSizes = {64.0f};
+    oceanOptions.windSpeed = 25.0f;
+    oceanOptions.choppiness = 2.0f;
+    OceanFFT ocean(oceanOptions);
+    ocean.Update(3.0f);
+    WaterParticles crests(options);
+    crests.AddCrestFoam(ocean, 0.1f, &jobs);
+    const auto& jacobian = ocean.GetCascade(0).jacobian;
+    size_t folding = 0;
+    for (size_t t = 0; t < jacobian.size(); ++t) {
+        const bool breaking = jacobian[t] < options.crestThreshold;
+        folding += breaking;
+        assert((crests.GetFoamTexture()[t] > 0.0f) == breaking);
+    }
+    assert(folding > 0 && folding < jacobian.size());
+    std::cout << "  [PASS] Crest foam on " << folding << " of " << jacobian.size() << " texels" << std::endl;
+
+    // Foam sizes that the four-wide passes cannot step are rounded up
+    WaterParticles::Options odd = options;
+    odd.capacity = 7;
+    odd.foamResolution = 30;
+    WaterParticles rounded(odd);
+    assert(rounded.GetFoamResolution() == 32 && rounded.GetFoamTexture().size() == 32 * 32);
+    rounded.AddCrestFoam(ocean, 0.1f);
+    rounded.Update(1.0f / 30.0f);
+    WaterParticles::Droplet one;
+    one.y = 5.0f;
+    for (int i = 0; i < 8; ++i) {
+        rounded.Emit(one);
+    }
+    rounded.Update(1.0f / 30.0f);
+    assert(rounded.GetCount() == 7 && rounded.GetCapacity() == 7);
+    std::cout << "  [PASS] Foam resolution 30 rounded up to " << rounded.GetFoamResolution()
+              << ", capacity 7 keeps 7 droplets" << std::endl;
+}
+
+void test_caustics() {
+    std::cout << "\nTest 6: Caustics..." << std::endl;
+    OceanFFT::Options oceanOptions;
+    oceanOptions.resolution = 32;
+    oceanOptions.tileSizes = {20.0f};
+    oceanOptions.windSpeed = 8.0f;
+    Caustics::Options options;
+    options.resolution = 32;
+    options.floorDepth = 10.0f;
+
+    // Still water lights the floor evenly with the attenuated sunlight
+    oceanOptions.amplitude = 0.0f;
+    OceanFFT flat(oceanOptions);
+    flat.Update(1.0f);
+    Caustics even(options);
+    even.Update(flat);
+    assert(even.GetTileSize() == 20.0f && even.GetVersion() == 1);
+    const float* l = options.lightDirection;
+    const float cosI = -l[1] / std::sqrt(l[0] * l[0] + l[1] * l[1] + l[2] * l[2]);
+    const float sinT = std::sqrt(1.0f - cosI * cosI) / options.ior;
+    const float expected = std::exp(-options.extinction * options.floorDepth / std::sqrt(1.0f - sinT * sinT));
+    for (float v : even.GetMap()) {
+        assert(std::abs(v - expected) < 1e-4f);
+    }
+    std::cout << "  [PASS] Flat water gives uniform intensity " << expected << std::endl;
+
+    // Waves focus light into bright lines while the mean stays close to flat
+    oceanOptions.amplitude = 2.0f;
+    OceanFFT ocean(oceanOptions);
+    ocean.Update(1.0f);
+    Caustics serial(options), threaded(options);
+    JobSystem jobs(4);
+    serial.Update(ocean);
+    threaded.Update(ocean, &jobs);
+    assert(serial.GetMap() == threaded.GetMap());
+    double mean = 0.0;
+    float lo = 1e9f, hi = 0.0f;
+    for (float v : serial.GetMap()) {
+        mean += v;
+        lo = std::min(lo, v);
+        hi = std::max(hi, v);
+    }
+    mean /= double(serial.GetMap().size());
+    assert(std::abs(mean - expected) < 0.05 * expected);
+    assert(hi > 1.5f * expected && lo < 0.8f * expected);
+    std::cout << "  [PASS] Wavy water: intensity " << lo << " to " << hi << ", mean " << mean
+              << ", threaded matches serial" << std::endl;
+
+    // One map tiles the ocean with the cascade's period
+    assert(std::abs(serial.Sample(3.3f, 7.1f) - serial.Sample(23.3f, -12.9f)) < 1e-4f);
+    std::cout << "  [PASS] Map repeats every " << serial.GetTileSize() << " m" << std::endl;
+
+    // Odd sizes are rounded up rather than breaking the periodic wrap
+    Caustics::Options odd = options;
+    odd.resolution = 24;
+    odd.raysPerTexel = 0;
+    Caustics rounded(odd);
+    rounded.Update(flat);
+    assert(rounded.GetResolution() == 32 && rounded.GetMap().size() == 32 * 32);
+    for (float v : rounded.GetMap()) {
+        assert(std::abs(v - expected) < 1e-4f);
+    }
+    std::cout << "  [PASS] Resolution 24 rounded up to " << rounded.GetResolution() << std::endl;
+
+    // Light that never reaches the floor falls back to straight down instead of NaN
+    const float overhead = std::exp(-odd.extinction * odd.floorDepth);
+    const float unusable[3][3] = {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.5f}};
+    for (const auto& direction : unusable) {
+        Caustics::Options sideways = odd;
+        std::copy(direction, direction + 3, sideways.lightDirection);
+        Caustics fallback(sideways);
+        fallback.Update(flat);
+        for (float v : fallback.GetMap()) {
+            assert(std::abs(v - overhead) < 1e-4f);
+        }
+    }
+    std::cout << "  [PASS] Zero, horizontal and upward light fall back to overhead (" << overhead << ")" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Water Tests..." << std::endl;
+
+    test_fft();
+    test_ocean();
+    test_height_query();
+    test_shallow_water();
+    test_particles();
+    test_caustics();
+
+    std::cout << "\n✓ All water tests passed!" << std::endl;
+    return 0;
+}
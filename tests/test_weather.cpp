@@ -0,0 +1,292 @@
+#include "MemoryStorage.h"
+
+#include <core/JobSystem.h>
+#include <core/StorageManager.h>
+#include <nature/AtmosphereGrid.h>
+#include <nature/CloudNoiseBaker.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace NRE;
+
+/**
+ * @brief Basic test for weather simulation
+ *
+ * Tests:
+ * - Atmosphere grid forcing, local weather and budgeted time slicing
+ * - Tileable cloud noise bakes, cache round trip, coverage updates and option normalization
+ */
+
+using WeatherType = WeatherSystem::WeatherType;
+
+static AtmosphereGrid::Options SmallGrid() {
+    AtmosphereGrid::Options options;
+    options.width = 16;
+    options.depth = 16;
+    options.layers = 8;
+    options.chunkSize = 4;
+    options.patternSize = 4.0f;
+    options.budgetMicroseconds = 1e9f;
+    return options;
+}
+
+// Count of each weather type over all column centers
+static std::multiset<WeatherType> Survey(const AtmosphereGrid& grid) {
+    std::multiset<WeatherType> seen;
+    const auto& o = grid.GetOptions();
+    for (int i = 0; i < o.depth; ++i) {
+        for (int j = 0; j < o.width; ++j) {
+            seen.insert(grid.GetWeather((float(j) + 0.5f) * o.cellSize, (float(i) + 0.5f) * o.cellSize));
+        }
+    }
+    return seen;
+}
+
+void test_atmosphere() {
+    std::cout << "\nTest 1: Atmosphere Grid..." << std::endl;
+    AtmosphereGrid grid(SmallGrid());
+    const size_t columns = 16 * 16;
+    assert(Survey(grid).count(WeatherType::Clear) == columns);
+    const auto calm = grid.GetConditions(1000.0f, 0.0f, 1000.0f);
+    assert(calm.precipitation == 0.0f && calm.cloudWater == 0.0f);
+    assert(calm.relativeHumidity > 0.3f && calm.relativeHumidity < 0.7f);
+    assert(grid.GetConditions(1000.0f, 5000.0f, 1000.0f).temperature < calm.temperature);
+
+    // SetWeather only steers; rain follows as cloud water builds up
+    grid.SetWeather(WeatherType::Rain, 0.0f);
+    assert(grid.GetTarget() == WeatherType::Rain);
+    grid.Update(60.0f);
+    assert(Survey(grid).count(WeatherType::Clear) == columns);
+    for (int step = 0; step < 180; ++step) {
+        grid.Update(60.0f);
+    }
+    assert(grid.GetStepCount() == 181);
+    const auto rainy = Survey(grid);
+    assert(rainy.count(WeatherType::Rain) + rainy.count(WeatherType::HeavyRain) > columns * 3 / 4);
+    const auto wet = grid.GetConditions(5000.0f, 0.0f, 7000.0f);
+    assert(wet.precipitation > 2.5f && wet.cloudWater > 0.0f);
+    std::cout << "  [PASS] Rain forcing: " << wet.precipitation << " mm/h after 3 h" << std::endl;
+
+    grid.SetWeather(WeatherType::Clear, 1800.0f);
+    for (int step = 0; step < 180; ++step) {
+        grid.Update(60.0f);
+    }
+    assert(Survey(grid).count(WeatherType::Clear) == columns);
+    std::cout << "  [PASS] Clears up after the forcing returns to clear" << std::endl;
+
+    // The cold forcing snows; partly cloudy skies differ from place to place
+    AtmosphereGrid cold(SmallGrid()), mixed(SmallGrid());
+    cold.SetWeather(WeatherType::Snow, 0.0f);
+    mixed.SetWeather(WeatherType::PartlyCloudy, 0.0f);
+    for (int step = 0; step < 180; ++step) {
+        cold.Update(60.0f);
+        mixed.Update(60.0f);
+    }
+    assert(Survey(cold).count(WeatherType::Snow) > columns * 3 / 4);
+    const auto sky = Survey(mixed);
+    assert(sky.count(WeatherType::Clear) > 0 && sky.count(WeatherType::Clear) < columns);
+    std::cout << "  [PASS] Snow below freezing; partly cloudy varies locally" << std::endl;
+
+    // A zero budget runs one chunk per Update and still reaches the same state
+    AtmosphereGrid::Options slicedOptions = SmallGrid();
+    slicedOptions.budgetMicroseconds = 0.0f;
+    AtmosphereGrid whole(SmallGrid()), sliced(slicedOptions), threaded(SmallGrid());
+    JobSystem jobs(3);
+    for (AtmosphereGrid* g : {&whole, &sliced, &threaded}) {
+        g->SetWeather(WeatherType::Thunderstorm, 600.0f);
+    }
+    for (int step = 0; step < 30; ++step) {
+        whole.Update(60.0f);
+        threaded.Update(60.0f, &jobs);
+        sliced.Update(60.0f);
+        assert(sliced.GetChunksLastUpdate() == 1);
+        for (size_t c = 1; c < sliced.GetChunkCount(); ++c) {
+            assert(sliced.GetStepCount() == uint64_t(step));
+            sliced.Update(0.0f);
+        }
+        assert(sliced.GetStepCount() == uint64_t(step + 1));
+    }
+    for (float x = 0.0f; x < 32000.0f; x += 3700.0f) {
+        for (float altitude : {0.0f, 2500.0f, 6000.0f}) {
+            const auto a = whole.GetConditions(x, altitude, 0.7f * x);
+            const auto b = sliced.GetConditions(x, altitude, 0.7f * x);
+            const auto c = threaded.GetConditions(x, altitude, 0.7f * x);
+            assert(a.temperature == b.temperature && a.cloudWater == b.cloudWater);
+            assert(a.precipitation == b.precipitation && a.relativeHumidity == b.relativeHumidity);
+            assert(a.temperature == c.temperature && a.cloudWater == c.cloudWater);
+        }
+    }
+
+    // Readers see the same blend every frame, however the budget slices the step
+    AtmosphereGrid framed(SmallGrid()), framedSliced(slicedOptions);
+    framed.SetWeather(WeatherType::Rain, 0.0f);
+    framedSliced.SetWeather(WeatherType::Rain, 0.0f);
+    int changes = 0;
+    float last = framed.GetConditions(9000.0f, 1500.0f, 4000.0f).relativeHumidity;
+    for (int frame = 0; frame < 240; ++frame) {  // 30 frames per step, 16 chunks
+        framed.Update(2.0f);
+        framedSliced.Update(2.0f);
+        const auto a = framed.GetConditions(9000.0f, 1500.0f, 4000.0f);
+        const auto b = framedSliced.GetConditions(9000.0f, 1500.0f, 4000.0f);
+        assert(a.temperature == b.temperature && a.cloudWater == b.cloudWater);
+        assert(a.relativeHumidity == b.relativeHumidity);
+        changes += a.relativeHumidity != last;
+        last = a.relativeHumidity;
+    }
+    assert(changes > 100);  // Blends smoothly within steps, not only at boundaries
+    std::cout << "  [PASS] " << sliced.GetChunkCount()
+              << " one-chunk slices per step match whole and threaded steps" << std::endl;
+    std::cout << "  [PASS] Per-frame blend independent of the budget" << std::endl;
+
+    // Empty chunks and grids are clamped instead of dividing by zero
+    AtmosphereGrid::Options tiny = SmallGrid();
+    tiny.width = 5;
+    tiny.depth = 0;
+    tiny.chunkSize = 0;
+    AtmosphereGrid clamped(tiny);
+    assert(clamped.GetOptions().depth == 1 && clamped.GetOptions().chunkSize == 1);
+    assert(clamped.GetChunkCount() == 5);
+    clamped.Update(60.0f);
+    clamped.Update(60.0f);
+    assert(clamped.GetStepCount() == 2);
+    assert(std::isfinite(clamped.GetConditions(3000.0f, 500.0f, 0.0f).temperature));
+    std::cout << "  [PASS] Chunk size 0 on a 5 x 0 grid clamped to 5 chunks of 1" << std::endl;
+}
+
+// Largest step between neighbors along x inside the volume, and across its wrap
+static void Steps(const CloudNoiseBaker::Volume& volume, int channel, int& inside, int& seam) {
+    const int n = volume.size;
+    inside = seam = 0;
+    for (int z = 0; z < n; ++z) {
+        for (int y = 0; y < n; ++y) {
+            const uint8_t* row = volume.texels.data() + (size_t(z) * size_t(n) + size_t(y)) * size_t(n) * 4;
+            for (int x = 0; x + 1 < n; ++x) {
+                inside = std::max(inside, std::abs(int(row[x * 4 + channel]) - int(row[(x + 1) * 4 + channel])));
+            }
+            seam = std::max(seam, std::abs(int(row[(n - 1) * 4 + channel]) - int(row[channel])));
+        }
+    }
+}
+
+static double MeanChannel(const std::vector<uint8_t>& rgba, int channel) {
+    double sum = 0.0;
+    for (size_t i = size_t(channel); i < rgba.size(); i += 4) {
+        sum += rgba[i];
+    }
+    return sum / (255.0 * double(rgba.size() / 4));
+}
+
+void test_cloud_noise() {
+    std::cout << "\nTest 2: Cloud Noise Baker..." << std::endl;
+    CloudNoiseBaker::Options options;
+    options.shapeSize = 16;
+    options.detailSize = 8;
+    options.weatherSize = 32;
+    options.shapeFrequency = 2;
+    options.detailFrequency = 2;
+    options.weatherFrequency = 2;
+    options.perlinOctaves = 3;
+
+    // Parallel bakes are byte-identical to serial ones
+    CloudNoiseBaker serial(options), threaded(options);
+    JobSystem jobs(4);
+    assert(!serial.Bake());
+    assert(!threaded.Bake(&jobs));
+    assert(serial.GetShape().texels == threaded.GetShape().texels);
+    assert(serial.GetDetail().texels == threaded.GetDetail().texels);
+    assert(serial.GetWeatherMap() == threaded.GetWeatherMap());
+    assert(serial.GetShape().texels.size() == 16 * 16 * 16 * 4);
+    std::cout << "  [PASS] Threaded bake matches serial" << std::endl;
+
+    // Every channel has contrast and wraps without a seam
+    for (const auto* volume : {&serial.GetShape(), &serial.GetDetail()}) {
+        for (int channel = 0; channel < 4; ++channel) {
+            uint8_t lo = 255, hi = 0;
+            for (size_t i = size_t(channel); i < volume->texels.size(); i += 4) {
+                lo = std::min(lo, volume->texels[i]);
+                hi = std::max(hi, volume->texels[i]);
+            }
+            assert(hi - lo > 64);
+            int inside = 0, seam = 0;
+            Steps(*volume, channel, inside, seam);
+            assert(seam <= inside);
+        }
+    }
+    std::cout << "  [PASS] Shape and detail channels tile seamlessly" << std::endl;
+
+    // A second startup loads the cached bake instead of generating it
+    MemoryStorage storage;
+    CloudNoiseBaker first(options), second(options);
+    assert(!first.Bake(&jobs, &storage));
+    assert(storage.entries.size() == 1 && storage.lowPriorityWrites == 1);
+    assert(storage.entries.count(first.GetKey()) == 1 && first.GetStoredBytes() > 0);
+    assert(second.Bake(&jobs, &storage) && second.WasLoaded());
+    assert(second.GetShape().texels == serial.GetShape().texels);
+    assert(second.GetDetail().texels == serial.GetDetail().texels);
+    assert(second.GetWeatherMap() == serial.GetWeatherMap());
+    CloudNoiseBaker::Options reseeded = options;
+    reseeded.seed = 2;
+    CloudNoiseBaker other(reseeded);
+    assert(other.GetKey() != first.GetKey() && !other.Bake(&jobs, &storage));
+    storage.entries[first.GetKey()].resize(40);  // Truncated entry: regenerate
+    CloudNoiseBaker third(options);
+    assert(!third.Bake(nullptr, &storage) && third.GetShape().texels == serial.GetShape().texels);
+    std::cout << "  [PASS] Cache round trip (" << first.GetStoredBytes() << " bytes stored)" << std::endl;
+
+    // Coverage updates only remap the weather map
+    const auto shape = serial.GetShape().texels;
+    serial.UpdateCoverage(CloudNoiseBaker::CoverageFor(WeatherType::Clear));
+    const double clear = MeanChannel(serial.GetWeatherMap(), 0);
+    serial.UpdateCoverage(CloudNoiseBaker::CoverageFor(WeatherType::Overcast), &jobs);
+    const double overcast = MeanChannel(serial.GetWeatherMap(), 0);
+    assert(clear < 0.1 && overcast > 0.8);
+    assert(MeanChannel(serial.GetWeatherMap(), 1) > 0.1);
+    assert(serial.GetShape().texels == shape);
+
+    AtmosphereGrid::Options gridOptions = SmallGrid();
+    AtmosphereGrid grid(gridOptions);
+    serial.UpdateCoverage(grid);
+    assert(MeanChannel(serial.GetWeatherMap(), 0) == 0.0);
+    grid.SetWeather(WeatherType::Rain, 0.0f);
+    for (int step = 0; step < 120; ++step) {
+        grid.Update(60.0f);
+    }
+    serial.UpdateCoverage(grid, &jobs);
+    assert(MeanChannel(serial.GetWeatherMap(), 0) > 0.8 && MeanChannel(serial.GetWeatherMap(), 1) > 0.2);
+    std::cout << "  [PASS] Coverage " << clear << " clear, " << overcast << " overcast, follows the atmosphere"
+              << std::endl;
+
+    // Sizes off the SIMD width and degenerate frequencies are normalized, not overrun
+    CloudNoiseBaker::Options odd = options;
+    odd.shapeSize = 10;
+    odd.detailSize = 6;
+    odd.weatherSize = 30;
+    odd.detailFrequency = 0;
+    odd.perlinOctaves = 0;
+    CloudNoiseBaker rounded(odd);
+    rounded.Bake(&jobs);
+    assert(rounded.GetShape().size == 12 && rounded.GetShape().texels.size() == 12 * 12 * 12 * 4);
+    assert(rounded.GetDetail().size == 8 && rounded.GetWeatherSize() == 32);
+    assert(rounded.GetOptions().detailFrequency == 1 && rounded.GetOptions().perlinOctaves == 1);
+    assert(rounded.GetWeatherMap().size() == 32 * 32 * 4);
+    std::cout << "  [PASS] Sizes 10/6/30 rounded up to " << rounded.GetShape().size << "/"
+              << rounded.GetDetail().size << "/" << rounded.GetWeatherSize() << std::endl;
+}
+
+int main() {
+    std::cout << "Running Weather Tests..." << std::endl;
+
+    test_atmosphere();
+    test_cloud_noise();
+
+    std::cout << "\n✓ All weather tests passed!" << std::endl;
+    return 0;
+}